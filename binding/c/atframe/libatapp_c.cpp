@@ -5,6 +5,7 @@
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -23,6 +24,9 @@
 #define ATAPP_MESSAGE(x) ((const ::atframework::atapp::app::message_t *)(x[1]))
 #define ATAPP_MESSAGE_IS_NULL(x) (nullptr == (x))
 
+#define ATAPP_CONFIGURE_SNAPSHOT(x) ((const ::atframework::atapp::configure_snapshot::ptr_t *)(x))
+#define ATAPP_CONFIGURE_SNAPSHOT_IS_NULL(x) (nullptr == (x))
+
 #define ATAPP_SENDER(x) ((const ::atframework::atapp::app::message_sender_t *)(x[0]))
 
 namespace detail {
@@ -246,6 +250,155 @@ class libatapp_c_on_module final : public ::atframework::atapp::module_impl {
  private:
   std::string name_;
 };
+
+class libatapp_c_msg_batch_module final : public ::atframework::atapp::module_impl {
+ private:
+  // Pointers of views are resolved by offsets when delivered, because buffer may be reallocated when appending
+  struct batch_buffer_t {
+    std::vector<libatapp_c_message_view_t> views;
+    std::vector<size_t> offsets;  // [data offset, source name offset] of each view
+    std::vector<unsigned char> buffer;
+
+    void clear() {
+      views.clear();
+      offsets.clear();
+      buffer.clear();
+    }
+  };
+
+ public:
+  libatapp_c_msg_batch_module() : callee_(nullptr), private_data_(nullptr), max_batch_size_(0), delivering_(false) {}
+
+  int init() override final { return 0; }
+
+  const char *name() const override final { return "libatapp_c_msg_batch_module"; }
+
+  int tick() override final { return static_cast<int>(flush()); }
+
+  int stop() override final {
+    flush();
+    return 0;
+  }
+
+  void push(const ::atframework::atapp::app::message_sender_t &source,
+            const ::atframework::atapp::app::message_t &msg) {
+    pending_.offsets.push_back(pending_.buffer.size());
+    pending_.buffer.insert(pending_.buffer.end(), msg.data.begin(), msg.data.end());
+    pending_.offsets.push_back(pending_.buffer.size());
+    pending_.buffer.insert(pending_.buffer.end(), source.name.begin(), source.name.end());
+
+    libatapp_c_message_view_t view;
+    view.direct_source_id = static_cast<uint64_t>(source.direct_source_id);
+    view.source_id = static_cast<uint64_t>(source.id);
+    view.source_name = nullptr;
+    view.source_name_len = static_cast<uint64_t>(source.name.size());
+    view.type = msg.type;
+    view.sequence = msg.message_sequence;
+    view.data = nullptr;
+    view.data_len = static_cast<uint64_t>(msg.data.size());
+    pending_.views.push_back(view);
+
+    if (max_batch_size_ > 0 && static_cast<uint64_t>(pending_.views.size()) >= max_batch_size_) {
+      flush();
+    }
+  }
+
+  uint64_t flush() {
+    // Messages received in callback will be delivered next time
+    if (delivering_ || pending_.views.empty()) {
+      return 0;
+    }
+
+    delivering_ = true;
+    pending_.views.swap(delivering_buffer_.views);
+    pending_.offsets.swap(delivering_buffer_.offsets);
+    pending_.buffer.swap(delivering_buffer_.buffer);
+
+    const unsigned char *base = delivering_buffer_.buffer.data();
+    for (size_t i = 0; i < delivering_buffer_.views.size(); ++i) {
+      libatapp_c_message_view_t &view = delivering_buffer_.views[i];
+      view.data = base + delivering_buffer_.offsets[i * 2];
+      view.source_name = reinterpret_cast<const char *>(base + delivering_buffer_.offsets[i * 2 + 1]);
+    }
+
+    uint64_t ret = static_cast<uint64_t>(delivering_buffer_.views.size());
+    if (nullptr != callee_) {
+      libatapp_c_context ctx;
+      ctx = get_app();
+      (*callee_)(ctx, delivering_buffer_.views.data(), ret, private_data_);
+    }
+
+    // Keep capacity to be reused
+    delivering_buffer_.clear();
+    delivering_ = false;
+    return ret;
+  }
+
+ public:
+  libatapp_c_on_msg_batch_fn_t callee_;
+  void *private_data_;
+  uint64_t max_batch_size_;
+
+ private:
+  batch_buffer_t pending_;
+  batch_buffer_t delivering_buffer_;
+  bool delivering_;
+};
+
+struct libatapp_c_on_msg_batch_functor {
+  explicit libatapp_c_on_msg_batch_functor(std::shared_ptr<libatapp_c_msg_batch_module> mod)
+      : module_(std::move(mod)) {}
+
+  int operator()(::atframework::atapp::app &, const ::atframework::atapp::app::message_sender_t &source,
+                 const ::atframework::atapp::app::message_t &msg) {
+    if (module_) {
+      module_->push(source, msg);
+    }
+    return 0;
+  }
+
+  std::shared_ptr<libatapp_c_msg_batch_module> module_;
+};
+
+static libatapp_c_msg_batch_module *libatapp_c_get_msg_batch_module(libatapp_c_context context) {
+  const libatapp_c_on_msg_batch_functor *functor =
+      ATAPP_CONTEXT(context)->get_evt_on_forward_request().target<libatapp_c_on_msg_batch_functor>();
+  if (nullptr == functor) {
+    return nullptr;
+  }
+
+  return functor->module_.get();
+}
+
+static int32_t libatapp_c_send_message(::atframework::atapp::app &self, libatapp_c_send_message_t &msg) {
+  gsl::span<const unsigned char> data{reinterpret_cast<const unsigned char *>(msg.data),
+                                      static_cast<size_t>(msg.data_len)};
+  uint64_t *sequence = &msg.sequence;
+  switch (msg.target_type) {
+    case LIBATAPP_C_MESSAGE_TARGET_BY_ID:
+      return self.send_message(msg.target_id, msg.type, data, sequence);
+    case LIBATAPP_C_MESSAGE_TARGET_BY_NAME:
+      if (nullptr == msg.target_buffer) {
+        return EN_ATBUS_ERR_PARAMS;
+      }
+      return self.send_message(gsl::string_view{msg.target_buffer, static_cast<size_t>(msg.target_buffer_len)},
+                               msg.type, data, sequence);
+    case LIBATAPP_C_MESSAGE_TARGET_BY_CONSISTENT_HASH:
+      if (nullptr == msg.target_buffer) {
+        return self.send_message_by_consistent_hash(msg.target_id, msg.type, data, sequence);
+      }
+      return self.send_message_by_consistent_hash(
+          gsl::span<const unsigned char>{reinterpret_cast<const unsigned char *>(msg.target_buffer),
+                                         static_cast<size_t>(msg.target_buffer_len)},
+          msg.type, data, sequence);
+    case LIBATAPP_C_MESSAGE_TARGET_BY_RANDOM:
+      return self.send_message_by_random(msg.type, data, sequence);
+    case LIBATAPP_C_MESSAGE_TARGET_BY_ROUND_ROBIN:
+      return self.send_message_by_round_robin(msg.type, data, sequence);
+    default:
+      return EN_ATBUS_ERR_PARAMS;
+  }
+}
 }  // namespace detail
 
 #define ATAPP_MODULE(x) ((::detail::libatapp_c_on_module *)(x))
@@ -264,6 +417,31 @@ LIBATAPP_MACRO_API void __cdecl libatapp_c_set_on_msg_fn(libatapp_c_context cont
   ATAPP_CONTEXT(context)->set_evt_on_forward_request(::detail::libatapp_c_on_msg_functor(fn, priv_data));
 }
 
+LIBATAPP_MACRO_API void __cdecl libatapp_c_set_on_msg_batch_fn(libatapp_c_context context,
+                                                               libatapp_c_on_msg_batch_fn_t fn, uint64_t max_batch_size,
+                                                               void *priv_data) {
+  if (ATAPP_CONTEXT_IS_NULL(context)) {
+    return;
+  }
+
+  // Only one module is added, update the callback when it's called again
+  ::detail::libatapp_c_msg_batch_module *mod = ::detail::libatapp_c_get_msg_batch_module(context);
+  if (nullptr == mod) {
+    std::shared_ptr<::detail::libatapp_c_msg_batch_module> res =
+        std::make_shared<::detail::libatapp_c_msg_batch_module>();
+    if (!res) {
+      return;
+    }
+    mod = res.get();
+    ATAPP_CONTEXT(context)->add_module(res);
+    ATAPP_CONTEXT(context)->set_evt_on_forward_request(::detail::libatapp_c_on_msg_batch_functor(res));
+  }
+
+  mod->callee_ = fn;
+  mod->private_data_ = priv_data;
+  mod->max_batch_size_ = max_batch_size;
+}
+
 LIBATAPP_MACRO_API void __cdecl libatapp_c_set_on_forward_response_fn(libatapp_c_context context,
                                                                       libatapp_c_on_send_fail_fn_t fn,
                                                                       void *priv_data) {
@@ -383,7 +561,9 @@ LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_run_noblock(libatapp_c_context con
     return EN_ATBUS_ERR_PARAMS;
   }
 
-  return ATAPP_CONTEXT(context)->run_noblock(max_event_count);
+  int32_t ret = ATAPP_CONTEXT(context)->run_noblock(max_event_count);
+  libatapp_c_flush_msg_batch(context);
+  return ret;
 }
 
 LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_reload(libatapp_c_context context) {
@@ -407,7 +587,9 @@ LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_tick(libatapp_c_context context) {
     return EN_ATBUS_ERR_PARAMS;
   }
 
-  return ATAPP_CONTEXT(context)->tick();
+  int32_t ret = ATAPP_CONTEXT(context)->tick();
+  libatapp_c_flush_msg_batch(context);
+  return ret;
 }
 
 LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_get_id(libatapp_c_context context) {
@@ -464,6 +646,87 @@ LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_get_configure(libatapp_c_context
   return ret;
 }
 
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_get_configure_generation(libatapp_c_context context) {
+  if (ATAPP_CONTEXT_IS_NULL(context)) {
+    return 0;
+  }
+
+  return ATAPP_CONTEXT(context)->get_configure_generation();
+}
+
+LIBATAPP_MACRO_API libatapp_c_configure_snapshot __cdecl libatapp_c_configure_snapshot_acquire(
+    libatapp_c_context context) {
+  libatapp_c_configure_snapshot ret;
+  ret = nullptr;
+  if (ATAPP_CONTEXT_IS_NULL(context)) {
+    return ret;
+  }
+
+  ::atframework::atapp::configure_snapshot::ptr_t snapshot = ATAPP_CONTEXT(context)->get_configure_snapshot();
+  if (!snapshot) {
+    return ret;
+  }
+
+  // The handle holds a reference of snapshot
+  ret = new (std::nothrow)::atframework::atapp::configure_snapshot::ptr_t(std::move(snapshot));
+  return ret;
+}
+
+LIBATAPP_MACRO_API void __cdecl libatapp_c_configure_snapshot_release(libatapp_c_configure_snapshot snapshot) {
+  delete ATAPP_CONFIGURE_SNAPSHOT(snapshot);
+}
+
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_configure_snapshot_get_generation(
+    libatapp_c_configure_snapshot snapshot) {
+  if (ATAPP_CONFIGURE_SNAPSHOT_IS_NULL(snapshot) || !*ATAPP_CONFIGURE_SNAPSHOT(snapshot)) {
+    return 0;
+  }
+
+  return (*ATAPP_CONFIGURE_SNAPSHOT(snapshot))->get_generation();
+}
+
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_configure_snapshot_get_size(libatapp_c_configure_snapshot snapshot,
+                                                                           const char *path, uint64_t path_len) {
+  if (ATAPP_CONFIGURE_SNAPSHOT_IS_NULL(snapshot) || !*ATAPP_CONFIGURE_SNAPSHOT(snapshot) || nullptr == path) {
+    return 0;
+  }
+
+  const ::atframework::atapp::configure_snapshot::value_list_t *values =
+      (*ATAPP_CONFIGURE_SNAPSHOT(snapshot))->find(gsl::string_view{path, static_cast<size_t>(path_len)});
+  if (nullptr == values) {
+    return 0;
+  }
+
+  return static_cast<uint64_t>(values->size());
+}
+
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_configure_snapshot_get(libatapp_c_configure_snapshot snapshot,
+                                                                      const char *path, uint64_t path_len,
+                                                                      const char *out_buf[], uint64_t out_len[],
+                                                                      uint64_t arr_sz) {
+  if (ATAPP_CONFIGURE_SNAPSHOT_IS_NULL(snapshot) || !*ATAPP_CONFIGURE_SNAPSHOT(snapshot) || nullptr == path) {
+    return 0;
+  }
+
+  const ::atframework::atapp::configure_snapshot::value_list_t *values =
+      (*ATAPP_CONFIGURE_SNAPSHOT(snapshot))->find(gsl::string_view{path, static_cast<size_t>(path_len)});
+  if (nullptr == values) {
+    return 0;
+  }
+
+  uint64_t ret = 0;
+  for (ret = 0; ret < values->size() && ret < arr_sz; ++ret) {
+    if (nullptr != out_buf) {
+      out_buf[ret] = (*values)[static_cast<size_t>(ret)].c_str();
+    }
+    if (nullptr != out_len) {
+      out_len[ret] = static_cast<uint64_t>((*values)[static_cast<size_t>(ret)].size());
+    }
+  }
+
+  return ret;
+}
+
 LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_is_inited(libatapp_c_context context) {
   if (ATAPP_CONTEXT_IS_NULL(context)) {
     return false;
@@ -567,6 +830,80 @@ LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_send_custom_msg(libatapp_c_context
   return ATAPP_CONTEXT(context)->get_bus_node()->send_custom_command(app_id, szs);
 }
 
+LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_send_message_by_id(libatapp_c_context context, uint64_t app_id,
+                                                                 int32_t type, const void *buffer, uint64_t sz,
+                                                                 uint64_t *sequence) {
+  if (ATAPP_CONTEXT_IS_NULL(context)) {
+    return EN_ATBUS_ERR_PARAMS;
+  }
+
+  return ATAPP_CONTEXT(context)->send_message(
+      app_id, type,
+      gsl::span<const unsigned char>{reinterpret_cast<const unsigned char *>(buffer), static_cast<size_t>(sz)},
+      sequence);
+}
+
+LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_send_message_by_name(libatapp_c_context context, const char *name,
+                                                                   uint64_t name_len, int32_t type,
+                                                                   const void *buffer, uint64_t sz,
+                                                                   uint64_t *sequence) {
+  if (ATAPP_CONTEXT_IS_NULL(context) || nullptr == name) {
+    return EN_ATBUS_ERR_PARAMS;
+  }
+
+  return ATAPP_CONTEXT(context)->send_message(
+      gsl::string_view{name, static_cast<size_t>(name_len)}, type,
+      gsl::span<const unsigned char>{reinterpret_cast<const unsigned char *>(buffer), static_cast<size_t>(sz)},
+      sequence);
+}
+
+LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_send_message_by_consistent_hash(libatapp_c_context context,
+                                                                              const void *hash_buffer,
+                                                                              uint64_t hash_buffer_len, int32_t type,
+                                                                              const void *buffer, uint64_t sz,
+                                                                              uint64_t *sequence) {
+  if (ATAPP_CONTEXT_IS_NULL(context) || nullptr == hash_buffer) {
+    return EN_ATBUS_ERR_PARAMS;
+  }
+
+  return ATAPP_CONTEXT(context)->send_message_by_consistent_hash(
+      gsl::span<const unsigned char>{reinterpret_cast<const unsigned char *>(hash_buffer),
+                                     static_cast<size_t>(hash_buffer_len)},
+      type, gsl::span<const unsigned char>{reinterpret_cast<const unsigned char *>(buffer), static_cast<size_t>(sz)},
+      sequence);
+}
+
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_send_many(libatapp_c_context context,
+                                                         libatapp_c_send_message_t *messages, uint64_t msg_count) {
+  if (ATAPP_CONTEXT_IS_NULL(context) || nullptr == messages) {
+    return 0;
+  }
+
+  uint64_t ret = 0;
+  for (uint64_t i = 0; i < msg_count; ++i) {
+    messages[i].sequence = 0;
+    messages[i].result = ::detail::libatapp_c_send_message(*ATAPP_CONTEXT(context), messages[i]);
+    if (messages[i].result >= 0) {
+      ++ret;
+    }
+  }
+
+  return ret;
+}
+
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_flush_msg_batch(libatapp_c_context context) {
+  if (ATAPP_CONTEXT_IS_NULL(context)) {
+    return 0;
+  }
+
+  ::detail::libatapp_c_msg_batch_module *mod = ::detail::libatapp_c_get_msg_batch_module(context);
+  if (nullptr == mod) {
+    return 0;
+  }
+
+  return mod->flush();
+}
+
 LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_msg_get_type(libatapp_c_message msg) {
   if (ATAPP_MESSAGE_IS_NULL(msg)) {
     return 0;
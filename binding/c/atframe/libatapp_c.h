@@ -18,6 +18,7 @@ using libatapp_c_context = void *;
 using libatapp_c_custom_cmd_sender = void *;
 using libatapp_c_message = const void *[2];
 using libatapp_c_module = void *;
+using libatapp_c_configure_snapshot = const void *;
 
 enum LIBATAPP_C_ATBUS_PROTOCOL_BODY_TYPE {
   LIBATAPP_C_ATBUS_BODY_TYPE_INVALID = 0,
@@ -37,6 +38,45 @@ enum LIBATAPP_C_ATBUS_PROTOCOL_BODY_TYPE {
   LIBATAPP_C_ATBUS_BODY_TYPE_MAX
 };
 
+enum LIBATAPP_C_MESSAGE_TARGET_TYPE {
+  LIBATAPP_C_MESSAGE_TARGET_BY_ID = 0,
+  LIBATAPP_C_MESSAGE_TARGET_BY_NAME = 1,
+  LIBATAPP_C_MESSAGE_TARGET_BY_CONSISTENT_HASH = 2,
+  LIBATAPP_C_MESSAGE_TARGET_BY_RANDOM = 3,
+  LIBATAPP_C_MESSAGE_TARGET_BY_ROUND_ROBIN = 4,
+};
+
+/**
+ * message to send by libatapp_c_send_many, all buffers are owned by caller
+ */
+struct libatapp_c_send_message_t {
+  int32_t target_type;         // LIBATAPP_C_MESSAGE_TARGET_TYPE
+  int32_t type;                // message type
+  uint64_t target_id;          // node id of BY_ID, or hash key of BY_CONSISTENT_HASH when target_buffer is null
+  const char *target_buffer;   // node name of BY_NAME, or hash buffer of BY_CONSISTENT_HASH
+  uint64_t target_buffer_len;  // length of target_buffer
+  const void *data;
+  uint64_t data_len;
+
+  // outputs
+  uint64_t sequence;
+  int32_t result;
+};
+
+/**
+ * message received by libatapp_c_on_msg_batch_fn_t, all buffers are only available in the callback
+ */
+struct libatapp_c_message_view_t {
+  uint64_t direct_source_id;
+  uint64_t source_id;
+  const char *source_name;
+  uint64_t source_name_len;
+  int32_t type;
+  uint64_t sequence;
+  const void *data;
+  uint64_t data_len;
+};
+
 // =========================== callbacks ===========================
 using libatapp_c_on_msg_fn_t = int32_t (*)(libatapp_c_context, libatapp_c_message, const void *msg_data,
                                            uint64_t msg_len, void *priv_data);
@@ -45,12 +85,27 @@ using libatapp_c_on_send_fail_fn_t = int32_t (*)(libatapp_c_context, uint64_t sr
 using libatapp_c_on_connected_fn_t = int32_t (*)(libatapp_c_context, uint64_t pd, int32_t status, void *priv_data);
 using libatapp_c_on_disconnected_fn_t = int32_t (*)(libatapp_c_context, uint64_t pd, int32_t status, void *priv_data);
 using libatapp_c_on_all_module_inited_fn_t = int32_t (*)(libatapp_c_context, void *priv_data);
+using libatapp_c_on_msg_batch_fn_t = int32_t (*)(libatapp_c_context, const libatapp_c_message_view_t *msgs,
+                                                 uint64_t msg_count, void *priv_data);
 using libatapp_c_on_cmd_option_fn_t = int32_t (*)(libatapp_c_context, libatapp_c_custom_cmd_sender,
                                                   const char *buffer[], uint64_t buffer_len[], uint64_t sz,
                                                   void *priv_data);
 
 LIBATAPP_MACRO_API void __cdecl libatapp_c_set_on_msg_fn(libatapp_c_context context, libatapp_c_on_msg_fn_t fn,
                                                          void *priv_data);
+/**
+ * set callback to receive messages in batch, it replaces the callback set by libatapp_c_set_on_msg_fn
+ * @note received messages are copied into a reusable buffer and delivered in every tick, or when the count of pending
+ *       messages reaches max_batch_size
+ * @note must be called before libatapp_c_init or libatapp_c_run
+ * @param context atapp context
+ * @param fn callback
+ * @param max_batch_size max count of messages in one callback, 0 means delivering messages only in tick
+ * @param priv_data private data passed to callback
+ */
+LIBATAPP_MACRO_API void __cdecl libatapp_c_set_on_msg_batch_fn(libatapp_c_context context,
+                                                               libatapp_c_on_msg_batch_fn_t fn, uint64_t max_batch_size,
+                                                               void *priv_data);
 LIBATAPP_MACRO_API void __cdecl libatapp_c_set_on_forward_response_fn(libatapp_c_context context,
                                                                       libatapp_c_on_send_fail_fn_t fn, void *priv_data);
 LIBATAPP_MACRO_API void __cdecl libatapp_c_set_on_connected_fn(libatapp_c_context context,
@@ -95,6 +150,33 @@ LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_get_configure(libatapp_c_context
                                                              const char *out_buf[], uint64_t out_len[],
                                                              uint64_t arr_sz);
 
+/**
+ * get generation of configure, it's increased after every reload, bindings can cache values of snapshot until it's
+ * changed
+ */
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_get_configure_generation(libatapp_c_context context);
+
+/**
+ * acquire the immutable snapshot of all configure values of current generation
+ * @note snapshot and values in it keep valid after reload, until libatapp_c_configure_snapshot_release is called
+ * @return snapshot, must be released by libatapp_c_configure_snapshot_release
+ */
+LIBATAPP_MACRO_API libatapp_c_configure_snapshot __cdecl libatapp_c_configure_snapshot_acquire(
+    libatapp_c_context context);
+LIBATAPP_MACRO_API void __cdecl libatapp_c_configure_snapshot_release(libatapp_c_configure_snapshot snapshot);
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_configure_snapshot_get_generation(
+    libatapp_c_configure_snapshot snapshot);
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_configure_snapshot_get_size(libatapp_c_configure_snapshot snapshot,
+                                                                           const char *path, uint64_t path_len);
+/**
+ * get values of path, such as "atapp.bus.listen"
+ * @return count of values written into out_buf and out_len
+ */
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_configure_snapshot_get(libatapp_c_configure_snapshot snapshot,
+                                                                      const char *path, uint64_t path_len,
+                                                                      const char *out_buf[], uint64_t out_len[],
+                                                                      uint64_t arr_sz);
+
 // =========================== flags ===========================
 LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_is_inited(libatapp_c_context context);
 LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_is_running(libatapp_c_context context);
@@ -113,6 +195,35 @@ LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_send_custom_msg(libatapp_c_context
                                                               const void *arr_buf[], uint64_t arr_size[],
                                                               uint64_t arr_count);
 
+/**
+ * send messages by endpoints and service discovery of atapp, the same as app::send_message*
+ * @param sequence where to store message sequence, can be null
+ */
+LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_send_message_by_id(libatapp_c_context context, uint64_t app_id,
+                                                                 int32_t type, const void *buffer, uint64_t sz,
+                                                                 uint64_t *sequence);
+LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_send_message_by_name(libatapp_c_context context, const char *name,
+                                                                   uint64_t name_len, int32_t type,
+                                                                   const void *buffer, uint64_t sz,
+                                                                   uint64_t *sequence);
+LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_send_message_by_consistent_hash(libatapp_c_context context,
+                                                                              const void *hash_buffer,
+                                                                              uint64_t hash_buffer_len, int32_t type,
+                                                                              const void *buffer, uint64_t sz,
+                                                                              uint64_t *sequence);
+/**
+ * send messages in batch, result and sequence of each message are stored into messages
+ * @return count of messages sent successfully
+ */
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_send_many(libatapp_c_context context,
+                                                         libatapp_c_send_message_t *messages, uint64_t msg_count);
+
+/**
+ * deliver pending messages to callback set by libatapp_c_set_on_msg_batch_fn immediately
+ * @return count of delivered messages
+ */
+LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_flush_msg_batch(libatapp_c_context context);
+
 // =========================== message ===========================
 LIBATAPP_MACRO_API int32_t __cdecl libatapp_c_msg_get_type(libatapp_c_message msg);
 LIBATAPP_MACRO_API uint64_t __cdecl libatapp_c_msg_get_forward_from(libatapp_c_message msg);
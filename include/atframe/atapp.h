@@ -31,6 +31,8 @@
 #include <vector>
 
 #include "atframe/atapp_conf.h"
+#include "atframe/atapp_conf_snapshot.h"
+#include "atframe/atapp_flat_hash_map.h"
 
 #include "atframe/atapp_common_types.h"
 #include "atframe/atapp_log_sink_maker.h"
@@ -60,8 +62,9 @@ class app {
  public:
   using module_ptr_t = std::shared_ptr<module_impl>;
   using yaml_conf_map_t = std::unordered_map<std::string, std::vector<YAML::Node>>;
-  using endpoint_index_by_id_t = std::unordered_map<uint64_t, atapp_endpoint::ptr_t>;
-  using endpoint_index_by_name_t = std::unordered_map<std::string, atapp_endpoint::ptr_t>;
+  using endpoint_index_by_id_t = flat_hash_map<uint64_t, atapp_endpoint::ptr_t>;
+  using endpoint_index_by_name_t =
+      flat_hash_map<std::string, atapp_endpoint::ptr_t, flat_string_hash, flat_string_equal>;
   using connector_protocol_map_t = std::unordered_map<std::string, std::shared_ptr<atapp_connector_impl>>;
   using address_type_t = atapp_connector_impl::address_type_t;
   using ev_loop_t = uv_loop_t;
@@ -363,6 +366,32 @@ class app {
                                                     configure_key_set *existed_keys = nullptr) const noexcept;
 
   LIBATAPP_MACRO_API const atapp::protocol::atapp_configure &get_origin_configure() const noexcept;
+
+  /**
+   * @brief get generation of configure, it's increased every time configure files are loaded by reload()
+   */
+  LIBATAPP_MACRO_API uint64_t get_configure_generation() const noexcept;
+
+  /**
+   * @brief get the immutable and flattened snapshot of all configure values of current generation
+   * @note values of atapp are picked from origin configure, and values of custom sections are picked from ini and yaml
+   *       files. The snapshot is built and published by reload(), so it can be called and used in any thread.
+   *       Return nullptr before configure is loaded.
+   */
+  LIBATAPP_MACRO_API configure_snapshot::ptr_t get_configure_snapshot() const;
+
+  /**
+   * @brief check whether a field path of origin configure is changed by the last reload
+   * @param path field path joined by '.', such as "bus", "etcd" or "etcd.init"
+   * @note always return true when startup or when the differential result is not available
+   */
+  LIBATAPP_MACRO_API bool is_origin_configure_changed(gsl::string_view path) const noexcept;
+
+  /**
+   * @brief get all changed field paths of origin configure by the last reload
+   * @note it's empty when startup or when the differential result is not available
+   */
+  LIBATAPP_MACRO_API const configure_key_set &get_origin_configure_changed_paths() const noexcept;
   LIBATAPP_MACRO_API const atapp::protocol::atapp_log &get_log_configure() const noexcept;
   LIBATAPP_MACRO_API const atapp::protocol::atapp_metadata &get_metadata() const noexcept;
   LIBATAPP_MACRO_API const atapp::protocol::atapp_runtime &get_runtime_configure() const noexcept;
@@ -429,6 +458,12 @@ class app {
   LIBATAPP_MACRO_API int32_t send_message(const std::string &target_node_name, int32_t type,
                                           gsl::span<const unsigned char> data, uint64_t *msg_sequence = nullptr,
                                           const atapp::protocol::atapp_metadata *metadata = nullptr);
+  LIBATAPP_MACRO_API int32_t send_message(const char *target_node_name, int32_t type,
+                                          gsl::span<const unsigned char> data, uint64_t *msg_sequence = nullptr,
+                                          const atapp::protocol::atapp_metadata *metadata = nullptr);
+  LIBATAPP_MACRO_API int32_t send_message(gsl::string_view target_node_name, int32_t type,
+                                          gsl::span<const unsigned char> data, uint64_t *msg_sequence = nullptr,
+                                          const atapp::protocol::atapp_metadata *metadata = nullptr);
   LIBATAPP_MACRO_API int32_t send_message(const etcd_discovery_node::ptr_t &target_node_discovery, int32_t type,
                                           gsl::span<const unsigned char> data, uint64_t *msg_sequence = nullptr,
                                           const atapp::protocol::atapp_metadata *metadata = nullptr);
@@ -525,12 +560,18 @@ class app {
                                              atfw::util::time::time_utility::raw_time_t previous_time);
   LIBATAPP_MACRO_API void remove_endpoint(uint64_t by_id);
   LIBATAPP_MACRO_API void remove_endpoint(const std::string &by_name);
+  LIBATAPP_MACRO_API void remove_endpoint(const char *by_name);
+  LIBATAPP_MACRO_API void remove_endpoint(gsl::string_view by_name);
   LIBATAPP_MACRO_API void remove_endpoint(const atapp_endpoint::ptr_t &enpoint);
   LIBATAPP_MACRO_API atapp_endpoint::ptr_t mutable_endpoint(const etcd_discovery_node::ptr_t &discovery);
   LIBATAPP_MACRO_API atapp_endpoint *get_endpoint(uint64_t by_id);
   LIBATAPP_MACRO_API const atapp_endpoint *get_endpoint(uint64_t by_id) const noexcept;
   LIBATAPP_MACRO_API atapp_endpoint *get_endpoint(const std::string &by_name);
   LIBATAPP_MACRO_API const atapp_endpoint *get_endpoint(const std::string &by_name) const noexcept;
+  LIBATAPP_MACRO_API atapp_endpoint *get_endpoint(const char *by_name);
+  LIBATAPP_MACRO_API const atapp_endpoint *get_endpoint(const char *by_name) const noexcept;
+  LIBATAPP_MACRO_API atapp_endpoint *get_endpoint(gsl::string_view by_name);
+  LIBATAPP_MACRO_API const atapp_endpoint *get_endpoint(gsl::string_view by_name) const noexcept;
 
   template <class TCONNECTOR, class... TARGS>
   LIBATAPP_MACRO_API_HEAD_ONLY std::shared_ptr<TCONNECTOR> add_connector(TARGS &&...args) {
@@ -588,6 +629,8 @@ class app {
 
   int apply_configure();
 
+  void publish_configure_snapshot(uint64_t generation);
+
   void run_ev_loop(int run_mode);
 
   int run_inner(int run_mode);
@@ -736,6 +779,9 @@ class app {
   static app *last_instance_;
   atfw::util::config::ini_loader cfg_loader_;
   yaml_conf_map_t yaml_loader_;
+  std::atomic<uint64_t> configure_generation_;
+  mutable std::mutex configure_snapshot_lock_;
+  configure_snapshot::ptr_t configure_snapshot_;
   atfw::util::cli::cmd_option::ptr_type app_option_;
   atfw::util::cli::cmd_option_ci::ptr_type cmd_handler_;
   std::vector<std::string> last_command_;
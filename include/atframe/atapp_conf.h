@@ -40,6 +40,8 @@
 #include "atframe/atapp_config.h"
 
 LIBATAPP_MACRO_NAMESPACE_BEGIN
+using configure_key_set = std::unordered_set<std::string>;
+
 struct app_conf {
   // bus configure
   std::string id_cmd;
@@ -74,6 +76,10 @@ struct app_conf {
   // backup data
   atapp::protocol::atapp_configure previous_origin;
   atapp::protocol::atapp_log previous_log;
+
+  // changed field paths between previous_origin and origin, only available after a differential reload
+  bool origin_changed_paths_available;
+  configure_key_set origin_changed_paths;
 };
 
 enum ATAPP_ERROR_TYPE {
@@ -94,6 +100,8 @@ enum ATAPP_ERROR_TYPE {
   EN_ATAPP_ERR_TOPOLOGY_UNKNOWN = -1104,
   EN_ATAPP_ERR_DISCOVERY_NOT_FOUND = -1105,
   EN_ATAPP_ERR_TOPOLOGY_DENY = -1106,
+  EN_ATAPP_ERR_DISCOVERY_CACHE_IO = -1107,
+  EN_ATAPP_ERR_DISCOVERY_CACHE_INVALID = -1108,
   EN_ATAPP_ERR_WORKER_POOL_BUSY = -1201,
   EN_ATAPP_ERR_WORKER_POOL_NO_AVAILABLE_WORKER = -1202,
   EN_ATAPP_ERR_WORKER_POOL_CLOSED = -1203,
@@ -104,8 +112,6 @@ enum ATAPP_ERROR_TYPE {
   EN_ATAPP_ERR_MIN = -1999,
 };
 
-using configure_key_set = std::unordered_set<std::string>;
-
 LIBATAPP_MACRO_API void parse_timepoint(gsl::string_view in, ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp &out);
 LIBATAPP_MACRO_API void parse_duration(gsl::string_view in, ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration &out);
 
@@ -189,6 +195,21 @@ LIBATAPP_MACRO_API void default_loader_dump_to(ATBUS_MACRO_PROTOBUF_NAMESPACE_ID
 LIBATAPP_MACRO_API bool protobuf_equal(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &l,
                                        const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &r);
 
+/**
+ * @brief Collect paths of fields which are different between two messages.
+ * @note Paths of sub messages are joined by '.', and all ancestors of a changed field are also inserted.
+ *       For example, when etcd.init.timeout is changed, "etcd", "etcd.init" and "etcd.init.timeout" will all be
+ *       inserted into changed_paths.
+ * @param l left message
+ * @param r right message
+ * @param changed_paths output set of changed paths
+ * @param prefix prefix of all paths
+ * @return true if there is any difference
+ */
+LIBATAPP_MACRO_API bool protobuf_diff(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &l,
+                                      const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &r,
+                                      configure_key_set &changed_paths, gsl::string_view prefix = "");
+
 /**
  * @brief Expand environment variable expressions in a string.
  *
@@ -205,4 +226,16 @@ LIBATAPP_MACRO_API bool protobuf_equal(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::
  */
 LIBATAPP_MACRO_API std::string expand_environment_expression(gsl::string_view input);
 
+/**
+ * @brief Refresh the environment generation used by the expression cache.
+ * @note Compiled expressions are cached by input string, expanded results and variable values are cached per
+ *       environment generation. The generation only changes when a variable referenced by cached expressions
+ *       changes, so reloading configures with an unchanged environment reuses all previous results.
+ *       All loader entries call this automatically, expand_environment_expression() always reads the latest values
+ *       of variables it references.
+ *
+ * @return current environment generation
+ */
+LIBATAPP_MACRO_API uint64_t refresh_environment_expression_generation();
+
 LIBATAPP_MACRO_NAMESPACE_END
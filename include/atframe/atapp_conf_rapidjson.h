@@ -13,6 +13,8 @@
 
 #include <config/compiler/protobuf_prefix.h>
 
+#include <google/protobuf/arena.h>
+
 #include <rapidjson/document.h>
 
 #include <config/compiler/protobuf_suffix.h>
@@ -74,6 +76,52 @@ LIBATAPP_MACRO_API bool rapidjson_loader_parse(
     const rapidjson_loader_dump_options &options = rapidjson_loader_dump_options(),
     gsl::span<unsigned char> use_buffer = {});
 
+/**
+ * @brief Resettable protobuf arena of the current thread, for temporary messages such as parsing watch events
+ * @note All messages created on the arena are released when the outermost scope of the current thread is destroyed.
+ *       Memory blocks of the arena are reused, so parsing in steady state do not allocate from heap.
+ * @note Messages on arena must not be moved out of the scope, copy them into messages on heap instead.
+ */
+class rapidjson_loader_arena_scope {
+ public:
+  LIBATAPP_MACRO_API rapidjson_loader_arena_scope();
+  LIBATAPP_MACRO_API ~rapidjson_loader_arena_scope();
+
+  rapidjson_loader_arena_scope(const rapidjson_loader_arena_scope &) = delete;
+  rapidjson_loader_arena_scope &operator=(const rapidjson_loader_arena_scope &) = delete;
+
+  ATFW_UTIL_FORCEINLINE ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Arena &get_arena() noexcept { return *arena_; }
+
+  template <class TMSG>
+  ATFW_UTIL_FORCEINLINE TMSG *create() {
+    return ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Arena::Create<TMSG>(arena_);
+  }
+
+ private:
+  ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Arena *arena_;
+};
+
+/**
+ * @brief Parse JSON into a new message created on arena
+ * @return message on arena, or nullptr when the JSON is invalid
+ */
+template <class TMSG>
+LIBATAPP_MACRO_API_HEAD_ONLY TMSG *rapidjson_loader_parse_on_arena(
+    ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Arena &arena, const std::string &src,
+    const rapidjson_loader_dump_options &options = rapidjson_loader_dump_options(),
+    gsl::span<unsigned char> use_buffer = {}) {
+  TMSG *ret = ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Arena::Create<TMSG>(&arena);
+  if (nullptr == ret) {
+    return nullptr;
+  }
+
+  if (!rapidjson_loader_parse(*ret, src, options, use_buffer)) {
+    return nullptr;
+  }
+
+  return ret;
+}
+
 LIBATAPP_MACRO_API void rapidjson_loader_mutable_set_member(rapidjson::Value &parent, gsl::string_view key,
                                                             rapidjson::Value &&val, rapidjson::Document &doc);
 LIBATAPP_MACRO_API void rapidjson_loader_mutable_set_member(rapidjson::Value &parent, gsl::string_view key,
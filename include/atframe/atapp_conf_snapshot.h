@@ -0,0 +1,92 @@
+// Copyright 2026 atframework
+//
+// Created by owent
+
+#pragma once
+
+#include <config/compiler_features.h>
+
+#include <gsl/select-gsl.h>
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "atframe/atapp_conf.h"
+#include "atframe/atapp_config.h"
+#include "atframe/atapp_flat_hash_map.h"
+
+LIBATAPP_MACRO_NAMESPACE_BEGIN
+
+/**
+ * @brief Immutable and flattened configure values of one reload
+ * @note Paths are joined by '.', values of arrays are stored in the same path, and elements of arrays of maps are
+ *       stored with index, such as "atapp.bus.listen" and "atapp.etcd.hosts".
+ * @note A snapshot is never modified after it's published by app, so it can be shared by threads and bindings, and
+ *       keep valid after reload.
+ */
+class configure_snapshot {
+ public:
+  using ptr_t = std::shared_ptr<const configure_snapshot>;
+  using value_list_t = std::vector<std::string>;
+  using value_map_t = flat_hash_map<std::string, value_list_t, flat_string_hash, flat_string_equal>;
+
+  LIBATAPP_MACRO_API explicit configure_snapshot(uint64_t generation);
+  LIBATAPP_MACRO_API ~configure_snapshot();
+
+  configure_snapshot(const configure_snapshot &) = delete;
+  configure_snapshot &operator=(const configure_snapshot &) = delete;
+
+  ATFW_UTIL_FORCEINLINE uint64_t get_generation() const noexcept { return generation_; }
+
+  ATFW_UTIL_FORCEINLINE size_t size() const noexcept { return values_.size(); }
+
+  ATFW_UTIL_FORCEINLINE const value_map_t &get_values() const noexcept { return values_; }
+
+  /**
+   * @brief find values of path
+   * @return values of path, or nullptr if not found
+   */
+  ATFW_UTIL_FORCEINLINE const value_list_t *find(gsl::string_view path) const noexcept {
+    value_map_t::const_iterator iter = values_.find(path);
+    if (iter == values_.end()) {
+      return nullptr;
+    }
+
+    return &iter->second;
+  }
+
+  /**
+   * @brief append all values of ini loader, existed values of the same path are replaced
+   */
+  LIBATAPP_MACRO_API void append(const atfw::util::config::ini_value &src, gsl::string_view prefix);
+
+  /**
+   * @brief append all values of yaml node, existed values of the same path are replaced
+   */
+  LIBATAPP_MACRO_API void append(const YAML::Node &src, gsl::string_view prefix);
+
+  /**
+   * @brief append all fields of protobuf message, including fields with default values
+   * @note Durations are written as "<N>s", "<N>ms", "<N>us" or "<N>ns", timestamps are written as unix timestamp
+   */
+  LIBATAPP_MACRO_API void append(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &src, gsl::string_view prefix);
+
+ private:
+  value_list_t &mutable_values(const std::string &path);
+
+  void append_ini_value(const atfw::util::config::ini_value &src, std::string &path);
+  void append_yaml_node(const YAML::Node &src, std::string &path);
+  void append_message(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &src, std::string &path);
+  void append_field(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &src,
+                    const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *fds, std::string &path);
+
+ private:
+  uint64_t generation_;
+  value_map_t values_;
+  // Paths which are already replaced by current append(), values of these paths are appended instead of replaced
+  configure_key_set replaced_paths_;
+};
+
+LIBATAPP_MACRO_NAMESPACE_END
@@ -0,0 +1,521 @@
+// Copyright 2026 atframework
+//
+// Created by owent
+
+#pragma once
+
+#include <config/compiler_features.h>
+
+#include <gsl/select-gsl.h>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "atframe/atapp_config.h"
+
+LIBATAPP_MACRO_NAMESPACE_BEGIN
+
+/**
+ * @brief Transparent hash of strings, std::string, gsl::string_view and const char* with the same content have the
+ *        same hash code, so lookup by gsl::string_view do not need a std::string temporary
+ */
+struct flat_string_hash {
+  using is_transparent = void;
+
+  ATFW_UTIL_FORCEINLINE size_t operator()(gsl::string_view key) const noexcept {
+    // Mix 8 bytes per round, names of services are usually longer than 16 bytes
+    uint64_t ret = 14695981039346656037ULL ^ static_cast<uint64_t>(key.size());
+    const char *data = key.data();
+    size_t left = key.size();
+    while (left >= sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, data, sizeof(word));
+      ret = (ret ^ word) * 11400714819323198485ULL;
+      ret ^= ret >> 29;
+      data += sizeof(uint64_t);
+      left -= sizeof(uint64_t);
+    }
+    if (left > 0) {
+      uint64_t word = 0;
+      memcpy(&word, data, left);
+      ret = (ret ^ word) * 11400714819323198485ULL;
+      ret ^= ret >> 29;
+    }
+    return static_cast<size_t>(ret);
+  }
+
+  ATFW_UTIL_FORCEINLINE size_t operator()(const std::string &key) const noexcept {
+    return (*this)(gsl::string_view{key.data(), key.size()});
+  }
+
+  ATFW_UTIL_FORCEINLINE size_t operator()(const char *key) const noexcept {
+    return (*this)(gsl::string_view{key, nullptr == key ? 0 : strlen(key)});
+  }
+};
+
+struct flat_string_equal {
+  using is_transparent = void;
+
+  ATFW_UTIL_FORCEINLINE bool operator()(gsl::string_view l, gsl::string_view r) const noexcept {
+    return l.size() == r.size() && (l.empty() || 0 == memcmp(l.data(), r.data(), l.size()));
+  }
+};
+
+/**
+ * @brief Open addressing hash map with robin hood linear probing and backward shift deletion
+ * @note Elements are stored inline in one array, so lookup of small keys touch only one or two cache lines.
+ * @note Any insertion or erasure may move elements, all iterators, pointers and references of elements are invalidated
+ *       then. Copy the mapped value into a local variable before calling functions which may modify the map.
+ * @note Key and T must be default constructible and move assignable. Empty slots hold default constructed values.
+ * @note Unlike std::unordered_map, value_type is std::pair<Key, T> and the key is NOT const, because slots are moved
+ *       by insertion and erasure. Never modify first through an iterator, the element can not be found any more and
+ *       the probe sequence is broken.
+ */
+template <class Key, class T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class flat_hash_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  // Key is mutable for moving slots, do not modify it by iterators
+  using value_type = std::pair<Key, T>;
+  using size_type = size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+
+ private:
+  // Erasure moves elements backward and resets the last one to a default constructed value
+  static constexpr const bool kNothrowErase =
+      std::is_nothrow_move_assignable<Key>::value && std::is_nothrow_move_assignable<T>::value &&
+      std::is_nothrow_default_constructible<Key>::value && std::is_nothrow_default_constructible<T>::value;
+
+ public:
+
+ private:
+  template <bool IsConst>
+  class basic_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename flat_hash_map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using owner_type = typename std::conditional<IsConst, const flat_hash_map, flat_hash_map>::type;
+    using reference = typename std::conditional<IsConst, const value_type &, value_type &>::type;
+    using pointer = typename std::conditional<IsConst, const value_type *, value_type *>::type;
+
+    basic_iterator() noexcept : owner_(nullptr), index_(0) {}
+    basic_iterator(owner_type *owner, size_t index) noexcept : owner_(owner), index_(index) {}
+
+    template <bool OtherConst, class = typename std::enable_if<IsConst && !OtherConst>::type>
+    basic_iterator(const basic_iterator<OtherConst> &other) noexcept  // NOLINT: implicit
+        : owner_(other.owner_), index_(other.index_) {}
+
+    ATFW_UTIL_FORCEINLINE reference operator*() const noexcept { return owner_->slots_[index_]; }
+    ATFW_UTIL_FORCEINLINE pointer operator->() const noexcept { return &owner_->slots_[index_]; }
+
+    basic_iterator &operator++() noexcept {
+      index_ = owner_->next_used_slot(index_ + 1);
+      return *this;
+    }
+
+    basic_iterator operator++(int) noexcept {
+      basic_iterator ret = *this;
+      ++(*this);
+      return ret;
+    }
+
+    friend bool operator==(const basic_iterator &l, const basic_iterator &r) noexcept { return l.index_ == r.index_; }
+    friend bool operator!=(const basic_iterator &l, const basic_iterator &r) noexcept { return l.index_ != r.index_; }
+
+   private:
+    template <bool>
+    friend class basic_iterator;
+    friend class flat_hash_map;
+
+    owner_type *owner_;
+    size_t index_;
+  };
+
+ public:
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+ private:
+  // Heterogeneous lookup is enabled only when both Hash and KeyEqual are transparent
+  template <class K, class H, class E>
+  using enable_if_transparent_t =
+      typename std::enable_if<std::is_void<typename H::is_transparent>::value &&
+                              std::is_void<typename E::is_transparent>::value &&
+                              !std::is_convertible<const K &, const_iterator>::value>::type;
+
+ public:
+  flat_hash_map() noexcept : size_(0), shift_(64) {}
+
+  flat_hash_map(const flat_hash_map &) = default;
+  flat_hash_map &operator=(const flat_hash_map &) = default;
+
+  flat_hash_map(flat_hash_map &&other) noexcept
+      : slots_(std::move(other.slots_)), distances_(std::move(other.distances_)), size_(other.size_),
+        shift_(other.shift_) {
+    other.size_ = 0;
+    other.shift_ = 64;
+  }
+
+  flat_hash_map &operator=(flat_hash_map &&other) noexcept {
+    if (this != &other) {
+      flat_hash_map tmp(std::move(other));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  ATFW_UTIL_FORCEINLINE iterator begin() noexcept { return iterator(this, next_used_slot(0)); }
+  ATFW_UTIL_FORCEINLINE const_iterator begin() const noexcept { return const_iterator(this, next_used_slot(0)); }
+  ATFW_UTIL_FORCEINLINE const_iterator cbegin() const noexcept { return begin(); }
+  ATFW_UTIL_FORCEINLINE iterator end() noexcept { return iterator(this, slots_.size()); }
+  ATFW_UTIL_FORCEINLINE const_iterator end() const noexcept { return const_iterator(this, slots_.size()); }
+  ATFW_UTIL_FORCEINLINE const_iterator cend() const noexcept { return end(); }
+
+  ATFW_UTIL_FORCEINLINE bool empty() const noexcept { return 0 == size_; }
+  ATFW_UTIL_FORCEINLINE size_t size() const noexcept { return size_; }
+  ATFW_UTIL_FORCEINLINE size_t capacity() const noexcept { return slots_.size(); }
+
+  void clear() noexcept {
+    slots_.clear();
+    distances_.clear();
+    size_ = 0;
+    shift_ = 64;
+  }
+
+  void swap(flat_hash_map &other) noexcept {
+    slots_.swap(other.slots_);
+    distances_.swap(other.distances_);
+    std::swap(size_, other.size_);
+    std::swap(shift_, other.shift_);
+  }
+
+  void reserve(size_t count) {
+    size_t capacity = 8;
+    // Keep load factor not greater than 0.75
+    while (capacity - capacity / 4 < count) {
+      capacity <<= 1;
+    }
+    if (capacity > slots_.size()) {
+      rehash(capacity);
+    }
+  }
+
+  ATFW_UTIL_FORCEINLINE iterator find(const key_type &key) noexcept { return iterator(this, find_slot(key)); }
+  ATFW_UTIL_FORCEINLINE const_iterator find(const key_type &key) const noexcept {
+    return const_iterator(this, find_slot(key));
+  }
+
+  template <class K, class H = Hash, class E = KeyEqual, class = enable_if_transparent_t<K, H, E>>
+  ATFW_UTIL_FORCEINLINE iterator find(const K &key) noexcept {
+    return iterator(this, find_slot(key));
+  }
+
+  template <class K, class H = Hash, class E = KeyEqual, class = enable_if_transparent_t<K, H, E>>
+  ATFW_UTIL_FORCEINLINE const_iterator find(const K &key) const noexcept {
+    return const_iterator(this, find_slot(key));
+  }
+
+  ATFW_UTIL_FORCEINLINE size_t count(const key_type &key) const noexcept {
+    return find_slot(key) < slots_.size() ? 1 : 0;
+  }
+
+  template <class K, class H = Hash, class E = KeyEqual, class = enable_if_transparent_t<K, H, E>>
+  ATFW_UTIL_FORCEINLINE size_t count(const K &key) const noexcept {
+    return find_slot(key) < slots_.size() ? 1 : 0;
+  }
+
+  template <class K, class... Args>
+  std::pair<iterator, bool> emplace(K &&key, Args &&...args) {
+    size_t index = find_slot(key);
+    if (index < slots_.size()) {
+      return std::pair<iterator, bool>(iterator(this, index), false);
+    }
+
+    index = insert_new(value_type(key_type(std::forward<K>(key)), mapped_type(std::forward<Args>(args)...)));
+    return std::pair<iterator, bool>(iterator(this, index), true);
+  }
+
+  ATFW_UTIL_FORCEINLINE std::pair<iterator, bool> insert(const value_type &value) {
+    return emplace(value.first, value.second);
+  }
+
+  ATFW_UTIL_FORCEINLINE std::pair<iterator, bool> insert(value_type &&value) {
+    return emplace(std::move(value.first), std::move(value.second));
+  }
+
+  mapped_type &operator[](const key_type &key) {
+    size_t index = find_slot(key);
+    if (index < slots_.size()) {
+      return slots_[index].second;
+    }
+    return slots_[insert_new(value_type(key, mapped_type()))].second;
+  }
+
+  mapped_type &operator[](key_type &&key) {
+    size_t index = find_slot(key);
+    if (index < slots_.size()) {
+      return slots_[index].second;
+    }
+    return slots_[insert_new(value_type(std::move(key), mapped_type()))].second;
+  }
+
+  /**
+   * @brief erase element by iterator
+   * @note Elements after the erased one may be moved, all iterators are invalidated, do not erase while iterating
+   */
+  void erase(const_iterator iter) noexcept(kNothrowErase) {
+    if (iter.index_ < slots_.size() && 0 != distances_[iter.index_]) {
+      erase_slot(iter.index_);
+    }
+  }
+
+  ATFW_UTIL_FORCEINLINE void erase(iterator iter) noexcept(kNothrowErase) { erase(const_iterator(iter)); }
+
+  size_t erase(const key_type &key) noexcept(kNothrowErase) {
+    size_t index = find_slot(key);
+    if (index >= slots_.size()) {
+      return 0;
+    }
+    erase_slot(index);
+    return 1;
+  }
+
+  template <class K, class H = Hash, class E = KeyEqual, class = enable_if_transparent_t<K, H, E>>
+  size_t erase(const K &key) noexcept(kNothrowErase) {
+    size_t index = find_slot(key);
+    if (index >= slots_.size()) {
+      return 0;
+    }
+    erase_slot(index);
+    return 1;
+  }
+
+ private:
+  ATFW_UTIL_FORCEINLINE size_t mask() const noexcept { return slots_.size() - 1; }
+
+  template <class K>
+  ATFW_UTIL_FORCEINLINE size_t ideal_slot(const K &key) const noexcept {
+    // Fibonacci hashing, std::hash of integers is usually identity and can not be used with power of two mask directly
+    return static_cast<size_t>((static_cast<uint64_t>(hasher()(key)) * 11400714819323198485ULL) >> shift_);
+  }
+
+  size_t next_used_slot(size_t index) const noexcept {
+    while (index < distances_.size() && 0 == distances_[index]) {
+      ++index;
+    }
+    return index;
+  }
+
+  template <class K>
+  size_t find_slot(const K &key) const noexcept {
+    if (0 == size_) {
+      return slots_.size();
+    }
+
+    size_t index = ideal_slot(key);
+    // distances_ store probe distance + 1, 0 means empty
+    for (uint32_t distance = 1;; ++distance) {
+      uint32_t slot_distance = distances_[index];
+      // Keys are placed in order of probe distance, stop when meet a empty slot or a slot closer to its ideal slot
+      if (slot_distance < distance) {
+        return slots_.size();
+      }
+      if (slot_distance == distance && key_equal()(slots_[index].first, key)) {
+        return index;
+      }
+      index = (index + 1) & mask();
+    }
+  }
+
+  size_t insert_new(value_type &&value) {
+    if ((size_ + 1) * 4 > slots_.size() * 3) {
+      rehash(slots_.empty() ? 8 : slots_.size() * 2);
+    }
+
+    size_t ret = slots_.size();
+    size_t index = ideal_slot(value.first);
+    uint32_t distance = 1;
+    // Robin hood insertion, keeps the probe sequence sorted by distance so find_slot can stop early
+    while (true) {
+      if (0 == distances_[index]) {
+        slots_[index] = std::move(value);
+        distances_[index] = distance;
+        ++size_;
+        return ret < slots_.size() ? ret : index;
+      }
+
+      if (distances_[index] < distance) {
+        using std::swap;
+        swap(slots_[index], value);
+        std::swap(distances_[index], distance);
+        if (ret >= slots_.size()) {
+          ret = index;
+        }
+      }
+
+      index = (index + 1) & mask();
+      ++distance;
+    }
+  }
+
+  void erase_slot(size_t index) noexcept(kNothrowErase) {
+    size_t next = (index + 1) & mask();
+    // Backward shift, no tombstones
+    while (distances_[next] > 1) {
+      slots_[index] = std::move(slots_[next]);
+      distances_[index] = distances_[next] - 1;
+      index = next;
+      next = (next + 1) & mask();
+    }
+
+    slots_[index] = value_type();
+    distances_[index] = 0;
+    --size_;
+  }
+
+  void rehash(size_t capacity) {
+    std::vector<value_type> old_slots;
+    std::vector<uint32_t> old_distances;
+    old_slots.swap(slots_);
+    old_distances.swap(distances_);
+
+    slots_.resize(capacity);
+    distances_.resize(capacity, 0);
+    size_ = 0;
+    shift_ = 64;
+    while (capacity > 1) {
+      capacity >>= 1;
+      --shift_;
+    }
+
+    for (size_t i = 0; i < old_slots.size(); ++i) {
+      if (0 != old_distances[i]) {
+        insert_new(std::move(old_slots[i]));
+      }
+    }
+  }
+
+ private:
+  std::vector<value_type> slots_;
+  std::vector<uint32_t> distances_;
+  size_t size_;
+  uint32_t shift_;
+};
+
+/**
+ * @brief Set of pointers stored inline when there are no more than InlineSize elements
+ * @note Insertion order is not kept after erasure, and all iterators are invalidated by insertion or erasure.
+ */
+template <class T, size_t InlineSize = 2>
+class small_pointer_set {
+ public:
+  using value_type = T *;
+  using size_type = size_t;
+  using iterator = value_type const *;
+  using const_iterator = value_type const *;
+
+  small_pointer_set() noexcept : size_(0) {
+    for (size_t i = 0; i < InlineSize; ++i) {
+      inline_data_[i] = nullptr;
+    }
+  }
+
+  ATFW_UTIL_FORCEINLINE const_iterator begin() const noexcept { return data(); }
+  ATFW_UTIL_FORCEINLINE const_iterator end() const noexcept { return data() + size_; }
+  ATFW_UTIL_FORCEINLINE bool empty() const noexcept { return 0 == size_; }
+  ATFW_UTIL_FORCEINLINE size_t size() const noexcept { return size_; }
+
+  ATFW_UTIL_FORCEINLINE size_t count(value_type value) const noexcept { return find(value) != end() ? 1 : 0; }
+
+  const_iterator find(value_type value) const noexcept {
+    const_iterator first = begin();
+    const_iterator last = end();
+    for (; first != last; ++first) {
+      if (*first == value) {
+        break;
+      }
+    }
+    return first;
+  }
+
+  std::pair<const_iterator, bool> insert(value_type value) {
+    const_iterator iter = find(value);
+    if (iter != end()) {
+      return std::pair<const_iterator, bool>(iter, false);
+    }
+
+    if (size_ < InlineSize) {
+      inline_data_[size_++] = value;
+    } else {
+      if (size_ == InlineSize) {
+        heap_data_.reserve(InlineSize * 2);
+        heap_data_.assign(inline_data_, inline_data_ + InlineSize);
+      }
+      heap_data_.push_back(value);
+      ++size_;
+    }
+    return std::pair<const_iterator, bool>(end() - 1, true);
+  }
+
+  size_t erase(value_type value) noexcept {
+    value_type *first = mutable_data();
+    value_type *last = first + size_;
+    value_type *iter = std::find(first, last, value);
+    if (iter == last) {
+      return 0;
+    }
+
+    *iter = *(last - 1);
+    --size_;
+    if (size_ > InlineSize) {
+      heap_data_.pop_back();
+    } else if (size_ == InlineSize) {
+      std::copy(heap_data_.begin(), heap_data_.begin() + InlineSize, inline_data_);
+      heap_data_.clear();
+    } else {
+      inline_data_[size_] = nullptr;
+    }
+    return 1;
+  }
+
+  void clear() noexcept {
+    for (size_t i = 0; i < InlineSize; ++i) {
+      inline_data_[i] = nullptr;
+    }
+    heap_data_.clear();
+    size_ = 0;
+  }
+
+  void swap(small_pointer_set &other) noexcept {
+    for (size_t i = 0; i < InlineSize; ++i) {
+      std::swap(inline_data_[i], other.inline_data_[i]);
+    }
+    heap_data_.swap(other.heap_data_);
+    std::swap(size_, other.size_);
+  }
+
+ private:
+  ATFW_UTIL_FORCEINLINE const value_type *data() const noexcept {
+    return size_ > InlineSize ? heap_data_.data() : inline_data_;
+  }
+  ATFW_UTIL_FORCEINLINE value_type *mutable_data() noexcept {
+    return size_ > InlineSize ? heap_data_.data() : inline_data_;
+  }
+
+ private:
+  value_type inline_data_[InlineSize];
+  std::vector<value_type> heap_data_;
+  size_t size_;
+};
+
+LIBATAPP_MACRO_NAMESPACE_END
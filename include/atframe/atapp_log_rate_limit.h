@@ -0,0 +1,206 @@
+// Copyright 2026 atframework
+//
+// Created by owent
+
+#pragma once
+
+#include <config/compiler_features.h>
+#include <log/log_wrapper.h>
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "atframe/atapp_config.h"
+
+namespace atframework {
+namespace atapp {
+namespace protocol {
+class atapp_log_rate_limit;
+}  // namespace protocol
+}  // namespace atapp
+}  // namespace atframework
+
+LIBATAPP_MACRO_NAMESPACE_BEGIN
+
+/**
+ * @brief Token bucket limits of logs, for each log category and each call site
+ * @note Buckets are refilled by tick(). The fast path of a log call is checked before the log is formatted, it's a
+ *       relaxed fetch_sub on the bucket of call site, and another one on the bucket of category when the call site
+ *       still has tokens.
+ * @note Suppressed logs are counted and summarized into the category every summary_interval.
+ * @note Loggers which are not in the global category list(etcd for example) use the extra categories after
+ *       categorize_t::MAX, and summaries of them are written into the logger set by set_logger().
+ * @note Extra categories are process-wide, when there are several apps in one process, only the owner set by
+ *       set_extra_category() can change them until it calls release_extra_category().
+ */
+class log_rate_limiter {
+ public:
+  enum extra_category_type : int32_t {
+    kCategoryEtcd = atfw::util::log::log_wrapper::categorize_t::MAX,
+    kCategoryCount,
+  };
+
+  struct limit_type {
+    uint32_t rate;   // tokens per second, 0 for unlimited
+    uint32_t burst;  // max tokens, use rate when it's 0
+  };
+
+  struct options_type {
+    limit_type category;
+    limit_type call_site;
+    std::chrono::steady_clock::duration summary_interval;
+
+    LIBATAPP_MACRO_API options_type() noexcept;
+  };
+
+  struct bucket_type {
+    std::atomic<int64_t> tokens;
+    std::atomic<uint64_t> suppressed;
+    // Only accessed by tick()
+    int64_t refill_remainder;  // tokens * microseconds which are not refilled yet
+
+    LIBATAPP_MACRO_API bucket_type() noexcept;
+  };
+
+  class call_site {
+   public:
+    LIBATAPP_MACRO_API call_site(const char *file_path, uint32_t line_number, int32_t category) noexcept;
+    LIBATAPP_MACRO_API ~call_site();
+
+    call_site(const call_site &) = delete;
+    call_site &operator=(const call_site &) = delete;
+
+    ATFW_UTIL_FORCEINLINE bool try_acquire() noexcept {
+      if ATFW_UTIL_LIKELY_CONDITION (bucket_.tokens.fetch_sub(1, std::memory_order_relaxed) > 0) {
+        return log_rate_limiter::instance().try_acquire_category(category_);
+      }
+
+      bucket_.suppressed.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    ATFW_UTIL_FORCEINLINE const char *get_file_path() const noexcept { return file_path_; }
+    ATFW_UTIL_FORCEINLINE uint32_t get_line_number() const noexcept { return line_number_; }
+    ATFW_UTIL_FORCEINLINE int32_t get_category() const noexcept { return category_; }
+
+   private:
+    friend class log_rate_limiter;
+
+    const char *file_path_;
+    uint32_t line_number_;
+    int32_t category_;
+    bucket_type bucket_;
+  };
+
+ public:
+  static LIBATAPP_MACRO_API log_rate_limiter &instance();
+
+  /**
+   * @brief Set limits of a category, all limits of this category are disabled when both rates are 0
+   */
+  LIBATAPP_MACRO_API void set_options(int32_t category, const options_type &options);
+
+  LIBATAPP_MACRO_API void set_options(int32_t category, const protocol::atapp_log_rate_limit &conf);
+
+  LIBATAPP_MACRO_API options_type get_options(int32_t category) const;
+
+  static LIBATAPP_MACRO_API options_type make_options(const protocol::atapp_log_rate_limit &conf);
+
+  /**
+   * @brief Set logger of an extra category, summaries are written into the default category when it's not set
+   */
+  LIBATAPP_MACRO_API void set_logger(int32_t category, const atfw::util::log::log_wrapper::ptr_t &logger);
+
+  /**
+   * @brief Set options and logger of an extra category, the first caller becomes the owner of it
+   * @return false when this category is owned by another owner, and nothing is changed
+   */
+  LIBATAPP_MACRO_API bool set_extra_category(int32_t category, const void *owner, const options_type &options,
+                                             const atfw::util::log::log_wrapper::ptr_t &logger);
+
+  /**
+   * @brief Reset options and logger of an extra category owned by owner, and release the ownership
+   */
+  LIBATAPP_MACRO_API void release_extra_category(int32_t category, const void *owner);
+
+  ATFW_UTIL_FORCEINLINE bool try_acquire_category(int32_t category) noexcept {
+    if (category < 0 || category >= kCategoryCount) {
+      return true;
+    }
+
+    bucket_type &bucket = categories_[category].bucket;
+    if ATFW_UTIL_LIKELY_CONDITION (bucket.tokens.fetch_sub(1, std::memory_order_relaxed) > 0) {
+      return true;
+    }
+
+    bucket.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  /**
+   * @brief Refill all buckets and write summaries of suppressed logs
+   * @return count of summaries written
+   */
+  LIBATAPP_MACRO_API int32_t tick(std::chrono::steady_clock::time_point now);
+
+  /**
+   * @brief Get total count of suppressed logs, including logs which are already summarized
+   */
+  LIBATAPP_MACRO_API uint64_t get_suppressed_count() const noexcept;
+
+ private:
+  log_rate_limiter();
+  ~log_rate_limiter();
+
+  void add_call_site(call_site *site);
+  void remove_call_site(call_site *site);
+  int32_t write_summary(int32_t category, uint64_t suppressed, const call_site *site,
+                        std::chrono::steady_clock::duration interval);
+
+ private:
+  struct category_type {
+    options_type options;
+    bucket_type bucket;
+    bool enabled;
+    std::chrono::steady_clock::time_point last_summary;
+    atfw::util::log::log_wrapper::ptr_t logger;
+    const void *owner;
+  };
+
+  mutable std::recursive_mutex lock_;
+  std::chrono::steady_clock::time_point last_tick_;
+  std::vector<call_site *> call_sites_;
+  category_type categories_[kCategoryCount];
+  std::atomic<uint64_t> summarized_count_;
+};
+
+LIBATAPP_MACRO_NAMESPACE_END
+
+// Check the rate limit of the current call site before a log of category is formatted
+#define LIBATAPP_MACRO_LOG_RATE_LIMIT_CHECK(CATEGORY)                                                    \
+  ([]() -> ::atframework::atapp::log_rate_limiter::call_site & {                                         \
+    static ::atframework::atapp::log_rate_limiter::call_site atapp_log_rate_limit_site(__FILE__, __LINE__, \
+                                                                                        (CATEGORY));     \
+    return atapp_log_rate_limit_site;                                                                    \
+  }().try_acquire())
+
+#define LIBATAPP_MACRO_RATE_LIMITED_LOG(LEVEL, LOG_MACRO, ...)                                                       \
+  do {                                                                                                               \
+    if (atfw::util::log::log_wrapper::check_level(                                                                   \
+            WDTLOGGETCAT(atfw::util::log::log_wrapper::categorize_t::DEFAULT), (LEVEL)) &&                           \
+        LIBATAPP_MACRO_LOG_RATE_LIMIT_CHECK(atfw::util::log::log_wrapper::categorize_t::DEFAULT)) {                  \
+      LOG_MACRO(__VA_ARGS__);                                                                                        \
+    }                                                                                                                \
+  } while (false)
+
+#define LIBATAPP_MACRO_RATE_LIMITED_LOG_ERROR(...) \
+  LIBATAPP_MACRO_RATE_LIMITED_LOG(atfw::util::log::log_level::kError, FWLOGERROR, __VA_ARGS__)
+#define LIBATAPP_MACRO_RATE_LIMITED_LOG_WARNING(...) \
+  LIBATAPP_MACRO_RATE_LIMITED_LOG(atfw::util::log::log_level::kWarning, FWLOGWARNING, __VA_ARGS__)
+#define LIBATAPP_MACRO_RATE_LIMITED_LOG_INFO(...) \
+  LIBATAPP_MACRO_RATE_LIMITED_LOG(atfw::util::log::log_level::kInfo, FWLOGINFO, __VA_ARGS__)
+#define LIBATAPP_MACRO_RATE_LIMITED_LOG_DEBUG(...) \
+  LIBATAPP_MACRO_RATE_LIMITED_LOG(atfw::util::log::log_level::kDebug, FWLOGDEBUG, __VA_ARGS__)
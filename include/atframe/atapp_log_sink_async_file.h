@@ -0,0 +1,91 @@
+// Copyright 2026 atframework
+//
+// Created by owent
+
+#pragma once
+
+#include <gsl/select-gsl.h>
+#include <log/log_sink_file_backend.h>
+#include <log/log_wrapper.h>
+#include <nostd/string_view.h>
+
+#include <stdint.h>
+#include <chrono>
+#include <memory>
+
+#include "atframe/atapp_config.h"
+
+LIBATAPP_MACRO_NAMESPACE_BEGIN
+
+/**
+ * @brief Asynchronous file log sink
+ * @note Formatted log content is copied into a lock-free ring buffer of the calling thread, one ring buffer for each
+ *       thread and sink. A background writer thread drains all ring buffers and writes them into the file backend in
+ *       batches, so the caller thread never touches the file.
+ * @note Rotation, writing alias and flush options are still handled by atfw::util::log::log_sink_file_backend, which is
+ *       only accessed by the writer thread.
+ */
+class log_sink_async_file_backend {
+ public:
+  enum class overflow_policy : int32_t {
+    kDrop = 0,    // Drop new log when the ring buffer is full
+    kBlock = 1,   // Wait for the writer thread when the ring buffer is full
+    kSample = 2,  // Keep only one of sample_rate logs when the ring buffer is more than 3/4 full, drop when full
+  };
+
+  struct options_type {
+    size_t buffer_size;
+    overflow_policy policy;
+    uint32_t sample_rate;
+    std::chrono::microseconds writer_interval;
+    size_t max_batch_size;
+
+    LIBATAPP_MACRO_API options_type() noexcept;
+  };
+
+  struct stats_type {
+    uint64_t pushed_records;
+    uint64_t written_records;
+    uint64_t written_batches;
+    uint64_t written_bytes;
+    uint64_t dropped_records;
+    uint64_t sampled_out_records;
+    uint64_t truncated_records;
+    uint64_t blocked_times;
+  };
+
+  struct context_type;
+
+ public:
+  LIBATAPP_MACRO_API log_sink_async_file_backend(atfw::util::log::log_sink_file_backend file_backend,
+                                                 const options_type &options);
+
+  LIBATAPP_MACRO_API void operator()(const atfw::util::log::log_wrapper::caller_info_t &caller,
+                                     atfw::util::nostd::string_view content);
+
+  /**
+   * @brief Wait until all logs pushed before this call are written into the file backend
+   * @param timeout max wait time
+   * @return true if all logs are written before timeout
+   */
+  LIBATAPP_MACRO_API bool flush(std::chrono::milliseconds timeout = std::chrono::milliseconds{1000});
+
+  LIBATAPP_MACRO_API stats_type get_stats() const noexcept;
+
+  /**
+   * @brief Get count of ring buffers still alive, rings of exited threads are released by the writer once drained
+   */
+  LIBATAPP_MACRO_API size_t get_thread_ring_count() const;
+
+  /**
+   * @brief Get stats of all asynchronous file sinks in this process, including destroyed ones
+   */
+  static LIBATAPP_MACRO_API stats_type get_global_stats() noexcept;
+
+  static LIBATAPP_MACRO_API overflow_policy parse_overflow_policy(gsl::string_view name) noexcept;
+
+ private:
+  std::shared_ptr<context_type> context_;
+};
+
+LIBATAPP_MACRO_NAMESPACE_END
@@ -0,0 +1,139 @@
+// Copyright 2026 atframework
+//
+// Created by owent
+
+#pragma once
+
+#include <gsl/select-gsl.h>
+#include <log/log_wrapper.h>
+#include <nostd/string_view.h>
+
+#include <stdint.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "atframe/atapp_config.h"
+
+LIBATAPP_MACRO_NAMESPACE_BEGIN
+
+/**
+ * @brief Binary log sink
+ * @note Layout of binlog file:
+ *         header: "ATBINLOG" + uint8 version + 3 bytes reserved
+ *         records: uint8 type + payload, integers are encoded by LEB128 varint and strings are varint length + bytes
+ *           kRecordCallSite: id, level, level name, file path, line number, function name
+ *           kRecordTimeBase: absolute timestamp in microseconds
+ *           kRecordLog: call site id, zigzag timestamp delta in microseconds, content
+ * @note Level, time and call site are stored in binary and only formatted by the offline decoder(atapp_binlog_decoder),
+ *       so the prefix of log category can be set to a short one for categories using this sink.
+ * @note Call sites are written once in every file, every file can be decoded alone after rotation.
+ * @note Existing files are scanned when the first file is opened, and logs are appended to the latest modified one.
+ *       An incomplete record at the end of it(written when crashed) is truncated before appending.
+ */
+class log_sink_binlog_backend {
+ public:
+  enum record_type_id : uint8_t {
+    kRecordCallSite = 1,
+    kRecordTimeBase = 2,
+    kRecordLog = 3,
+  };
+
+  struct options_type {
+    std::string file_pattern;  // only %N(rotate index) is supported
+    size_t max_file_size;
+    uint32_t rotate_size;
+    atfw::util::log::log_level auto_flush;
+    std::chrono::seconds flush_interval;
+
+    LIBATAPP_MACRO_API options_type() noexcept;
+  };
+
+  struct context_type;
+
+ public:
+  LIBATAPP_MACRO_API explicit log_sink_binlog_backend(const options_type &options);
+
+  LIBATAPP_MACRO_API void operator()(const atfw::util::log::log_wrapper::caller_info_t &caller,
+                                     atfw::util::nostd::string_view content);
+
+  LIBATAPP_MACRO_API void flush();
+
+  LIBATAPP_MACRO_API uint64_t get_written_records() const noexcept;
+
+  LIBATAPP_MACRO_API uint64_t get_call_site_count() const noexcept;
+
+  static LIBATAPP_MACRO_API gsl::string_view get_magic() noexcept;
+
+  static LIBATAPP_MACRO_API uint8_t get_version() noexcept;
+
+  /**
+   * @brief Get file path of a rotate index, only %N(rotate index) and %% are replaced
+   */
+  static LIBATAPP_MACRO_API std::string get_file_path(const std::string &file_pattern, uint32_t index);
+
+  /**
+   * @brief Get rotate index of the latest modified file, so a restarted sink can continue from it
+   * @note Empty files are skipped, and files not full yet are preferred when the modification time is the same
+   * @return index of the latest file, or 0 if there is no file
+   */
+  static LIBATAPP_MACRO_API uint32_t get_latest_file_index(const std::string &file_pattern, uint32_t rotate_size,
+                                                           size_t max_file_size);
+
+ private:
+  std::shared_ptr<context_type> context_;
+};
+
+/**
+ * @brief Decoder of binlog file
+ */
+class log_binlog_reader {
+ public:
+  enum class read_result : int32_t {
+    kOk = 0,
+    kEof = 1,
+    kTruncated = -1,
+    kBadFormat = -2,
+  };
+
+  struct call_site_type {
+    int32_t level;
+    std::string level_name;
+    std::string file_path;
+    uint32_t line_number;
+    std::string func_name;
+  };
+
+  struct record_type {
+    const call_site_type *call_site;
+    std::chrono::system_clock::time_point timestamp;
+    gsl::string_view content;
+  };
+
+ public:
+  LIBATAPP_MACRO_API log_binlog_reader();
+
+  /**
+   * @brief reset input data, data must be valid until next reset
+   * @return kOk or kBadFormat if header is invalid
+   */
+  LIBATAPP_MACRO_API read_result reset(gsl::string_view data);
+
+  LIBATAPP_MACRO_API read_result next(record_type &output);
+
+  LIBATAPP_MACRO_API size_t get_offset() const noexcept;
+
+  /**
+   * @brief format record into text like the default log prefix: [LEVEL][YYYY-mm-dd HH:MM:SS.ffffff][FILE:LINE(FUNC)]:
+   */
+  static LIBATAPP_MACRO_API std::string format(const record_type &input);
+
+ private:
+  gsl::string_view data_;
+  size_t offset_;
+  int64_t last_timestamp_us_;
+  std::unordered_map<uint64_t, call_site_type> call_sites_;
+};
+
+LIBATAPP_MACRO_NAMESPACE_END
@@ -39,6 +39,18 @@ class log_sink_maker {
 
   static LIBATAPP_MACRO_API log_reg_t get_file_sink_reg();
 
+  static LIBATAPP_MACRO_API gsl::string_view get_async_file_sink_name();
+
+  static LIBATAPP_MACRO_API log_reg_t get_async_file_sink_reg();
+
+  static LIBATAPP_MACRO_API gsl::string_view get_binlog_sink_name();
+
+  static LIBATAPP_MACRO_API log_reg_t get_binlog_sink_reg();
+
+  static LIBATAPP_MACRO_API gsl::string_view get_mmap_file_sink_name();
+
+  static LIBATAPP_MACRO_API log_reg_t get_mmap_file_sink_reg();
+
   static LIBATAPP_MACRO_API gsl::string_view get_stdout_sink_name();
 
   static LIBATAPP_MACRO_API log_reg_t get_stdout_sink_reg();
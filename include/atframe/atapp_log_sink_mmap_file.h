@@ -0,0 +1,69 @@
+// Copyright 2026 atframework
+//
+// Created by owent
+
+#pragma once
+
+#include <log/log_wrapper.h>
+#include <nostd/string_view.h>
+
+#include <stdint.h>
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "atframe/atapp_config.h"
+
+LIBATAPP_MACRO_NAMESPACE_BEGIN
+
+/**
+ * @brief Memory-mapped rotating log file sink
+ * @note Every file segment is pre-allocated to max_file_size and mapped into memory, logs are appended by memcpy. The
+ *       next segment is prepared by a background thread, so rotation is just a pointer swap for the caller thread.
+ * @note msync of the active segment and unmapping of retired segments are also done by the background thread. Data
+ *       copied into a shared mapping is owned by the page cache, it's kept even if the process crashes.
+ * @note The unused tail of a segment is zero. Retired segments are truncated to the written size, and when an existing
+ *       segment is opened again(after a crash for example), new logs are appended after the last non-zero byte.
+ * @note Existing files are scanned when the sink is created, and logs are appended to the latest modified one.
+ */
+class log_sink_mmap_file_backend {
+ public:
+  struct options_type {
+    std::string file_pattern;  // only %N(rotate index) is supported
+    size_t max_file_size;
+    uint32_t rotate_size;
+    atfw::util::log::log_level auto_flush;
+    std::chrono::milliseconds flush_interval;
+
+    LIBATAPP_MACRO_API options_type() noexcept;
+  };
+
+  struct stats_type {
+    uint64_t written_records;
+    uint64_t written_bytes;
+    uint64_t truncated_records;
+    uint64_t rotate_times;
+    uint64_t prepared_rotate_times;  // rotations that only swap pointer to the prepared segment
+    uint64_t sync_times;
+  };
+
+  struct context_type;
+
+ public:
+  LIBATAPP_MACRO_API explicit log_sink_mmap_file_backend(const options_type &options);
+
+  LIBATAPP_MACRO_API void operator()(const atfw::util::log::log_wrapper::caller_info_t &caller,
+                                     atfw::util::nostd::string_view content);
+
+  /**
+   * @brief Synchronize the active segment into disk in the caller thread
+   */
+  LIBATAPP_MACRO_API void flush();
+
+  LIBATAPP_MACRO_API stats_type get_stats() const noexcept;
+
+ private:
+  std::shared_ptr<context_type> context_;
+};
+
+LIBATAPP_MACRO_NAMESPACE_END
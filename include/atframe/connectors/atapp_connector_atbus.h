@@ -5,12 +5,15 @@
 #pragma once
 
 #include <nostd/nullability.h>
+#include <random/random_generator.h>
 #include <time/time_utility.h>
 
 #include <atbus_topology.h>
 #include <detail/libatbus_config.h>
 
+#include <chrono>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <unordered_map>
 
@@ -32,6 +35,21 @@ class atapp_connector_atbus : public atapp_connector_impl, public std::enable_sh
   using atbus_connection_handle_ptr_t = atfw::util::memory::strong_rc_ptr<atbus_connection_handle_data>;
   using handle_map_t = std::unordered_map<uint64_t, atbus_connection_handle_ptr_t>;
 
+ public:
+  /**
+   * @brief Metrics of the reconnect scheduler, reconnect and topology timeouts of all handles are grouped into buckets
+   *        and each bucket has only one wakeup
+   */
+  struct reconnect_scheduler_stats {
+    size_t pending_buckets = 0;
+    size_t pending_handles = 0;
+    uint64_t wakeup_times = 0;
+    uint64_t reconnect_started = 0;
+    uint64_t reconnect_deferred = 0;  // reconnects moved to next bucket because of reconnect_max_concurrency
+    uint64_t storm_times = 0;         // wakeups which have more reconnects than reconnect_max_concurrency
+    size_t max_bucket_handles = 0;
+  };
+
  public:
   LIBATAPP_MACRO_API atapp_connector_atbus(app &owner);
   LIBATAPP_MACRO_API virtual ~atapp_connector_atbus();
@@ -59,6 +77,8 @@ class atapp_connector_atbus : public atapp_connector_impl, public std::enable_sh
 
   LIBATAPP_MACRO_API const atbus::topology_policy_rule &get_topology_policy_rule() const noexcept;
 
+  LIBATAPP_MACRO_API reconnect_scheduler_stats get_reconnect_scheduler_stats() const noexcept;
+
 #if !defined(NDEBUG)
   LIBATAPP_MACRO_API atbus::bus_id_t get_connection_handle_proxy_bus_id(atbus::bus_id_t target_bus_id) const noexcept;
   LIBATAPP_MACRO_API bool has_connection_handle(atbus::bus_id_t target_bus_id) const noexcept;
@@ -120,6 +140,12 @@ class atapp_connector_atbus : public atapp_connector_impl, public std::enable_sh
   bool setup_reconnect_timer(const handle_map_t::iterator &iter,
                              std::chrono::system_clock::time_point previous_timeout);
 
+  void on_reconnect_bucket_timeout(atfw::util::time::time_utility::raw_time_t bucket_timeout);
+
+  // @return true if this handle need to reconnect now
+  bool process_handle_timeout(const atbus_connection_handle_ptr_t &handle,
+                              std::chrono::system_clock::time_point &next_timer_timeout);
+
   int32_t try_direct_reconnect(const atbus_connection_handle_ptr_t &handle);
 
   int32_t try_connect_to(const etcd_discovery_node &discovery, const atapp_connection_handle::ptr_t &handle,
@@ -152,12 +178,22 @@ class atapp_connector_atbus : public atapp_connector_impl, public std::enable_sh
   void unbind_connection_handle_proxy(atbus_connection_handle_data &target, atbus_connection_handle_data &proxy);
 
  private:
+  struct reconnect_bucket_type {
+    jiffies_timer_watcher_t timer_handle;
+    std::unordered_map<atbus::bus_id_t, atfw::util::memory::weak_rc_ptr<atbus_connection_handle_data>> handles;
+  };
+
   handle_map_t handles_;
   atbus::topology_data::ptr_t atbus_topology_data_;
   atbus::topology_policy_rule atbus_topology_policy_rule_;
   atbus::bus_id_t last_connect_bus_id_;
   const atapp_connection_handle *last_connect_handle_;
   int32_t last_connect_result_;
+
+  std::map<atfw::util::time::time_utility::raw_time_t, reconnect_bucket_type> reconnect_buckets_;
+  reconnect_scheduler_stats reconnect_stats_;
+  atfw::util::random::xoshiro256_starstar reconnect_random_generator_;
+  std::chrono::microseconds reconnect_bucket_interval_;
 };
 
 LIBATAPP_MACRO_NAMESPACE_END
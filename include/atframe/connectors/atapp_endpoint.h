@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "atframe/atapp_conf.h"
+#include "atframe/atapp_flat_hash_map.h"
 #include "atframe/atapp_common_types.h"
 #include "atframe/etcdcli/etcd_discovery.h"
 
@@ -39,7 +40,8 @@ struct atapp_endpoint_bind_helper {
 
 class atapp_endpoint {
  public:
-  using handle_set_t = std::unordered_set<atapp_connection_handle *>;
+  // Endpoint almost always has only one or two connection handles, keep them inline
+  using handle_set_t = small_pointer_set<atapp_connection_handle, 2>;
   using handle_set_iterator = handle_set_t::iterator;
   using handle_set_const_iterator = handle_set_t::const_iterator;
   using ptr_t = std::shared_ptr<atapp_endpoint>;
@@ -16,6 +16,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "atframe/etcdcli/etcd_packer.h"
@@ -82,6 +83,10 @@ class etcd_cluster {
     std::chrono::system_clock::duration etcd_members_update_interval;
     std::chrono::system_clock::duration etcd_members_retry_interval;
     std::chrono::system_clock::duration etcd_members_init_retry_interval;
+    bool etcd_members_latency_aware_select;  // select member by latency and error rate instead of randomly
+    std::chrono::system_clock::duration etcd_members_probe_interval;
+    std::chrono::system_clock::time_point etcd_members_next_probe_time;
+    std::chrono::system_clock::time_point etcd_members_next_select_time;
 
     // generated data for lease
     int64_t lease;
@@ -90,14 +95,17 @@ class etcd_cluster {
     std::chrono::system_clock::duration keepalive_interval;
     std::chrono::system_clock::duration keepalive_retry_interval;
     size_t keepalive_retry_times;
+    bool keepalive_batch_set;    // merge data writing of keepalive actors into txn requests
+    bool keepalive_share_lease;  // share lease, keepalive and authorization token with clusters of the same endpoints
 
     // SSL configure
     // @see https://github.com/etcd-io/etcd/blob/master/Documentation/op-guide/security.md for detail
-    bool ssl_enable_alpn;    // curl 7.36.0 CURLOPT_SSL_ENABLE_ALPN
-    bool ssl_verify_peer;    // CURLOPT_SSL_VERIFYPEER, CURLOPT_SSL_VERIFYHOST, CURLOPT_SSL_VERIFYSTATUS and
-                             // CURLOPT_PROXY_SSL_VERIFYPEER, CURLOPT_PROXY_SSL_VERIFYHOST
-    bool http_debug_mode;    // print verbose information
-    bool auto_update_hosts;  // auto update cluster member
+    bool ssl_enable_alpn;     // curl 7.36.0 CURLOPT_SSL_ENABLE_ALPN
+    bool ssl_verify_peer;     // CURLOPT_SSL_VERIFYPEER, CURLOPT_SSL_VERIFYHOST, CURLOPT_SSL_VERIFYSTATUS and
+                              // CURLOPT_PROXY_SSL_VERIFYPEER, CURLOPT_PROXY_SSL_VERIFYHOST
+    bool http_debug_mode;     // print verbose information
+    bool auto_update_hosts;   // auto update cluster member
+    bool http2_multiplexing;  // curl 7.47.0 CURL_HTTP_VERSION_2TLS and CURLOPT_PIPEWAIT, share one connection
 
     ssl_version_t ssl_min_version;  // CURLOPT_SSLVERSION and CURLOPT_PROXY_SSLVERSION @see ssl_version_t,
                                     // TLSv1.1/TLSv1.2/TLSv1.3
@@ -131,6 +139,46 @@ class etcd_cluster {
                                         //   TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256:TLS_AES_128_GCM_SHA256
   };
 
+  enum class request_type_t : uint8_t {
+    kUnknown = 0,
+    kAuthenticate,
+    kAuthUserGet,
+    kMemberList,
+    kLeaseGrant,
+    kLeaseKeepalive,
+    kLeaseRevoke,
+    kKvGet,
+    kKvSet,
+    kKvDelete,
+    kKvTxn,
+    kWatch,
+    kMemberProbe,
+    kMax,
+  };
+
+  enum : size_t { kRequestLatencyBucketCount = 12 };
+
+  struct LIBATAPP_MACRO_API_HEAD_ONLY request_stats_t {
+    size_t in_flight;
+    size_t sum_finished_requests;
+    size_t sum_error_requests;
+    size_t sum_cancelled_requests;  // stopped or failed to start before finished
+    size_t sum_unhooked_requests;   // finished without reporting by add_stats_request_finished(), e.g. no callback
+    size_t sum_new_connections;     // finished requests which created new connection(s)
+    size_t sum_reused_connections;  // finished requests which reused a connection
+    int64_t sum_latency_us;
+    int64_t max_latency_us;
+    size_t latency_buckets[kRequestLatencyBucketCount];  // @see get_request_latency_bucket_upper_bound()
+  };
+
+  struct LIBATAPP_MACRO_API_HEAD_ONLY member_health_t {
+    double ewma_latency_us;            // smoothed latency
+    double ewma_latency_deviation_us;  // smoothed mean deviation of latency
+    double ewma_error_rate;            // smoothed rate of failed requests, [0, 1]
+    size_t sample_count;
+    std::chrono::system_clock::time_point last_sample_time;
+  };
+
   struct LIBATAPP_MACRO_API_HEAD_ONLY stats_t {
     size_t sum_error_requests;
     size_t continue_error_requests;
@@ -138,6 +186,8 @@ class etcd_cluster {
     size_t continue_success_requests;
 
     size_t sum_create_requests;
+
+    request_stats_t requests_by_type[static_cast<size_t>(request_type_t::kMax)];
   };
 
   using on_event_up_down_fn_t = std::function<void(etcd_cluster &)>;
@@ -160,10 +210,37 @@ class etcd_cluster {
   LIBATAPP_MACRO_API void set_flag(flag_t f, bool v);
 
   ATFW_UTIL_FORCEINLINE const stats_t &get_stats() const { return stats_; }
+  ATFW_UTIL_FORCEINLINE const request_stats_t &get_request_stats(request_type_t type) const {
+    return stats_.requests_by_type[static_cast<size_t>(type) < static_cast<size_t>(request_type_t::kMax)
+                                       ? static_cast<size_t>(type)
+                                       : static_cast<size_t>(request_type_t::kUnknown)];
+  }
+  LIBATAPP_MACRO_API static const char *get_request_type_name(request_type_t type) noexcept;
+
+  /**
+   * @brief get the upper bound of latency bucket
+   * @param index index of bucket
+   * @return upper bound of the bucket, the last bucket has no upper bound and std::chrono::microseconds::max() will be
+   * returned
+   */
+  LIBATAPP_MACRO_API static std::chrono::microseconds get_request_latency_bucket_upper_bound(size_t index) noexcept;
+
+  /**
+   * @brief get the health data of a cluster member
+   * @param host host of cluster member, @see get_available_hosts()
+   * @return health data, nullptr if there is no sample of this member
+   */
+  LIBATAPP_MACRO_API const member_health_t *get_member_health(const std::string &host) const noexcept;
 
   LIBATAPP_MACRO_API void set_logger(const atfw::util::log::log_wrapper::ptr_t &logger,
                                      atfw::util::log::log_level log_level) noexcept;
   ATFW_UTIL_FORCEINLINE const atfw::util::log::log_wrapper::ptr_t &get_logger() const noexcept { return logger_; }
+  ATFW_UTIL_FORCEINLINE atfw::util::log::log_level get_runtime_log_level() const noexcept { return runtime_log_level_; }
+
+  /**
+   * @brief Check if logs of level will be written into the logger of etcd or the default category
+   */
+  LIBATAPP_MACRO_API bool check_log_level(atfw::util::log::log_level level) const noexcept;
 
   // ====================== apis for configure ==================
   ATFW_UTIL_FORCEINLINE const std::vector<std::string> &get_available_hosts() const { return conf_.hosts; }
@@ -266,6 +343,21 @@ class etcd_cluster {
   ATFW_UTIL_FORCEINLINE void set_conf_keepalive_retry_times(size_t v) { conf_.keepalive_retry_times = v; }
   ATFW_UTIL_FORCEINLINE size_t get_conf_keepalive_retry_times() const { return conf_.keepalive_retry_times; }
 
+  ATFW_UTIL_FORCEINLINE void set_conf_keepalive_batch_set(bool v) { conf_.keepalive_batch_set = v; }
+  ATFW_UTIL_FORCEINLINE bool get_conf_keepalive_batch_set() const { return conf_.keepalive_batch_set; }
+
+  ATFW_UTIL_FORCEINLINE void set_conf_keepalive_share_lease(bool v) { conf_.keepalive_share_lease = v; }
+  ATFW_UTIL_FORCEINLINE bool get_conf_keepalive_share_lease() const { return conf_.keepalive_share_lease; }
+
+  /**
+   * @brief get count of clusters sharing the same lease with this one
+   * @note Clusters using the same curl multi context, endpoints, authorization and keepalive timeout share one lease.
+   *       Only the first one(leader) grants and renews the lease and authorization token.
+   * @return 0 if lease is not shared, or count of clusters including this one
+   */
+  LIBATAPP_MACRO_API size_t get_lease_share_count() const noexcept;
+  LIBATAPP_MACRO_API bool is_lease_share_leader() const noexcept;
+
   ATFW_UTIL_FORCEINLINE void set_conf_ssl_enable_alpn(bool v) { conf_.ssl_enable_alpn = v; }
   ATFW_UTIL_FORCEINLINE bool get_conf_ssl_enable_alpn() const { return conf_.ssl_enable_alpn; }
 
@@ -278,6 +370,23 @@ class etcd_cluster {
   ATFW_UTIL_FORCEINLINE void set_conf_etcd_members_auto_update_hosts(bool v) { conf_.auto_update_hosts = v; }
   ATFW_UTIL_FORCEINLINE bool get_conf_etcd_members_auto_update_hosts() const { return conf_.auto_update_hosts; }
 
+  ATFW_UTIL_FORCEINLINE void set_conf_etcd_members_latency_aware_select(bool v) {
+    conf_.etcd_members_latency_aware_select = v;
+  }
+  ATFW_UTIL_FORCEINLINE bool get_conf_etcd_members_latency_aware_select() const {
+    return conf_.etcd_members_latency_aware_select;
+  }
+
+  ATFW_UTIL_FORCEINLINE void set_conf_etcd_members_probe_interval(std::chrono::system_clock::duration v) {
+    conf_.etcd_members_probe_interval = v;
+  }
+  ATFW_UTIL_FORCEINLINE const std::chrono::system_clock::duration &get_conf_etcd_members_probe_interval() const {
+    return conf_.etcd_members_probe_interval;
+  }
+
+  ATFW_UTIL_FORCEINLINE void set_conf_http2_multiplexing(bool v) { conf_.http2_multiplexing = v; }
+  ATFW_UTIL_FORCEINLINE bool get_conf_http2_multiplexing() const { return conf_.http2_multiplexing; }
+
   ATFW_UTIL_FORCEINLINE void set_conf_ssl_min_version(ssl_version_t v) { conf_.ssl_min_version = v; }
   ATFW_UTIL_FORCEINLINE ssl_version_t get_conf_ssl_min_version() const { return conf_.ssl_min_version; }
 
@@ -374,6 +483,13 @@ class etcd_cluster {
   LIBATAPP_MACRO_API bool add_keepalive(const std::shared_ptr<etcd_keepalive> &keepalive);
   LIBATAPP_MACRO_API bool add_retry_keepalive(const std::shared_ptr<etcd_keepalive> &keepalive);
   LIBATAPP_MACRO_API bool remove_keepalive(const std::shared_ptr<etcd_keepalive> &keepalive);
+  /**
+   * @brief add a keepalive actor to write its data in the next batch(txn) request
+   * @note all pending actors will be sent in txn requests in the next tick, and each actor will still receive its own
+   * result.
+   * @return true if added
+   */
+  LIBATAPP_MACRO_API bool add_keepalive_batch_set(const std::shared_ptr<etcd_keepalive> &keepalive);
   LIBATAPP_MACRO_API bool add_watcher(const std::shared_ptr<etcd_watcher> &watcher);
   LIBATAPP_MACRO_API bool remove_watcher(const std::shared_ptr<etcd_watcher> &watcher);
 
@@ -462,12 +578,35 @@ class etcd_cluster {
   LIBATAPP_MACRO_API void reset_on_event_down_handle(on_event_up_down_handle_t &handle);
 
  private:
+  struct keepalive_batch_cancelled_t {
+    std::string path;
+    void *keepalive_addr;  // maybe already destroyed, just used to write log
+    bool has_data;         // data is written before this batch request
+  };
+
+  struct lease_share_release_path_t {
+    std::string path;
+    void *keepalive_addr;  // maybe already destroyed, just used to write log
+  };
+
   void remove_keepalive_path(etcd_keepalive_deletor *keepalive_deletor, bool delay_delete);
   static int libcurl_callback_on_remove_keepalive_path(atfw::util::network::http_request &req);
 
   void retry_pending_actions();
+  int flush_keepalive_batch_set();
+  void cancel_keepalive_batch_set();
+  void remove_keepalive_batch_cancelled_path(const keepalive_batch_cancelled_t &cancelled, bool written);
+  static int libcurl_callback_on_keepalive_batch_set(atfw::util::network::http_request &req);
   void set_lease(int64_t v, bool force_active_keepalives);
 
+  bool update_lease_share_group();
+  void leave_lease_share_group();
+  bool is_lease_share_follower() const noexcept;
+  void sync_lease_share_followers();
+  void take_over_lease_share_leader(const etcd_cluster &previous_leader);
+  void take_over_lease_share_paths(const std::vector<lease_share_release_path_t> &paths,
+                                   const etcd_cluster &previous_owner);
+
   bool create_request_auth_authenticate();
   static int libcurl_callback_on_auth_authenticate(atfw::util::network::http_request &req);
   bool create_request_auth_user_get();
@@ -485,12 +624,24 @@ class etcd_cluster {
   void add_stats_error_request();
   void add_stats_success_request();
   void add_stats_create_request();
+  void cleanup_stats_request_tracking(bool force);
 
   bool check_authorization() const;
 
   static void delete_keepalive_deletor(etcd_keepalive_deletor *in, bool close_rpc);
   void cleanup_keepalive_deletors();
   bool select_cluster_member();
+  const std::string *select_cluster_member_by_health(const std::string *exclude);
+  const std::string *find_cluster_member_host(const std::string &url) const;
+  void update_member_health(const atfw::util::network::http_request &req, request_type_t request_type,
+                            int64_t latency_us);
+  void cleanup_member_health();
+  bool check_member_failover();
+
+  bool create_request_member_probe();
+  static int libcurl_callback_on_member_probe(atfw::util::network::http_request &req);
+
+  void reset_authorization_header();
 
  public:
   /**
@@ -505,11 +656,36 @@ class etcd_cluster {
   LIBATAPP_MACRO_API void check_socket_error_code(int socket_code);
 
   LIBATAPP_MACRO_API void setup_http_request(atfw::util::network::http_request::ptr_t &req, rapidjson::Document &doc,
-                                             time_t timeout);
+                                             time_t timeout, request_type_t request_type = request_type_t::kUnknown);
+
+  /**
+   * @brief record latency, connection reuse and result of a request created by setup_http_request()
+   * @note should be called in the on_complete callback of the request
+   */
+  LIBATAPP_MACRO_API void add_stats_request_finished(atfw::util::network::http_request &req);
 
  private:
   using etcd_keepalive_deletor_map_t = std::unordered_map<std::string, etcd_keepalive_deletor *>;
 
+  struct request_tracking_t {
+    // Keep request until it's reported or swept, so we can check whether it's finished or cancelled
+    atfw::util::network::http_request::ptr_t request;
+    request_type_t request_type;
+    std::chrono::steady_clock::time_point start_time;  // Not affected by adjustment of system time
+  };
+  using request_tracking_map_t = std::unordered_map<const atfw::util::network::http_request *, request_tracking_t>;
+  using member_health_map_t = std::unordered_map<std::string, member_health_t>;
+
+  struct keepalive_batch_set_t {
+    atfw::util::network::http_request::ptr_t rpc;
+    std::vector<std::shared_ptr<etcd_keepalive> > actors;
+    // Keepalives removed when this request is running, their paths will be deleted after it finished
+    std::vector<keepalive_batch_cancelled_t> cancelled;
+  };
+  using keepalive_batch_set_map_t = std::unordered_map<uint64_t, keepalive_batch_set_t>;
+
+  struct lease_share_group_t;
+
   uint32_t flags_;
   atfw::util::random::mt19937 random_generator_;
   conf_t conf_;
@@ -522,9 +698,17 @@ class etcd_cluster {
   atfw::util::network::http_request::ptr_t rpc_authenticate_;
   atfw::util::network::http_request::ptr_t rpc_update_members_;
   atfw::util::network::http_request::ptr_t rpc_keepalive_;
+  atfw::util::network::http_request::ptr_t rpc_probe_member_;
   std::vector<std::shared_ptr<etcd_keepalive> > keepalive_actors_;
   std::vector<std::shared_ptr<etcd_keepalive> > keepalive_retry_actors_;
   etcd_keepalive_deletor_map_t keepalive_deletors_;
+  std::vector<std::shared_ptr<etcd_keepalive> > keepalive_batch_set_pending_actors_;
+  keepalive_batch_set_map_t keepalive_batch_set_running_;
+  uint64_t keepalive_batch_set_sequence_;
+  request_tracking_map_t request_tracking_;
+  member_health_map_t member_health_;
+  bool member_failover_pending_;
+  std::shared_ptr<lease_share_group_t> lease_share_group_;
   std::vector<std::shared_ptr<etcd_watcher> > watcher_actors_;
 
   on_event_up_down_handle_set_t event_on_up_callbacks_;
@@ -15,6 +15,7 @@
 #include <memory/rc_ptr.h>
 #include <random/random_generator.h>
 
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -38,6 +39,19 @@ class etcd_discovery_node {
   using ptr_t = atfw::util::memory::strong_rc_ptr<etcd_discovery_node>;
 
   using node_version = etcd_data_version;
+  using shared_metadata_ptr = std::shared_ptr<const atapp::protocol::atapp_metadata>;
+  using shared_gateway_ptr = std::shared_ptr<const atapp::protocol::atapp_gateway>;
+
+  /**
+   * @brief Hot fields used by index and routing, routing can scan them without touching the protobuf message
+   */
+  struct hot_data_type {
+    uint64_t id;
+    uint64_t type_id;
+    uint64_t zone_id;
+    std::pair<uint64_t, uint64_t> name_hash;
+    int32_t stateful_pod_index;
+  };
 
   UTIL_DESIGN_PATTERN_NOCOPYABLE(etcd_discovery_node)
   UTIL_DESIGN_PATTERN_NOMOVABLE(etcd_discovery_node)
@@ -46,6 +60,11 @@ class etcd_discovery_node {
   LIBATAPP_MACRO_API etcd_discovery_node();
   LIBATAPP_MACRO_API ~etcd_discovery_node();
 
+  /**
+   * @brief Get discovery data without metadata and gateways
+   * @note Metadata and gateways are shared by nodes, use get_metadata() and get_gateways() to read them, or copy_to()
+   *       to get the complete message.
+   */
   ATFW_UTIL_FORCEINLINE const atapp::protocol::atapp_discovery &get_discovery_info() const { return node_info_; }
   ATFW_UTIL_FORCEINLINE const node_version &get_version() const noexcept { return node_version_; }
 
@@ -54,9 +73,42 @@ class etcd_discovery_node {
   LIBATAPP_MACRO_API void update_version(const node_version &version, bool upgrade);
   LIBATAPP_MACRO_API void copy_to(atapp::protocol::atapp_discovery &output) const;
   LIBATAPP_MACRO_API void copy_key_to(atapp::protocol::atapp_discovery &output) const;
+
+  /**
+   * @brief Check if the complete discovery data(including metadata and gateways) of this node is the same as input
+   */
+  LIBATAPP_MACRO_API bool equal_to(const atapp::protocol::atapp_discovery &input) const;
   LIBATAPP_MACRO_API uintptr_t get_context_addr() const noexcept { return context_addr_; }
 
-  ATFW_UTIL_FORCEINLINE const std::pair<uint64_t, uint64_t> &get_name_hash() const noexcept { return name_hash_; }
+  ATFW_UTIL_FORCEINLINE const std::pair<uint64_t, uint64_t> &get_name_hash() const noexcept {
+    return hot_data_.name_hash;
+  }
+  ATFW_UTIL_FORCEINLINE const hot_data_type &get_hot_data() const noexcept { return hot_data_; }
+
+  /**
+   * @brief Get the interned metadata block, nodes with the same metadata share the same immutable block
+   * @return interned metadata, nullptr when this node has no metadata
+   */
+  ATFW_UTIL_FORCEINLINE const shared_metadata_ptr &get_shared_metadata() const noexcept { return shared_metadata_; }
+
+  ATFW_UTIL_FORCEINLINE bool has_metadata() const noexcept { return has_metadata_; }
+
+  /**
+   * @brief Get metadata of this node, the default instance is returned when it has no metadata
+   */
+  LIBATAPP_MACRO_API const atapp::protocol::atapp_metadata &get_metadata() const noexcept;
+
+  /**
+   * @brief Get the interned gateway blocks, in the same order as gateways of the discovery data
+   */
+  ATFW_UTIL_FORCEINLINE const std::vector<shared_gateway_ptr> &get_gateways() const noexcept {
+    return shared_gateways_;
+  }
+
+  /**
+   * @brief Get count of alive interned blocks(metadata, gateways and gateways converted from listen addresses)
+   */
+  LIBATAPP_MACRO_API static size_t get_shared_block_count();
 
   ATFW_UTIL_FORCEINLINE void set_private_data_ptr(void *input) noexcept { private_data_ptr_ = input; }
   ATFW_UTIL_FORCEINLINE void *get_private_data_ptr() const noexcept { return private_data_ptr_; }
@@ -74,15 +126,24 @@ class etcd_discovery_node {
   LIBATAPP_MACRO_API void reset_on_destroy();
 
   LIBATAPP_MACRO_API void reset_ingress_index() const noexcept;
+  /**
+   * @brief Get next gateway, listen addresses are converted into interned gateways when there is no gateway
+   * @note The returned reference is valid until next copy_from()
+   */
   LIBATAPP_MACRO_API const atapp::protocol::atapp_gateway &next_ingress_gateway() const;
   LIBATAPP_MACRO_API int32_t get_ingress_size() const;
 
  private:
+  hot_data_type hot_data_;
   atapp::protocol::atapp_discovery node_info_;
   node_version node_version_;
   uintptr_t context_addr_;
 
-  std::pair<uint64_t, uint64_t> name_hash_;
+  // node_info_ never has metadata and gateways, they are kept in these interned blocks
+  bool has_metadata_;
+  shared_metadata_ptr shared_metadata_;
+  std::vector<shared_gateway_ptr> shared_gateways_;
+  std::vector<shared_gateway_ptr> ingress_for_listen_;
   union {
     void *private_data_ptr_;
     uint64_t private_data_u64_;
@@ -92,7 +153,6 @@ class etcd_discovery_node {
   };
   on_destroy_fn_type on_destroy_fn_;
   mutable int32_t ingress_index_;
-  mutable atapp::protocol::atapp_gateway ingress_for_listen_;
 };
 
 class etcd_discovery_set {
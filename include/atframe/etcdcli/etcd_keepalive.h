@@ -19,6 +19,8 @@ LIBATAPP_MACRO_NAMESPACE_BEGIN
 class etcd_cluster;
 
 class etcd_keepalive : public std::enable_shared_from_this<etcd_keepalive> {
+  friend class etcd_cluster;
+
  public:
   using checker_fn_t = std::function<bool(const std::string &)>;  // the parameter will be base64 of the value
   using ptr_t = std::shared_ptr<etcd_keepalive>;
@@ -66,6 +68,12 @@ class etcd_keepalive : public std::enable_shared_from_this<etcd_keepalive> {
  private:
   void process();
 
+  /**
+   * @brief called by etcd_cluster when the batch(txn) request which contains this keepalive finished
+   * @param retry_alone the batch is rejected by etcd, write data of this keepalive by its own request in next retry
+   */
+  void on_batch_set_data(uint64_t batch_sequence, bool success, bool retry_alone);
+
  private:
   static int libcurl_callback_on_get_data(atfw::util::network::http_request &req);
   static int libcurl_callback_on_set_data(atfw::util::network::http_request &req);
@@ -79,6 +87,9 @@ class etcd_keepalive : public std::enable_shared_from_this<etcd_keepalive> {
     bool is_actived;
     bool is_value_changed;
     bool has_data;
+    bool is_batch_pending;    // waiting for etcd_cluster to write data in a batch(txn) request
+    uint64_t batch_sequence;  // sequence of the running batch request, 0 if not sent yet
+    bool skip_batch_once;     // write data by its own request once, set after a rejected batch request
   };
   rpc_data_t rpc_;
 
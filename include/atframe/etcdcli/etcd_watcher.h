@@ -11,6 +11,7 @@
 
 #include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -29,6 +30,7 @@ class atapp_etcd_watcher;
 LIBATAPP_MACRO_NAMESPACE_BEGIN
 
 class etcd_cluster;
+class worker_pool_module;
 
 class etcd_watcher {
  public:
@@ -43,6 +45,7 @@ class etcd_watcher {
     bool created;
     bool canceled;
     bool snapshot;
+    bool from_checkpoint;  // loaded from the local checkpoint and not confirmed by etcd yet
     int64_t compact_revision;
     std::vector<event_t> events;
   };
@@ -125,9 +128,59 @@ class etcd_watcher {
     return rpc_.startup_random_delay_max;
   }
 
+  /**
+   * @brief set the checkpoint file of this watcher
+   * @note The last revision and all known key-values will be saved into this file. When started again, the watcher
+   *       will notify a snapshot from the checkpoint immediately and resume watching from the saved revision, so the
+   *       full range request can be skipped. Empty means disabling checkpoint.
+   * @note Changes after the checkpoint file is saved are appended into {file_path}.journal, and the checkpoint file is
+   *       rewritten only when the journal is larger than it.
+   * @param file_path path of checkpoint file
+   */
+  LIBATAPP_MACRO_API void set_conf_checkpoint_file(const std::string &file_path);
+  ATFW_UTIL_FORCEINLINE const std::string &get_conf_checkpoint_file() const noexcept { return checkpoint_.file_path; }
+
+  /**
+   * @brief set the worker pool to write checkpoint and journal files
+   * @note files are written in the main thread if it's not set or the job can not be spawned
+   */
+  LIBATAPP_MACRO_API void set_conf_checkpoint_worker_pool(const std::shared_ptr<worker_pool_module> &worker_pool);
+
+  ATFW_UTIL_FORCEINLINE void set_conf_checkpoint_interval(std::chrono::system_clock::duration v) noexcept {
+    checkpoint_.interval = v;
+  }
+  ATFW_UTIL_FORCEINLINE const std::chrono::system_clock::duration &get_conf_checkpoint_interval() const noexcept {
+    return checkpoint_.interval;
+  }
+
+  /**
+   * @brief set configure from protobuf
+   * @note checkpoint file will be set to {checkpoint_directory}/{escaped watch path}.checkpoint.json if
+   *       checkpoint_directory is not empty, and the directory is created when the checkpoint is written first time
+   */
   LIBATAPP_MACRO_API void set_conf_from_protobuf(
       const ::atframework::atapp::protocol::atapp_etcd_watcher &config) noexcept;
 
+  // ====================== apis for checkpoint ==================
+  ATFW_UTIL_FORCEINLINE int64_t get_last_revision() const noexcept { return rpc_.last_revision; }
+  ATFW_UTIL_FORCEINLINE int64_t get_checkpoint_revision() const noexcept { return checkpoint_.revision; }
+  ATFW_UTIL_FORCEINLINE size_t get_checkpoint_key_count() const noexcept { return checkpoint_.kvs.size(); }
+  ATFW_UTIL_FORCEINLINE bool has_checkpoint() const noexcept { return checkpoint_.has_cache; }
+
+  /**
+   * @brief load checkpoint file into cache
+   * @return true if checkpoint file is loaded and matches the path of this watcher
+   */
+  LIBATAPP_MACRO_API bool load_checkpoint();
+
+  /**
+   * @brief save cache into checkpoint file, the file is written into a temporary file and then renamed
+   * @note the journal file is removed after the checkpoint file is saved
+   * @note this function waits for all pending writing in worker pool and then writes the file in current thread
+   * @return true on success
+   */
+  LIBATAPP_MACRO_API bool save_checkpoint();
+
   // ====================== apis for events ==================
   ATFW_UTIL_FORCEINLINE void set_evt_handle(watch_event_fn_t &&fn) { evt_handle_ = std::move(fn); }
   LIBATAPP_MACRO_API void set_evt_handle(watch_event_fn_t_ptr fn);
@@ -135,6 +188,16 @@ class etcd_watcher {
  private:
   void process();
 
+  std::string pack_checkpoint() const;
+  std::string get_checkpoint_journal_file() const;
+  bool flush_checkpoint(bool async);
+  bool write_checkpoint(bool full_save, std::string &&content, bool async);
+  void check_checkpoint_writer();
+  void resume_from_checkpoint();
+  void notify_checkpoint_snapshot();
+  void merge_checkpoint_snapshot(int64_t revision, response_t &response);
+  void apply_checkpoint_events(const etcd_response_header &header, const response_t &response);
+
  private:
   static int libcurl_callback_on_range_completed(atfw::util::network::http_request &req);
 
@@ -164,6 +227,29 @@ class etcd_watcher {
   };
   rpc_data_t rpc_;
 
+  struct checkpoint_writer_t;
+  struct checkpoint_data_t {
+    std::string file_path;
+    std::chrono::system_clock::duration interval;
+    std::chrono::system_clock::time_point next_save_time;
+    bool resume_checked;
+    bool notify_pending;  // snapshot from checkpoint is waiting for the event handle
+    bool confirmed;       // the cache is confirmed by a range response or watch events from etcd
+    bool has_cache;
+    bool dirty;
+    bool full_save_required;  // journal can not be used and the whole checkpoint must be rewritten
+    int64_t revision;
+    size_t journal_events;  // events in journal file
+    std::string journal;    // records not written into journal file yet
+    std::map<std::string, etcd_key_value> kvs;
+
+    // Shared with worker jobs, files are written in order by the writer
+    std::shared_ptr<checkpoint_writer_t> writer;
+    std::weak_ptr<worker_pool_module> worker_pool;
+    uint64_t writer_failed_count;
+  };
+  checkpoint_data_t checkpoint_;
+
   watch_event_fn_t evt_handle_;
 };
 LIBATAPP_MACRO_NAMESPACE_END
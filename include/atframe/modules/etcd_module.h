@@ -33,6 +33,9 @@ class etcd_module {
                               const atapp::protocol::atapp_log *ATFW_UTIL_MACRO_NULLABLE log_conf);
   LIBATAPP_MACRO_API int reload(const atapp::protocol::atapp_etcd &conf,
                                 const atapp::protocol::atapp_log *ATFW_UTIL_MACRO_NULLABLE log_conf);
+  // Only reload logger of etcd cluster, atapp.etcd.log.* is not a part of atapp_etcd
+  LIBATAPP_MACRO_API int reload_logger(const atapp::protocol::atapp_etcd &conf,
+                                       const atapp::protocol::atapp_log *ATFW_UTIL_MACRO_NULLABLE log_conf);
   LIBATAPP_MACRO_API int stop();
   LIBATAPP_MACRO_API void reset();
   LIBATAPP_MACRO_API int tick();
@@ -57,6 +60,8 @@ class etcd_module {
   static int http_callback_on_etcd_closed(atfw::util::network::http_request &req);
   void load_cluster_conf(const atapp::protocol::atapp_etcd &conf,
                          const atapp::protocol::atapp_log *ATFW_UTIL_MACRO_NULLABLE log_conf = nullptr);
+  void load_logger_conf(const atapp::protocol::atapp_etcd &conf,
+                        const atapp::protocol::atapp_log *ATFW_UTIL_MACRO_NULLABLE log_conf);
 
   bool enable_;
   atfw::util::network::http_request::ptr_t cleanup_request_;
@@ -21,6 +21,8 @@
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 LIBATAPP_MACRO_NAMESPACE_BEGIN
 class service_discovery_module : public ::atframework::atapp::module_impl {
@@ -135,6 +137,12 @@ class service_discovery_module : public ::atframework::atapp::module_impl {
     LIBATAPP_MACRO_API const etcd_module &get_etcd_module() const;
 
     LIBATAPP_MACRO_API bool check_keepalive_actor_start_success();
+
+    /**
+     * @brief check the start state of internal keepalive actors without blocking
+     * @return <0 if any keepalive actor failed, 0 if any is still running, >0 if all passed
+     */
+    LIBATAPP_MACRO_API int get_keepalive_actor_start_state() const;
     LIBATAPP_MACRO_API void add_discovery_watcher_by_id_callback(const discovery_watcher_list_callback_t &fn);
     LIBATAPP_MACRO_API void add_discovery_watcher_by_name_callback(const discovery_watcher_list_callback_t &fn);
     LIBATAPP_MACRO_API void add_topology_watcher_callback(const topology_watcher_list_callback_t &fn);
@@ -276,6 +284,36 @@ class service_discovery_module : public ::atframework::atapp::module_impl {
   add_on_topology_snapshot_loaded(const topology_snapshot_event_callback_t &fn);
   LIBATAPP_MACRO_API void remove_on_topology_snapshot_loaded(topology_snapshot_event_callback_handle_t &handle);
 
+  /**
+   * @brief Load discovery and topology data from local cache file
+   * @note Loaded data is used to route before etcd is ready and is marked as stale until the first snapshot of etcd
+   *       is loaded, then it will be reconciled by the snapshot. Data of each cluster context is reconciled by the
+   *       snapshot of its own context.
+   * @note When the cache is loaded by init(), init() will not wait for the keepalive actors, they are checked in
+   *       tick() and the app will be stopped if any of them failed.
+   * @param file_path path of cache file
+   * @return count of loaded nodes and topology peers, or error code(<0)
+   */
+  LIBATAPP_MACRO_API int load_discovery_cache(const std::string &file_path);
+
+  /**
+   * @brief Save discovery and topology data into local cache file
+   * @param file_path path of cache file
+   * @param async serialize and write the file in worker pool
+   * @return 0 or error code
+   */
+  LIBATAPP_MACRO_API int save_discovery_cache(const std::string &file_path, bool async);
+
+  /**
+   * @brief If discovery data is loaded from local cache and not reconciled by etcd yet
+   */
+  LIBATAPP_MACRO_API bool is_discovery_cache_stale() const noexcept;
+
+  /**
+   * @brief If topology data is loaded from local cache and not reconciled by etcd yet
+   */
+  LIBATAPP_MACRO_API bool is_topology_cache_stale() const noexcept;
+
   LIBATAPP_MACRO_API etcd_watcher::watch_event_fn_t_ptr create_discovery_watcher_callback_list_wrapper(
       const ::atfw::util::nostd::nonnull<std::shared_ptr<service_discovery_cluster_context>> &context);
   LIBATAPP_MACRO_API etcd_watcher::watch_event_fn_t_ptr create_topology_watcher_callback_list_wrapper(
@@ -293,7 +331,13 @@ class service_discovery_module : public ::atframework::atapp::module_impl {
   bool update_internal_watcher_event(node_info_t &node, const etcd_discovery_node::node_version &version);
   bool update_internal_watcher_event(topology_info_t &topology_info);
 
+  void tick_discovery_cache();
+  void tick_keepalive_start_check();
+  service_discovery_cluster_context *find_cluster_context_by_addr(uintptr_t context_addr) noexcept;
+  service_discovery_cluster_context *find_cluster_context_by_path(const std::string &path) noexcept;
+
   struct watcher_internal_access_t;
+  struct discovery_cache_writer_t;
 
  private:
   bool discovery_enabled_;
@@ -332,5 +376,16 @@ class service_discovery_module : public ::atframework::atapp::module_impl {
 
   atfw::util::time::time_utility::raw_time_t tick_next_timepoint_;
   std::chrono::system_clock::duration tick_interval_;
+
+  std::string discovery_cache_path_;
+  std::chrono::system_clock::duration discovery_cache_save_interval_;
+  std::chrono::system_clock::duration discovery_cache_max_age_;
+  std::chrono::system_clock::time_point discovery_cache_next_save_time_;
+  bool discovery_cache_dirty_;
+  bool keepalive_start_check_pending_;
+  // Address of cluster contexts which have data loaded from cache and are not reconciled by etcd yet
+  std::unordered_set<uintptr_t> discovery_cache_stale_contexts_;
+  std::unordered_set<uintptr_t> topology_cache_stale_contexts_;
+  std::shared_ptr<discovery_cache_writer_t> discovery_cache_writer_;
 };
 LIBATAPP_MACRO_NAMESPACE_END
@@ -22,6 +22,10 @@ option(PROJECT_TEST_ENABLE_BOOST_UNIT_TEST "Enable boost unit test." OFF)
 
 option(ATFRAMEWORK_USE_DYNAMIC_LIBRARY "Build and linking with dynamic libraries." OFF)
 
+option(LIBATAPP_ENABLE_RAPIDJSON_SIMD
+       "Enable SSE2/SSE4.2/NEON path of rapidjson and URI escaping of rapidjson_loader, it's also set for dependents."
+       OFF)
+
 set(LIBATAPP_MACRO_HASH_MAGIC_NUMBER
     "0x01000193U"
     CACHE STRING "Magic number of libatapp")
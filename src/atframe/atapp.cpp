@@ -50,6 +50,7 @@
 #endif
 
 #include "atframe/atapp_conf_rapidjson.h"
+#include "atframe/atapp_log_rate_limit.h"
 #include "atframe/atapp_windows_minidump.h"
 #include "atframe/modules/service_discovery_module.h"
 #include "atframe/modules/worker_pool_module.h"
@@ -410,7 +411,8 @@ LIBATAPP_MACRO_API app::flag_guard_t::~flag_guard_t() {
 }
 
 LIBATAPP_MACRO_API app::app()
-    : setup_result_(0),
+    : configure_generation_(0),
+      setup_result_(0),
       pending_signals_{},
       ev_loop_(nullptr),
       flags_(0),
@@ -435,6 +437,7 @@ LIBATAPP_MACRO_API app::app()
   conf_.id = 0;
   conf_.execute_path = nullptr;
   conf_.upgrade_mode = false;
+  conf_.origin_changed_paths_available = false;
   conf_.runtime_pod_stateful_index = static_cast<int32_t>(atapp_pod_stateful_index::kUnset);
   conf_.timer_tick_interval =
       std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::milliseconds{8});
@@ -461,6 +464,7 @@ LIBATAPP_MACRO_API app::app()
   stats_.internal_etcd.sum_success_requests = 0;
   stats_.internal_etcd.continue_success_requests = 0;
   stats_.internal_etcd.sum_create_requests = 0;
+  memset(stats_.internal_etcd.requests_by_type, 0, sizeof(stats_.internal_etcd.requests_by_type));
   stats_.last_proc_event_count = 0;
   stats_.receive_custom_command_request_count = 0;
   stats_.receive_custom_command_reponse_count = 0;
@@ -1122,11 +1126,23 @@ LIBATAPP_MACRO_API int app::reload() {
   // apply configure
   apply_configure();
 
+  // Readers only take the published snapshot, so they never touch loaders which are modified by reload()
+  publish_configure_snapshot(configure_generation_.load(std::memory_order_relaxed) + 1);
+
   // prereload
   for (module_ptr_t &mod : modules_) {
     mod->prereload(conf_);
   }
 
+  // Differential reload is only available when running, all configures should be applied when startup
+  conf_.origin_changed_paths.clear();
+  if (is_running()) {
+    protobuf_diff(conf_.previous_origin, conf_.origin, conf_.origin_changed_paths);
+    conf_.origin_changed_paths_available = true;
+  } else {
+    conf_.origin_changed_paths_available = false;
+  }
+
   // Check configure
   if (0 == get_app_id() && get_app_name().empty()) {
     FWLOGERROR("Invalid configure file and can not load atapp id and name from environment");
@@ -1168,7 +1184,7 @@ LIBATAPP_MACRO_API int app::reload() {
     }
 
     // step 7.1 reload atbus configure
-    if (bus_node_) {
+    if (bus_node_ && is_origin_configure_changed("bus")) {
       bus_node_->reload_crypto(
           conf_.bus_conf.crypto_key_exchange_type, conf_.bus_conf.crypto_key_refresh_interval,
           gsl::span<const atbus::protocol::ATBUS_CRYPTO_ALGORITHM_TYPE>(conf_.bus_conf.crypto_allow_algorithms));
@@ -1287,6 +1303,9 @@ LIBATAPP_MACRO_API int app::tick() {
     atfw::util::time::time_utility::update();
   } while (active_count > 0 && tick_timer_.last_tick_timepoint < end_tp);
 
+  // refill log rate limits and write summaries of suppressed logs
+  log_rate_limiter::instance().tick(std::chrono::steady_clock::now());
+
   ev_loop_t *loop = get_evloop();
   // if is stoping, quit loop every tick
   if (nullptr != loop) {
@@ -1359,7 +1378,7 @@ LIBATAPP_MACRO_API int app::tick() {
         const ::atframework::atapp::etcd_cluster::stats_t &current =
             internal_module_service_discovery_->get_raw_etcd_ctx().get_stats();
         FWLOGINFO(
-            "\tetcd module(last minite): request count: {}, failed request: {}, continue failed: {}, success "
+            "\tetcd module(last minute): request count: {}, failed request: {}, continue failed: {}, success "
             "request: "
             "{}, continue success request {}",
             current.sum_create_requests - stats_.internal_etcd.sum_create_requests,
@@ -1372,6 +1391,30 @@ LIBATAPP_MACRO_API int app::tick() {
             "{}, continue success request {}",
             current.sum_create_requests, current.sum_error_requests, current.continue_error_requests,
             current.sum_success_requests, current.continue_success_requests);
+        for (size_t i = 0; i < static_cast<size_t>(etcd_cluster::request_type_t::kMax); ++i) {
+          const etcd_cluster::request_stats_t &current_type = current.requests_by_type[i];
+          const etcd_cluster::request_stats_t &previous_type = stats_.internal_etcd.requests_by_type[i];
+          size_t finished_count = current_type.sum_finished_requests - previous_type.sum_finished_requests;
+          if (0 == finished_count && 0 == current_type.in_flight &&
+              current_type.sum_cancelled_requests == previous_type.sum_cancelled_requests &&
+              current_type.sum_unhooked_requests == previous_type.sum_unhooked_requests) {
+            continue;
+          }
+
+          FWLOGINFO(
+              "\tetcd module(last minute) {}: in flight: {}, finished: {}, failed: {}, cancelled: {}, unhooked: {}, "
+              "new connection: {}, reused connection: {}, average latency: {}us, max latency(since startup): {}us",
+              etcd_cluster::get_request_type_name(static_cast<etcd_cluster::request_type_t>(i)), current_type.in_flight,
+              finished_count, current_type.sum_error_requests - previous_type.sum_error_requests,
+              current_type.sum_cancelled_requests - previous_type.sum_cancelled_requests,
+              current_type.sum_unhooked_requests - previous_type.sum_unhooked_requests,
+              current_type.sum_new_connections - previous_type.sum_new_connections,
+              current_type.sum_reused_connections - previous_type.sum_reused_connections,
+              0 == finished_count ? 0
+                                  : (current_type.sum_latency_us - previous_type.sum_latency_us) /
+                                        static_cast<int64_t>(finished_count),
+              current_type.max_latency_us);
+        }
         stats_.internal_etcd = current;
       }
 
@@ -1641,6 +1684,27 @@ LIBATAPP_MACRO_API const atapp::protocol::atapp_configure &app::get_origin_confi
   return conf_.origin;
 }
 
+LIBATAPP_MACRO_API bool app::is_origin_configure_changed(gsl::string_view path) const noexcept {
+  if (!conf_.origin_changed_paths_available) {
+    return true;
+  }
+
+  return conf_.origin_changed_paths.end() != conf_.origin_changed_paths.find(std::string(path.data(), path.size()));
+}
+
+LIBATAPP_MACRO_API const configure_key_set &app::get_origin_configure_changed_paths() const noexcept {
+  return conf_.origin_changed_paths;
+}
+
+LIBATAPP_MACRO_API uint64_t app::get_configure_generation() const noexcept {
+  return configure_generation_.load(std::memory_order_acquire);
+}
+
+LIBATAPP_MACRO_API configure_snapshot::ptr_t app::get_configure_snapshot() const {
+  std::lock_guard<std::mutex> lock_guard{configure_snapshot_lock_};
+  return configure_snapshot_;
+}
+
 LIBATAPP_MACRO_API const atapp::protocol::atapp_log &app::get_log_configure() const noexcept { return conf_.log; }
 
 LIBATAPP_MACRO_API const atapp::protocol::atapp_metadata &app::get_metadata() const noexcept { return conf_.metadata; }
@@ -2095,13 +2159,27 @@ LIBATAPP_MACRO_API int32_t app::send_message(uint64_t target_node_id, int32_t ty
 LIBATAPP_MACRO_API int32_t app::send_message(const std::string &target_node_name, int32_t type,
                                              gsl::span<const unsigned char> data, uint64_t *msg_sequence,
                                              const atapp::protocol::atapp_metadata *metadata) {
+  return send_message(gsl::string_view{target_node_name.data(), target_node_name.size()}, type, data, msg_sequence,
+                      metadata);
+}
+
+LIBATAPP_MACRO_API int32_t app::send_message(const char *target_node_name, int32_t type,
+                                             gsl::span<const unsigned char> data, uint64_t *msg_sequence,
+                                             const atapp::protocol::atapp_metadata *metadata) {
+  return send_message(nullptr == target_node_name ? gsl::string_view{} : gsl::string_view{target_node_name}, type,
+                      data, msg_sequence, metadata);
+}
+
+LIBATAPP_MACRO_API int32_t app::send_message(gsl::string_view target_node_name, int32_t type,
+                                             gsl::span<const unsigned char> data, uint64_t *msg_sequence,
+                                             const atapp::protocol::atapp_metadata *metadata) {
   if (!check_flag(flag_t::kInitialized)) {
     return EN_ATAPP_ERR_NOT_INITED;
   }
 
   do {
     atapp_endpoint *cache = get_endpoint(target_node_name);
-    if (nullptr == cache && target_node_name == get_app_name()) {
+    if (nullptr == cache && gsl::string_view(get_app_name().data(), get_app_name().size()) == target_node_name) {
       cache = auto_mutable_self_endpoint().get();
     }
 
@@ -2124,8 +2202,9 @@ LIBATAPP_MACRO_API int32_t app::send_message(const std::string &target_node_name
     return EN_ATAPP_ERR_DISCOVERY_DISABLED;
   }
 
-  etcd_discovery_node::ptr_t node =
-      internal_module_service_discovery_->get_global_discovery().get_node_by_name(target_node_name);
+  // Endpoint is created here, so the name is only copied once for each target
+  etcd_discovery_node::ptr_t node = internal_module_service_discovery_->get_global_discovery().get_node_by_name(
+      static_cast<std::string>(target_node_name));
   if (!node) {
     return EN_ATBUS_ERR_ATNODE_NOT_FOUND;
   }
@@ -2414,6 +2493,14 @@ LIBATAPP_MACRO_API void app::remove_endpoint(uint64_t by_id) {
 }
 
 LIBATAPP_MACRO_API void app::remove_endpoint(const std::string &by_name) {
+  remove_endpoint(gsl::string_view{by_name.data(), by_name.size()});
+}
+
+LIBATAPP_MACRO_API void app::remove_endpoint(const char *by_name) {
+  remove_endpoint(nullptr == by_name ? gsl::string_view{} : gsl::string_view{by_name});
+}
+
+LIBATAPP_MACRO_API void app::remove_endpoint(gsl::string_view by_name) {
   endpoint_index_by_name_t::const_iterator iter_name = endpoint_index_by_name_.find(by_name);
   if (iter_name == endpoint_index_by_name_.end()) {
     return;
@@ -2510,8 +2597,14 @@ LIBATAPP_MACRO_API atapp_endpoint::ptr_t app::mutable_endpoint(const etcd_discov
       if (ret) {
         remove_endpoint(id);
         need_update_id_index = true;
+        // Elements of flat index may be moved after erasing
+        iter_name = endpoint_index_by_name_.find(name);
+      }
+      if (iter_name != endpoint_index_by_name_.end()) {
+        ret = iter_name->second;
+      } else {
+        ret.reset();
       }
-      ret = iter_name->second;
       need_update_name_index = !ret;
     } else {
       need_update_name_index = true;
@@ -2629,6 +2722,22 @@ LIBATAPP_MACRO_API const atapp_endpoint *app::get_endpoint(uint64_t by_id) const
 }
 
 LIBATAPP_MACRO_API atapp_endpoint *app::get_endpoint(const std::string &by_name) {
+  return get_endpoint(gsl::string_view{by_name.data(), by_name.size()});
+}
+
+LIBATAPP_MACRO_API const atapp_endpoint *app::get_endpoint(const std::string &by_name) const noexcept {
+  return get_endpoint(gsl::string_view{by_name.data(), by_name.size()});
+}
+
+LIBATAPP_MACRO_API atapp_endpoint *app::get_endpoint(const char *by_name) {
+  return get_endpoint(nullptr == by_name ? gsl::string_view{} : gsl::string_view{by_name});
+}
+
+LIBATAPP_MACRO_API const atapp_endpoint *app::get_endpoint(const char *by_name) const noexcept {
+  return get_endpoint(nullptr == by_name ? gsl::string_view{} : gsl::string_view{by_name});
+}
+
+LIBATAPP_MACRO_API atapp_endpoint *app::get_endpoint(gsl::string_view by_name) {
   endpoint_index_by_name_t::iterator iter_name = endpoint_index_by_name_.find(by_name);
   if (iter_name != endpoint_index_by_name_.end()) {
     return iter_name->second.get();
@@ -2637,7 +2746,7 @@ LIBATAPP_MACRO_API atapp_endpoint *app::get_endpoint(const std::string &by_name)
   return nullptr;
 }
 
-LIBATAPP_MACRO_API const atapp_endpoint *app::get_endpoint(const std::string &by_name) const noexcept {
+LIBATAPP_MACRO_API const atapp_endpoint *app::get_endpoint(gsl::string_view by_name) const noexcept {
   endpoint_index_by_name_t::const_iterator iter_name = endpoint_index_by_name_.find(by_name);
   if (iter_name != endpoint_index_by_name_.end()) {
     return iter_name->second.get();
@@ -2823,6 +2932,24 @@ LIBATAPP_MACRO_API bool app::check_flag(flag_t f) const noexcept {
   return 0 != (flags_.load(std::memory_order_acquire) & (static_cast<uint64_t>(1) << static_cast<uint32_t>(f_value)));
 }
 
+void app::publish_configure_snapshot(uint64_t generation) {
+  std::shared_ptr<configure_snapshot> snapshot = std::make_shared<configure_snapshot>(generation);
+  snapshot->append(cfg_loader_.get_root_node(), "");
+  for (yaml_conf_map_t::const_iterator iter = yaml_loader_.begin(); iter != yaml_loader_.end(); ++iter) {
+    for (size_t i = 0; i < iter->second.size(); ++i) {
+      snapshot->append(iter->second[i], "");
+    }
+  }
+  // Parsed values with environment variables and default values
+  snapshot->append(conf_.origin, "atapp");
+
+  {
+    std::lock_guard<std::mutex> lock_guard{configure_snapshot_lock_};
+    configure_snapshot_ = std::move(snapshot);
+  }
+  configure_generation_.store(generation, std::memory_order_release);
+}
+
 int app::apply_configure() {
   std::string old_name = conf_.origin.name();
   std::string old_hostname = conf_.origin.hostname();
@@ -3882,6 +4009,21 @@ int app::setup_log() {
     log_reg_[log_sink_name] = log_sink_maker::get_file_sink_reg();
   }
 
+  log_sink_name = static_cast<std::string>(log_sink_maker::get_async_file_sink_name());
+  if (log_reg_.find(log_sink_name) == log_reg_.end()) {
+    log_reg_[log_sink_name] = log_sink_maker::get_async_file_sink_reg();
+  }
+
+  log_sink_name = static_cast<std::string>(log_sink_maker::get_binlog_sink_name());
+  if (log_reg_.find(log_sink_name) == log_reg_.end()) {
+    log_reg_[log_sink_name] = log_sink_maker::get_binlog_sink_reg();
+  }
+
+  log_sink_name = static_cast<std::string>(log_sink_maker::get_mmap_file_sink_name());
+  if (log_reg_.find(log_sink_name) == log_reg_.end()) {
+    log_reg_[log_sink_name] = log_sink_maker::get_mmap_file_sink_reg();
+  }
+
   log_sink_name = static_cast<std::string>(log_sink_maker::get_stdout_sink_name());
   if (log_reg_.find(log_sink_name) == log_reg_.end()) {
     log_reg_[log_sink_name] = log_sink_maker::get_stdout_sink_reg();
@@ -3923,6 +4065,7 @@ int app::setup_log() {
     }
 
     setup_logger(*logger, conf_.log.level(), conf_.log.category(i));
+    log_rate_limiter::instance().set_options(log_index, conf_.log.category(i).rate_limit());
   }
 
   return 0;
@@ -4878,7 +5021,8 @@ int app::command_handler_list_discovery(atfw::util::cli::callback_param params)
       if (!nodes[i]) {
         continue;
       }
-      const atapp::protocol::atapp_discovery &node_info = nodes[i]->get_discovery_info();
+      atapp::protocol::atapp_discovery node_info;
+      nodes[i]->copy_to(node_info);
       add_custom_command_rsp(
           params, LOG_WRAPPER_FWAPI_FORMAT("node -> private data: {}, destroy event: {}, hash: {:016x}{:016x}, {}",
                                            reinterpret_cast<const void *>(nodes[i]->get_private_data_ptr()),
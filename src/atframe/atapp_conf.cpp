@@ -24,6 +24,7 @@
 
 // Must include protobuf first, or MinGW will redefine GetMessage -> GetMessageA
 #include <atframe/atapp_conf.h>
+#include <atframe/atapp_flat_hash_map.h>
 
 #include <libatbus.h>
 
@@ -35,6 +36,8 @@
 #include <time/time_utility.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <limits>
 #include <mutex>
 #include <string>
@@ -56,9 +59,8 @@
 LIBATAPP_MACRO_NAMESPACE_BEGIN
 namespace {
 
-// Forward declarations for expression expansion functions (defined later in this namespace).
-static std::string expand_expression_impl(gsl::string_view input, size_t depth);
-static bool field_has_enable_expression(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *fds);
+// Forward declaration for expression expansion function (defined later in this namespace).
+static std::string expand_expression_impl(gsl::string_view input);
 
 static const char *skip_space(const char *begin, const char *end) {
   while (nullptr != begin && begin < end && *begin) {
@@ -422,6 +424,128 @@ static const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::EnumValueDescriptor *pick_enum_v
   return nullptr;
 }
 
+// Per-field CONFIGURE metadata, resolved once per descriptor instead of walking options/extensions for every value.
+struct ATFW_UTIL_SYMBOL_LOCAL configure_field_meta_t {
+  enum special_message_type : int8_t {
+    kNone = 0,
+    kDuration = 1,
+    kTimestamp = 2,
+  };
+
+  bool has_configure = false;
+  bool enable_expression = false;
+  bool size_mode = false;
+  special_message_type special_message = kNone;
+  std::string default_value;
+  std::string min_value;
+  std::string max_value;
+  std::string field_match_name;
+  std::string field_match_value;
+};
+
+struct ATFW_UTIL_SYMBOL_LOCAL configure_message_meta_t {
+  std::vector<configure_field_meta_t> fields;
+};
+
+static const configure_message_meta_t *build_configure_message_meta(
+    const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Descriptor *desc) {
+  // Metadata is built only once for each descriptor and never released, so readers can keep raw pointers of it.
+  static std::mutex g_message_meta_mutex;
+  std::lock_guard<std::mutex> lg(g_message_meta_mutex);
+  static std::unordered_map<const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Descriptor *,
+                            atfw::util::memory::strong_rc_ptr<configure_message_meta_t>>
+      g_message_meta;
+
+  auto it = g_message_meta.find(desc);
+  if (it != g_message_meta.end()) {
+    return it->second.get();
+  }
+
+  atfw::util::memory::strong_rc_ptr<configure_message_meta_t> res =
+      atfw::util::memory::make_strong_rc<configure_message_meta_t>();
+  g_message_meta[desc] = res;
+
+  res->fields.resize(static_cast<size_t>(desc->field_count()));
+  for (int i = 0; i < desc->field_count(); ++i) {
+    const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *fds = desc->field(i);
+    if (fds == nullptr) {
+      continue;
+    }
+
+    configure_field_meta_t &field_meta = res->fields[static_cast<size_t>(i)];
+    if (nullptr != fds->message_type()) {
+      if (fds->message_type()->full_name() == ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration::descriptor()->full_name()) {
+        field_meta.special_message = configure_field_meta_t::kDuration;
+      } else if (fds->message_type()->full_name() ==
+                 ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp::descriptor()->full_name()) {
+        field_meta.special_message = configure_field_meta_t::kTimestamp;
+      }
+    }
+
+    if (!fds->options().HasExtension(atapp::protocol::CONFIGURE)) {
+      continue;
+    }
+
+    const atapp::protocol::atapp_configure_meta &meta = fds->options().GetExtension(atapp::protocol::CONFIGURE);
+    field_meta.has_configure = true;
+    field_meta.enable_expression = meta.enable_expression();
+    field_meta.size_mode = meta.size_mode();
+    field_meta.default_value = meta.default_value();
+    field_meta.min_value = meta.min_value();
+    field_meta.max_value = meta.max_value();
+    field_meta.field_match_name = meta.field_match().field_name();
+    field_meta.field_match_value = meta.field_match().field_value();
+  }
+
+  return res.get();
+}
+
+static const configure_message_meta_t *get_configure_message_meta(
+    const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Descriptor *desc) {
+  if (desc == nullptr) {
+    return nullptr;
+  }
+
+  // Fields of the same message are usually visited one by one, so check the last descriptor first, and use a
+  // thread local index to avoid locking the global table on hot path.
+  static thread_local const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Descriptor *last_desc = nullptr;
+  static thread_local const configure_message_meta_t *last_meta = nullptr;
+  if (last_desc == desc) {
+    return last_meta;
+  }
+
+  static thread_local std::unordered_map<const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Descriptor *,
+                                         const configure_message_meta_t *>
+      local_message_meta;
+  const configure_message_meta_t *ret;
+  auto it = local_message_meta.find(desc);
+  if (it != local_message_meta.end()) {
+    ret = it->second;
+  } else {
+    ret = build_configure_message_meta(desc);
+    local_message_meta[desc] = ret;
+  }
+
+  last_desc = desc;
+  last_meta = ret;
+  return ret;
+}
+
+static const configure_field_meta_t &get_configure_field_meta(
+    const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *fds) {
+  static configure_field_meta_t empty_meta;
+  if (nullptr == fds || fds->is_extension()) {
+    return empty_meta;
+  }
+
+  const configure_message_meta_t *message_meta = get_configure_message_meta(fds->containing_type());
+  if (nullptr == message_meta || fds->index() < 0 || static_cast<size_t>(fds->index()) >= message_meta->fields.size()) {
+    return empty_meta;
+  }
+
+  return message_meta->fields[static_cast<size_t>(fds->index())];
+}
+
 static inline void dump_pick_field_min(bool &out) { out = false; }
 
 static inline void dump_pick_field_min(std::string &) {}
@@ -675,18 +799,18 @@ dump_pick_enum_field_with_extensions(gsl::string_view val_str,
   // Expand expression if enable_expression is set
   // expanded_val must outlive val_str since val_str may point into it.
   std::string expanded_val;
-  if (!val_str.empty() && field_has_enable_expression(fds)) {
-    expanded_val = expand_expression_impl(val_str, 0);
+  if (!val_str.empty() && get_configure_field_meta(fds).enable_expression) {
+    expanded_val = expand_expression_impl(val_str);
     val_str = expanded_val;
   }
 
   if (val_str.empty()) {
-    if (fds->options().HasExtension(atapp::protocol::CONFIGURE)) {
-      const atapp::protocol::atapp_configure_meta &meta = fds->options().GetExtension(atapp::protocol::CONFIGURE);
+    const configure_field_meta_t &meta = get_configure_field_meta(fds);
+    if (meta.has_configure) {
       // Reuse expanded_val to hold the default value — it must outlive val_str.
-      expanded_val = meta.default_value();
-      if (!expanded_val.empty() && meta.enable_expression()) {
-        expanded_val = expand_expression_impl(expanded_val, 0);
+      expanded_val = meta.default_value;
+      if (!expanded_val.empty() && meta.enable_expression) {
+        expanded_val = expand_expression_impl(expanded_val);
       }
       val_str = expanded_val;
     }
@@ -891,8 +1015,10 @@ static bool dump_field_with_value(const std::pair<ATBUS_MACRO_PROTOBUF_NAMESPACE
 //   Nesting is supported: ${OUTER_${INNER}}, ${VAR:-${OTHER:-fallback}}
 //
 // The implementation uses a recursive-descent parser that handles nested
-// braces by counting depth.  A maximum recursion depth guard prevents
-// infinite loops from malformed input.
+// braces by counting depth and compiles the input into literal and variable
+// segments once.  Compiled expressions, variable values and expanded results
+// are cached, see refresh_environment_expression_generation().  A maximum
+// recursion depth guard prevents infinite loops from malformed input.
 // ============================================================================
 
 // Maximum recursion depth to prevent stack overflow from deeply nested or
@@ -963,23 +1089,60 @@ static size_t find_top_level_operator(gsl::string_view content) {
   return std::string::npos;
 }
 
-// Core recursive expansion of environment variable expressions.
-static std::string expand_expression_impl(gsl::string_view input, size_t depth) {
+// Compiled form of an expression.  Literal text is pre-split into segments so evaluation only needs to look up
+// variables and concatenate.  Nested expressions (variable names and :-/:+ arguments) are compiled recursively.
+struct ATFW_UTIL_SYMBOL_LOCAL compiled_expression_t;
+using compiled_expression_ptr = atfw::util::memory::strong_rc_ptr<compiled_expression_t>;
+
+struct ATFW_UTIL_SYMBOL_LOCAL compiled_expression_segment_t {
+  enum segment_type : int8_t {
+    kLiteral = 0,
+    kVariable = 1,        // $VAR or ${VAR}
+    kDefaultValue = 2,    // ${VAR:-default}
+    kAlternateValue = 3,  // ${VAR:+word}
+  };
+
+  segment_type type = kLiteral;
+  std::string literal;
+  compiled_expression_ptr variable_name;
+  compiled_expression_ptr argument;
+};
+
+struct ATFW_UTIL_SYMBOL_LOCAL compiled_expression_t {
+  std::vector<compiled_expression_segment_t> segments;
+  bool has_variable = false;
+};
+
+static void compiled_expression_append_literal(compiled_expression_t &out, gsl::string_view literal) {
+  if (literal.empty()) {
+    return;
+  }
+
+  if (out.segments.empty() || out.segments.back().type != compiled_expression_segment_t::kLiteral) {
+    out.segments.emplace_back();
+  }
+  out.segments.back().literal.append(literal.data(), literal.size());
+}
+
+static void compiled_expression_append_literal(compiled_expression_t &out, char c) {
+  compiled_expression_append_literal(out, gsl::string_view(&c, 1));
+}
+
+static compiled_expression_ptr compile_expression_impl(gsl::string_view input, size_t depth) {
+  compiled_expression_ptr ret = atfw::util::memory::make_strong_rc<compiled_expression_t>();
   if (depth > kMaxExpressionRecursionDepth) {
     // Guard against excessive nesting — return input as-is.
-    return static_cast<std::string>(input);
+    compiled_expression_append_literal(*ret, input);
+    return ret;
   }
 
-  std::string result;
-  result.reserve(input.size());
-
   size_t i = 0;
   while (i < input.size()) {
     char c = input[i];
 
     // Handle escape: \$ → literal '$'
     if (c == '\\' && i + 1 < input.size() && input[i + 1] == '$') {
-      result.push_back('$');
+      compiled_expression_append_literal(*ret, '$');
       i += 2;
       continue;
     }
@@ -988,7 +1151,7 @@ static std::string expand_expression_impl(gsl::string_view input, size_t depth)
     if (c == '$') {
       if (i + 1 >= input.size()) {
         // Trailing '$' — keep it literally
-        result.push_back('$');
+        compiled_expression_append_literal(*ret, '$');
         ++i;
         continue;
       }
@@ -999,8 +1162,7 @@ static std::string expand_expression_impl(gsl::string_view input, size_t depth)
         size_t close_pos = find_matching_close_brace(remaining);
         if (close_pos == std::string::npos) {
           // No matching '}' — treat as literal text
-          result.push_back('$');
-          result.push_back('{');
+          compiled_expression_append_literal(*ret, gsl::string_view("${", 2));
           i += 2;
           continue;
         }
@@ -1009,42 +1171,26 @@ static std::string expand_expression_impl(gsl::string_view input, size_t depth)
         // NOLINTNEXTLINE(bugprone-suspicious-stringview-data-usage)
         gsl::string_view content(remaining.data(), close_pos);
 
-        // Look for top-level operator (:- or :+) first, then expand parts independently.
+        // Look for top-level operator (:- or :+) first, then compile parts independently.
         size_t op_pos = find_top_level_operator(content);
 
+        compiled_expression_segment_t segment;
         if (op_pos != std::string::npos) {
-          char op_char = content[op_pos + 1];  // '-' or '+'
           // NOLINTNEXTLINE(bugprone-suspicious-stringview-data-usage)
           gsl::string_view var_part(content.data(), op_pos);
           gsl::string_view arg_part(content.data() + op_pos + 2, content.size() - op_pos - 2);
 
-          // Expand the variable name part (may contain nested expressions)
-          std::string var_name = expand_expression_impl(var_part, depth + 1);
-
-          // Look up the environment variable
-          std::string env_val = atfw::util::file_system::getenv(var_name.c_str());
-
-          if (op_char == '-') {
-            // ${VAR:-default}: use default if VAR is unset or empty
-            if (env_val.empty()) {
-              result += expand_expression_impl(arg_part, depth + 1);
-            } else {
-              result += env_val;
-            }
-          } else {
-            // op_char == '+'
-            // ${VAR:+word}: use word if VAR is set and non-empty
-            if (!env_val.empty()) {
-              result += expand_expression_impl(arg_part, depth + 1);
-            }
-            // else: VAR is empty, result gets nothing appended
-          }
+          segment.type = content[op_pos + 1] == '-' ? compiled_expression_segment_t::kDefaultValue
+                                                    : compiled_expression_segment_t::kAlternateValue;
+          segment.variable_name = compile_expression_impl(var_part, depth + 1);
+          segment.argument = compile_expression_impl(arg_part, depth + 1);
         } else {
           // No operator — pure variable reference, possibly with nested expressions
-          std::string var_name = expand_expression_impl(content, depth + 1);
-          std::string env_val = atfw::util::file_system::getenv(var_name.c_str());
-          result += env_val;
+          segment.type = compiled_expression_segment_t::kVariable;
+          segment.variable_name = compile_expression_impl(content, depth + 1);
         }
+        ret->segments.emplace_back(std::move(segment));
+        ret->has_variable = true;
 
         // Advance past the closing '}'
         i += 2 + close_pos + 1;
@@ -1059,36 +1205,229 @@ static std::string expand_expression_impl(gsl::string_view input, size_t depth)
           ++name_end;
         }
 
-        std::string var_name(input.data() + name_start, name_end - name_start);
-        std::string env_val = atfw::util::file_system::getenv(var_name.c_str());
-        result += env_val;
+        compiled_expression_segment_t segment;
+        segment.type = compiled_expression_segment_t::kVariable;
+        segment.variable_name = atfw::util::memory::make_strong_rc<compiled_expression_t>();
+        compiled_expression_append_literal(*segment.variable_name,
+                                           gsl::string_view(input.data() + name_start, name_end - name_start));
+        ret->segments.emplace_back(std::move(segment));
+        ret->has_variable = true;
         i = name_end;
         continue;
       }
 
       // '$' followed by non-variable character — keep literally
-      result.push_back('$');
+      compiled_expression_append_literal(*ret, '$');
       ++i;
       continue;
     }
 
-    // Ordinary character
-    result.push_back(c);
-    ++i;
+    // Ordinary characters, copy the whole run up to the next special character at once
+    size_t run_end = i + 1;
+    while (run_end < input.size() && input[run_end] != '$' && input[run_end] != '\\') {
+      ++run_end;
+    }
+    compiled_expression_append_literal(*ret, gsl::string_view(input.data() + i, run_end - i));
+    i = run_end;
+  }
+
+  return ret;
+}
+
+// Compiled expressions never depend on the environment, while expanded results and variable values are only valid
+// for the environment generation they were computed in.  The generation is bumped when any variable referenced by
+// cached results changes, so reloading with an unchanged environment reuses all previous results and checking it only
+// costs one getenv() for each referenced variable instead of scanning the whole process environment.
+// Lookups use gsl::string_view and do not create a std::string key unless a new entry is inserted.
+struct ATFW_UTIL_SYMBOL_LOCAL expression_cache_t {
+  std::mutex lock;
+  std::atomic<uint64_t> environment_generation{1};
+  flat_hash_map<std::string, compiled_expression_ptr, flat_string_hash, flat_string_equal> compiled;
+  flat_hash_map<std::string, std::string, flat_string_hash, flat_string_equal> results;
+  std::unordered_map<std::string, std::string> variables;
+};
+
+// Expanded results of the current thread, they are read without cache.lock and dropped when the environment
+// generation changes.
+struct ATFW_UTIL_SYMBOL_LOCAL expression_local_cache_t {
+  uint64_t environment_generation = 0;
+  flat_hash_map<std::string, std::string, flat_string_hash, flat_string_equal> results;
+};
+
+// Upper bound of each cache, the caches are just dropped when they grow larger than this.
+static constexpr size_t kMaxExpressionCacheSize = 65536;
+
+static expression_cache_t &get_expression_cache() {
+  static expression_cache_t ret;
+  return ret;
+}
+
+// Must be called with cache.lock held
+static void reset_expression_environment_generation(expression_cache_t &cache) {
+  cache.results.clear();
+  cache.environment_generation.fetch_add(1, std::memory_order_release);
+}
+
+// Must be called with cache.lock held
+static const std::string &lookup_expression_variable(expression_cache_t &cache, const std::string &name,
+                                                     bool refresh) {
+  auto iter = cache.variables.find(name);
+  if (iter != cache.variables.end()) {
+    if (refresh) {
+      std::string value = atfw::util::file_system::getenv(name.c_str());
+      if (value != iter->second) {
+        iter->second.swap(value);
+        reset_expression_environment_generation(cache);
+      }
+    }
+    return iter->second;
   }
 
+  if (cache.variables.size() >= kMaxExpressionCacheSize) {
+    // Results may depend on dropped variables, which could not be checked any more
+    cache.variables.clear();
+    reset_expression_environment_generation(cache);
+  }
+  return cache.variables[name] = atfw::util::file_system::getenv(name.c_str());
+}
+
+// Must be called with cache.lock held
+static void evaluate_compiled_expression(expression_cache_t &cache, const compiled_expression_t &expr, bool refresh,
+                                         std::string &out) {
+  for (const auto &segment : expr.segments) {
+    if (segment.type == compiled_expression_segment_t::kLiteral) {
+      out += segment.literal;
+      continue;
+    }
+
+    std::string var_name;
+    if (segment.variable_name) {
+      evaluate_compiled_expression(cache, *segment.variable_name, refresh, var_name);
+    }
+    const std::string &env_val = lookup_expression_variable(cache, var_name, refresh);
+
+    switch (segment.type) {
+      case compiled_expression_segment_t::kVariable: {
+        out += env_val;
+        break;
+      }
+      case compiled_expression_segment_t::kDefaultValue: {
+        // ${VAR:-default}: use default if VAR is unset or empty
+        if (!env_val.empty()) {
+          out += env_val;
+        } else if (segment.argument) {
+          evaluate_compiled_expression(cache, *segment.argument, refresh, out);
+        }
+        break;
+      }
+      case compiled_expression_segment_t::kAlternateValue: {
+        // ${VAR:+word}: use word if VAR is set and non-empty
+        if (!env_val.empty() && segment.argument) {
+          evaluate_compiled_expression(cache, *segment.argument, refresh, out);
+        }
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+}
+
+// Must be called with cache.lock held
+static compiled_expression_ptr get_compiled_expression(expression_cache_t &cache, gsl::string_view key) {
+  auto compiled_iter = cache.compiled.find(key);
+  if (compiled_iter != cache.compiled.end()) {
+    return compiled_iter->second;
+  }
+
+  compiled_expression_ptr ret = compile_expression_impl(key, 0);
+  if (cache.compiled.size() >= kMaxExpressionCacheSize) {
+    cache.compiled.clear();
+  }
+  cache.compiled[static_cast<std::string>(key)] = ret;
+  return ret;
+}
+
+// Expand expression with the compiled and result caches of current environment generation.
+static std::string expand_expression_impl(gsl::string_view input) {
+  if (input.empty()) {
+    return std::string();
+  }
+
+  // Fast path, every field with enable_expression is expanded here when loading configure
+  static thread_local expression_local_cache_t local_cache;
+  expression_cache_t &cache = get_expression_cache();
+  uint64_t environment_generation = cache.environment_generation.load(std::memory_order_acquire);
+  if (local_cache.environment_generation != environment_generation) {
+    local_cache.results.clear();
+    local_cache.environment_generation = environment_generation;
+  }
+  auto local_iter = local_cache.results.find(input);
+  if (local_iter != local_cache.results.end()) {
+    return local_iter->second;
+  }
+
+  std::string result;
+  {
+    std::lock_guard<std::mutex> lg(cache.lock);
+    auto result_iter = cache.results.find(input);
+    if (result_iter != cache.results.end()) {
+      result = result_iter->second;
+    } else {
+      compiled_expression_ptr expr = get_compiled_expression(cache, input);
+      if (!expr->has_variable) {
+        if (!expr->segments.empty()) {
+          result = expr->segments.front().literal;
+        }
+      } else {
+        result.reserve(input.size());
+        evaluate_compiled_expression(cache, *expr, false, result);
+
+        if (cache.results.size() >= kMaxExpressionCacheSize) {
+          cache.results.clear();
+        }
+        cache.results[static_cast<std::string>(input)] = result;
+      }
+    }
+
+    // The generation may be changed by evaluating, results of the old generation must not be kept
+    environment_generation = cache.environment_generation.load(std::memory_order_acquire);
+  }
+
+  if (local_cache.environment_generation != environment_generation) {
+    local_cache.results.clear();
+    local_cache.environment_generation = environment_generation;
+  }
+  if (local_cache.results.size() >= kMaxExpressionCacheSize) {
+    local_cache.results.clear();
+  }
+  local_cache.results[static_cast<std::string>(input)] = result;
   return result;
 }
 
-// Check if a field descriptor has enable_expression set in its CONFIGURE extension.
-static bool field_has_enable_expression(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *fds) {
-  if (nullptr == fds) {
-    return false;
+// Expand expression with the latest values of referenced variables, cached results which depend on changed variables
+// are dropped.
+static std::string expand_expression_refresh(gsl::string_view input) {
+  if (input.empty()) {
+    return std::string();
   }
-  if (!fds->options().HasExtension(atapp::protocol::CONFIGURE)) {
-    return false;
+
+  expression_cache_t &cache = get_expression_cache();
+
+  std::lock_guard<std::mutex> lg(cache.lock);
+  compiled_expression_ptr expr = get_compiled_expression(cache, input);
+  std::string result;
+  if (!expr->has_variable) {
+    if (!expr->segments.empty()) {
+      result = expr->segments.front().literal;
+    }
+    return result;
   }
-  return fds->options().GetExtension(atapp::protocol::CONFIGURE).enable_expression();
+
+  result.reserve(input.size());
+  evaluate_compiled_expression(cache, *expr, true, result);
+  return result;
 }
 
 template <class TRET>
@@ -1099,44 +1438,31 @@ static std::pair<TRET, bool> dump_pick_field_with_extensions(
   dump_pick_field_min(min_value);
   dump_pick_field_max(max_value);
 
+  const configure_field_meta_t &meta = get_configure_field_meta(fds);
+
   // Expand expression if enable_expression is set
   std::string expanded_val;
-  if (!val_str.empty() && field_has_enable_expression(fds)) {
-    expanded_val = expand_expression_impl(val_str, 0);
+  if (!val_str.empty() && meta.enable_expression) {
+    expanded_val = expand_expression_impl(val_str);
     val_str = gsl::string_view(expanded_val.data(), expanded_val.size());
   }
 
   if (val_str.empty()) {
-    if (fds->options().HasExtension(atapp::protocol::CONFIGURE)) {
-      const atapp::protocol::atapp_configure_meta &meta = fds->options().GetExtension(atapp::protocol::CONFIGURE);
-      std::string default_str = meta.default_value();
-      if (!default_str.empty() && meta.enable_expression()) {
-        default_str = expand_expression_impl(default_str, 0);
-      }
-      dump_pick_field_from_str(value, default_str, meta.size_mode());
+    if (meta.has_configure && !meta.default_value.empty() && meta.enable_expression) {
+      dump_pick_field_from_str(value, expand_expression_impl(meta.default_value), meta.size_mode);
     } else {
-      dump_pick_field_from_str(value, std::string(), false);
+      dump_pick_field_from_str(value, meta.default_value, meta.size_mode);
     }
 
     is_default = true;
   } else {
-    if (fds->options().HasExtension(atapp::protocol::CONFIGURE)) {
-      const atapp::protocol::atapp_configure_meta &meta = fds->options().GetExtension(atapp::protocol::CONFIGURE);
-      dump_pick_field_from_str(value, val_str, meta.size_mode());
-    } else {
-      dump_pick_field_from_str(value, val_str, false);
-    }
+    dump_pick_field_from_str(value, val_str, meta.size_mode);
   }
-  if (fds->options().HasExtension(atapp::protocol::CONFIGURE)) {
-    const atapp::protocol::atapp_configure_meta &meta = fds->options().GetExtension(atapp::protocol::CONFIGURE);
-    const std::string &min_val_str = meta.min_value();
-    const std::string &max_val_str = meta.max_value();
-    if (!min_val_str.empty()) {
-      dump_pick_field_from_str(min_value, min_val_str, meta.size_mode());
-    }
-    if (!max_val_str.empty()) {
-      dump_pick_field_from_str(max_value, max_val_str, meta.size_mode());
-    }
+  if (!meta.min_value.empty()) {
+    dump_pick_field_from_str(min_value, meta.min_value, meta.size_mode);
+  }
+  if (!meta.max_value.empty()) {
+    dump_pick_field_from_str(max_value, meta.max_value, meta.size_mode);
   }
 
   if (dump_pick_field_less(value, min_value)) {
@@ -1170,19 +1496,16 @@ static void dump_pick_default_field(ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &
     }
   }
 
-  bool allow_string_default_value = nullptr == fds->message_type();
-  if (!allow_string_default_value) {
-    allow_string_default_value =
-        fds->message_type()->full_name() == ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration::descriptor()->full_name() ||
-        fds->message_type()->full_name() == ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp::descriptor()->full_name();
-  }
+  const configure_field_meta_t &meta = get_configure_field_meta(fds);
+  bool allow_string_default_value =
+      nullptr == fds->message_type() || meta.special_message != configure_field_meta_t::kNone;
 
   if (allow_string_default_value) {
-    if (!fds->options().HasExtension(atapp::protocol::CONFIGURE)) {
+    if (!meta.has_configure) {
       return;
     }
 
-    if (fds->options().GetExtension(atapp::protocol::CONFIGURE).default_value().empty()) {
+    if (meta.default_value.empty()) {
       return;
     }
 
@@ -1241,13 +1564,11 @@ static void dump_pick_default_field(ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &
       } else {
         // special message
         google::protobuf::Message *submsg = dst.GetReflection()->MutableMessage(&dst, fds);
-        if (fds->message_type()->full_name() ==
-            ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration::descriptor()->full_name()) {
+        if (meta.special_message == configure_field_meta_t::kDuration) {
           ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration value =
               dump_pick_field_with_extensions<ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration>("", fds).first;
           dynamic_copy_protobuf_duration_or_timestamp(submsg, value);
-        } else if (fds->message_type()->full_name() ==
-                   ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp::descriptor()->full_name()) {
+        } else if (meta.special_message == configure_field_meta_t::kTimestamp) {
           ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp value =
               dump_pick_field_with_extensions<ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp>("", fds).first;
           dynamic_copy_protobuf_duration_or_timestamp(submsg, value);
@@ -1333,6 +1654,10 @@ static bool dump_pick_map_key_field(gsl::string_view val_str, ATBUS_MACRO_PROTOB
   return ret;
 }
 
+static bool dump_ini_message_item(const atfw::util::config::ini_value &src,
+                                  ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &dst, configure_key_set *dump_existed_set,
+                                  gsl::string_view existed_set_prefix);
+
 static bool dump_pick_field(const atfw::util::config::ini_value &val, ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &dst,
                             const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *fds, size_t index,
                             configure_key_set *dump_existed_set, gsl::string_view existed_set_prefix) {
@@ -1369,12 +1694,13 @@ static bool dump_pick_field(const atfw::util::config::ini_value &val, ATBUS_MACR
     }
     case ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_MESSAGE: {
       // special message
-      if (fds->message_type()->full_name() == ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration::descriptor()->full_name()) {
+      const configure_field_meta_t &meta = get_configure_field_meta(fds);
+      if (meta.special_message == configure_field_meta_t::kDuration) {
         auto value = dump_pick_field_with_extensions<ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration>(val, fds, index);
         ret = dump_field_with_value(value, dst, fds, dump_existed_set, existed_set_prefix);
         break;
       }
-      if (fds->message_type()->full_name() == ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp::descriptor()->full_name()) {
+      if (meta.special_message == configure_field_meta_t::kTimestamp) {
         auto value = dump_pick_field_with_extensions<ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp>(val, fds, index);
         ret = dump_field_with_value(value, dst, fds, dump_existed_set, existed_set_prefix);
         break;
@@ -1393,7 +1719,7 @@ static bool dump_pick_field(const atfw::util::config::ini_value &val, ATBUS_MACR
         atfw::util::config::ini_value::node_type::const_iterator iter = val.get_children().begin();
 
         // Check if the map field itself has enable_expression
-        bool map_enable_expression = field_has_enable_expression(fds);
+        bool map_enable_expression = meta.enable_expression;
 
         for (; iter != val.get_children().end(); ++iter) {
           if (!iter->second) {
@@ -1412,7 +1738,7 @@ static bool dump_pick_field(const atfw::util::config::ini_value &val, ATBUS_MACR
           gsl::string_view map_key_str = iter->first;
           std::string expanded_map_key;
           if (map_enable_expression) {
-            expanded_map_key = expand_expression_impl(map_key_str, 0);
+            expanded_map_key = expand_expression_impl(map_key_str);
             map_key_str = gsl::string_view(expanded_map_key.data(), expanded_map_key.size());
           }
 
@@ -1426,7 +1752,7 @@ static bool dump_pick_field(const atfw::util::config::ini_value &val, ATBUS_MACR
           if (map_enable_expression &&
               value_fds->cpp_type() == ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_STRING) {
             std::string map_val_str = iter->second->as_cpp_string();
-            std::string expanded_map_val = expand_expression_impl(map_val_str, 0);
+            std::string expanded_map_val = expand_expression_impl(map_val_str);
             auto value_pair = std::pair<std::string, bool>(std::move(expanded_map_val), false);
             if (dump_field_with_value(value_pair, *submsg, value_fds, dump_existed_set, submsg_map_existed_set_key)) {
               has_data = true;
@@ -1455,7 +1781,7 @@ static bool dump_pick_field(const atfw::util::config::ini_value &val, ATBUS_MACR
 
           ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message *submsg = dst.GetReflection()->AddMessage(&dst, fds);
           if (nullptr != submsg) {
-            if (ini_loader_dump_to(*idx_iter->second, *submsg, dump_existed_set,
+            if (dump_ini_message_item(*idx_iter->second, *submsg, dump_existed_set,
                                    atfw::util::log::format("{}{}.{}.", existed_set_prefix, fds->name(), j))) {
               ret = true;
               if (dump_existed_set != nullptr) {
@@ -1468,7 +1794,7 @@ static bool dump_pick_field(const atfw::util::config::ini_value &val, ATBUS_MACR
       } else {
         ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message *submsg = dst.GetReflection()->MutableMessage(&dst, fds);
         if (nullptr != submsg) {
-          if (ini_loader_dump_to(val, *submsg, dump_existed_set,
+          if (dump_ini_message_item(val, *submsg, dump_existed_set,
                                  atfw::util::log::format("{}{}.", existed_set_prefix, fds->name()))) {
             ret = true;
             if (dump_existed_set != nullptr) {
@@ -1518,19 +1844,18 @@ static bool dump_field_item(const atfw::util::config::ini_value &src, ATBUS_MACR
   }
 
   // 同层级展开
-  if (!fds->is_repeated() && fds->options().HasExtension(atfw::atapp::protocol::CONFIGURE)) {
-    const auto &opt_ext = fds->options().GetExtension(atfw::atapp::protocol::CONFIGURE);
-    const auto &field_match = opt_ext.field_match();
-    if (!field_match.field_name().empty() && !field_match.field_value().empty()) {
+  const configure_field_meta_t &meta = get_configure_field_meta(fds);
+  if (!fds->is_repeated() && meta.has_configure) {
+    if (!meta.field_match_name.empty() && !meta.field_match_value.empty()) {
       atfw::util::config::ini_value::node_type::const_iterator field_value_iter =
-          src.get_children().find(field_match.field_name());
+          src.get_children().find(meta.field_match_name);
       if (field_value_iter == src.get_children().end()) {
         return false;
       }
       if (!field_value_iter->second) {
         return false;
       }
-      if (field_value_iter->second->as_cpp_string() != field_match.field_value()) {
+      if (field_value_iter->second->as_cpp_string() != meta.field_match_value) {
         return false;
       }
 
@@ -1538,7 +1863,7 @@ static bool dump_field_item(const atfw::util::config::ini_value &src, ATBUS_MACR
       if (nullptr == submsg) {
         return false;
       }
-      return ini_loader_dump_to(src, *submsg, dump_existed_set, existed_set_prefix);
+      return dump_ini_message_item(src, *submsg, dump_existed_set, existed_set_prefix);
     }
   }
 
@@ -1574,42 +1899,28 @@ static std::pair<TRET, bool> dump_pick_field_with_extensions(
   TRET value, min_value, max_value;
   dump_pick_field_min(min_value);
   dump_pick_field_max(max_value);
+  const configure_field_meta_t &meta = get_configure_field_meta(fds);
   if (!val.IsScalar() || val.Scalar().empty()) {
-    if (fds->options().HasExtension(atapp::protocol::CONFIGURE)) {
-      const atapp::protocol::atapp_configure_meta &meta = fds->options().GetExtension(atapp::protocol::CONFIGURE);
-      std::string default_str = meta.default_value();
-      if (!default_str.empty() && meta.enable_expression()) {
-        default_str = expand_expression_impl(default_str, 0);
-      }
-      dump_pick_field_from_str(value, default_str, meta.size_mode());
+    if (meta.has_configure && !meta.default_value.empty() && meta.enable_expression) {
+      dump_pick_field_from_str(value, expand_expression_impl(meta.default_value), meta.size_mode);
     } else {
-      dump_pick_field_from_str(value, std::string(), false);
+      dump_pick_field_from_str(value, meta.default_value, meta.size_mode);
     }
   } else {
     // Expand expression if enable_expression is set
     std::string expanded_scalar;
     gsl::string_view scalar_view(val.Scalar().data(), val.Scalar().size());
-    if (field_has_enable_expression(fds)) {
-      expanded_scalar = expand_expression_impl(scalar_view, 0);
+    if (meta.enable_expression) {
+      expanded_scalar = expand_expression_impl(scalar_view);
       scalar_view = gsl::string_view(expanded_scalar.data(), expanded_scalar.size());
     }
-    if (fds->options().HasExtension(atapp::protocol::CONFIGURE)) {
-      const atapp::protocol::atapp_configure_meta &meta = fds->options().GetExtension(atapp::protocol::CONFIGURE);
-      dump_pick_field_from_str(value, scalar_view, meta.size_mode());
-    } else {
-      dump_pick_field_from_str(value, scalar_view, false);
-    }
+    dump_pick_field_from_str(value, scalar_view, meta.size_mode);
   }
-  if (fds->options().HasExtension(atapp::protocol::CONFIGURE)) {
-    const atapp::protocol::atapp_configure_meta &meta = fds->options().GetExtension(atapp::protocol::CONFIGURE);
-    const std::string &min_val_str = meta.min_value();
-    const std::string &max_val_str = meta.max_value();
-    if (!min_val_str.empty()) {
-      dump_pick_field_from_str(min_value, min_val_str, meta.size_mode());
-    }
-    if (!max_val_str.empty()) {
-      dump_pick_field_from_str(max_value, max_val_str, meta.size_mode());
-    }
+  if (!meta.min_value.empty()) {
+    dump_pick_field_from_str(min_value, meta.min_value, meta.size_mode);
+  }
+  if (!meta.max_value.empty()) {
+    dump_pick_field_from_str(max_value, meta.max_value, meta.size_mode);
   }
 
   if (dump_pick_field_less(value, min_value)) {
@@ -1677,13 +1988,12 @@ static bool dump_pick_field(const YAML::Node &val, ATBUS_MACRO_PROTOBUF_NAMESPAC
       }
       case ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_MESSAGE: {
         // special message
+        const configure_field_meta_t &meta = get_configure_field_meta(fds);
         if (val.IsScalar()) {
-          if (fds->message_type()->full_name() ==
-              ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration::descriptor()->full_name()) {
+          if (meta.special_message == configure_field_meta_t::kDuration) {
             auto value = dump_pick_field_with_extensions<ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration>(val, fds);
             ret = dump_field_with_value(value, dst, fds, dump_existed_set, existed_set_prefix);
-          } else if (fds->message_type()->full_name() ==
-                     ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp::descriptor()->full_name()) {
+          } else if (meta.special_message == configure_field_meta_t::kTimestamp) {
             auto value = dump_pick_field_with_extensions<ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp>(val, fds);
             ret = dump_field_with_value(value, dst, fds, dump_existed_set, existed_set_prefix);
           }
@@ -1705,7 +2015,7 @@ static bool dump_pick_field(const YAML::Node &val, ATBUS_MACRO_PROTOBUF_NAMESPAC
 
             YAML::Node::const_iterator iter = val.begin();
             // Check if the map field itself has enable_expression
-            bool map_enable_expression = field_has_enable_expression(fds);
+            bool map_enable_expression = meta.enable_expression;
             for (; iter != val.end(); ++iter) {
               int index = dst.GetReflection()->FieldSize(dst, fds);
               submsg = dst.GetReflection()->AddMessage(&dst, fds);
@@ -1719,7 +2029,7 @@ static bool dump_pick_field(const YAML::Node &val, ATBUS_MACRO_PROTOBUF_NAMESPAC
 
               if (map_enable_expression && iter->first.IsScalar()) {
                 // Expand map key expression
-                std::string expanded_key = expand_expression_impl(iter->first.Scalar(), 0);
+                std::string expanded_key = expand_expression_impl(iter->first.Scalar());
                 YAML::Node expanded_key_node(expanded_key);
                 if (dump_pick_field(expanded_key_node, *submsg, key_fds, dump_existed_set,
                                     submsg_map_existed_set_key)) {
@@ -1734,7 +2044,7 @@ static bool dump_pick_field(const YAML::Node &val, ATBUS_MACRO_PROTOBUF_NAMESPAC
               if (map_enable_expression && iter->second.IsScalar() &&
                   value_fds->cpp_type() != ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_MESSAGE) {
                 // Expand map value expression
-                std::string expanded_val = expand_expression_impl(iter->second.Scalar(), 0);
+                std::string expanded_val = expand_expression_impl(iter->second.Scalar());
                 YAML::Node expanded_val_node(expanded_val);
                 if (dump_pick_field(expanded_val_node, *submsg, value_fds, dump_existed_set,
                                     submsg_map_existed_set_key)) {
@@ -1841,15 +2151,14 @@ static bool dump_field_item(const YAML::Node &src, ATBUS_MACRO_PROTOBUF_NAMESPAC
 #endif
 
     // 同层级展开
-    if (!fds->is_repeated() && fds->options().HasExtension(atfw::atapp::protocol::CONFIGURE)) {
-      const auto &opt_ext = fds->options().GetExtension(atfw::atapp::protocol::CONFIGURE);
-      const auto &field_match = opt_ext.field_match();
-      if (!field_match.field_name().empty() && !field_match.field_value().empty()) {
-        const YAML::Node field_value_node = src[field_match.field_name()];
+    const configure_field_meta_t &meta = get_configure_field_meta(fds);
+    if (!fds->is_repeated() && meta.has_configure) {
+      if (!meta.field_match_name.empty() && !meta.field_match_value.empty()) {
+        const YAML::Node field_value_node = src[meta.field_match_name];
         if (!field_value_node.IsScalar()) {
           return false;
         }
-        if (field_value_node.Scalar() != field_match.field_value()) {
+        if (field_value_node.Scalar() != meta.field_match_value) {
           return false;
         }
 
@@ -1967,14 +2276,13 @@ static bool dump_environment_pick_field(const std::string &key, ATBUS_MACRO_PROT
       std::string val = atfw::util::file_system::getenv(key.c_str());
       // special message
       if (!val.empty()) {
-        if (fds->message_type()->full_name() ==
-            ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration::descriptor()->full_name()) {
+        const configure_field_meta_t &meta = get_configure_field_meta(fds);
+        if (meta.special_message == configure_field_meta_t::kDuration) {
           auto value = dump_pick_field_with_extensions<ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration>(val, fds);
           if (dump_field_with_value(value, dst, fds, dump_existed_set, existed_set_prefix)) {
             ret = true;
           }
-        } else if (fds->message_type()->full_name() ==
-                   ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp::descriptor()->full_name()) {
+        } else if (meta.special_message == configure_field_meta_t::kTimestamp) {
           auto value = dump_pick_field_with_extensions<ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp>(val, fds);
           if (dump_field_with_value(value, dst, fds, dump_existed_set, existed_set_prefix)) {
             ret = true;
@@ -2081,10 +2389,9 @@ static bool dump_environment_field_item(gsl::string_view prefix, ATBUS_MACRO_PRO
   }
 
   // 同层级展开
-  if (!fds->is_repeated() && fds->options().HasExtension(atfw::atapp::protocol::CONFIGURE)) {
-    const auto &opt_ext = fds->options().GetExtension(atfw::atapp::protocol::CONFIGURE);
-    const auto &field_match = opt_ext.field_match();
-    if (!field_match.field_name().empty() && !field_match.field_value().empty()) {
+  const configure_field_meta_t &meta = get_configure_field_meta(fds);
+  if (!fds->is_repeated() && meta.has_configure) {
+    if (!meta.field_match_name.empty() && !meta.field_match_value.empty()) {
       std::string env_key_prefix;
       env_key_prefix.reserve(prefix.size() + 1 + fds->name().size());
       if (!prefix.empty()) {
@@ -2092,11 +2399,11 @@ static bool dump_environment_field_item(gsl::string_view prefix, ATBUS_MACRO_PRO
         env_key_prefix += "_";
       }
 
-      env_key_prefix += field_match.field_name();
+      env_key_prefix += meta.field_match_name;
       std::transform(env_key_prefix.begin(), env_key_prefix.end(), env_key_prefix.begin(),
                      atfw::util::string::toupper<char>);
       std::string field_value_env = atfw::util::file_system::getenv(env_key_prefix.c_str());
-      if (field_value_env != field_match.field_value()) {
+      if (field_value_env != meta.field_match_value) {
         return false;
       }
 
@@ -2172,6 +2479,24 @@ static bool dump_message_item(const YAML::Node &src, ATBUS_MACRO_PROTOBUF_NAMESP
   return ret;
 }
 
+static bool dump_ini_message_item(const atfw::util::config::ini_value &src,
+                                  ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &dst, configure_key_set *dump_existed_set,
+                                  gsl::string_view existed_set_prefix) {
+  const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Descriptor *desc = dst.GetDescriptor();
+  if (nullptr == desc) {
+    return false;
+  }
+
+  bool ret = false;
+  for (int i = 0; i < desc->field_count(); ++i) {
+    if (dump_field_item(src, dst, desc->field(i), dump_existed_set, existed_set_prefix)) {
+      ret = true;
+    }
+  }
+
+  return ret;
+}
+
 static bool dump_environment_message_item(gsl::string_view prefix, ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &dst,
                                           configure_key_set *dump_existed_set, gsl::string_view existed_set_prefix) {
   const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Descriptor *desc = dst.GetDescriptor();
@@ -2191,7 +2516,25 @@ static bool dump_environment_message_item(gsl::string_view prefix, ATBUS_MACRO_P
 }  // namespace
 
 LIBATAPP_MACRO_API std::string expand_environment_expression(gsl::string_view input) {
-  return expand_expression_impl(input, 0);
+  return expand_expression_refresh(input);
+}
+
+LIBATAPP_MACRO_API uint64_t refresh_environment_expression_generation() {
+  expression_cache_t &cache = get_expression_cache();
+  std::lock_guard<std::mutex> lg(cache.lock);
+  bool changed = false;
+  for (auto &variable : cache.variables) {
+    std::string value = atfw::util::file_system::getenv(variable.first.c_str());
+    if (value != variable.second) {
+      variable.second.swap(value);
+      changed = true;
+    }
+  }
+  if (changed) {
+    reset_expression_environment_generation(cache);
+  }
+
+  return cache.environment_generation.load(std::memory_order_acquire);
 }
 
 LIBATAPP_MACRO_API void parse_timepoint(gsl::string_view in, ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp &out) {
@@ -2205,19 +2548,8 @@ LIBATAPP_MACRO_API void parse_duration(gsl::string_view in, ATBUS_MACRO_PROTOBUF
 LIBATAPP_MACRO_API bool ini_loader_dump_to(const atfw::util::config::ini_value &src,
                                            ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &dst,
                                            configure_key_set *dump_existed_set, gsl::string_view existed_set_prefix) {
-  const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Descriptor *desc = dst.GetDescriptor();
-  if (nullptr == desc) {
-    return false;
-  }
-
-  bool ret = false;
-  for (int i = 0; i < desc->field_count(); ++i) {
-    if (dump_field_item(src, dst, desc->field(i), dump_existed_set, existed_set_prefix)) {
-      ret = true;
-    }
-  }
-
-  return ret;
+  refresh_environment_expression_generation();
+  return dump_ini_message_item(src, dst, dump_existed_set, existed_set_prefix);
 }
 
 LIBATAPP_MACRO_API bool ini_loader_dump_to(const atfw::util::config::ini_value &src,
@@ -2278,6 +2610,7 @@ LIBATAPP_MACRO_API bool ini_loader_dump_to(const atfw::util::config::ini_value &
 
 LIBATAPP_MACRO_API void yaml_loader_dump_to(const YAML::Node &src, ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &dst,
                                             configure_key_set *dump_existed_set, gsl::string_view existed_set_prefix) {
+  refresh_environment_expression_generation();
   dump_message_item(src, dst, dump_existed_set, existed_set_prefix);
 }
 
@@ -2433,11 +2766,13 @@ LIBATAPP_MACRO_API bool environment_loader_dump_to(gsl::string_view prefix,
                                                    ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &dst,
                                                    configure_key_set *dump_existed_set,
                                                    gsl::string_view existed_set_prefix) {
+  refresh_environment_expression_generation();
   return dump_environment_message_item(prefix, dst, dump_existed_set, existed_set_prefix);
 }
 
 LIBATAPP_MACRO_API void default_loader_dump_to(ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &dst,
                                                const configure_key_set &existed_set) {
+  refresh_environment_expression_generation();
   for (int i = 0; i < dst.GetDescriptor()->field_count(); ++i) {
     const auto *fds = dst.GetDescriptor()->field(i);
     if (fds == nullptr) {
@@ -2876,8 +3211,75 @@ bool protobuf_equal_inner_field(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message
 
   return true;
 }
+
+static bool protobuf_diff_inner_message(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &l,
+                                        const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &r,
+                                        configure_key_set &changed_paths, std::string &path) {
+  if (&l == &r) {
+    return false;
+  }
+
+  const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Descriptor *desc = l.GetDescriptor();
+  if (desc != r.GetDescriptor()) {
+    if (!path.empty()) {
+      // Remove the tailing '.'
+      changed_paths.insert(path.substr(0, path.size() - 1));
+    }
+    return true;
+  }
+
+  bool ret = false;
+  size_t prefix_length = path.size();
+  for (int i = 0; i < desc->field_count(); ++i) {
+    const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *fds = desc->field(i);
+    if (nullptr == fds) {
+      continue;
+    }
+
+    // Recursive into sub message and record the path of all changed ancestors
+    if (!fds->is_repeated() && fds->cpp_type() == ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_MESSAGE) {
+      if (!l.GetReflection()->HasField(l, fds) && !r.GetReflection()->HasField(r, fds)) {
+        continue;
+      }
+
+      path.append(fds->name());
+      size_t field_path_length = path.size();
+      path.push_back('.');
+      if (protobuf_diff_inner_message(l.GetReflection()->GetMessage(l, fds), r.GetReflection()->GetMessage(r, fds),
+                                      changed_paths, path)) {
+        path.resize(field_path_length);
+        changed_paths.insert(path);
+        ret = true;
+      }
+      path.resize(prefix_length);
+      continue;
+    }
+
+    if (false == protobuf_equal_inner_field(l, r, fds)) {
+      path.append(fds->name());
+      changed_paths.insert(path);
+      path.resize(prefix_length);
+      ret = true;
+    }
+  }
+
+  return ret;
+}
 }  // namespace
 
+LIBATAPP_MACRO_API bool protobuf_diff(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &l,
+                                      const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &r,
+                                      configure_key_set &changed_paths, gsl::string_view prefix) {
+  std::string path;
+  path.reserve(prefix.size() + 64);
+  path.assign(prefix.data(), prefix.size());
+  if (!path.empty() && path.back() != '.') {
+    path.push_back('.');
+  }
+
+  return protobuf_diff_inner_message(l, r, changed_paths, path);
+}
+
 LIBATAPP_MACRO_API bool protobuf_equal(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &l,
                                        const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &r) {
   return protobuf_equal_inner_message(l, r);
@@ -18,6 +18,7 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/message.h>
 #include <google/protobuf/reflection.h>
 #include <google/protobuf/repeated_field.h>
@@ -43,6 +44,18 @@
 #include <string/tquerystring.h>
 
 #include <cassert>
+#include <memory>
+
+#if defined(RAPIDJSON_SSE42) || defined(RAPIDJSON_SSE2)
+#  include <emmintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  endif
+#  define LIBATAPP_RAPIDJSON_LOADER_URI_SSE2 1
+#elif defined(RAPIDJSON_NEON)
+#  include <arm_neon.h>
+#  define LIBATAPP_RAPIDJSON_LOADER_URI_NEON 1
+#endif
 
 #if defined(ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD) && ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD
 #  include <pthread.h>
@@ -86,8 +99,178 @@ static gsl::span<unsigned char> rapidjson_loader_get_shared_buffer() {
 }
 #endif
 
+using rapidjson_loader_parse_document_t =
+    rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>, rapidjson::MemoryPoolAllocator<>>;
+
+static constexpr const size_t kRapidjsonLoaderParseStackBufferSize = 64 * 1024;
+static constexpr const size_t kRapidjsonLoaderArenaInitialBlockSize = 256 * 1024;
+
+static ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Arena &rapidjson_loader_get_thread_arena() {
+  struct arena_holder_type {
+    std::unique_ptr<char[]> initial_block;
+    std::unique_ptr<ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Arena> arena;
+
+    arena_holder_type() : initial_block(new char[kRapidjsonLoaderArenaInitialBlockSize]) {
+      ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::ArenaOptions options;
+      options.initial_block = initial_block.get();
+      options.initial_block_size = kRapidjsonLoaderArenaInitialBlockSize;
+      arena.reset(new ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Arena(options));
+    }
+
+    ~arena_holder_type() {
+      // Arena must be destroyed before the initial block
+      arena.reset();
+    }
+  };
+
+  static thread_local arena_holder_type holder;
+  return *holder.arena;
+}
+
+static size_t &rapidjson_loader_get_thread_arena_depth() {
+  static thread_local size_t depth = 0;
+  return depth;
+}
+
+static bool rapidjson_loader_parse_document(rapidjson_loader_parse_document_t &doc, const std::string &json) {
+#if defined(LIBATFRAME_UTILS_ENABLE_EXCEPTION) && LIBATFRAME_UTILS_ENABLE_EXCEPTION
+  try {
+#endif
+    doc.Parse(json.c_str(), json.size());
+#if defined(LIBATFRAME_UTILS_ENABLE_EXCEPTION) && LIBATFRAME_UTILS_ENABLE_EXCEPTION
+  } catch (...) {
+    return false;
+  }
+#endif
+
+  if (!doc.IsObject() && !doc.IsArray()) {
+    return false;
+  }
+
+  return true;
+}
+
+// Characters which are never escaped by encode_uri() and encode_uri_component()
+static inline bool rapidjson_loader_is_uri_unreserved(unsigned char c) {
+  unsigned char lower = static_cast<unsigned char>(c | 0x20);
+  return (c >= '0' && c <= '9') || (lower >= 'a' && lower <= 'z') || c == '-' || c == '.' || c == '_' || c == '~';
+}
+
+#if defined(LIBATAPP_RAPIDJSON_LOADER_URI_SSE2)
+static inline size_t rapidjson_loader_count_trailing_zero(uint32_t mask) {
+#  if defined(_MSC_VER)
+  unsigned long ret = 0;
+  _BitScanForward(&ret, mask);
+  return static_cast<size_t>(ret);
+#  else
+  return static_cast<size_t>(__builtin_ctz(mask));
+#  endif
+}
+#endif
+
+/**
+ * @brief Get length of the leading characters which will not be changed by URI escaping
+ */
+static size_t rapidjson_loader_scan_uri_unreserved(const char *input, size_t length) {
+  size_t i = 0;
+#if defined(LIBATAPP_RAPIDJSON_LOADER_URI_SSE2)
+  // Bytes larger than 0x7F are negative in signed comparison, so they are never matched
+  const __m128i digit_lower_bound = _mm_set1_epi8('0' - 1);
+  const __m128i digit_upper_bound = _mm_set1_epi8('9' + 1);
+  const __m128i alpha_lower_bound = _mm_set1_epi8('a' - 1);
+  const __m128i alpha_upper_bound = _mm_set1_epi8('z' + 1);
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  const __m128i mark_minus = _mm_set1_epi8('-');
+  const __m128i mark_dot = _mm_set1_epi8('.');
+  const __m128i mark_underline = _mm_set1_epi8('_');
+  const __m128i mark_tilde = _mm_set1_epi8('~');
+  for (; i + 16 <= length; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    __m128i lower = _mm_or_si128(v, case_bit);
+    __m128i accepted =
+        _mm_or_si128(_mm_and_si128(_mm_cmpgt_epi8(v, digit_lower_bound), _mm_cmplt_epi8(v, digit_upper_bound)),
+                     _mm_and_si128(_mm_cmpgt_epi8(lower, alpha_lower_bound), _mm_cmplt_epi8(lower, alpha_upper_bound)));
+    accepted = _mm_or_si128(accepted, _mm_or_si128(_mm_cmpeq_epi8(v, mark_minus), _mm_cmpeq_epi8(v, mark_dot)));
+    accepted = _mm_or_si128(accepted, _mm_or_si128(_mm_cmpeq_epi8(v, mark_underline), _mm_cmpeq_epi8(v, mark_tilde)));
+
+    uint32_t rejected = static_cast<uint32_t>(~_mm_movemask_epi8(accepted)) & 0xFFFFU;
+    if (0 != rejected) {
+      return i + rapidjson_loader_count_trailing_zero(rejected);
+    }
+  }
+#elif defined(LIBATAPP_RAPIDJSON_LOADER_URI_NEON)
+  const uint8x16_t case_bit = vdupq_n_u8(0x20);
+  for (; i + 16 <= length; i += 16) {
+    uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(input + i));
+    uint8x16_t lower = vorrq_u8(v, case_bit);
+    uint8x16_t accepted = vorrq_u8(vandq_u8(vcgeq_u8(v, vdupq_n_u8('0')), vcleq_u8(v, vdupq_n_u8('9'))),
+                                   vandq_u8(vcgeq_u8(lower, vdupq_n_u8('a')), vcleq_u8(lower, vdupq_n_u8('z'))));
+    accepted = vorrq_u8(accepted, vorrq_u8(vceqq_u8(v, vdupq_n_u8('-')), vceqq_u8(v, vdupq_n_u8('.'))));
+    accepted = vorrq_u8(accepted, vorrq_u8(vceqq_u8(v, vdupq_n_u8('_')), vceqq_u8(v, vdupq_n_u8('~'))));
+
+    uint64x2_t accepted64 = vreinterpretq_u64_u8(accepted);
+    if ((vgetq_lane_u64(accepted64, 0) & vgetq_lane_u64(accepted64, 1)) != UINT64_MAX) {
+      // Find the position by scalar path
+      break;
+    }
+  }
+#endif
+
+  for (; i < length; ++i) {
+    if (!rapidjson_loader_is_uri_unreserved(static_cast<unsigned char>(input[i]))) {
+      break;
+    }
+  }
+
+  return i;
+}
+
+/**
+ * @brief Get position of the first '%' or '+', characters before it will not be changed by URI unescaping
+ */
+static size_t rapidjson_loader_scan_uri_escaped(const char *input, size_t length) {
+  size_t i = 0;
+#if defined(LIBATAPP_RAPIDJSON_LOADER_URI_SSE2)
+  const __m128i mark_percent = _mm_set1_epi8('%');
+  const __m128i mark_plus = _mm_set1_epi8('+');
+  for (; i + 16 <= length; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    uint32_t matched = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, mark_percent), _mm_cmpeq_epi8(v, mark_plus))));
+    if (0 != matched) {
+      return i + rapidjson_loader_count_trailing_zero(matched);
+    }
+  }
+#elif defined(LIBATAPP_RAPIDJSON_LOADER_URI_NEON)
+  const uint8x16_t mark_percent = vdupq_n_u8('%');
+  const uint8x16_t mark_plus = vdupq_n_u8('+');
+  for (; i + 16 <= length; i += 16) {
+    uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(input + i));
+    uint64x2_t matched = vreinterpretq_u64_u8(vorrq_u8(vceqq_u8(v, mark_percent), vceqq_u8(v, mark_plus)));
+    if (0 != (vgetq_lane_u64(matched, 0) | vgetq_lane_u64(matched, 1))) {
+      break;
+    }
+  }
+#endif
+
+  for (; i < length; ++i) {
+    if ('%' == input[i] || '+' == input[i]) {
+      break;
+    }
+  }
+
+  return i;
+}
+
 static void load_field_string_filter(const std::string &input, rapidjson::Value &output, rapidjson::Document &doc,
                                      const rapidjson_loader_load_options &options) {
+  // Most strings need not escaping, copy them directly
+  if (rapidjson_loader_string_mode::kRaw != options.string_mode &&
+      rapidjson_loader_scan_uri_unreserved(input.c_str(), input.size()) >= input.size()) {
+    output.SetString(input.c_str(), static_cast<rapidjson::SizeType>(input.size()), doc.GetAllocator());
+    return;
+  }
+
   switch (options.string_mode) {
     case rapidjson_loader_string_mode::kUri: {
       std::string strv = atfw::util::uri::encode_uri(input.c_str(), input.size());
@@ -543,6 +726,12 @@ static std::string dump_pick_field_string_filter(const rapidjson::Value &val,
     return std::string();
   }
 
+  // Most strings need not unescaping, copy them directly
+  if (rapidjson_loader_string_mode::kRaw != options.string_mode &&
+      rapidjson_loader_scan_uri_escaped(val.GetString(), val.GetStringLength()) >= val.GetStringLength()) {
+    return std::string(val.GetString(), val.GetStringLength());
+  }
+
   switch (options.string_mode) {
     case rapidjson_loader_string_mode::kUri:
       return atfw::util::uri::decode_uri(val.GetString(), val.GetStringLength());
@@ -871,16 +1060,54 @@ LIBATAPP_MACRO_API bool rapidjson_loader_parse(ATBUS_MACRO_PROTOBUF_NAMESPACE_ID
     use_buffer = rapidjson_loader_get_default_shared_buffer();
   }
 
-  rapidjson::MemoryPoolAllocator<> allocator{reinterpret_cast<void *>(use_buffer.data()), use_buffer.size()};
-  rapidjson::Document doc{&allocator};
-  if (!rapidjson_loader_unstringify(doc, src)) {
+  // The parse stack also use the tail of buffer, so parsing in steady state do not allocate from heap
+  if (use_buffer.size() < 4 * kRapidjsonLoaderParseStackBufferSize) {
+    rapidjson::MemoryPoolAllocator<> allocator{reinterpret_cast<void *>(use_buffer.data()), use_buffer.size()};
+    rapidjson_loader_parse_document_t doc{&allocator};
+    if (!rapidjson_loader_parse_document(doc, src)) {
+      return false;
+    }
+
+    if (doc.IsObject()) {
+      rapidjson_loader_dump_to(static_cast<const rapidjson::Value &>(doc), dst, options);
+    }
+    return true;
+  }
+
+  // Keep the stack buffer aligned, the allocator store its header in the buffer
+  size_t value_buffer_size = (use_buffer.size() - kRapidjsonLoaderParseStackBufferSize) & ~static_cast<size_t>(15);
+  rapidjson::MemoryPoolAllocator<> allocator{reinterpret_cast<void *>(use_buffer.data()), value_buffer_size};
+  rapidjson::MemoryPoolAllocator<> stack_allocator{reinterpret_cast<void *>(use_buffer.data() + value_buffer_size),
+                                                   use_buffer.size() - value_buffer_size};
+  rapidjson_loader_parse_document_t doc{&allocator, rapidjson_loader_parse_document_t::kDefaultStackCapacity,
+                                        &stack_allocator};
+  if (!rapidjson_loader_parse_document(doc, src)) {
     return false;
   }
 
-  rapidjson_loader_dump_to(doc, dst, options);
+  if (doc.IsObject()) {
+    rapidjson_loader_dump_to(static_cast<const rapidjson::Value &>(doc), dst, options);
+  }
   return true;
 }
 
+LIBATAPP_MACRO_API rapidjson_loader_arena_scope::rapidjson_loader_arena_scope()
+    : arena_(&rapidjson_loader_get_thread_arena()) {
+  ++rapidjson_loader_get_thread_arena_depth();
+}
+
+LIBATAPP_MACRO_API rapidjson_loader_arena_scope::~rapidjson_loader_arena_scope() {
+  size_t &depth = rapidjson_loader_get_thread_arena_depth();
+  if (depth > 0) {
+    --depth;
+  }
+
+  // Only the outermost scope release messages, the first block is kept and reused by next scope
+  if (0 == depth) {
+    arena_->Reset();
+  }
+}
+
 LIBATAPP_MACRO_API void rapidjson_loader_mutable_set_member(rapidjson::Value &parent, gsl::string_view key,
                                                             rapidjson::Value &&val, rapidjson::Document &doc) {
   if (!parent.IsObject()) {
@@ -0,0 +1,275 @@
+// Copyright 2026 atframework
+//
+// Created by owent
+
+#include "atframe/atapp_conf_snapshot.h"
+
+#include <cstdio>
+#include <string>
+
+LIBATAPP_MACRO_NAMESPACE_BEGIN
+
+namespace {
+static void configure_snapshot_join_path(std::string &path, gsl::string_view name) {
+  if (!path.empty()) {
+    path.push_back('.');
+  }
+  path.append(name.data(), name.size());
+}
+
+static std::string configure_snapshot_format_duration(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration &value) {
+  if (0 == value.nanos()) {
+    return std::to_string(value.seconds()) + "s";
+  }
+
+  int64_t nanos = value.seconds() * 1000000000 + value.nanos();
+  if (0 == nanos % 1000000) {
+    return std::to_string(nanos / 1000000) + "ms";
+  }
+  if (0 == nanos % 1000) {
+    return std::to_string(nanos / 1000) + "us";
+  }
+  return std::to_string(nanos) + "ns";
+}
+
+static std::string configure_snapshot_format_floating(double value, int precision) {
+  char buffer[64] = {0};
+  int len = snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+  if (len <= 0) {
+    return std::string();
+  }
+
+  return std::string(buffer, static_cast<size_t>(len) < sizeof(buffer) ? static_cast<size_t>(len) : sizeof(buffer) - 1);
+}
+
+static std::string configure_snapshot_pick_scalar(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &src,
+                                                  const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *fds,
+                                                  int index) {
+  const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Reflection *reflection = src.GetReflection();
+  bool repeated = fds->is_repeated();
+  switch (fds->cpp_type()) {
+    case ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_INT32:
+      return std::to_string(repeated ? reflection->GetRepeatedInt32(src, fds, index) : reflection->GetInt32(src, fds));
+    case ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_INT64:
+      return std::to_string(repeated ? reflection->GetRepeatedInt64(src, fds, index) : reflection->GetInt64(src, fds));
+    case ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_UINT32:
+      return std::to_string(repeated ? reflection->GetRepeatedUInt32(src, fds, index)
+                                     : reflection->GetUInt32(src, fds));
+    case ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_UINT64:
+      return std::to_string(repeated ? reflection->GetRepeatedUInt64(src, fds, index)
+                                     : reflection->GetUInt64(src, fds));
+    case ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_DOUBLE:
+      return configure_snapshot_format_floating(
+          repeated ? reflection->GetRepeatedDouble(src, fds, index) : reflection->GetDouble(src, fds), 17);
+    case ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_FLOAT:
+      return configure_snapshot_format_floating(
+          repeated ? reflection->GetRepeatedFloat(src, fds, index) : reflection->GetFloat(src, fds), 9);
+    case ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_BOOL:
+      return (repeated ? reflection->GetRepeatedBool(src, fds, index) : reflection->GetBool(src, fds)) ? "true"
+                                                                                                         : "false";
+    case ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_ENUM: {
+      const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::EnumValueDescriptor *value =
+          repeated ? reflection->GetRepeatedEnum(src, fds, index) : reflection->GetEnum(src, fds);
+      return nullptr == value ? std::string() : static_cast<std::string>(value->name());
+    }
+    case ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_STRING:
+      return repeated ? reflection->GetRepeatedString(src, fds, index) : reflection->GetString(src, fds);
+    default:
+      return std::string();
+  }
+}
+}  // namespace
+
+LIBATAPP_MACRO_API configure_snapshot::configure_snapshot(uint64_t generation) : generation_(generation) {}
+
+LIBATAPP_MACRO_API configure_snapshot::~configure_snapshot() {}
+
+LIBATAPP_MACRO_API void configure_snapshot::append(const atfw::util::config::ini_value &src,
+                                                   gsl::string_view prefix) {
+  replaced_paths_.clear();
+  std::string path{prefix.data(), prefix.size()};
+  path.reserve(256);
+  append_ini_value(src, path);
+  replaced_paths_.clear();
+}
+
+LIBATAPP_MACRO_API void configure_snapshot::append(const YAML::Node &src, gsl::string_view prefix) {
+  replaced_paths_.clear();
+  std::string path{prefix.data(), prefix.size()};
+  path.reserve(256);
+  append_yaml_node(src, path);
+  replaced_paths_.clear();
+}
+
+LIBATAPP_MACRO_API void configure_snapshot::append(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &src,
+                                                   gsl::string_view prefix) {
+  replaced_paths_.clear();
+  std::string path{prefix.data(), prefix.size()};
+  path.reserve(256);
+  append_message(src, path);
+  replaced_paths_.clear();
+}
+
+configure_snapshot::value_list_t &configure_snapshot::mutable_values(const std::string &path) {
+  value_list_t &ret = values_[path];
+  // Values from the previous append() are replaced, values from the same append() are merged into array
+  if (replaced_paths_.insert(path).second) {
+    ret.clear();
+  }
+  return ret;
+}
+
+void configure_snapshot::append_ini_value(const atfw::util::config::ini_value &src, std::string &path) {
+  if (src.size() > 0 && !path.empty()) {
+    value_list_t &values = mutable_values(path);
+    for (size_t i = 0; i < src.size(); ++i) {
+      values.push_back(src.as_cpp_string(i));
+    }
+  }
+
+  size_t prefix_length = path.size();
+  for (auto &child : src.get_children()) {
+    if (!child.second) {
+      continue;
+    }
+
+    configure_snapshot_join_path(path, child.first);
+    append_ini_value(*child.second, path);
+    path.resize(prefix_length);
+  }
+}
+
+void configure_snapshot::append_yaml_node(const YAML::Node &src, std::string &path) {
+  if (!src) {
+    return;
+  }
+
+  if (src.IsScalar()) {
+    if (!path.empty()) {
+      mutable_values(path).push_back(src.Scalar());
+    }
+    return;
+  }
+
+  size_t prefix_length = path.size();
+  if (src.IsMap()) {
+    for (YAML::const_iterator iter = src.begin(); iter != src.end(); ++iter) {
+      if (!iter->first.IsScalar()) {
+        continue;
+      }
+
+      configure_snapshot_join_path(path, iter->first.Scalar());
+      append_yaml_node(iter->second, path);
+      path.resize(prefix_length);
+    }
+    return;
+  }
+
+  if (src.IsSequence()) {
+    for (size_t i = 0; i < src.size(); ++i) {
+      const YAML::Node element = src[i];
+      if (element.IsScalar()) {
+        append_yaml_node(element, path);
+        continue;
+      }
+
+      configure_snapshot_join_path(path, std::to_string(i));
+      append_yaml_node(element, path);
+      path.resize(prefix_length);
+    }
+  }
+}
+
+void configure_snapshot::append_message(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &src, std::string &path) {
+  const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Descriptor *desc = src.GetDescriptor();
+  if (nullptr == desc) {
+    return;
+  }
+
+  size_t prefix_length = path.size();
+  for (int i = 0; i < desc->field_count(); ++i) {
+    const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *fds = desc->field(i);
+    if (nullptr == fds) {
+      continue;
+    }
+
+    configure_snapshot_join_path(path, gsl::string_view{fds->name().data(), fds->name().size()});
+    append_field(src, fds, path);
+    path.resize(prefix_length);
+  }
+}
+
+void configure_snapshot::append_field(const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &src,
+                                      const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *fds,
+                                      std::string &path) {
+  const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Reflection *reflection = src.GetReflection();
+  if (fds->cpp_type() != ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor::CPPTYPE_MESSAGE) {
+    if (fds->is_repeated()) {
+      value_list_t &values = mutable_values(path);
+      int size = reflection->FieldSize(src, fds);
+      values.reserve(static_cast<size_t>(size));
+      for (int i = 0; i < size; ++i) {
+        values.push_back(configure_snapshot_pick_scalar(src, fds, i));
+      }
+    } else {
+      mutable_values(path).push_back(configure_snapshot_pick_scalar(src, fds, 0));
+    }
+    return;
+  }
+
+  const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Descriptor *message_desc = fds->message_type();
+  if (fds->is_map()) {
+    // Map entries are written as "<path>.<key>"
+    const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *key_fds = message_desc->map_key();
+    const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::FieldDescriptor *value_fds = message_desc->map_value();
+    size_t prefix_length = path.size();
+    int size = reflection->FieldSize(src, fds);
+    for (int i = 0; i < size; ++i) {
+      const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &entry = reflection->GetRepeatedMessage(src, fds, i);
+      configure_snapshot_join_path(path, configure_snapshot_pick_scalar(entry, key_fds, 0));
+      append_field(entry, value_fds, path);
+      path.resize(prefix_length);
+    }
+    return;
+  }
+
+  if (message_desc->full_name() == ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration::descriptor()->full_name() ||
+      message_desc->full_name() == ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Timestamp::descriptor()->full_name()) {
+    bool is_duration =
+        message_desc->full_name() == ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration::descriptor()->full_name();
+    int size = fds->is_repeated() ? reflection->FieldSize(src, fds) : 1;
+    value_list_t &values = mutable_values(path);
+    for (int i = 0; i < size; ++i) {
+      const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message &value =
+          fds->is_repeated() ? reflection->GetRepeatedMessage(src, fds, i) : reflection->GetMessage(src, fds);
+      const ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Reflection *value_reflection = value.GetReflection();
+      int64_t seconds = value_reflection->GetInt64(value, message_desc->FindFieldByNumber(1));
+      int32_t nanos = value_reflection->GetInt32(value, message_desc->FindFieldByNumber(2));
+      if (is_duration) {
+        ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Duration duration;
+        duration.set_seconds(seconds);
+        duration.set_nanos(nanos);
+        values.push_back(configure_snapshot_format_duration(duration));
+      } else {
+        values.push_back(std::to_string(seconds));
+      }
+    }
+    return;
+  }
+
+  if (fds->is_repeated()) {
+    // Elements of arrays of messages are written as "<path>.<index>"
+    size_t prefix_length = path.size();
+    int size = reflection->FieldSize(src, fds);
+    for (int i = 0; i < size; ++i) {
+      configure_snapshot_join_path(path, std::to_string(i));
+      append_message(reflection->GetRepeatedMessage(src, fds, i), path);
+      path.resize(prefix_length);
+    }
+    return;
+  }
+
+  append_message(reflection->GetMessage(src, fds), path);
+}
+
+LIBATAPP_MACRO_NAMESPACE_END
@@ -0,0 +1,312 @@
+// Copyright 2026 atframework
+//
+// Created by owent
+
+#include "atframe/atapp_log_rate_limit.h"
+
+#include <atframe/atapp_conf.h>
+
+#include <algorithm>
+#include <limits>
+
+LIBATAPP_MACRO_NAMESPACE_BEGIN
+
+namespace {
+// Tokens of buckets without limit, large enough to never be consumed between two ticks
+static constexpr const int64_t kLogRateLimitUnlimited = (std::numeric_limits<int64_t>::max)() / 2;
+static constexpr const int64_t kLogRateLimitMicrosecondsPerSecond = 1000000;
+// Buckets are full after this time, also avoid overflow
+static constexpr const int64_t kLogRateLimitMaxRefillMicroseconds = 10 * kLogRateLimitMicrosecondsPerSecond;
+
+static int64_t log_rate_limit_get_burst(const log_rate_limiter::limit_type &limit) noexcept {
+  if (0 == limit.rate) {
+    return kLogRateLimitUnlimited;
+  }
+
+  return static_cast<int64_t>(limit.burst > 0 ? limit.burst : limit.rate);
+}
+
+static void log_rate_limit_reset_bucket(log_rate_limiter::bucket_type &bucket,
+                                        const log_rate_limiter::limit_type &limit) noexcept {
+  bucket.tokens.store(log_rate_limit_get_burst(limit), std::memory_order_relaxed);
+  bucket.refill_remainder = 0;
+}
+
+static void log_rate_limit_refill_bucket(log_rate_limiter::bucket_type &bucket,
+                                         const log_rate_limiter::limit_type &limit, int64_t elapsed_us) noexcept {
+  int64_t burst = log_rate_limit_get_burst(limit);
+  if (0 == limit.rate) {
+    bucket.tokens.store(burst, std::memory_order_relaxed);
+    return;
+  }
+
+  int64_t total = bucket.refill_remainder + static_cast<int64_t>(limit.rate) * elapsed_us;
+  int64_t add_tokens = total / kLogRateLimitMicrosecondsPerSecond;
+  bucket.refill_remainder = total % kLogRateLimitMicrosecondsPerSecond;
+  if (0 == add_tokens) {
+    return;
+  }
+
+  int64_t current = bucket.tokens.load(std::memory_order_relaxed);
+  int64_t target;
+  do {
+    // Tokens may be negative after logs are suppressed, debts are not kept
+    target = (std::min)(burst, (std::max)(current, static_cast<int64_t>(0)) + add_tokens);
+  } while (!bucket.tokens.compare_exchange_weak(current, target, std::memory_order_relaxed));
+}
+}  // namespace
+
+LIBATAPP_MACRO_API log_rate_limiter::options_type::options_type() noexcept
+    : category{0, 0}, call_site{0, 0}, summary_interval(std::chrono::seconds{10}) {}
+
+LIBATAPP_MACRO_API log_rate_limiter::bucket_type::bucket_type() noexcept
+    : tokens(kLogRateLimitUnlimited), suppressed(0), refill_remainder(0) {}
+
+LIBATAPP_MACRO_API log_rate_limiter::call_site::call_site(const char *file_path, uint32_t line_number,
+                                                          int32_t category) noexcept
+    : file_path_(file_path), line_number_(line_number), category_(category) {
+  log_rate_limiter::instance().add_call_site(this);
+}
+
+LIBATAPP_MACRO_API log_rate_limiter::call_site::~call_site() { log_rate_limiter::instance().remove_call_site(this); }
+
+LIBATAPP_MACRO_API log_rate_limiter &log_rate_limiter::instance() {
+  static log_rate_limiter ret;
+  return ret;
+}
+
+log_rate_limiter::log_rate_limiter() : summarized_count_(0) {
+  for (auto &category : categories_) {
+    category.enabled = false;
+    category.owner = nullptr;
+  }
+}
+
+log_rate_limiter::~log_rate_limiter() {}
+
+LIBATAPP_MACRO_API void log_rate_limiter::set_options(int32_t category, const options_type &options) {
+  if (category < 0 || category >= kCategoryCount) {
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock_guard{lock_};
+  category_type &category_data = categories_[category];
+  category_data.options = options;
+  if (category_data.options.summary_interval <= std::chrono::steady_clock::duration::zero()) {
+    category_data.options.summary_interval = std::chrono::seconds{10};
+  }
+  category_data.enabled = options.category.rate > 0 || options.call_site.rate > 0;
+  if (category_data.last_summary == std::chrono::steady_clock::time_point()) {
+    category_data.last_summary = std::chrono::steady_clock::now();
+  }
+
+  log_rate_limit_reset_bucket(category_data.bucket, category_data.options.category);
+  for (auto &site : call_sites_) {
+    if (site->category_ == category) {
+      log_rate_limit_reset_bucket(site->bucket_, category_data.options.call_site);
+    }
+  }
+}
+
+LIBATAPP_MACRO_API void log_rate_limiter::set_options(int32_t category, const protocol::atapp_log_rate_limit &conf) {
+  set_options(category, make_options(conf));
+}
+
+LIBATAPP_MACRO_API log_rate_limiter::options_type log_rate_limiter::make_options(
+    const protocol::atapp_log_rate_limit &conf) {
+  options_type options;
+  options.category.rate = conf.category_rate();
+  options.category.burst = conf.category_burst();
+  options.call_site.rate = conf.call_site_rate();
+  options.call_site.burst = conf.call_site_burst();
+  if (conf.summary_interval().seconds() > 0 || conf.summary_interval().nanos() > 0) {
+    options.summary_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::seconds{conf.summary_interval().seconds()} +
+        std::chrono::nanoseconds{conf.summary_interval().nanos()});
+  }
+
+  return options;
+}
+
+LIBATAPP_MACRO_API log_rate_limiter::options_type log_rate_limiter::get_options(int32_t category) const {
+  if (category < 0 || category >= kCategoryCount) {
+    return options_type();
+  }
+
+  std::lock_guard<std::recursive_mutex> lock_guard{lock_};
+  return categories_[category].options;
+}
+
+LIBATAPP_MACRO_API void log_rate_limiter::set_logger(int32_t category,
+                                                     const atfw::util::log::log_wrapper::ptr_t &logger) {
+  if (category < atfw::util::log::log_wrapper::categorize_t::MAX || category >= kCategoryCount) {
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock_guard{lock_};
+  categories_[category].logger = logger;
+}
+
+LIBATAPP_MACRO_API bool log_rate_limiter::set_extra_category(int32_t category, const void *owner,
+                                                             const options_type &options,
+                                                             const atfw::util::log::log_wrapper::ptr_t &logger) {
+  if (category < atfw::util::log::log_wrapper::categorize_t::MAX || category >= kCategoryCount ||
+      nullptr == owner) {
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock_guard{lock_};
+  category_type &category_data = categories_[category];
+  if (nullptr != category_data.owner && owner != category_data.owner) {
+    return false;
+  }
+
+  category_data.owner = owner;
+  category_data.logger = logger;
+  set_options(category, options);
+  return true;
+}
+
+LIBATAPP_MACRO_API void log_rate_limiter::release_extra_category(int32_t category, const void *owner) {
+  if (category < atfw::util::log::log_wrapper::categorize_t::MAX || category >= kCategoryCount ||
+      nullptr == owner) {
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock_guard{lock_};
+  category_type &category_data = categories_[category];
+  if (owner != category_data.owner) {
+    return;
+  }
+
+  category_data.owner = nullptr;
+  category_data.logger.reset();
+  set_options(category, options_type());
+}
+
+LIBATAPP_MACRO_API int32_t log_rate_limiter::tick(std::chrono::steady_clock::time_point now) {
+  std::lock_guard<std::recursive_mutex> lock_guard{lock_};
+
+  int64_t elapsed_us = 0;
+  if (last_tick_ != std::chrono::steady_clock::time_point() && now > last_tick_) {
+    elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(now - last_tick_).count();
+  }
+  if (now > last_tick_) {
+    last_tick_ = now;
+  }
+  if (elapsed_us > kLogRateLimitMaxRefillMicroseconds) {
+    elapsed_us = kLogRateLimitMaxRefillMicroseconds;
+  }
+
+  int32_t ret = 0;
+  bool summary_categories[kCategoryCount];
+  std::chrono::steady_clock::duration summary_intervals[kCategoryCount];
+  for (int32_t i = 0; i < kCategoryCount; ++i) {
+    category_type &category_data = categories_[i];
+    summary_categories[i] = false;
+    if (!category_data.enabled) {
+      continue;
+    }
+
+    log_rate_limit_refill_bucket(category_data.bucket, category_data.options.category, elapsed_us);
+    if (now - category_data.last_summary < category_data.options.summary_interval) {
+      continue;
+    }
+
+    summary_categories[i] = true;
+    summary_intervals[i] = now - category_data.last_summary;
+    category_data.last_summary = now;
+
+    uint64_t suppressed = category_data.bucket.suppressed.exchange(0, std::memory_order_relaxed);
+    if (suppressed > 0) {
+      ret += write_summary(i, suppressed, nullptr, summary_intervals[i]);
+    }
+  }
+
+  for (auto &site : call_sites_) {
+    if (site->category_ < 0 || site->category_ >= kCategoryCount) {
+      continue;
+    }
+
+    category_type &category_data = categories_[site->category_];
+    if (!category_data.enabled) {
+      continue;
+    }
+
+    log_rate_limit_refill_bucket(site->bucket_, category_data.options.call_site, elapsed_us);
+    if (!summary_categories[site->category_]) {
+      continue;
+    }
+
+    uint64_t suppressed = site->bucket_.suppressed.exchange(0, std::memory_order_relaxed);
+    if (suppressed > 0) {
+      ret += write_summary(site->category_, suppressed, site, summary_intervals[site->category_]);
+    }
+  }
+
+  return ret;
+}
+
+LIBATAPP_MACRO_API uint64_t log_rate_limiter::get_suppressed_count() const noexcept {
+  std::lock_guard<std::recursive_mutex> lock_guard{lock_};
+
+  uint64_t ret = summarized_count_.load(std::memory_order_relaxed);
+  for (auto &category_data : categories_) {
+    ret += category_data.bucket.suppressed.load(std::memory_order_relaxed);
+  }
+  for (auto &site : call_sites_) {
+    ret += site->bucket_.suppressed.load(std::memory_order_relaxed);
+  }
+  return ret;
+}
+
+void log_rate_limiter::add_call_site(call_site *site) {
+  if (nullptr == site) {
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock_guard{lock_};
+  call_sites_.push_back(site);
+  if (site->category_ >= 0 && site->category_ < kCategoryCount) {
+    log_rate_limit_reset_bucket(site->bucket_, categories_[site->category_].options.call_site);
+  }
+}
+
+void log_rate_limiter::remove_call_site(call_site *site) {
+  std::lock_guard<std::recursive_mutex> lock_guard{lock_};
+  auto iter = std::find(call_sites_.begin(), call_sites_.end(), site);
+  if (iter != call_sites_.end()) {
+    summarized_count_.fetch_add(site->bucket_.suppressed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    *iter = call_sites_.back();
+    call_sites_.pop_back();
+  }
+}
+
+int32_t log_rate_limiter::write_summary(int32_t category, uint64_t suppressed, const call_site *site,
+                                        std::chrono::steady_clock::duration interval) {
+  summarized_count_.fetch_add(suppressed, std::memory_order_relaxed);
+
+  atfw::util::log::log_wrapper *logger = nullptr;
+  if (category < atfw::util::log::log_wrapper::categorize_t::MAX) {
+    logger = WLOG_GETCAT(category);
+  } else if (categories_[category].logger) {
+    logger = categories_[category].logger.get();
+  } else {
+    logger = WLOG_GETCAT(atfw::util::log::log_wrapper::categorize_t::DEFAULT);
+  }
+  if (nullptr == logger || !logger->check_level(atfw::util::log::log_level::kWarning)) {
+    return 0;
+  }
+
+  int64_t interval_ms = std::chrono::duration_cast<std::chrono::milliseconds>(interval).count();
+  if (nullptr == site) {
+    FWINSTLOGWARNING(*logger, "Suppressed {} log(s) of category {} by rate limit in last {}ms", suppressed, category,
+                     interval_ms);
+  } else {
+    FWINSTLOGWARNING(*logger, "Suppressed {} log(s) from {}:{} by rate limit in last {}ms", suppressed,
+                     site->file_path_, site->line_number_, interval_ms);
+  }
+  return 1;
+}
+
+LIBATAPP_MACRO_NAMESPACE_END
@@ -0,0 +1,540 @@
+// Copyright 2026 atframework
+//
+// Created by owent
+
+#include "atframe/atapp_log_sink_async_file.h"
+
+#include <common/string_oprs.h>
+#include <config/compiler_features.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+LIBATAPP_MACRO_NAMESPACE_BEGIN
+
+namespace {
+
+struct async_log_record_header {
+  uint32_t length;
+  int32_t level;
+};
+
+/**
+ * @brief Single producer single consumer byte ring buffer, producer is the logging thread and consumer is the writer
+ * @note head_ and tail_ are monotonic counters, the used size is always tail_ - head_
+ */
+class async_log_ring {
+ public:
+  explicit async_log_ring(size_t capacity)
+      : buffer_(capacity), mask_(capacity - 1), closed_(false), head_(0), producer_cached_head_(0), tail_(0) {}
+
+  ATFW_UTIL_FORCEINLINE size_t capacity() const noexcept { return buffer_.size(); }
+
+  ATFW_UTIL_FORCEINLINE size_t used() const noexcept {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+  ATFW_UTIL_FORCEINLINE bool is_closed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+  void close() noexcept {
+    closed_.store(true, std::memory_order_release);
+    std::vector<char> empty_buffer;
+    buffer_.swap(empty_buffer);
+  }
+
+  // Called by producer only
+  bool push(int32_t level, const char *data, size_t length) noexcept {
+    size_t need = sizeof(async_log_record_header) + length;
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (need > capacity() - (tail - producer_cached_head_)) {
+      producer_cached_head_ = head_.load(std::memory_order_acquire);
+      if (need > capacity() - (tail - producer_cached_head_)) {
+        return false;
+      }
+    }
+
+    async_log_record_header header;
+    header.length = static_cast<uint32_t>(length);
+    header.level = level;
+    copy_in(tail, &header, sizeof(header));
+    copy_in(tail + sizeof(header), data, length);
+    tail_.store(tail + need, std::memory_order_release);
+    return true;
+  }
+
+  // Called by consumer only
+  size_t drain(std::string &output, int32_t &min_level, size_t max_batch_size) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    size_t ret = 0;
+    while (head < tail && output.size() < max_batch_size) {
+      async_log_record_header header;
+      copy_out(head, &header, sizeof(header));
+
+      // Records are joined by line break, the file backend will append the last one
+      if (!output.empty()) {
+        output.push_back('\n');
+      }
+      size_t offset = output.size();
+      output.resize(offset + header.length);
+      copy_out(head + sizeof(header), &output[offset], header.length);
+
+      if (header.level < min_level) {
+        min_level = header.level;
+      }
+      head += sizeof(header) + header.length;
+      ++ret;
+    }
+
+    head_.store(head, std::memory_order_release);
+    return ret;
+  }
+
+ private:
+  void copy_in(size_t position, const void *data, size_t length) noexcept {
+    size_t offset = position & mask_;
+    size_t first = (std::min)(length, capacity() - offset);
+    memcpy(&buffer_[offset], data, first);
+    if (first < length) {
+      memcpy(&buffer_[0], reinterpret_cast<const char *>(data) + first, length - first);
+    }
+  }
+
+  void copy_out(size_t position, void *data, size_t length) const noexcept {
+    size_t offset = position & mask_;
+    size_t first = (std::min)(length, capacity() - offset);
+    memcpy(data, &buffer_[offset], first);
+    if (first < length) {
+      memcpy(reinterpret_cast<char *>(data) + first, &buffer_[0], length - first);
+    }
+  }
+
+ private:
+  std::vector<char> buffer_;
+  size_t mask_;
+  std::atomic<bool> closed_;
+
+  // Written by consumer
+  alignas(64) std::atomic<size_t> head_;
+  // Written by producer
+  alignas(64) size_t producer_cached_head_;
+  std::atomic<size_t> tail_;
+};
+
+struct async_log_thread_cache {
+  uint64_t last_context_id = 0;
+  async_log_ring *last_ring = nullptr;
+  std::unordered_map<uint64_t, std::shared_ptr<async_log_ring>> rings;
+};
+
+static async_log_thread_cache &get_async_log_thread_cache() {
+  static thread_local async_log_thread_cache ret;
+  return ret;
+}
+
+struct async_log_stats_counters {
+  std::atomic<uint64_t> pushed_records{0};
+  std::atomic<uint64_t> written_records{0};
+  std::atomic<uint64_t> written_batches{0};
+  std::atomic<uint64_t> written_bytes{0};
+  std::atomic<uint64_t> dropped_records{0};
+  std::atomic<uint64_t> sampled_out_records{0};
+  std::atomic<uint64_t> truncated_records{0};
+  std::atomic<uint64_t> blocked_times{0};
+
+  void add(std::atomic<uint64_t> async_log_stats_counters::*field, uint64_t value) noexcept {
+    (this->*field).fetch_add(value, std::memory_order_relaxed);
+  }
+
+  log_sink_async_file_backend::stats_type load() const noexcept {
+    log_sink_async_file_backend::stats_type ret;
+    ret.pushed_records = pushed_records.load(std::memory_order_relaxed);
+    ret.written_records = written_records.load(std::memory_order_relaxed);
+    ret.written_batches = written_batches.load(std::memory_order_relaxed);
+    ret.written_bytes = written_bytes.load(std::memory_order_relaxed);
+    ret.dropped_records = dropped_records.load(std::memory_order_relaxed);
+    ret.sampled_out_records = sampled_out_records.load(std::memory_order_relaxed);
+    ret.truncated_records = truncated_records.load(std::memory_order_relaxed);
+    ret.blocked_times = blocked_times.load(std::memory_order_relaxed);
+    return ret;
+  }
+};
+
+static async_log_stats_counters &get_async_log_global_stats() {
+  static async_log_stats_counters ret;
+  return ret;
+}
+
+static uint64_t allocate_async_log_context_id() {
+  static std::atomic<uint64_t> allocator{0};
+  return allocator.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+static size_t round_up_async_log_buffer_size(size_t input) {
+  size_t ret = 4096;
+  while (ret < input && ret < (static_cast<size_t>(1) << 30)) {
+    ret <<= 1;
+  }
+  return ret;
+}
+
+}  // namespace
+
+struct log_sink_async_file_backend::context_type {
+  uint64_t id;
+  options_type options;
+  atfw::util::log::log_sink_file_backend file_backend;
+
+  std::mutex rings_lock;
+  std::vector<std::shared_ptr<async_log_ring>> rings;
+  std::atomic<uint64_t> rings_version;
+
+  std::mutex waker_lock;
+  std::condition_variable waker_cv;
+  std::condition_variable drained_cv;
+  std::atomic<bool> wake_pending;
+  std::atomic<uint32_t> blocking_waiters;
+  std::atomic<bool> stopping;
+  std::atomic<uint64_t> flush_requested;
+  std::atomic<uint64_t> flush_finished;
+  std::atomic<uint64_t> sample_sequence;
+  std::thread writer;
+
+  async_log_stats_counters stats;
+
+  context_type(atfw::util::log::log_sink_file_backend &&backend, const options_type &opts)
+      : id(allocate_async_log_context_id()),
+        options(opts),
+        file_backend(std::move(backend)),
+        rings_version(0),
+        wake_pending(false),
+        blocking_waiters(0),
+        stopping(false),
+        flush_requested(0),
+        flush_finished(0),
+        sample_sequence(0) {
+    options.buffer_size = round_up_async_log_buffer_size(options.buffer_size);
+    if (0 == options.sample_rate) {
+      options.sample_rate = 1;
+    }
+    if (options.writer_interval <= std::chrono::microseconds::zero()) {
+      options.writer_interval = std::chrono::milliseconds{10};
+    }
+    if (0 == options.max_batch_size) {
+      options.max_batch_size = 256 * 1024;
+    }
+
+    writer = std::thread([this]() { run_writer(); });
+  }
+
+  ~context_type() {
+    {
+      std::lock_guard<std::mutex> lg{waker_lock};
+      stopping.store(true, std::memory_order_release);
+    }
+    waker_cv.notify_all();
+    drained_cv.notify_all();
+    if (writer.joinable()) {
+      writer.join();
+    }
+
+    // Producers hold context when pushing, so no one can access these rings now. Release the memory and let
+    //   threads clean their cache when they register rings next time
+    std::lock_guard<std::mutex> lg{rings_lock};
+    for (auto &ring : rings) {
+      if (ring) {
+        ring->close();
+      }
+    }
+    rings.clear();
+  }
+
+  void add_stats(std::atomic<uint64_t> async_log_stats_counters::*field, uint64_t value = 1) noexcept {
+    stats.add(field, value);
+    get_async_log_global_stats().add(field, value);
+  }
+
+  async_log_ring *mutable_thread_ring() {
+    async_log_thread_cache &cache = get_async_log_thread_cache();
+    if (cache.last_context_id == id && nullptr != cache.last_ring) {
+      return cache.last_ring;
+    }
+
+    auto iter = cache.rings.find(id);
+    if (iter == cache.rings.end()) {
+      // Remove rings of destroyed sinks
+      for (auto clean_iter = cache.rings.begin(); clean_iter != cache.rings.end();) {
+        if (!clean_iter->second || clean_iter->second->is_closed()) {
+          clean_iter = cache.rings.erase(clean_iter);
+        } else {
+          ++clean_iter;
+        }
+      }
+
+      std::shared_ptr<async_log_ring> ring = std::make_shared<async_log_ring>(options.buffer_size);
+      {
+        std::lock_guard<std::mutex> lg{rings_lock};
+        rings.push_back(ring);
+        rings_version.fetch_add(1, std::memory_order_release);
+      }
+      iter = cache.rings.insert(std::make_pair(id, std::move(ring))).first;
+    }
+
+    cache.last_context_id = id;
+    cache.last_ring = iter->second.get();
+    return cache.last_ring;
+  }
+
+  void wakeup_writer() {
+    if (!wake_pending.exchange(true, std::memory_order_acq_rel)) {
+      waker_cv.notify_one();
+    }
+  }
+
+  void push(int32_t level, atfw::util::nostd::string_view content) {
+    async_log_ring *ring = mutable_thread_ring();
+
+    const char *data = content.data();
+    size_t length = content.size();
+    // Never let one record use more than half of the buffer
+    size_t max_length = ring->capacity() / 2 - sizeof(async_log_record_header);
+    if (length > max_length) {
+      length = max_length;
+      add_stats(&async_log_stats_counters::truncated_records);
+    }
+
+    if (overflow_policy::kSample == options.policy && ring->used() >= ring->capacity() / 4 * 3) {
+      if (0 != sample_sequence.fetch_add(1, std::memory_order_relaxed) % options.sample_rate) {
+        add_stats(&async_log_stats_counters::sampled_out_records);
+        wakeup_writer();
+        return;
+      }
+    }
+
+    if (ring->push(level, data, length)) {
+      add_stats(&async_log_stats_counters::pushed_records);
+      if (ring->used() >= ring->capacity() / 2) {
+        wakeup_writer();
+      }
+      return;
+    }
+
+    if (overflow_policy::kBlock != options.policy) {
+      add_stats(&async_log_stats_counters::dropped_records);
+      wakeup_writer();
+      return;
+    }
+
+    add_stats(&async_log_stats_counters::blocked_times);
+    blocking_waiters.fetch_add(1, std::memory_order_acq_rel);
+    bool pushed = false;
+    while (!stopping.load(std::memory_order_acquire)) {
+      wakeup_writer();
+      {
+        std::unique_lock<std::mutex> lk{waker_lock};
+        drained_cv.wait_for(lk, options.writer_interval);
+      }
+      if (ring->push(level, data, length)) {
+        pushed = true;
+        break;
+      }
+    }
+    blocking_waiters.fetch_sub(1, std::memory_order_acq_rel);
+
+    if (pushed) {
+      add_stats(&async_log_stats_counters::pushed_records);
+    } else {
+      add_stats(&async_log_stats_counters::dropped_records);
+    }
+  }
+
+  void write_batch(std::string &batch, int32_t min_level, size_t records) {
+    if (records == 0) {
+      return;
+    }
+
+    atfw::util::log::log_wrapper::caller_info_t caller(static_cast<atfw::util::log::log_level>(min_level), "", "", 0,
+                                                       "");
+    file_backend(caller, atfw::util::nostd::string_view{batch.data(), batch.size()});
+
+    add_stats(&async_log_stats_counters::written_records, records);
+    add_stats(&async_log_stats_counters::written_batches);
+    add_stats(&async_log_stats_counters::written_bytes, batch.size() + 1);
+    batch.clear();
+  }
+
+  void drain_all(std::vector<std::shared_ptr<async_log_ring>> &snapshot, uint64_t &snapshot_version,
+                 std::string &batch) {
+    if (snapshot_version != rings_version.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> lg{rings_lock};
+      snapshot = rings;
+      snapshot_version = rings_version.load(std::memory_order_acquire);
+    }
+
+    int32_t min_level = INT32_MAX;
+    size_t records = 0;
+    bool has_more = true;
+    while (has_more) {
+      has_more = false;
+      for (auto &ring : snapshot) {
+        if (!ring) {
+          continue;
+        }
+
+        records += ring->drain(batch, min_level, options.max_batch_size);
+        if (batch.size() >= options.max_batch_size) {
+          write_batch(batch, min_level, records);
+          min_level = INT32_MAX;
+          records = 0;
+          has_more = true;
+        }
+      }
+    }
+
+    write_batch(batch, min_level, records);
+
+    release_exited_rings(snapshot, snapshot_version);
+  }
+
+  // When a thread exits, its ring is only referenced by rings and the snapshot of writer. No one can push into it any
+  //   more, so it can be released after all of its logs are written.
+  void release_exited_rings(std::vector<std::shared_ptr<async_log_ring>> &snapshot, uint64_t &snapshot_version) {
+    bool has_exited_ring = false;
+    for (auto &ring : snapshot) {
+      if (ring && ring.use_count() <= 2 && 0 == ring->used()) {
+        has_exited_ring = true;
+        break;
+      }
+    }
+    if (!has_exited_ring) {
+      return;
+    }
+
+    snapshot.clear();
+    std::lock_guard<std::mutex> lg{rings_lock};
+    rings.erase(std::remove_if(rings.begin(), rings.end(),
+                               [](const std::shared_ptr<async_log_ring> &ring) {
+                                 return !ring || (ring.use_count() == 1 && 0 == ring->used());
+                               }),
+                rings.end());
+    snapshot = rings;
+    snapshot_version = rings_version.fetch_add(1, std::memory_order_acq_rel) + 1;
+  }
+
+  size_t get_ring_count() {
+    std::lock_guard<std::mutex> lg{rings_lock};
+    return rings.size();
+  }
+
+  void run_writer() {
+    std::vector<std::shared_ptr<async_log_ring>> snapshot;
+    uint64_t snapshot_version = 0;
+    std::string batch;
+    batch.reserve(options.max_batch_size + 4096);
+
+    while (true) {
+      bool is_stopping = stopping.load(std::memory_order_acquire);
+      uint64_t flush_target = flush_requested.load(std::memory_order_acquire);
+      wake_pending.store(false, std::memory_order_release);
+
+      drain_all(snapshot, snapshot_version, batch);
+
+      {
+        std::unique_lock<std::mutex> lk{waker_lock};
+        flush_finished.store(flush_target, std::memory_order_release);
+        if (blocking_waiters.load(std::memory_order_acquire) > 0 || flush_target > 0) {
+          drained_cv.notify_all();
+        }
+
+        if (is_stopping) {
+          break;
+        }
+
+        waker_cv.wait_for(lk, options.writer_interval, [this, flush_target]() {
+          return stopping.load(std::memory_order_acquire) || wake_pending.load(std::memory_order_acquire) ||
+                 flush_requested.load(std::memory_order_acquire) != flush_target;
+        });
+      }
+    }
+  }
+
+  bool flush(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lk{waker_lock};
+    uint64_t target = flush_requested.fetch_add(1, std::memory_order_acq_rel) + 1;
+    waker_cv.notify_one();
+    return drained_cv.wait_for(lk, timeout, [this, target]() {
+      return stopping.load(std::memory_order_acquire) || flush_finished.load(std::memory_order_acquire) >= target;
+    });
+  }
+};
+
+LIBATAPP_MACRO_API log_sink_async_file_backend::options_type::options_type() noexcept
+    : buffer_size(1024 * 1024),
+      policy(overflow_policy::kDrop),
+      sample_rate(16),
+      writer_interval(std::chrono::milliseconds{10}),
+      max_batch_size(256 * 1024) {}
+
+LIBATAPP_MACRO_API log_sink_async_file_backend::log_sink_async_file_backend(
+    atfw::util::log::log_sink_file_backend file_backend, const options_type &options)
+    : context_(std::make_shared<context_type>(std::move(file_backend), options)) {}
+
+LIBATAPP_MACRO_API void log_sink_async_file_backend::operator()(
+    const atfw::util::log::log_wrapper::caller_info_t &caller, atfw::util::nostd::string_view content) {
+  if (!context_) {
+    return;
+  }
+
+  context_->push(static_cast<int32_t>(caller.level_id), content);
+}
+
+LIBATAPP_MACRO_API bool log_sink_async_file_backend::flush(std::chrono::milliseconds timeout) {
+  if (!context_) {
+    return true;
+  }
+
+  return context_->flush(timeout);
+}
+
+LIBATAPP_MACRO_API log_sink_async_file_backend::stats_type log_sink_async_file_backend::get_stats() const noexcept {
+  if (!context_) {
+    return async_log_stats_counters().load();
+  }
+
+  return context_->stats.load();
+}
+
+LIBATAPP_MACRO_API size_t log_sink_async_file_backend::get_thread_ring_count() const {
+  if (!context_) {
+    return 0;
+  }
+
+  return context_->get_ring_count();
+}
+
+LIBATAPP_MACRO_API log_sink_async_file_backend::stats_type log_sink_async_file_backend::get_global_stats() noexcept {
+  return get_async_log_global_stats().load();
+}
+
+LIBATAPP_MACRO_API log_sink_async_file_backend::overflow_policy log_sink_async_file_backend::parse_overflow_policy(
+    gsl::string_view name) noexcept {
+  if (name.size() == 5 && 0 == UTIL_STRFUNC_STRNCASE_CMP(name.data(), "block", 5)) {
+    return overflow_policy::kBlock;
+  }
+
+  if (name.size() == 6 && 0 == UTIL_STRFUNC_STRNCASE_CMP(name.data(), "sample", 6)) {
+    return overflow_policy::kSample;
+  }
+
+  return overflow_policy::kDrop;
+}
+
+LIBATAPP_MACRO_NAMESPACE_END
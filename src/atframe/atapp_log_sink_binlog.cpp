@@ -0,0 +1,648 @@
+// Copyright 2026 atframework
+//
+// Created by owent
+
+#include "atframe/atapp_log_sink_binlog.h"
+
+#include <common/file_system.h>
+#include <config/compiler_features.h>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+LIBATAPP_MACRO_NAMESPACE_BEGIN
+
+namespace {
+static constexpr const char kBinlogMagic[] = "ATBINLOG";
+static constexpr size_t kBinlogMagicSize = sizeof(kBinlogMagic) - 1;
+static constexpr uint8_t kBinlogVersion = 1;
+static constexpr size_t kBinlogHeaderSize = kBinlogMagicSize + 4;
+
+// caller_info_t may use const char* or string_view for names
+ATFW_UTIL_FORCEINLINE static gsl::string_view binlog_to_view(const char *input) noexcept {
+  if (nullptr == input) {
+    return gsl::string_view{};
+  }
+  return gsl::string_view{input, strlen(input)};
+}
+
+template <class TVIEW>
+ATFW_UTIL_FORCEINLINE static gsl::string_view binlog_to_view(const TVIEW &input) noexcept {
+  return gsl::string_view{input.data(), input.size()};
+}
+
+static void binlog_append_varint(std::string &output, uint64_t value) {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<char>(value));
+}
+
+static void binlog_append_string(std::string &output, gsl::string_view value) {
+  binlog_append_varint(output, static_cast<uint64_t>(value.size()));
+  output.append(value.data(), value.size());
+}
+
+ATFW_UTIL_FORCEINLINE static uint64_t binlog_zigzag_encode(int64_t value) noexcept {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+ATFW_UTIL_FORCEINLINE static int64_t binlog_zigzag_decode(uint64_t value) noexcept {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+static bool binlog_read_varint(gsl::string_view data, size_t &offset, uint64_t &output) noexcept {
+  output = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (offset >= data.size()) {
+      return false;
+    }
+    uint8_t c = static_cast<uint8_t>(data[offset++]);
+    output |= static_cast<uint64_t>(c & 0x7F) << shift;
+    if (0 == (c & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool binlog_read_string(gsl::string_view data, size_t &offset, gsl::string_view &output) noexcept {
+  uint64_t length = 0;
+  if (!binlog_read_varint(data, offset, length)) {
+    return false;
+  }
+  if (length > data.size() - offset) {
+    return false;
+  }
+  output = gsl::string_view{data.data() + offset, static_cast<size_t>(length)};
+  offset += static_cast<size_t>(length);
+  return true;
+}
+
+// Get modification time in nanoseconds(seconds on platforms without sub-second precision) and size of a file
+static bool binlog_stat_file(const std::string &file_path, int64_t &mtime_ns, size_t &file_size) noexcept {
+#if defined(_MSC_VER)
+  struct _stat64 file_stat;
+  if (0 != _stat64(file_path.c_str(), &file_stat)) {
+    return false;
+  }
+  mtime_ns = static_cast<int64_t>(file_stat.st_mtime) * 1000000000LL;
+#else
+  struct stat file_stat;
+  if (0 != stat(file_path.c_str(), &file_stat)) {
+    return false;
+  }
+#  if defined(__APPLE__)
+  mtime_ns = static_cast<int64_t>(file_stat.st_mtimespec.tv_sec) * 1000000000LL +
+             static_cast<int64_t>(file_stat.st_mtimespec.tv_nsec);
+#  elif defined(__linux__)
+  mtime_ns =
+      static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000LL + static_cast<int64_t>(file_stat.st_mtim.tv_nsec);
+#  else
+  mtime_ns = static_cast<int64_t>(file_stat.st_mtime) * 1000000000LL;
+#  endif
+#endif
+  file_size = file_stat.st_size > 0 ? static_cast<size_t>(file_stat.st_size) : 0;
+  return true;
+}
+
+static int64_t binlog_now_us() noexcept {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+struct binlog_call_site_key {
+  const void *file_path;
+  const void *func_name;
+  uint32_t line_number;
+  int32_t level;
+
+  friend bool operator==(const binlog_call_site_key &l, const binlog_call_site_key &r) noexcept {
+    return l.file_path == r.file_path && l.func_name == r.func_name && l.line_number == r.line_number &&
+           l.level == r.level;
+  }
+};
+
+struct binlog_call_site_key_hash {
+  size_t operator()(const binlog_call_site_key &key) const noexcept {
+    size_t ret = std::hash<const void *>()(key.file_path);
+    ret ^= std::hash<const void *>()(key.func_name) + 0x9e3779b9 + (ret << 6) + (ret >> 2);
+    ret ^= std::hash<uint64_t>()((static_cast<uint64_t>(key.line_number) << 32) | static_cast<uint32_t>(key.level)) +
+           0x9e3779b9 + (ret << 6) + (ret >> 2);
+    return ret;
+  }
+};
+
+struct binlog_call_site_entry {
+  uint64_t id;
+  int32_t level;
+  std::string level_name;
+  std::string file_path;
+  uint32_t line_number;
+  std::string func_name;
+  uint64_t written_generation;
+};
+
+}  // namespace
+
+struct log_sink_binlog_backend::context_type {
+  options_type options;
+
+  std::mutex lock;
+  FILE *file;
+  bool file_index_loaded;
+  uint32_t file_index;
+  size_t file_size;
+  // Increased when a new file is opened, call sites and time base should be written again
+  uint64_t file_generation;
+  uint64_t time_base_generation;
+  int64_t last_timestamp_us;
+  std::chrono::steady_clock::time_point last_flush_time;
+  std::string buffer;
+
+  std::vector<binlog_call_site_entry> call_sites;
+  std::unordered_map<binlog_call_site_key, size_t, binlog_call_site_key_hash> call_site_index;
+  uint64_t written_records;
+
+  explicit context_type(const options_type &opts)
+      : options(opts),
+        file(nullptr),
+        file_index_loaded(false),
+        file_index(0),
+        file_size(0),
+        file_generation(0),
+        time_base_generation(0),
+        last_timestamp_us(0),
+        last_flush_time(std::chrono::steady_clock::now()),
+        written_records(0) {
+    if (options.file_pattern.empty()) {
+      options.file_pattern = "server.%N.binlog";
+    }
+    if (0 == options.max_file_size) {
+      options.max_file_size = 262144;  // 256KB
+    }
+    if (0 == options.rotate_size) {
+      options.rotate_size = 10;
+    }
+  }
+
+  ~context_type() { close_file(); }
+
+  void close_file() {
+    if (nullptr != file) {
+      fflush(file);
+      fclose(file);
+      file = nullptr;
+    }
+  }
+
+  std::string make_file_path(uint32_t index) const {
+    return log_sink_binlog_backend::get_file_path(options.file_pattern, index);
+  }
+
+  // Continue from the latest file written before restart, or logs always start from index 0 and overwrite old ones
+  void load_latest_file_index() {
+    file_index_loaded = true;
+    file_index =
+        log_sink_binlog_backend::get_latest_file_index(options.file_pattern, options.rotate_size, options.max_file_size);
+  }
+
+  static FILE *open_file_stream(const std::string &file_path, const char *mode) {
+    FILE *ret = nullptr;
+#if defined(_MSC_VER)
+    if (0 != fopen_s(&ret, file_path.c_str(), mode)) {
+      ret = nullptr;
+    }
+#else
+    ret = fopen(file_path.c_str(), mode);
+#endif
+    return ret;
+  }
+
+  // The last record may be incomplete if the process crashed when writing it, and appending after it will make all the
+  // following records unreadable. So the file is truncated to the last complete record before appending, and false is
+  // returned if the file can not be appended and should be created again.
+  static bool repair_file(const std::string &file_path) {
+    std::string data;
+    {
+      FILE *input = open_file_stream(file_path, "rb");
+      if (nullptr == input) {
+        return true;
+      }
+      char buffer[4096];
+      size_t read_size;
+      while ((read_size = fread(buffer, 1, sizeof(buffer), input)) > 0) {
+        data.append(buffer, read_size);
+      }
+      fclose(input);
+    }
+    if (data.empty()) {
+      return true;
+    }
+
+    log_binlog_reader reader;
+    if (log_binlog_reader::read_result::kOk != reader.reset(gsl::string_view{data.data(), data.size()})) {
+      return false;
+    }
+    log_binlog_reader::record_type record;
+    log_binlog_reader::read_result res;
+    do {
+      res = reader.next(record);
+    } while (log_binlog_reader::read_result::kOk == res);
+    if (log_binlog_reader::read_result::kEof == res) {
+      return true;
+    }
+
+    // Write complete records into a temporary file and rename it
+    std::string tmp_file_path = file_path + ".tmp";
+    FILE *output = open_file_stream(tmp_file_path, "wb");
+    if (nullptr == output) {
+      return false;
+    }
+    bool written = reader.get_offset() == fwrite(data.data(), 1, reader.get_offset(), output);
+    written = 0 == fclose(output) && written;
+    if (!written) {
+      std::remove(tmp_file_path.c_str());
+      return false;
+    }
+#if defined(_WIN32)
+    std::remove(file_path.c_str());
+#endif
+    if (0 != std::rename(tmp_file_path.c_str(), file_path.c_str())) {
+      std::remove(tmp_file_path.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  bool open_file(bool truncate) {
+    close_file();
+
+    if (!file_index_loaded) {
+      load_latest_file_index();
+    }
+
+    std::string file_path = make_file_path(file_index);
+    std::string directory;
+    if (atfw::util::file_system::dirname(file_path.c_str(), 0, directory) && !directory.empty() &&
+        !atfw::util::file_system::is_exist(directory.c_str())) {
+      atfw::util::file_system::mkdir(directory.c_str(), true);
+    }
+
+    if (!truncate && !repair_file(file_path)) {
+      truncate = true;
+    }
+
+    file = open_file_stream(file_path, truncate ? "wb" : "ab");
+    if (nullptr == file) {
+      return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long current_size = ftell(file);
+    file_size = current_size > 0 ? static_cast<size_t>(current_size) : 0;
+    if (0 == file_size) {
+      char header[kBinlogHeaderSize] = {0};
+      memcpy(header, kBinlogMagic, kBinlogMagicSize);
+      header[kBinlogMagicSize] = static_cast<char>(kBinlogVersion);
+      fwrite(header, 1, sizeof(header), file);
+      file_size += sizeof(header);
+    }
+
+    ++file_generation;
+    return true;
+  }
+
+  binlog_call_site_entry &mutable_call_site(const atfw::util::log::log_wrapper::caller_info_t &caller) {
+    gsl::string_view file_path = binlog_to_view(caller.file_path);
+    gsl::string_view func_name = binlog_to_view(caller.func_name);
+
+    binlog_call_site_key key;
+    key.file_path = file_path.data();
+    key.func_name = func_name.data();
+    key.line_number = static_cast<uint32_t>(caller.line_number);
+    key.level = static_cast<int32_t>(caller.level_id);
+
+    auto iter = call_site_index.find(key);
+    if (iter != call_site_index.end()) {
+      binlog_call_site_entry &ret = call_sites[iter->second];
+      // Names may be passed from a reused buffer(C binding for example), check content again
+      if (ret.file_path.size() == file_path.size() && ret.func_name.size() == func_name.size() &&
+          0 == memcmp(ret.file_path.data(), file_path.data(), file_path.size()) &&
+          0 == memcmp(ret.func_name.data(), func_name.data(), func_name.size())) {
+        return ret;
+      }
+    }
+
+    binlog_call_site_entry entry;
+    entry.id = static_cast<uint64_t>(call_sites.size() + 1);
+    entry.level = key.level;
+    gsl::string_view level_name = binlog_to_view(caller.level_name);
+    entry.level_name.assign(level_name.data(), level_name.size());
+    entry.file_path.assign(file_path.data(), file_path.size());
+    entry.line_number = key.line_number;
+    entry.func_name.assign(func_name.data(), func_name.size());
+    entry.written_generation = 0;
+
+    call_site_index[key] = call_sites.size();
+    call_sites.emplace_back(std::move(entry));
+    return call_sites.back();
+  }
+
+  void write(const atfw::util::log::log_wrapper::caller_info_t &caller, atfw::util::nostd::string_view content) {
+    int64_t now_us = binlog_now_us();
+
+    std::lock_guard<std::mutex> lg{lock};
+    if (nullptr != file && file_size >= options.max_file_size) {
+      file_index = (file_index + 1) % options.rotate_size;
+      open_file(true);
+    }
+    if (nullptr == file && !open_file(false)) {
+      return;
+    }
+
+    buffer.clear();
+    binlog_call_site_entry &call_site = mutable_call_site(caller);
+    if (call_site.written_generation != file_generation) {
+      buffer.push_back(static_cast<char>(kRecordCallSite));
+      binlog_append_varint(buffer, call_site.id);
+      binlog_append_varint(buffer, binlog_zigzag_encode(call_site.level));
+      binlog_append_string(buffer, call_site.level_name);
+      binlog_append_string(buffer, call_site.file_path);
+      binlog_append_varint(buffer, call_site.line_number);
+      binlog_append_string(buffer, call_site.func_name);
+      call_site.written_generation = file_generation;
+    }
+
+    // Every file starts with an absolute timestamp, later records only store the delta
+    if (0 == last_timestamp_us || time_base_generation != file_generation) {
+      buffer.push_back(static_cast<char>(kRecordTimeBase));
+      binlog_append_varint(buffer, binlog_zigzag_encode(now_us));
+      last_timestamp_us = now_us;
+      time_base_generation = file_generation;
+    }
+
+    buffer.push_back(static_cast<char>(kRecordLog));
+    binlog_append_varint(buffer, call_site.id);
+    binlog_append_varint(buffer, binlog_zigzag_encode(now_us - last_timestamp_us));
+    binlog_append_string(buffer, gsl::string_view{content.data(), content.size()});
+    last_timestamp_us = now_us;
+
+    fwrite(buffer.data(), 1, buffer.size(), file);
+    file_size += buffer.size();
+    ++written_records;
+
+    bool need_flush = caller.level_id <= options.auto_flush;
+    if (!need_flush && options.flush_interval > std::chrono::seconds::zero()) {
+      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      need_flush = now - last_flush_time >= options.flush_interval;
+    }
+    if (need_flush) {
+      fflush(file);
+      last_flush_time = std::chrono::steady_clock::now();
+    }
+  }
+};
+
+LIBATAPP_MACRO_API log_sink_binlog_backend::options_type::options_type() noexcept
+    : max_file_size(262144),
+      rotate_size(10),
+      auto_flush(atfw::util::log::log_level::kDisabled),
+      flush_interval(std::chrono::seconds{1}) {}
+
+LIBATAPP_MACRO_API log_sink_binlog_backend::log_sink_binlog_backend(const options_type &options)
+    : context_(std::make_shared<context_type>(options)) {}
+
+LIBATAPP_MACRO_API void log_sink_binlog_backend::operator()(const atfw::util::log::log_wrapper::caller_info_t &caller,
+                                                            atfw::util::nostd::string_view content) {
+  if (!context_) {
+    return;
+  }
+
+  context_->write(caller, content);
+}
+
+LIBATAPP_MACRO_API void log_sink_binlog_backend::flush() {
+  if (!context_) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lg{context_->lock};
+  if (nullptr != context_->file) {
+    fflush(context_->file);
+  }
+}
+
+LIBATAPP_MACRO_API uint64_t log_sink_binlog_backend::get_written_records() const noexcept {
+  if (!context_) {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lg{context_->lock};
+  return context_->written_records;
+}
+
+LIBATAPP_MACRO_API uint64_t log_sink_binlog_backend::get_call_site_count() const noexcept {
+  if (!context_) {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lg{context_->lock};
+  return static_cast<uint64_t>(context_->call_sites.size());
+}
+
+LIBATAPP_MACRO_API gsl::string_view log_sink_binlog_backend::get_magic() noexcept {
+  return gsl::string_view{kBinlogMagic, kBinlogMagicSize};
+}
+
+LIBATAPP_MACRO_API uint8_t log_sink_binlog_backend::get_version() noexcept { return kBinlogVersion; }
+
+LIBATAPP_MACRO_API std::string log_sink_binlog_backend::get_file_path(const std::string &file_pattern, uint32_t index) {
+  std::string ret;
+  ret.reserve(file_pattern.size() + 8);
+  for (size_t i = 0; i < file_pattern.size(); ++i) {
+    char c = file_pattern[i];
+    if ('%' == c && i + 1 < file_pattern.size()) {
+      char n = file_pattern[i + 1];
+      if ('N' == n) {
+        ret += std::to_string(index);
+        ++i;
+        continue;
+      } else if ('%' == n) {
+        ret.push_back('%');
+        ++i;
+        continue;
+      }
+    }
+    ret.push_back(c);
+  }
+  return ret;
+}
+
+LIBATAPP_MACRO_API uint32_t log_sink_binlog_backend::get_latest_file_index(const std::string &file_pattern,
+                                                                           uint32_t rotate_size, size_t max_file_size) {
+  uint32_t ret = 0;
+  bool found = false;
+  int64_t latest_mtime_ns = 0;
+  bool latest_is_full = false;
+  for (uint32_t i = 0; i < rotate_size; ++i) {
+    int64_t mtime_ns = 0;
+    size_t current_size = 0;
+    // Empty files are never written, they can be reused
+    if (!binlog_stat_file(get_file_path(file_pattern, i), mtime_ns, current_size) || 0 == current_size) {
+      continue;
+    }
+
+    // Files rotated in the same tick have the same modification time, the one not full yet is the latest
+    bool is_full = current_size >= max_file_size;
+    if (!found || mtime_ns > latest_mtime_ns || (mtime_ns == latest_mtime_ns && latest_is_full && !is_full)) {
+      found = true;
+      latest_mtime_ns = mtime_ns;
+      latest_is_full = is_full;
+      ret = i;
+    }
+  }
+
+  return ret;
+}
+
+LIBATAPP_MACRO_API log_binlog_reader::log_binlog_reader() : offset_(0), last_timestamp_us_(0) {}
+
+LIBATAPP_MACRO_API log_binlog_reader::read_result log_binlog_reader::reset(gsl::string_view data) {
+  data_ = data;
+  offset_ = 0;
+  last_timestamp_us_ = 0;
+  call_sites_.clear();
+
+  if (data_.size() < kBinlogHeaderSize) {
+    return read_result::kBadFormat;
+  }
+  if (0 != memcmp(data_.data(), kBinlogMagic, kBinlogMagicSize)) {
+    return read_result::kBadFormat;
+  }
+  if (static_cast<uint8_t>(data_[kBinlogMagicSize]) > kBinlogVersion) {
+    return read_result::kBadFormat;
+  }
+
+  offset_ = kBinlogHeaderSize;
+  return read_result::kOk;
+}
+
+LIBATAPP_MACRO_API log_binlog_reader::read_result log_binlog_reader::next(record_type &output) {
+  while (offset_ < data_.size()) {
+    size_t offset = offset_;
+    uint8_t type = static_cast<uint8_t>(data_[offset++]);
+    switch (type) {
+      case log_sink_binlog_backend::kRecordCallSite: {
+        uint64_t id = 0;
+        uint64_t level = 0;
+        uint64_t line_number = 0;
+        gsl::string_view level_name;
+        gsl::string_view file_path;
+        gsl::string_view func_name;
+        if (!binlog_read_varint(data_, offset, id) || !binlog_read_varint(data_, offset, level) ||
+            !binlog_read_string(data_, offset, level_name) || !binlog_read_string(data_, offset, file_path) ||
+            !binlog_read_varint(data_, offset, line_number) || !binlog_read_string(data_, offset, func_name)) {
+          return read_result::kTruncated;
+        }
+
+        call_site_type &call_site = call_sites_[id];
+        call_site.level = static_cast<int32_t>(binlog_zigzag_decode(level));
+        call_site.level_name.assign(level_name.data(), level_name.size());
+        call_site.file_path.assign(file_path.data(), file_path.size());
+        call_site.line_number = static_cast<uint32_t>(line_number);
+        call_site.func_name.assign(func_name.data(), func_name.size());
+        break;
+      }
+      case log_sink_binlog_backend::kRecordTimeBase: {
+        uint64_t timestamp = 0;
+        if (!binlog_read_varint(data_, offset, timestamp)) {
+          return read_result::kTruncated;
+        }
+        last_timestamp_us_ = binlog_zigzag_decode(timestamp);
+        break;
+      }
+      case log_sink_binlog_backend::kRecordLog: {
+        uint64_t id = 0;
+        uint64_t delta = 0;
+        gsl::string_view content;
+        if (!binlog_read_varint(data_, offset, id) || !binlog_read_varint(data_, offset, delta) ||
+            !binlog_read_string(data_, offset, content)) {
+          return read_result::kTruncated;
+        }
+
+        auto iter = call_sites_.find(id);
+        if (iter == call_sites_.end()) {
+          return read_result::kBadFormat;
+        }
+
+        last_timestamp_us_ += binlog_zigzag_decode(delta);
+        output.call_site = &iter->second;
+        output.timestamp = std::chrono::system_clock::time_point{
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::microseconds{last_timestamp_us_})};
+        output.content = content;
+        offset_ = offset;
+        return read_result::kOk;
+      }
+      default:
+        return read_result::kBadFormat;
+    }
+
+    offset_ = offset;
+  }
+
+  return read_result::kEof;
+}
+
+LIBATAPP_MACRO_API size_t log_binlog_reader::get_offset() const noexcept { return offset_; }
+
+LIBATAPP_MACRO_API std::string log_binlog_reader::format(const record_type &input) {
+  std::string ret;
+  if (nullptr == input.call_site) {
+    ret.assign(input.content.data(), input.content.size());
+    return ret;
+  }
+
+  int64_t timestamp_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(input.timestamp.time_since_epoch()).count();
+  time_t timestamp_sec = static_cast<time_t>(timestamp_us / 1000000);
+  struct tm tm_local;
+#if defined(_MSC_VER)
+  localtime_s(&tm_local, &timestamp_sec);
+#else
+  localtime_r(&timestamp_sec, &tm_local);
+#endif
+
+  char time_buffer[64] = {0};
+  size_t time_length = strftime(time_buffer, sizeof(time_buffer), "%Y-%m-%d %H:%M:%S", &tm_local);
+  snprintf(time_buffer + time_length, sizeof(time_buffer) - time_length, ".%06d",
+           static_cast<int>(timestamp_us % 1000000));
+
+  ret.reserve(input.call_site->level_name.size() + input.call_site->file_path.size() +
+              input.call_site->func_name.size() + input.content.size() + 64);
+  ret.push_back('[');
+  ret += input.call_site->level_name;
+  ret += "][";
+  ret += time_buffer;
+  ret += "][";
+  ret += input.call_site->file_path;
+  ret.push_back(':');
+  ret += std::to_string(input.call_site->line_number);
+  ret.push_back('(');
+  ret += input.call_site->func_name;
+  ret += ")]: ";
+  ret.append(input.content.data(), input.content.size());
+  return ret;
+}
+
+LIBATAPP_MACRO_NAMESPACE_END
@@ -5,7 +5,11 @@
 #include "atframe/atapp_log_sink_maker.h"
 
 #include <atframe/atapp_conf.h>
+#include <atframe/atapp_log_sink_async_file.h>
+#include <atframe/atapp_log_sink_binlog.h>
+#include <atframe/atapp_log_sink_mmap_file.h>
 
+#include <chrono>
 #include <iostream>
 #include "nostd/string_view.h"
 
@@ -23,19 +27,15 @@
 
 LIBATAPP_MACRO_NAMESPACE_BEGIN
 namespace {
-static atfw::util::log::log_wrapper::log_handler_t _log_sink_file(
-    atfw::util::log::log_wrapper& /*logger*/, int32_t /*index*/,
-    const ::atframework::atapp::protocol::atapp_log& /*log_cfg*/,
-    const ::atframework::atapp::protocol::atapp_log_category& /*cat_cfg*/,
-    const ::atframework::atapp::protocol::atapp_log_sink& sink_cfg) {
-  std::string file_pattern = sink_cfg.log_backend_file().file();
+template <class TFILE_CONF>
+static void _log_setup_file_backend(atfw::util::log::log_sink_file_backend& file_sink, const TFILE_CONF& file_conf) {
+  std::string file_pattern = file_conf.file();
   if (file_pattern.empty()) {
     file_pattern = "server.%N.log";
   }
-  size_t max_file_size = static_cast<size_t>(sink_cfg.log_backend_file().rotate().size());
-  uint32_t rotate_size = static_cast<uint32_t>(sink_cfg.log_backend_file().rotate().number());
+  size_t max_file_size = static_cast<size_t>(file_conf.rotate().size());
+  uint32_t rotate_size = static_cast<uint32_t>(file_conf.rotate().number());
 
-  atfw::util::log::log_sink_file_backend file_sink;
   if (0 == max_file_size) {
     max_file_size = 262144;  // 256KB
   }
@@ -48,13 +48,108 @@ static atfw::util::log::log_wrapper::log_handler_t _log_sink_file(
   file_sink.set_max_file_size(max_file_size);
   file_sink.set_rotate_size(rotate_size);
 
-  file_sink.set_auto_flush(atfw::util::log::log_formatter::get_level_by_name(sink_cfg.log_backend_file().auto_flush()));
-  file_sink.set_flush_interval(static_cast<time_t>(sink_cfg.log_backend_file().flush_interval().seconds()));
-  file_sink.set_writing_alias_pattern(sink_cfg.log_backend_file().writing_alias());
+  file_sink.set_auto_flush(atfw::util::log::log_formatter::get_level_by_name(file_conf.auto_flush()));
+  file_sink.set_flush_interval(static_cast<time_t>(file_conf.flush_interval().seconds()));
+  file_sink.set_writing_alias_pattern(file_conf.writing_alias());
+}
+
+static atfw::util::log::log_wrapper::log_handler_t _log_sink_file(
+    atfw::util::log::log_wrapper& /*logger*/, int32_t /*index*/,
+    const ::atframework::atapp::protocol::atapp_log& /*log_cfg*/,
+    const ::atframework::atapp::protocol::atapp_log_category& /*cat_cfg*/,
+    const ::atframework::atapp::protocol::atapp_log_sink& sink_cfg) {
+  atfw::util::log::log_sink_file_backend file_sink;
+  _log_setup_file_backend(file_sink, sink_cfg.log_backend_file());
 
   return file_sink;
 }
 
+static atfw::util::log::log_wrapper::log_handler_t _log_sink_async_file(
+    atfw::util::log::log_wrapper& /*logger*/, int32_t /*index*/,
+    const ::atframework::atapp::protocol::atapp_log& /*log_cfg*/,
+    const ::atframework::atapp::protocol::atapp_log_category& /*cat_cfg*/,
+    const ::atframework::atapp::protocol::atapp_log_sink& sink_cfg) {
+  const ::atframework::atapp::protocol::atapp_log_sink_async_file& async_conf = sink_cfg.log_backend_async_file();
+
+  atfw::util::log::log_sink_file_backend file_sink;
+  _log_setup_file_backend(file_sink, async_conf);
+
+  log_sink_async_file_backend::options_type options;
+  if (async_conf.buffer_size() > 0) {
+    options.buffer_size = static_cast<size_t>(async_conf.buffer_size());
+  }
+  options.policy = log_sink_async_file_backend::parse_overflow_policy(async_conf.overflow_policy());
+  if (async_conf.sample_rate() > 0) {
+    options.sample_rate = async_conf.sample_rate();
+  }
+  if (async_conf.writer_interval().seconds() > 0 || async_conf.writer_interval().nanos() > 0) {
+    options.writer_interval = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::seconds{async_conf.writer_interval().seconds()} +
+        std::chrono::nanoseconds{async_conf.writer_interval().nanos()});
+  }
+  if (async_conf.max_batch_size() > 0) {
+    options.max_batch_size = static_cast<size_t>(async_conf.max_batch_size());
+  }
+
+  return log_sink_async_file_backend(std::move(file_sink), options);
+}
+
+static atfw::util::log::log_wrapper::log_handler_t _log_sink_binlog(
+    atfw::util::log::log_wrapper& /*logger*/, int32_t /*index*/,
+    const ::atframework::atapp::protocol::atapp_log& /*log_cfg*/,
+    const ::atframework::atapp::protocol::atapp_log_category& /*cat_cfg*/,
+    const ::atframework::atapp::protocol::atapp_log_sink& sink_cfg) {
+  const ::atframework::atapp::protocol::atapp_log_sink_binlog& binlog_conf = sink_cfg.log_backend_binlog();
+
+  log_sink_binlog_backend::options_type options;
+  options.file_pattern = binlog_conf.file();
+  if (options.file_pattern.empty()) {
+    options.file_pattern = "server.%N.binlog";
+  }
+  if (binlog_conf.rotate().size() > 0) {
+    options.max_file_size = static_cast<size_t>(binlog_conf.rotate().size());
+  }
+  if (binlog_conf.rotate().number() > 0) {
+    options.rotate_size = binlog_conf.rotate().number();
+  }
+  if (!binlog_conf.auto_flush().empty()) {
+    options.auto_flush = atfw::util::log::log_formatter::get_level_by_name(binlog_conf.auto_flush());
+  }
+  options.flush_interval = std::chrono::seconds{binlog_conf.flush_interval().seconds()};
+
+  return log_sink_binlog_backend(options);
+}
+
+static atfw::util::log::log_wrapper::log_handler_t _log_sink_mmap_file(
+    atfw::util::log::log_wrapper& /*logger*/, int32_t /*index*/,
+    const ::atframework::atapp::protocol::atapp_log& /*log_cfg*/,
+    const ::atframework::atapp::protocol::atapp_log_category& /*cat_cfg*/,
+    const ::atframework::atapp::protocol::atapp_log_sink& sink_cfg) {
+  const ::atframework::atapp::protocol::atapp_log_sink_mmap_file& mmap_conf = sink_cfg.log_backend_mmap_file();
+
+  log_sink_mmap_file_backend::options_type options;
+  options.file_pattern = mmap_conf.file();
+  if (options.file_pattern.empty()) {
+    options.file_pattern = "server.%N.log";
+  }
+  if (mmap_conf.rotate().size() > 0) {
+    options.max_file_size = static_cast<size_t>(mmap_conf.rotate().size());
+  }
+  if (mmap_conf.rotate().number() > 0) {
+    options.rotate_size = mmap_conf.rotate().number();
+  }
+  if (!mmap_conf.auto_flush().empty()) {
+    options.auto_flush = atfw::util::log::log_formatter::get_level_by_name(mmap_conf.auto_flush());
+  }
+  if (mmap_conf.flush_interval().seconds() > 0 || mmap_conf.flush_interval().nanos() > 0) {
+    options.flush_interval = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::seconds{mmap_conf.flush_interval().seconds()} +
+        std::chrono::nanoseconds{mmap_conf.flush_interval().nanos()});
+  }
+
+  return log_sink_mmap_file_backend(options);
+}
+
 static void _log_sink_stdout_handle(const atfw::util::log::log_wrapper::caller_info_t& caller,
                                     atfw::util::nostd::string_view content) {
   if (caller.level_id <= atfw::util::log::log_level::kNotice) {
@@ -185,6 +280,22 @@ LIBATAPP_MACRO_API gsl::string_view log_sink_maker::get_file_sink_name() { retur
 
 LIBATAPP_MACRO_API log_sink_maker::log_reg_t log_sink_maker::get_file_sink_reg() { return _log_sink_file; }
 
+LIBATAPP_MACRO_API gsl::string_view log_sink_maker::get_async_file_sink_name() { return "async_file"; }
+
+LIBATAPP_MACRO_API log_sink_maker::log_reg_t log_sink_maker::get_async_file_sink_reg() {
+  return _log_sink_async_file;
+}
+
+LIBATAPP_MACRO_API gsl::string_view log_sink_maker::get_binlog_sink_name() { return "binlog"; }
+
+LIBATAPP_MACRO_API log_sink_maker::log_reg_t log_sink_maker::get_binlog_sink_reg() { return _log_sink_binlog; }
+
+LIBATAPP_MACRO_API gsl::string_view log_sink_maker::get_mmap_file_sink_name() { return "mmap_file"; }
+
+LIBATAPP_MACRO_API log_sink_maker::log_reg_t log_sink_maker::get_mmap_file_sink_reg() {
+  return _log_sink_mmap_file;
+}
+
 LIBATAPP_MACRO_API gsl::string_view log_sink_maker::get_stdout_sink_name() { return "stdout"; }
 
 LIBATAPP_MACRO_API log_sink_maker::log_reg_t log_sink_maker::get_stdout_sink_reg() { return _log_sink_stdout; }
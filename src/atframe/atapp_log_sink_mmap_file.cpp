@@ -0,0 +1,493 @@
+// Copyright 2026 atframework
+//
+// Created by owent
+
+#include "atframe/atapp_log_sink_mmap_file.h"
+#include "atframe/atapp_log_sink_binlog.h"
+
+#include <common/file_system.h>
+#include <config/compiler_features.h>
+
+#if defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+LIBATAPP_MACRO_NAMESPACE_BEGIN
+
+namespace {
+struct mmap_log_segment {
+  uint32_t index;
+  char *data;
+  size_t capacity;
+  size_t used;
+#if defined(_WIN32)
+  HANDLE file;
+  HANDLE mapping;
+#else
+  int fd;
+#endif
+
+  mmap_log_segment()
+      : index(0),
+        data(nullptr),
+        capacity(0),
+        used(0)
+#if defined(_WIN32)
+        ,
+        file(INVALID_HANDLE_VALUE),
+        mapping(nullptr)
+#else
+        ,
+        fd(-1)
+#endif
+  {
+  }
+};
+
+static void mmap_log_close_segment(mmap_log_segment &segment) {
+#if defined(_WIN32)
+  if (nullptr != segment.data) {
+    UnmapViewOfFile(segment.data);
+  }
+  if (nullptr != segment.mapping) {
+    CloseHandle(segment.mapping);
+  }
+  if (INVALID_HANDLE_VALUE != segment.file) {
+    // Remove the zero tail
+    LARGE_INTEGER file_size;
+    file_size.QuadPart = static_cast<LONGLONG>(segment.used);
+    if (SetFilePointerEx(segment.file, file_size, nullptr, FILE_BEGIN)) {
+      SetEndOfFile(segment.file);
+    }
+    CloseHandle(segment.file);
+  }
+  segment.file = INVALID_HANDLE_VALUE;
+  segment.mapping = nullptr;
+#else
+  if (nullptr != segment.data) {
+    munmap(segment.data, segment.capacity);
+  }
+  if (segment.fd >= 0) {
+    // Remove the zero tail
+    if (0 != ftruncate(segment.fd, static_cast<off_t>(segment.used))) {
+      // Keep the zero tail, decoder can skip it
+    }
+    close(segment.fd);
+  }
+  segment.fd = -1;
+#endif
+  segment.data = nullptr;
+  segment.capacity = 0;
+}
+
+static bool mmap_log_open_segment(mmap_log_segment &segment, const std::string &path, uint32_t index, size_t capacity,
+                                  bool truncate) {
+  segment.index = index;
+  segment.used = 0;
+
+  std::string directory;
+  if (atfw::util::file_system::dirname(path.c_str(), 0, directory) && !directory.empty() &&
+      !atfw::util::file_system::is_exist(directory.c_str())) {
+    atfw::util::file_system::mkdir(directory.c_str(), true);
+  }
+
+  size_t existing_size = 0;
+#if defined(_WIN32)
+  segment.file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                             truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (INVALID_HANDLE_VALUE == segment.file) {
+    return false;
+  }
+  LARGE_INTEGER file_size;
+  if (GetFileSizeEx(segment.file, &file_size) && file_size.QuadPart > 0) {
+    existing_size = static_cast<size_t>(file_size.QuadPart);
+  }
+  if (existing_size > capacity) {
+    capacity = existing_size;
+  }
+
+  uint64_t mapping_size = static_cast<uint64_t>(capacity);
+  segment.mapping = CreateFileMappingA(segment.file, nullptr, PAGE_READWRITE, static_cast<DWORD>(mapping_size >> 32),
+                                       static_cast<DWORD>(mapping_size & 0xFFFFFFFF), nullptr);
+  if (nullptr == segment.mapping) {
+    mmap_log_close_segment(segment);
+    return false;
+  }
+  segment.data = reinterpret_cast<char *>(MapViewOfFile(segment.mapping, FILE_MAP_WRITE, 0, 0, capacity));
+  if (nullptr == segment.data) {
+    mmap_log_close_segment(segment);
+    return false;
+  }
+#else
+  segment.fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+  if (segment.fd < 0) {
+    return false;
+  }
+  struct stat file_stat;
+  if (0 == fstat(segment.fd, &file_stat) && file_stat.st_size > 0) {
+    existing_size = static_cast<size_t>(file_stat.st_size);
+  }
+  if (existing_size > capacity) {
+    capacity = existing_size;
+  }
+  // Pre-allocate the whole segment, so page faults never extend the file
+  if (0 != ftruncate(segment.fd, static_cast<off_t>(capacity))) {
+    mmap_log_close_segment(segment);
+    return false;
+  }
+
+  void *data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, segment.fd, 0);
+  if (MAP_FAILED == data) {
+    mmap_log_close_segment(segment);
+    return false;
+  }
+  segment.data = reinterpret_cast<char *>(data);
+#endif
+  segment.capacity = capacity;
+
+  // Append after the last non-zero byte of existing data
+  size_t used = existing_size < capacity ? existing_size : capacity;
+  while (used > 0 && 0 == segment.data[used - 1]) {
+    --used;
+  }
+  segment.used = used;
+  return true;
+}
+
+static void mmap_log_sync_segment(mmap_log_segment &segment, bool wait) {
+  if (nullptr == segment.data || 0 == segment.used) {
+    return;
+  }
+
+#if defined(_WIN32)
+  FlushViewOfFile(segment.data, segment.used);
+  if (wait && INVALID_HANDLE_VALUE != segment.file) {
+    FlushFileBuffers(segment.file);
+  }
+#else
+  msync(segment.data, segment.used, wait ? MS_SYNC : MS_ASYNC);
+#endif
+}
+}  // namespace
+
+struct log_sink_mmap_file_backend::context_type {
+  options_type options;
+
+  mutable std::mutex lock;
+  std::condition_variable background_cv;
+  // Notified when the background thread finishes preparing or closing a segment
+  std::condition_variable segment_cv;
+  std::thread background_thread;
+  bool stopping;
+  bool sync_requested;
+  // msync is called without lock, segments can not be closed until it's finished
+  size_t syncing_count;
+
+  std::unique_ptr<mmap_log_segment> current;
+  std::unique_ptr<mmap_log_segment> prepared;
+  std::list<std::unique_ptr<mmap_log_segment>> retired;
+  uint32_t file_index;
+  // Index of the segment which is being opened or closed by the background thread, UINT32_MAX for none
+  uint32_t preparing_index;
+  uint32_t closing_index;
+
+  stats_type stats;
+
+  explicit context_type(const options_type &opts)
+      : options(opts),
+        stopping(false),
+        sync_requested(false),
+        syncing_count(0),
+        file_index(0),
+        preparing_index(UINT32_MAX),
+        closing_index(UINT32_MAX),
+        stats() {
+    if (options.file_pattern.empty()) {
+      options.file_pattern = "server.%N.log";
+    }
+    if (0 == options.max_file_size) {
+      options.max_file_size = 262144;  // 256KB
+    }
+    if (0 == options.rotate_size) {
+      options.rotate_size = 10;
+    }
+    if (options.flush_interval <= std::chrono::milliseconds::zero()) {
+      options.flush_interval = std::chrono::milliseconds{1000};
+    }
+
+    // Continue from the latest file written before restart, or logs always start from index 0 and overwrite old ones
+    file_index = log_sink_binlog_backend::get_latest_file_index(options.file_pattern, options.rotate_size,
+                                                                options.max_file_size);
+
+    background_thread = std::thread([this]() { background_main(); });
+  }
+
+  ~context_type() {
+    {
+      std::lock_guard<std::mutex> lg{lock};
+      stopping = true;
+    }
+    background_cv.notify_all();
+    if (background_thread.joinable()) {
+      background_thread.join();
+    }
+
+    for (auto &segment : retired) {
+      mmap_log_close_segment(*segment);
+    }
+    retired.clear();
+    if (prepared) {
+      mmap_log_close_segment(*prepared);
+      prepared.reset();
+    }
+    if (current) {
+      mmap_log_sync_segment(*current, false);
+      mmap_log_close_segment(*current);
+      current.reset();
+    }
+  }
+
+  // Whether the next segment can be opened before the active one is retired
+  ATFW_UTIL_FORCEINLINE bool can_prepare() const noexcept { return options.rotate_size > 1; }
+
+  ATFW_UTIL_FORCEINLINE uint32_t next_index() const noexcept { return (file_index + 1) % options.rotate_size; }
+
+  // Must be called with lock held
+  void wait_for_sync(std::unique_lock<std::mutex> &guard) {
+    while (syncing_count > 0) {
+      segment_cv.wait(guard);
+    }
+  }
+
+  // Must be called with lock held, msync is called after unlocking so writers are not blocked by it
+  void sync_current(std::unique_lock<std::mutex> &guard, bool wait) {
+    if (!current) {
+      return;
+    }
+
+    // Only the mapping and file handles are used, they are kept until syncing_count is zero
+    mmap_log_segment segment = *current;
+    ++syncing_count;
+    ++stats.sync_times;
+    guard.unlock();
+
+    mmap_log_sync_segment(segment, wait);
+
+    guard.lock();
+    --syncing_count;
+    segment_cv.notify_all();
+  }
+
+  // Must be called with lock held
+  std::unique_ptr<mmap_log_segment> open_segment_sync(std::unique_lock<std::mutex> &guard, uint32_t index,
+                                                      bool truncate) {
+    // Wait for background thread which is touching the same file
+    while (index == preparing_index || index == closing_index) {
+      segment_cv.wait(guard);
+    }
+    if (prepared && prepared->index == index) {
+      return std::move(prepared);
+    }
+    for (auto iter = retired.begin(); iter != retired.end(); ++iter) {
+      if ((*iter)->index == index) {
+        wait_for_sync(guard);
+        mmap_log_close_segment(**iter);
+        retired.erase(iter);
+        break;
+      }
+    }
+
+    std::unique_ptr<mmap_log_segment> ret{new mmap_log_segment()};
+    if (!mmap_log_open_segment(*ret, log_sink_binlog_backend::get_file_path(options.file_pattern, index), index,
+                               options.max_file_size, truncate)) {
+      return nullptr;
+    }
+    return ret;
+  }
+
+  // Must be called with lock held
+  void rotate(std::unique_lock<std::mutex> &guard) {
+    if (current) {
+      if (can_prepare()) {
+        retired.emplace_back(std::move(current));
+      } else {
+        // Only one file, it will be opened again immediately
+        wait_for_sync(guard);
+        mmap_log_close_segment(*current);
+        current.reset();
+      }
+    }
+
+    file_index = next_index();
+    ++stats.rotate_times;
+    if (prepared && prepared->index == file_index) {
+      ++stats.prepared_rotate_times;
+      current = std::move(prepared);
+    } else {
+      current = open_segment_sync(guard, file_index, true);
+    }
+    background_cv.notify_one();
+  }
+
+  void write(const atfw::util::log::log_wrapper::caller_info_t &caller, atfw::util::nostd::string_view content) {
+    std::unique_lock<std::mutex> guard{lock};
+    if (!current) {
+      current = open_segment_sync(guard, file_index, false);
+      if (!current) {
+        return;
+      }
+    }
+
+    size_t content_size = content.size();
+    if (content_size + 1 > current->capacity) {
+      content_size = current->capacity - 1;
+      ++stats.truncated_records;
+    }
+
+    if (current->used + content_size + 1 > current->capacity) {
+      rotate(guard);
+      if (!current) {
+        return;
+      }
+    }
+
+    char *output = current->data + current->used;
+    memcpy(output, content.data(), content_size);
+    output[content_size] = '\n';
+    current->used += content_size + 1;
+    ++stats.written_records;
+    stats.written_bytes += content_size + 1;
+
+    bool notify = false;
+    if (caller.level_id <= options.auto_flush) {
+      sync_requested = true;
+      notify = true;
+    }
+    // Prepare the next segment when the active one is half full
+    if (can_prepare() && !prepared && UINT32_MAX == preparing_index && current->used * 2 >= current->capacity) {
+      notify = true;
+    }
+    guard.unlock();
+
+    if (notify) {
+      background_cv.notify_one();
+    }
+  }
+
+  void background_main() {
+    std::unique_lock<std::mutex> guard{lock};
+    while (true) {
+      // Close retired segments first, the next prepared segment may reuse the same file
+      while (!retired.empty()) {
+        wait_for_sync(guard);
+        if (retired.empty()) {
+          break;
+        }
+        std::unique_ptr<mmap_log_segment> segment = std::move(retired.front());
+        retired.pop_front();
+        closing_index = segment->index;
+        guard.unlock();
+
+        mmap_log_sync_segment(*segment, false);
+        mmap_log_close_segment(*segment);
+
+        guard.lock();
+        closing_index = UINT32_MAX;
+        segment_cv.notify_all();
+      }
+
+      if (stopping) {
+        break;
+      }
+
+      if (can_prepare() && current && !prepared && current->used * 2 >= current->capacity) {
+        uint32_t index = next_index();
+        preparing_index = index;
+        guard.unlock();
+
+        std::unique_ptr<mmap_log_segment> segment{new mmap_log_segment()};
+        if (!mmap_log_open_segment(*segment, log_sink_binlog_backend::get_file_path(options.file_pattern, index), index,
+                                   options.max_file_size, true)) {
+          segment.reset();
+        }
+
+        guard.lock();
+        preparing_index = UINT32_MAX;
+        if (segment && !stopping && index == next_index()) {
+          prepared = std::move(segment);
+        } else if (segment) {
+          mmap_log_close_segment(*segment);
+        }
+        segment_cv.notify_all();
+        continue;
+      }
+
+      if (current && (sync_requested || current->used > 0)) {
+        sync_requested = false;
+        sync_current(guard, false);
+
+        // Notifications when msync is running without lock should not be missed
+        if (stopping || !retired.empty() || sync_requested ||
+            (can_prepare() && current && !prepared && current->used * 2 >= current->capacity)) {
+          continue;
+        }
+      }
+
+      background_cv.wait_for(guard, options.flush_interval);
+    }
+  }
+};
+
+LIBATAPP_MACRO_API log_sink_mmap_file_backend::options_type::options_type() noexcept
+    : max_file_size(262144),
+      rotate_size(10),
+      auto_flush(atfw::util::log::log_level::kDisabled),
+      flush_interval(std::chrono::milliseconds{1000}) {}
+
+LIBATAPP_MACRO_API log_sink_mmap_file_backend::log_sink_mmap_file_backend(const options_type &options)
+    : context_(std::make_shared<context_type>(options)) {}
+
+LIBATAPP_MACRO_API void log_sink_mmap_file_backend::operator()(
+    const atfw::util::log::log_wrapper::caller_info_t &caller, atfw::util::nostd::string_view content) {
+  if (!context_) {
+    return;
+  }
+
+  context_->write(caller, content);
+}
+
+LIBATAPP_MACRO_API void log_sink_mmap_file_backend::flush() {
+  if (!context_) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> guard{context_->lock};
+  context_->sync_current(guard, true);
+}
+
+LIBATAPP_MACRO_API log_sink_mmap_file_backend::stats_type log_sink_mmap_file_backend::get_stats() const noexcept {
+  if (!context_) {
+    return stats_type();
+  }
+
+  std::lock_guard<std::mutex> lg{context_->lock};
+  return context_->stats;
+}
+
+LIBATAPP_MACRO_NAMESPACE_END
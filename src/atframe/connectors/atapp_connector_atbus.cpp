@@ -15,8 +15,11 @@
 
 #include <atframe/atapp.h>
 #include <atframe/atapp_common_types.h>
+#include <atframe/atapp_log_rate_limit.h>
 #include <atframe/modules/service_discovery_module.h>
 
+#include <vector>
+
 LIBATAPP_MACRO_NAMESPACE_BEGIN
 
 namespace {
@@ -61,6 +64,21 @@ static bool check_atbus_endpoint_available(const atbus::node::ptr_t &node, atbus
   return ep->is_available();
 }
 
+// 超时时间向上对齐到调度桶边界，同一个桶内的handle共享一次定时器唤醒
+static atfw::util::time::time_utility::raw_time_t round_up_reconnect_bucket(
+    atfw::util::time::time_utility::raw_time_t timeout, std::chrono::system_clock::duration bucket_interval) {
+  if (bucket_interval <= std::chrono::system_clock::duration::zero()) {
+    return timeout;
+  }
+
+  std::chrono::system_clock::duration remainder = timeout.time_since_epoch() % bucket_interval;
+  if (remainder == std::chrono::system_clock::duration::zero()) {
+    return timeout;
+  }
+
+  return timeout + (bucket_interval - remainder);
+}
+
 }  // namespace
 
 struct ATFW_UTIL_SYMBOL_LOCAL atapp_connector_atbus::atbus_connection_handle_data {
@@ -75,7 +93,7 @@ struct ATFW_UTIL_SYMBOL_LOCAL atapp_connector_atbus::atbus_connection_handle_dat
   atbus::bus_id_t proxy_bus_id = 0;
   std::unordered_set<atbus::bus_id_t> proxy_for_bus_id;
 
-  jiffies_timer_watcher_t timer_handle;
+  // 所在重连调度桶的超时时间
   atfw::util::time::time_utility::raw_time_t pending_timer_timeout;
 #if !defined(NDEBUG)
   int32_t last_update_timer_error = 0;
@@ -83,7 +101,11 @@ struct ATFW_UTIL_SYMBOL_LOCAL atapp_connector_atbus::atbus_connection_handle_dat
 };
 
 LIBATAPP_MACRO_API atapp_connector_atbus::atapp_connector_atbus(app &owner)
-    : atapp_connector_impl(owner), last_connect_bus_id_(0), last_connect_handle_(nullptr), last_connect_result_(0) {
+    : atapp_connector_impl(owner),
+      last_connect_bus_id_(0),
+      last_connect_handle_(nullptr),
+      last_connect_result_(0),
+      reconnect_bucket_interval_(0) {
   register_protocol("mem");
   register_protocol("shm");
   register_protocol("unix");
@@ -94,6 +116,9 @@ LIBATAPP_MACRO_API atapp_connector_atbus::atapp_connector_atbus(app &owner)
   register_protocol("dns");
 
   atbus_topology_data_ = atfw::util::memory::make_strong_rc<atbus::topology_data>();
+  reconnect_random_generator_.init_seed(
+      static_cast<atfw::util::random::xoshiro256_starstar::result_type>(atfw::util::time::time_utility::get_now()) ^
+      static_cast<atfw::util::random::xoshiro256_starstar::result_type>(atbus::node::get_pid()));
 }
 
 LIBATAPP_MACRO_API atapp_connector_atbus::~atapp_connector_atbus() { cleanup(); }
@@ -101,6 +126,10 @@ LIBATAPP_MACRO_API atapp_connector_atbus::~atapp_connector_atbus() { cleanup();
 LIBATAPP_MACRO_API gsl::string_view atapp_connector_atbus::name() const noexcept { return "atapp::connector.atbus"; }
 
 LIBATAPP_MACRO_API void atapp_connector_atbus::reload() noexcept {
+  // Timers are updated frequently, so do not read the bucket interval from protobuf every time
+  protobuf_to_chrono_set_duration(reconnect_bucket_interval_,
+                                  get_owner()->get_origin_configure().bus().reconnect_bucket_interval());
+
   // checking atbus_topology_data changes
   const protocol::atbus_topology_data &topology_data_conf = get_owner()->get_origin_configure().bus().topology().data();
   bool changed = static_cast<int>(atbus_topology_data_->labels.size()) != topology_data_conf.label_size() ||
@@ -499,6 +528,17 @@ LIBATAPP_MACRO_API const atbus::topology_policy_rule &atapp_connector_atbus::get
   return atbus_topology_policy_rule_;
 }
 
+LIBATAPP_MACRO_API atapp_connector_atbus::reconnect_scheduler_stats
+atapp_connector_atbus::get_reconnect_scheduler_stats() const noexcept {
+  reconnect_scheduler_stats ret = reconnect_stats_;
+  ret.pending_buckets = reconnect_buckets_.size();
+  ret.pending_handles = 0;
+  for (auto &bucket : reconnect_buckets_) {
+    ret.pending_handles += bucket.second.handles.size();
+  }
+  return ret;
+}
+
 #if !defined(NDEBUG)
 LIBATAPP_MACRO_API atbus::bus_id_t atapp_connector_atbus::get_connection_handle_proxy_bus_id(
     atbus::bus_id_t target_bus_id) const noexcept {
@@ -571,7 +611,12 @@ atapp_connector_atbus::get_connection_handle_debug_info(atbus::bus_id_t target_b
   info.pending_timer_timeout = iter->second->pending_timer_timeout;
   info.lost_topology_timeout = iter->second->lost_topology_timeout;
   info.reconnect_next_timepoint = iter->second->reconnect_next_timepoint;
-  info.timer_handle_expired = iter->second->timer_handle.expired();
+  {
+    auto bucket_iter = reconnect_buckets_.find(iter->second->pending_timer_timeout);
+    info.timer_handle_expired = bucket_iter == reconnect_buckets_.end() || bucket_iter->second.timer_handle.expired() ||
+                                bucket_iter->second.handles.end() ==
+                                    bucket_iter->second.handles.find(iter->second->current_bus_id);
+  }
   info.proxy_bus_id = iter->second->proxy_bus_id;
   info.proxy_for_count = iter->second->proxy_for_bus_id.size();
   info.last_update_timer_error = iter->second->last_update_timer_error;
@@ -971,100 +1016,58 @@ void atapp_connector_atbus::update_timer(const atbus_connection_handle_ptr_t &ha
     return;
   }
 
-  if (handle->pending_timer_timeout != std::chrono::system_clock::from_time_t(0) && !handle->timer_handle.expired() &&
-      handle->pending_timer_timeout <= timeout) {
-    return;
+  atfw::util::time::time_utility::raw_time_t bucket_timeout = round_up_reconnect_bucket(
+      timeout, std::chrono::duration_cast<std::chrono::system_clock::duration>(reconnect_bucket_interval_));
+
+  if (handle->pending_timer_timeout != std::chrono::system_clock::from_time_t(0) &&
+      handle->pending_timer_timeout <= bucket_timeout) {
+    auto bucket_iter = reconnect_buckets_.find(handle->pending_timer_timeout);
+    if (bucket_iter != reconnect_buckets_.end() && !bucket_iter->second.timer_handle.expired()) {
+      return;
+    }
   }
 
   remove_timer(handle);
-  atfw::util::memory::weak_rc_ptr<atbus_connection_handle_data> weak_handle(handle);
-  std::weak_ptr<atapp_connector_atbus> weak_self(shared_from_this());
 
   FWLOGDEBUG("atbus node {:#x} set timer for connection handle of bus id {:#x} timeout at {:%F %T}",
-             get_owner()->get_app_id(), handle->current_bus_id, timeout);
-  int res = get_owner()->add_custom_timer(
-      timeout,
-      [weak_handle, weak_self](time_t /*tick_time*/, const jiffies_timer_t::timer_t &) {
-        atbus_connection_handle_ptr_t h = weak_handle.lock();
-        if (!h) {
-          return;
-        }
-
-        h->pending_timer_timeout = std::chrono::system_clock::from_time_t(0);
-        h->timer_handle.reset();
-
-        std::shared_ptr<atapp_connector_atbus> self = weak_self.lock();
-        if (!self) {
-          return;
-        }
-
-        FWLOGDEBUG("atbus timer callback fired for bus id {:#x}, retry_times={}", h->current_bus_id,
-                   h->reconnect_retry_times);
-
-        // 检查handle是否仍然有效
-        auto iter = self->handles_.find(h->current_bus_id);
-        if (iter == self->handles_.end()) {
-          return;
-        }
-        if (iter->second != h) {
-          return;
-        }
-
-        std::chrono::system_clock::time_point sys_now = app::get_sys_now();
-        std::chrono::system_clock::time_point next_timer_timeout = std::chrono::system_clock::from_time_t(0);
-
-        // 处理丢失拓扑后的重连超时则直接移除
-        if (check_flag(h->flags, atbus_connection_handle_flags_t::kLostTopology)) {
-          if (sys_now >= h->lost_topology_timeout) {
-            FWLOGWARNING("atbus node {:#x} remove connection handle to bus id {:#x} for lost topology timeout",
-                         self->get_owner()->get_app_id(), h->current_bus_id);
-            self->remove_connection_handle(iter);
+             get_owner()->get_app_id(), handle->current_bus_id, bucket_timeout);
+  auto bucket_iter = reconnect_buckets_.find(bucket_timeout);
+  if (bucket_iter == reconnect_buckets_.end()) {
+    // 每个桶只注册一个定时器
+    reconnect_bucket_type &bucket = reconnect_buckets_[bucket_timeout];
+    std::weak_ptr<atapp_connector_atbus> weak_self(shared_from_this());
+    int res = get_owner()->add_custom_timer(
+        bucket_timeout,
+        [weak_self, bucket_timeout](time_t /*tick_time*/, const jiffies_timer_t::timer_t &) {
+          std::shared_ptr<atapp_connector_atbus> self = weak_self.lock();
+          if (!self) {
             return;
           }
-          next_timer_timeout = h->lost_topology_timeout;
-        }
-
-        // 如果处于就绪状态则不需要重连和移除
-        if (check_flag(h->flags, atbus_connection_handle_flags_t::kReady)) {
-          if (next_timer_timeout != std::chrono::system_clock::from_time_t(0)) {
-            self->update_timer(h, next_timer_timeout);
-          }
-          return;
-        }
 
-        // 重连时间未到则继续等待
-        bool need_reconnect = iter->second->reconnect_next_timepoint <= sys_now;
-        if (!need_reconnect) {
-          if (next_timer_timeout == std::chrono::system_clock::from_time_t(0) ||
-              next_timer_timeout > iter->second->reconnect_next_timepoint) {
-            next_timer_timeout = iter->second->reconnect_next_timepoint;
-          }
-
-          self->update_timer(h, next_timer_timeout);
-          return;
-        }
-
-        if (!self->setup_reconnect_timer(iter, next_timer_timeout)) {
-          return;
-        }
-        self->try_direct_reconnect(h);
-      },
-      nullptr, &handle->timer_handle);
-  if (res < 0) {
-    FWLOGERROR(
-        "atbus node {:#x} failed to add timer for connection handle of bus id {:#x}, error code: {}, "
-        "timeout: {:%F %T}, timer_expired: {}, pending_timer_timeout: {:%F %T}",
-        get_owner()->get_app_id(), handle->current_bus_id, res, timeout, handle->timer_handle.expired(),
-        handle->pending_timer_timeout);
+          self->on_reconnect_bucket_timeout(bucket_timeout);
+        },
+        nullptr, &bucket.timer_handle);
+    if (res < 0) {
+      reconnect_buckets_.erase(bucket_timeout);
+      FWLOGERROR(
+          "atbus node {:#x} failed to add timer for connection handle of bus id {:#x}, error code: {}, "
+          "timeout: {:%F %T}",
+          get_owner()->get_app_id(), handle->current_bus_id, res, bucket_timeout);
 #if !defined(NDEBUG)
-    handle->last_update_timer_error = res;
+      handle->last_update_timer_error = res;
 #endif
-    return;
+      return;
+    }
+
+    bucket_iter = reconnect_buckets_.find(bucket_timeout);
   }
+
+  bucket_iter->second.handles[handle->current_bus_id] = atfw::util::memory::weak_rc_ptr<atbus_connection_handle_data>(
+      handle);
 #if !defined(NDEBUG)
   handle->last_update_timer_error = 0;
 #endif
-  handle->pending_timer_timeout = timeout;
+  handle->pending_timer_timeout = bucket_timeout;
 }
 
 void atapp_connector_atbus::remove_timer(const atbus_connection_handle_ptr_t &handle) {
@@ -1079,8 +1082,139 @@ void atapp_connector_atbus::remove_timer(const atbus_connection_handle_ptr_t &ha
   FWLOGDEBUG("atbus node {:#x} remove timer for connection handle of bus id {:#x} timeout at {:%F %T}",
              get_owner()->get_app_id(), handle->current_bus_id, handle->pending_timer_timeout);
 
+  auto bucket_iter = reconnect_buckets_.find(handle->pending_timer_timeout);
   handle->pending_timer_timeout = std::chrono::system_clock::from_time_t(0);
-  get_owner()->remove_custom_timer(handle->timer_handle);
+  if (bucket_iter == reconnect_buckets_.end()) {
+    return;
+  }
+
+  auto handle_iter = bucket_iter->second.handles.find(handle->current_bus_id);
+  if (handle_iter != bucket_iter->second.handles.end() && handle_iter->second.lock().get() == handle.get()) {
+    bucket_iter->second.handles.erase(handle_iter);
+  }
+
+  if (bucket_iter->second.handles.empty()) {
+    get_owner()->remove_custom_timer(bucket_iter->second.timer_handle);
+    reconnect_buckets_.erase(bucket_iter);
+  }
+}
+
+void atapp_connector_atbus::on_reconnect_bucket_timeout(atfw::util::time::time_utility::raw_time_t bucket_timeout) {
+  auto bucket_iter = reconnect_buckets_.find(bucket_timeout);
+  if (bucket_iter == reconnect_buckets_.end()) {
+    return;
+  }
+
+  std::vector<atbus_connection_handle_ptr_t> pending_handles;
+  pending_handles.reserve(bucket_iter->second.handles.size());
+  for (auto &handle : bucket_iter->second.handles) {
+    atbus_connection_handle_ptr_t h = handle.second.lock();
+    if (h && h->pending_timer_timeout == bucket_timeout) {
+      pending_handles.push_back(h);
+    }
+  }
+  reconnect_buckets_.erase(bucket_iter);
+
+  ++reconnect_stats_.wakeup_times;
+  if (pending_handles.size() > reconnect_stats_.max_bucket_handles) {
+    reconnect_stats_.max_bucket_handles = pending_handles.size();
+  }
+
+  const auto &conf = get_owner()->get_origin_configure().bus();
+  uint32_t max_concurrency = conf.reconnect_max_concurrency();
+  size_t started_count = 0;
+  size_t deferred_count = 0;
+
+  for (auto &h : pending_handles) {
+    // 前面的handle处理过程中可能已经重新调度或移除了后面的handle
+    if (h->pending_timer_timeout != bucket_timeout) {
+      continue;
+    }
+    h->pending_timer_timeout = std::chrono::system_clock::from_time_t(0);
+
+    FWLOGDEBUG("atbus timer callback fired for bus id {:#x}, retry_times={}", h->current_bus_id,
+               h->reconnect_retry_times);
+
+    std::chrono::system_clock::time_point next_timer_timeout = std::chrono::system_clock::from_time_t(0);
+    if (!process_handle_timeout(h, next_timer_timeout)) {
+      continue;
+    }
+
+    // 超出单次唤醒的重连并发限制，顺延到下一个桶，不增加重连次数
+    if (max_concurrency > 0 && started_count >= max_concurrency) {
+      std::chrono::system_clock::time_point deferred_timeout =
+          app::get_sys_now() +
+          std::chrono::duration_cast<std::chrono::system_clock::duration>(reconnect_bucket_interval_);
+      if (next_timer_timeout == std::chrono::system_clock::from_time_t(0) || deferred_timeout < next_timer_timeout) {
+        next_timer_timeout = deferred_timeout;
+      }
+      ++deferred_count;
+      update_timer(h, next_timer_timeout);
+      continue;
+    }
+
+    if (!setup_reconnect_timer(handles_.find(h->current_bus_id), next_timer_timeout)) {
+      continue;
+    }
+    ++started_count;
+    try_direct_reconnect(h);
+  }
+
+  reconnect_stats_.reconnect_started += started_count;
+  reconnect_stats_.reconnect_deferred += deferred_count;
+  if (deferred_count > 0) {
+    ++reconnect_stats_.storm_times;
+    FWLOGWARNING(
+        "atbus node {:#x} reconnect storm detected, {} handles in bucket {:%F %T}, {} reconnects started and {} "
+        "deferred",
+        get_owner()->get_app_id(), pending_handles.size(), bucket_timeout, started_count, deferred_count);
+  }
+}
+
+bool atapp_connector_atbus::process_handle_timeout(const atbus_connection_handle_ptr_t &h,
+                                                   std::chrono::system_clock::time_point &next_timer_timeout) {
+  // 检查handle是否仍然有效
+  auto iter = handles_.find(h->current_bus_id);
+  if (iter == handles_.end()) {
+    return false;
+  }
+  if (iter->second != h) {
+    return false;
+  }
+
+  std::chrono::system_clock::time_point sys_now = app::get_sys_now();
+
+  // 处理丢失拓扑后的重连超时则直接移除
+  if (check_flag(h->flags, atbus_connection_handle_flags_t::kLostTopology)) {
+    if (sys_now >= h->lost_topology_timeout) {
+      FWLOGWARNING("atbus node {:#x} remove connection handle to bus id {:#x} for lost topology timeout",
+                   get_owner()->get_app_id(), h->current_bus_id);
+      remove_connection_handle(iter);
+      return false;
+    }
+    next_timer_timeout = h->lost_topology_timeout;
+  }
+
+  // 如果处于就绪状态则不需要重连和移除
+  if (check_flag(h->flags, atbus_connection_handle_flags_t::kReady)) {
+    if (next_timer_timeout != std::chrono::system_clock::from_time_t(0)) {
+      update_timer(h, next_timer_timeout);
+    }
+    return false;
+  }
+
+  // 重连时间未到则继续等待
+  if (h->reconnect_next_timepoint > sys_now) {
+    if (next_timer_timeout == std::chrono::system_clock::from_time_t(0) ||
+        next_timer_timeout > h->reconnect_next_timepoint) {
+      next_timer_timeout = h->reconnect_next_timepoint;
+    }
+
+    update_timer(h, next_timer_timeout);
+    return false;
+  }
+
+  return true;
 }
 
 bool atapp_connector_atbus::setup_reconnect_timer(const handle_map_t::iterator &iter,
@@ -1124,6 +1258,21 @@ bool atapp_connector_atbus::setup_reconnect_timer(const handle_map_t::iterator &
     }
     --calc_interval;
   }
+  // 增加随机抖动，避免网络分区恢复后大量handle同时重连
+  std::chrono::microseconds reconnect_jitter;
+  protobuf_to_chrono_set_duration(reconnect_jitter, conf.reconnect_jitter());
+  if (reconnect_jitter > reconnect_cur_interval) {
+    reconnect_jitter = reconnect_cur_interval;
+  }
+  if (reconnect_jitter > std::chrono::microseconds(0)) {
+    // Keep the interval not greater than reconnect_max_interval, and still spread handles at the max interval
+    if (reconnect_cur_interval + reconnect_jitter > reconnect_max_interval) {
+      reconnect_cur_interval = reconnect_max_interval - reconnect_jitter;
+    }
+    reconnect_cur_interval += std::chrono::microseconds(
+        reconnect_random_generator_.random_between<int64_t>(0, static_cast<int64_t>(reconnect_jitter.count())));
+  }
+
   auto sys_now = app::get_sys_now();
   std::chrono::system_clock::time_point reconnect_run_timeout =
       sys_now + std::chrono::duration_cast<std::chrono::system_clock::duration>(reconnect_cur_interval);
@@ -1185,7 +1334,9 @@ int32_t atapp_connector_atbus::try_direct_reconnect(const atbus_connection_handl
 
   int32_t ret = try_connect_to(*discovery, handle->app_handle, false);
   if (ret < 0) {
-    FWLOGERROR("reconnect to bus id {:#x} failed with error code {}", handle->current_bus_id, ret);
+    // A peer which is always unavailable may flood logs here
+    LIBATAPP_MACRO_RATE_LIMITED_LOG_ERROR("reconnect to bus id {:#x} failed with error code {}", handle->current_bus_id,
+                                          ret);
   }
 
   return ret;
@@ -1648,6 +1799,8 @@ void atapp_connector_atbus::remove_connection_handle(const handle_map_t::iterato
     return;
   }
 
+  remove_timer(handle_data);
+
   // 移除代理关系的上游关系
   if (handle_data->proxy_bus_id != 0) {
     auto upstream_iter = handles_.find(handle_data->proxy_bus_id);
@@ -136,7 +136,7 @@ LIBATAPP_MACRO_API void atapp_connector_loopback::on_receive_forward_response(
     if (0 != sender.id) {
       sender.remote = owner->get_endpoint(sender.id);
     } else {
-      sender.remote = owner->get_endpoint(static_cast<std::string>(sender.name));
+      sender.remote = owner->get_endpoint(sender.name);
     }
   }
 
@@ -175,7 +175,7 @@ LIBATAPP_MACRO_API int32_t atapp_connector_loopback::process(
       sender.name = owner->get_app_name();
       // endpoint maybe replaced in callback , so we need refind it every time
       if (0 == sender.id) {
-        sender.remote = owner->get_endpoint(static_cast<std::string>(sender.name));
+        sender.remote = owner->get_endpoint(sender.name);
       } else {
         sender.remote = owner->get_endpoint(sender.id);
       }
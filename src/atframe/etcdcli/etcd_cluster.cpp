@@ -4,6 +4,11 @@
 
 #include <assert.h>
 
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <unordered_set>
+
 #include <libatbus.h>
 
 #include <std/explicit_declare.h>
@@ -25,12 +30,19 @@
 #include <atframe/etcdcli/etcd_cluster.h>
 
 #include <atframe/atapp.h>
+#include <atframe/atapp_flat_hash_map.h>
+#include <atframe/atapp_log_rate_limit.h>
 
 // Patch for MSVC
 #if defined(GetObject)
 #  undef GetObject
 #endif
 
+// Check level of the etcd logger and the default category first, then the rate limit of etcd logs
+#define LIBATAPP_MACRO_ETCD_CLUSTER_LOG_RATE_LIMIT_CHECK(cluster, LEVEL) \
+  ((cluster).check_log_level(LEVEL) &&                                   \
+   LIBATAPP_MACRO_LOG_RATE_LIMIT_CHECK(::atframework::atapp::log_rate_limiter::kCategoryEtcd))
+
 LIBATAPP_MACRO_NAMESPACE_BEGIN
 /**
  * @note APIs just like this
@@ -87,6 +99,10 @@ LIBATAPP_MACRO_NAMESPACE_BEGIN
 #define ETCD_API_V3_KV_GET "/v3/kv/range"
 #define ETCD_API_V3_KV_SET "/v3/kv/put"
 #define ETCD_API_V3_KV_DELETE "/v3/kv/deleterange"
+#define ETCD_API_V3_KV_TXN "/v3/kv/txn"
+
+// Default value of --max-txn-ops of etcd
+#define ETCD_API_V3_KV_TXN_MAX_OPS 128
 
 #define ETCD_API_V3_WATCH "/v3/watch"
 
@@ -94,6 +110,19 @@ LIBATAPP_MACRO_NAMESPACE_BEGIN
 #define ETCD_API_V3_LEASE_KEEPALIVE "/v3/lease/keepalive"
 #define ETCD_API_V3_LEASE_REVOKE "/v3/kv/lease/revoke"
 
+#define ETCD_API_V3_MAINTENANCE_STATUS "/v3/maintenance/status"
+
+// Smoothing factors of member health, the same as SRTT and RTTVAR in RFC 6298
+#define ETCD_MEMBER_HEALTH_LATENCY_ALPHA 0.125
+#define ETCD_MEMBER_HEALTH_LATENCY_BETA 0.25
+#define ETCD_MEMBER_HEALTH_ERROR_ALPHA 0.2
+// Samples before a member's health data is trusted for failover
+#define ETCD_MEMBER_HEALTH_MIN_SAMPLES 8
+// Failover when tail latency of selected member is larger than ratio * other member's and also exceed the margin
+#define ETCD_MEMBER_HEALTH_FAILOVER_LATENCY_RATIO 2.0
+#define ETCD_MEMBER_HEALTH_FAILOVER_LATENCY_MARGIN_US 1000.0
+#define ETCD_MEMBER_HEALTH_FAILOVER_ERROR_RATE 0.5
+
 namespace {
 static const std::string &get_default_user_agent() {
   static std::string ret;
@@ -188,11 +217,30 @@ EXPLICIT_UNUSED_ATTR static int etcd_cluster_verbose_callback(atfw::util::networ
 }
 }  // namespace
 
+struct etcd_cluster::lease_share_group_t {
+  std::string key;
+  std::vector<etcd_cluster *> members;  // members[0] is the leader, which grants and renews lease and token
+
+  // The group key contains the curl multi context, so all members of a group always run in the same thread.
+  // The lock only protects the registry itself, which is shared by clusters of all threads.
+  static std::mutex &get_registry_lock() {
+    static std::mutex ret;
+    return ret;
+  }
+
+  static std::unordered_map<std::string, std::weak_ptr<lease_share_group_t> > &get_registry() {
+    static std::unordered_map<std::string, std::weak_ptr<lease_share_group_t> > ret;
+    return ret;
+  }
+};
+
 LIBATAPP_MACRO_API etcd_cluster::etcd_cluster()
     : flags_(0),
       stats_{},
       startup_log_level_(atfw::util::log::log_level::kDisabled),
-      runtime_log_level_(atfw::util::log::log_level::kDisabled) {
+      runtime_log_level_(atfw::util::log::log_level::kDisabled),
+      keepalive_batch_set_sequence_(0),
+      member_failover_pending_(false) {
   conf_.authorization_next_update_time = std::chrono::system_clock::from_time_t(0);
   conf_.authorization_retry_interval = std::chrono::seconds(5);
   conf_.auth_user_get_next_update_time = std::chrono::system_clock::from_time_t(0);
@@ -206,6 +254,10 @@ LIBATAPP_MACRO_API etcd_cluster::etcd_cluster()
   conf_.etcd_members_update_interval = std::chrono::minutes(5);
   conf_.etcd_members_retry_interval = std::chrono::minutes(1);
   conf_.etcd_members_init_retry_interval = std::chrono::seconds(3);
+  conf_.etcd_members_latency_aware_select = false;
+  conf_.etcd_members_probe_interval = std::chrono::seconds(30);
+  conf_.etcd_members_next_probe_time = std::chrono::system_clock::from_time_t(0);
+  conf_.etcd_members_next_select_time = std::chrono::system_clock::from_time_t(0);
 
   conf_.lease = 0;
   conf_.keepalive_next_update_time = std::chrono::system_clock::from_time_t(0);
@@ -213,11 +265,14 @@ LIBATAPP_MACRO_API etcd_cluster::etcd_cluster()
   conf_.keepalive_interval = std::chrono::seconds(5);
   conf_.keepalive_retry_interval = std::chrono::seconds(3);
   conf_.keepalive_retry_times = 8;
+  conf_.keepalive_batch_set = false;
+  conf_.keepalive_share_lease = false;
 
   conf_.ssl_enable_alpn = true;
   conf_.ssl_verify_peer = false;
   conf_.http_debug_mode = false;
   conf_.auto_update_hosts = true;
+  conf_.http2_multiplexing = false;
 
   conf_.ssl_min_version = ssl_version_t::kDisabled;
   conf_.user_agent.clear();
@@ -269,7 +324,38 @@ LIBATAPP_MACRO_API atfw::util::network::http_request::ptr_t etcd_cluster::close(
     rpc_keepalive_.reset();
   }
 
+  // Other clusters are still using the shared lease, so just remove data of this cluster instead of revoking it
+  // The paths are handed over to another member, which keeps running and retries the deletion when it fails
+  etcd_cluster *lease_share_successor = nullptr;
+  if (lease_share_group_) {
+    for (auto &member : lease_share_group_->members) {
+      if (member != this) {
+        lease_share_successor = member;
+        break;
+      }
+    }
+  }
+  bool lease_shared = nullptr != lease_share_successor;
+  std::vector<lease_share_release_path_t> lease_share_release_paths;
+  if (lease_shared && revoke_lease) {
+    lease_share_release_paths.reserve(keepalive_actors_.size() + keepalive_deletors_.size());
+    for (auto &keepalive : keepalive_actors_) {
+      if (keepalive && keepalive->has_data()) {
+        lease_share_release_paths.push_back(
+            lease_share_release_path_t{keepalive->get_path(), reinterpret_cast<void *>(keepalive.get())});
+      }
+    }
+    for (auto &keepalive_deletor : keepalive_deletors_) {
+      if (nullptr != keepalive_deletor.second) {
+        lease_share_release_paths.push_back(
+            lease_share_release_path_t{keepalive_deletor.first, keepalive_deletor.second->keepalive_addr});
+      }
+    }
+  }
+  leave_lease_share_group();
+
   cleanup_keepalive_deletors();
+  cancel_keepalive_batch_set();
 
   if (rpc_update_members_) {
     rpc_update_members_->set_on_complete(nullptr);
@@ -277,6 +363,12 @@ LIBATAPP_MACRO_API atfw::util::network::http_request::ptr_t etcd_cluster::close(
     rpc_update_members_.reset();
   }
 
+  if (rpc_probe_member_) {
+    rpc_probe_member_->set_on_complete(nullptr);
+    rpc_probe_member_->stop();
+    rpc_probe_member_.reset();
+  }
+
   if (rpc_authenticate_) {
     rpc_authenticate_->set_on_complete(nullptr);
     rpc_authenticate_->stop();
@@ -301,7 +393,11 @@ LIBATAPP_MACRO_API atfw::util::network::http_request::ptr_t etcd_cluster::close(
   atfw::util::network::http_request::ptr_t ret;
   if (curl_multi_) {
     if (0 != conf_.lease) {
-      if (revoke_lease) {
+      if (lease_shared) {
+        if (!lease_share_release_paths.empty()) {
+          lease_share_successor->take_over_lease_share_paths(lease_share_release_paths, *this);
+        }
+      } else if (revoke_lease) {
         ret = create_request_lease_revoke();
 
         // wait to delete content
@@ -324,6 +420,9 @@ LIBATAPP_MACRO_API atfw::util::network::http_request::ptr_t etcd_cluster::close(
 
 LIBATAPP_MACRO_API void etcd_cluster::reset() {
   close(true, true);
+  cleanup_stats_request_tracking(true);
+  member_health_.clear();
+  member_failover_pending_ = false;
 
   curl_multi_.reset();
   flags_ = 0;
@@ -345,6 +444,10 @@ LIBATAPP_MACRO_API void etcd_cluster::reset() {
   conf_.etcd_members_update_interval = std::chrono::minutes(5);
   conf_.etcd_members_retry_interval = std::chrono::minutes(1);
   conf_.etcd_members_init_retry_interval = std::chrono::seconds(3);
+  conf_.etcd_members_latency_aware_select = false;
+  conf_.etcd_members_probe_interval = std::chrono::seconds(30);
+  conf_.etcd_members_next_probe_time = std::chrono::system_clock::from_time_t(0);
+  conf_.etcd_members_next_select_time = std::chrono::system_clock::from_time_t(0);
 
   conf_.lease = 0;
   conf_.keepalive_next_update_time = std::chrono::system_clock::from_time_t(0);
@@ -352,11 +455,14 @@ LIBATAPP_MACRO_API void etcd_cluster::reset() {
   conf_.keepalive_interval = std::chrono::seconds(5);
   conf_.keepalive_retry_interval = std::chrono::seconds(3);
   conf_.keepalive_retry_times = 8;
+  conf_.keepalive_batch_set = false;
+  conf_.keepalive_share_lease = false;
 
   conf_.ssl_enable_alpn = true;
   conf_.ssl_verify_peer = false;
   conf_.http_debug_mode = false;
   conf_.auto_update_hosts = true;
+  conf_.http2_multiplexing = false;
 
   conf_.ssl_min_version = ssl_version_t::kDisabled;
   conf_.user_agent.clear();
@@ -394,19 +500,34 @@ LIBATAPP_MACRO_API int etcd_cluster::tick() {
     return 0;
   }
 
+  // requests which are stopped or finished without reporting
+  cleanup_stats_request_tracking(false);
+
   // update members
   if (app::get_sys_now() > conf_.etcd_members_next_update_time) {
     ret += create_request_member_update() ? 1 : 0;
   }
 
+  if (conf_.etcd_members_latency_aware_select) {
+    // probe members which are not used recently to keep their health data fresh
+    if (app::get_sys_now() > conf_.etcd_members_next_probe_time) {
+      ret += create_request_member_probe() ? 1 : 0;
+    }
+
+    check_member_failover();
+  }
+
   // empty other actions will be delayed
   if (conf_.path_node.empty()) {
     return ret;
   }
 
+  // lease and authorization token of followers are maintained by the leader of share group
+  bool lease_share_follower = update_lease_share_group();
+
   // check or start authorization
   if (!check_authorization()) {
-    if (!rpc_authenticate_) {
+    if (!rpc_authenticate_ && !lease_share_follower) {
       ret += create_request_auth_authenticate() ? 1 : 0;
     }
 
@@ -414,19 +535,21 @@ LIBATAPP_MACRO_API int etcd_cluster::tick() {
   }
 
   // Send /v3/auth/user/get interval to renew auth token
-  if (!conf_.authorization.empty() && !rpc_authenticate_) {
+  if (!conf_.authorization.empty() && !rpc_authenticate_ && !lease_share_follower) {
     ret += create_request_auth_user_get() ? 1 : 0;
   }
 
   // keepalive lease
   if (check_flag(flag_t::kEnableLease)) {
     if (0 == get_lease()) {
-      ret += create_request_lease_grant() ? 1 : 0;
+      if (!lease_share_follower) {
+        ret += create_request_lease_grant() ? 1 : 0;
+      }
 
       // run actions after lease granted
       return ret;
     }
-    if (app::get_sys_now() > conf_.keepalive_next_update_time) {
+    if (!lease_share_follower && app::get_sys_now() > conf_.keepalive_next_update_time) {
       ret += create_request_lease_keepalive() ? 1 : 0;
     }
   } else if (!check_flag(flag_t::kRunning)) {
@@ -436,6 +559,9 @@ LIBATAPP_MACRO_API int etcd_cluster::tick() {
   // run pending
   retry_pending_actions();
 
+  // send data of keepalive actors in batch
+  ret += flush_keepalive_batch_set();
+
   // resolve ready flag
   if (!check_flag(flag_t::kReady) && check_flag(flag_t::kRunning)) {
     resolve_ready();
@@ -537,6 +663,15 @@ LIBATAPP_MACRO_API void etcd_cluster::set_flag(flag_t f, bool v) {
   }
 }
 
+LIBATAPP_MACRO_API bool etcd_cluster::check_log_level(atfw::util::log::log_level level) const noexcept {
+  if (logger_ && logger_->check_level(level)) {
+    return true;
+  }
+
+  return atfw::util::log::log_wrapper::check_level(WDTLOGGETCAT(atfw::util::log::log_wrapper::categorize_t::DEFAULT),
+                                                   level);
+}
+
 LIBATAPP_MACRO_API void etcd_cluster::set_logger(const atfw::util::log::log_wrapper::ptr_t &logger,
                                                  atfw::util::log::log_level log_level) noexcept {
   logger_ = logger;
@@ -666,8 +801,33 @@ LIBATAPP_MACRO_API bool etcd_cluster::remove_keepalive(const std::shared_ptr<etc
     }
   }
 
+  // The put of running batch request may be applied after the delete request, so delete path after it finished
+  bool wait_running_batch = false;
+  if (keepalive->rpc_.is_batch_pending) {
+    if (0 == keepalive->rpc_.batch_sequence) {
+      keepalive_batch_set_pending_actors_.erase(std::remove(keepalive_batch_set_pending_actors_.begin(),
+                                                            keepalive_batch_set_pending_actors_.end(), keepalive),
+                                                keepalive_batch_set_pending_actors_.end());
+    } else if (found) {
+      keepalive_batch_set_map_t::iterator batch_iter =
+          keepalive_batch_set_running_.find(keepalive->rpc_.batch_sequence);
+      if (batch_iter != keepalive_batch_set_running_.end()) {
+        keepalive_batch_cancelled_t cancelled;
+        cancelled.path = keepalive->get_path();
+        cancelled.keepalive_addr = keepalive.get();
+        cancelled.has_data = keepalive->has_data();
+        batch_iter->second.cancelled.emplace_back(std::move(cancelled));
+        wait_running_batch = true;
+      }
+    }
+    keepalive->rpc_.is_batch_pending = false;
+    keepalive->rpc_.batch_sequence = 0;
+  }
+
   if (found) {
-    if (keepalive->has_data()) {
+    if (wait_running_batch) {
+      keepalive->close(true);
+    } else if (keepalive->has_data()) {
       etcd_keepalive_deletor *keepalive_deletor = new etcd_keepalive_deletor();
       if (nullptr == keepalive_deletor) {
         LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(
@@ -835,6 +995,10 @@ int etcd_cluster::libcurl_callback_on_remove_keepalive_path(atfw::util::network:
       self->rpc.reset();
     }
 
+    if (nullptr != self->owner) {
+      self->owner->add_stats_request_finished(req);
+    }
+
     // 服务器错误则忽略，正常流程path不存在也会返回200，然后没有 deleted=1 。如果删除成功会有 deleted=1
     // 判定 404 只是是个防御性判定
     if (0 != req.get_error_code() ||
@@ -886,6 +1050,267 @@ int etcd_cluster::libcurl_callback_on_remove_keepalive_path(atfw::util::network:
   return 0;
 }
 
+LIBATAPP_MACRO_API bool etcd_cluster::add_keepalive_batch_set(const std::shared_ptr<etcd_keepalive> &keepalive) {
+  if (!keepalive) {
+    return false;
+  }
+
+  if (check_flag(flag_t::kClosing)) {
+    return false;
+  }
+
+  if (this != &keepalive->get_owner()) {
+    return false;
+  }
+
+  if (keepalive->rpc_.is_batch_pending) {
+    return true;
+  }
+
+  keepalive->rpc_.is_batch_pending = true;
+  keepalive->rpc_.batch_sequence = 0;
+  keepalive_batch_set_pending_actors_.push_back(keepalive);
+  return true;
+}
+
+int etcd_cluster::flush_keepalive_batch_set() {
+  if (keepalive_batch_set_pending_actors_.empty()) {
+    return 0;
+  }
+
+  // Keep pending and wait for the lease, all data will be written with the new lease
+  if (!curl_multi_ || conf_.path_node.empty() || check_flag(flag_t::kClosing) || 0 == get_lease()) {
+    return 0;
+  }
+
+  std::vector<std::shared_ptr<etcd_keepalive> > pending_actors;
+  pending_actors.swap(keepalive_batch_set_pending_actors_);
+
+  int ret = 0;
+  size_t actor_index = 0;
+  std::unordered_set<gsl::string_view, flat_string_hash, flat_string_equal> batch_paths;
+  while (actor_index < pending_actors.size()) {
+    uint64_t sequence = ++keepalive_batch_set_sequence_;
+
+    rapidjson::Document doc;
+    rapidjson::Value &root = doc.SetObject();
+    rapidjson::Value success_ops{rapidjson::kArrayType};
+    std::vector<std::shared_ptr<etcd_keepalive> > actors;
+    actors.reserve((std::min)(pending_actors.size() - actor_index, static_cast<size_t>(ETCD_API_V3_KV_TXN_MAX_OPS)));
+    batch_paths.clear();
+    for (; actor_index < pending_actors.size() && actors.size() < ETCD_API_V3_KV_TXN_MAX_OPS; ++actor_index) {
+      std::shared_ptr<etcd_keepalive> &actor = pending_actors[actor_index];
+      // Closed or removed
+      if (!actor || !actor->rpc_.is_batch_pending || 0 != actor->rpc_.batch_sequence) {
+        continue;
+      }
+
+      // etcd rejects the whole txn if a key is put twice, keep the later one pending for the next batch
+      if (!batch_paths.insert(gsl::string_view(actor->get_path().data(), actor->get_path().size())).second) {
+        keepalive_batch_set_pending_actors_.push_back(actor);
+        continue;
+      }
+
+      rapidjson::Value put_request{rapidjson::kObjectType};
+      etcd_packer::pack_base64(put_request, "key", actor->get_path(), doc);
+      etcd_packer::pack_base64(put_request, "value", actor->get_value(), doc);
+      put_request.AddMember("lease", get_lease(), doc.GetAllocator());
+
+      rapidjson::Value request_op{rapidjson::kObjectType};
+      request_op.AddMember("request_put", put_request, doc.GetAllocator());
+      success_ops.PushBack(request_op, doc.GetAllocator());
+
+      actor->rpc_.batch_sequence = sequence;
+      actor->rpc_.is_value_changed = false;
+      actors.push_back(actor);
+    }
+
+    if (actors.empty()) {
+      continue;
+    }
+    root.AddMember("success", success_ops, doc.GetAllocator());
+
+    atfw::util::network::http_request::ptr_t req = atfw::util::network::http_request::create(
+        curl_multi_.get(), LOG_WRAPPER_FWAPI_FORMAT("{}{}", conf_.path_node, ETCD_API_V3_KV_TXN));
+    int res = 0;
+    if (req) {
+      add_stats_create_request();
+      setup_http_request(req, doc, get_http_timeout_ms(), request_type_t::kKvTxn);
+      req->set_priv_data(this);
+      req->set_on_complete(libcurl_callback_on_keepalive_batch_set);
+
+      keepalive_batch_set_t &batch = keepalive_batch_set_running_[sequence];
+      batch.rpc = req;
+      batch.actors = actors;
+
+      res = req->start(atfw::util::network::http_request::method_t::EN_MT_POST, false);
+      if (res != 0) {
+        req->set_priv_data(nullptr);
+        req->set_on_complete(nullptr);
+        keepalive_batch_set_running_.erase(sequence);
+      }
+    } else {
+      add_stats_error_request();
+      res = -1;
+    }
+
+    if (res != 0) {
+      LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(*this,
+                                            "Etcd start batch request {} for {} keepalive(s) to {}{} failed, res: {}",
+                                            sequence, actors.size(), conf_.path_node, ETCD_API_V3_KV_TXN, res);
+      for (auto &actor : actors) {
+        actor->on_batch_set_data(sequence, false, false);
+      }
+      continue;
+    }
+
+    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(*this, "Etcd start batch request {} for {} keepalive(s) to {}", sequence,
+                                          actors.size(), req->get_url());
+    ++ret;
+  }
+
+  return ret;
+}
+
+void etcd_cluster::cancel_keepalive_batch_set() {
+  for (auto &actor : keepalive_batch_set_pending_actors_) {
+    if (actor) {
+      actor->rpc_.is_batch_pending = false;
+      actor->rpc_.batch_sequence = 0;
+    }
+  }
+  keepalive_batch_set_pending_actors_.clear();
+
+  keepalive_batch_set_map_t running_batches;
+  running_batches.swap(keepalive_batch_set_running_);
+  for (auto &batch : running_batches) {
+    if (batch.second.rpc) {
+      batch.second.rpc->set_on_complete(nullptr);
+      batch.second.rpc->set_priv_data(nullptr);
+      batch.second.rpc->stop();
+    }
+
+    for (auto &actor : batch.second.actors) {
+      if (actor && actor->rpc_.batch_sequence == batch.first) {
+        actor->rpc_.is_batch_pending = false;
+        actor->rpc_.batch_sequence = 0;
+        actor->rpc_.is_value_changed = true;
+      }
+    }
+  }
+}
+
+int etcd_cluster::libcurl_callback_on_keepalive_batch_set(atfw::util::network::http_request &req) {
+  etcd_cluster *self = reinterpret_cast<etcd_cluster *>(req.get_priv_data());
+  if (nullptr == self) {
+    FWLOGERROR("Etcd keepalive batch request shouldn't has request without private data");
+    return 0;
+  }
+  self->add_stats_request_finished(req);
+
+  uint64_t sequence = 0;
+  keepalive_batch_set_t batch;
+  for (auto iter = self->keepalive_batch_set_running_.begin(); iter != self->keepalive_batch_set_running_.end();
+       ++iter) {
+    if (iter->second.rpc.get() == &req) {
+      sequence = iter->first;
+      batch = std::move(iter->second);
+      self->keepalive_batch_set_running_.erase(iter);
+      break;
+    }
+  }
+
+  if (0 == sequence) {
+    return 0;
+  }
+
+  bool success = true;
+  // The txn has no compare, so it's only rejected by etcd when one of the puts is invalid. Write these keys by their
+  // own requests in the next retry, so one bad key will not fail all the other keys again.
+  bool retry_alone = false;
+  // 服务器错误则重试
+  if (0 != req.get_error_code() ||
+      atfw::util::network::http_request::status_code_t::EN_ECG_SUCCESS !=
+          atfw::util::network::http_request::get_status_code_group(req.get_response_code())) {
+    success = false;
+
+    std::string response_content = req.get_response_stream().str();
+    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(
+        *self, "Etcd batch request {} for {} keepalive(s) failed, error code: {}, http code: {}\n{}\n{}", sequence,
+        batch.actors.size(), req.get_error_code(), req.get_response_code(), req.get_error_msg(), response_content);
+
+    self->check_socket_error_code(req.get_error_code());
+    self->check_authorization_expired(req.get_response_code(), response_content);
+    retry_alone = 0 == req.get_error_code() && batch.actors.size() > 1;
+  } else {
+    std::string http_content;
+    req.get_response_stream().str().swap(http_content);
+    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_TRACE(*self, "Etcd batch request {} got http response: {}", sequence,
+                                          http_content);
+
+    rapidjson::Document doc;
+    bool succeeded = false;
+    if (atapp::etcd_packer::parse_object(doc, http_content.c_str())) {
+      etcd_packer::unpack_bool(doc, "succeeded", succeeded);
+    }
+
+    if (!succeeded) {
+      success = false;
+      retry_alone = batch.actors.size() > 1;
+      if (LIBATAPP_MACRO_ETCD_CLUSTER_LOG_RATE_LIMIT_CHECK(*self, atfw::util::log::log_level::kError)) {
+        LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(*self, "Etcd batch request {} for {} keepalive(s) failed, response: {}",
+                                              sequence, batch.actors.size(), http_content);
+      }
+    }
+  }
+
+  for (auto &actor : batch.actors) {
+    if (actor) {
+      actor->on_batch_set_data(sequence, success, retry_alone);
+    }
+  }
+
+  for (auto &cancelled : batch.cancelled) {
+    self->remove_keepalive_batch_cancelled_path(cancelled, success);
+  }
+
+  return 0;
+}
+
+void etcd_cluster::remove_keepalive_batch_cancelled_path(const keepalive_batch_cancelled_t &cancelled, bool written) {
+  // Nothing is written by this keepalive
+  if (!written && !cancelled.has_data) {
+    return;
+  }
+
+  if (check_flag(flag_t::kClosing)) {
+    return;
+  }
+
+  // The path is taken by another keepalive after removed
+  for (auto &actor : keepalive_actors_) {
+    if (actor && actor->get_path() == cancelled.path) {
+      return;
+    }
+  }
+
+  etcd_keepalive_deletor *keepalive_deletor = new etcd_keepalive_deletor();
+  if (nullptr == keepalive_deletor) {
+    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(
+        *this, "Etcd cluster try to delete keepalive {} path {} but malloc etcd_keepalive_deletor failed.",
+        cancelled.keepalive_addr, cancelled.path);
+    return;
+  }
+
+  LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(*this, "Etcd cluster delete path {} of keepalive {} removed in batch request",
+                                        cancelled.path, cancelled.keepalive_addr);
+  keepalive_deletor->retry_times = 0;
+  keepalive_deletor->path = cancelled.path;
+  keepalive_deletor->keepalive_addr = cancelled.keepalive_addr;
+  keepalive_deletor->owner = nullptr;
+  remove_keepalive_path(keepalive_deletor, false);
+}
+
 void etcd_cluster::retry_pending_actions() {
   // retry keepalive in retry list
   if (0 != get_lease()) {
@@ -920,6 +1345,10 @@ void etcd_cluster::set_lease(int64_t v, bool force_active_keepalives) {
   int64_t old_v = get_lease();
   conf_.lease = v;
 
+  if (old_v != v) {
+    sync_lease_share_followers();
+  }
+
   if (old_v == v && false == force_active_keepalives && v != 0) {
     retry_pending_actions();
     return;
@@ -940,6 +1369,160 @@ void etcd_cluster::set_lease(int64_t v, bool force_active_keepalives) {
   }
 }
 
+bool etcd_cluster::update_lease_share_group() {
+  if (!conf_.keepalive_share_lease || !check_flag(flag_t::kEnableLease) || check_flag(flag_t::kClosing) ||
+      !curl_multi_) {
+    leave_lease_share_group();
+    return false;
+  }
+
+  if (!lease_share_group_) {
+    // Do not give up a lease already granted, share it after restart
+    if (0 != get_lease() || rpc_keepalive_) {
+      return false;
+    }
+
+    std::vector<std::string> hosts = conf_.conf_hosts;
+    std::sort(hosts.begin(), hosts.end());
+    std::string key = LOG_WRAPPER_FWAPI_FORMAT(
+        "{}|{}|{}|", reinterpret_cast<const void *>(curl_multi_.get()),
+        std::chrono::duration_cast<std::chrono::seconds>(conf_.keepalive_timeout).count(), conf_.authorization);
+    for (auto &host : hosts) {
+      key += host;
+      key += ',';
+    }
+
+    std::lock_guard<std::mutex> lock_guard{lease_share_group_t::get_registry_lock()};
+    std::weak_ptr<lease_share_group_t> &group_ref = lease_share_group_t::get_registry()[key];
+    lease_share_group_ = group_ref.lock();
+    if (!lease_share_group_) {
+      lease_share_group_ = std::make_shared<lease_share_group_t>();
+      lease_share_group_->key = key;
+      group_ref = lease_share_group_;
+    }
+    lease_share_group_->members.push_back(this);
+
+    if (lease_share_group_->members.size() > 1) {
+      LIBATAPP_MACRO_ETCD_CLUSTER_LOG_INFO(*this, "Etcd cluster {} share lease with {} other cluster(s), leader: {}",
+                                           reinterpret_cast<const void *>(this),
+                                           lease_share_group_->members.size() - 1,
+                                           reinterpret_cast<const void *>(lease_share_group_->members.front()));
+    }
+  }
+
+  if (!is_lease_share_follower()) {
+    return false;
+  }
+
+  const etcd_cluster *leader = lease_share_group_->members.front();
+  if (conf_.authorization_header != leader->conf_.authorization_header) {
+    conf_.authorization_header = leader->conf_.authorization_header;
+    conf_.authorization_user_roles = leader->conf_.authorization_user_roles;
+    if (!conf_.authorization_header.empty()) {
+      retry_pending_actions();
+    }
+  }
+
+  if (get_lease() != leader->get_lease()) {
+    if (0 != leader->get_lease() && !check_flag(flag_t::kRunning)) {
+      set_flag(flag_t::kRunning, true);
+    }
+    set_lease(leader->get_lease(), true);
+  }
+
+  return true;
+}
+
+void etcd_cluster::leave_lease_share_group() {
+  if (!lease_share_group_) {
+    return;
+  }
+
+  std::shared_ptr<lease_share_group_t> group;
+  group.swap(lease_share_group_);
+
+  bool is_leader = !group->members.empty() && group->members.front() == this;
+  group->members.erase(std::remove(group->members.begin(), group->members.end(), this), group->members.end());
+
+  if (group->members.empty()) {
+    std::lock_guard<std::mutex> lock_guard{lease_share_group_t::get_registry_lock()};
+    auto &registry = lease_share_group_t::get_registry();
+    auto iter = registry.find(group->key);
+    if (iter != registry.end() && iter->second.lock() == group) {
+      registry.erase(iter);
+    }
+    return;
+  }
+
+  if (is_leader) {
+    group->members.front()->take_over_lease_share_leader(*this);
+  }
+}
+
+void etcd_cluster::take_over_lease_share_leader(const etcd_cluster &previous_leader) {
+  // The new leader already has the lease and token, just renew them as soon as possible
+  conf_.keepalive_next_update_time = std::chrono::system_clock::from_time_t(0);
+  LIBATAPP_MACRO_ETCD_CLUSTER_LOG_INFO(*this, "Etcd cluster {} take over shared lease {} from {}",
+                                       reinterpret_cast<const void *>(this), get_lease(),
+                                       reinterpret_cast<const void *>(&previous_leader));
+}
+
+void etcd_cluster::take_over_lease_share_paths(const std::vector<lease_share_release_path_t> &paths,
+                                               const etcd_cluster &previous_owner) {
+  if (check_flag(flag_t::kClosing)) {
+    return;
+  }
+
+  LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(*this, "Etcd cluster {} start to remove {} path(s) of {} in shared lease {}",
+                                        reinterpret_cast<const void *>(this), paths.size(),
+                                        reinterpret_cast<const void *>(&previous_owner), get_lease());
+  for (auto &release_path : paths) {
+    etcd_keepalive_deletor *keepalive_deletor = new etcd_keepalive_deletor();
+    if (nullptr == keepalive_deletor) {
+      LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(
+          *this, "Etcd cluster try to delete keepalive {} path {} but malloc etcd_keepalive_deletor failed.",
+          release_path.keepalive_addr, release_path.path);
+      continue;
+    }
+
+    keepalive_deletor->retry_times = 0;
+    keepalive_deletor->path = release_path.path;
+    keepalive_deletor->keepalive_addr = release_path.keepalive_addr;
+    keepalive_deletor->owner = nullptr;
+    remove_keepalive_path(keepalive_deletor, false);
+  }
+}
+
+bool etcd_cluster::is_lease_share_follower() const noexcept {
+  return lease_share_group_ && !lease_share_group_->members.empty() && lease_share_group_->members.front() != this;
+}
+
+void etcd_cluster::sync_lease_share_followers() {
+  if (!lease_share_group_ || is_lease_share_follower()) {
+    return;
+  }
+
+  // Followers may be removed when syncing
+  std::vector<etcd_cluster *> members = lease_share_group_->members;
+  for (auto &member : members) {
+    if (member != this) {
+      member->update_lease_share_group();
+    }
+  }
+}
+
+LIBATAPP_MACRO_API size_t etcd_cluster::get_lease_share_count() const noexcept {
+  if (!lease_share_group_) {
+    return 0;
+  }
+
+  return lease_share_group_->members.size();
+}
+
+LIBATAPP_MACRO_API bool etcd_cluster::is_lease_share_leader() const noexcept {
+  return lease_share_group_ && !lease_share_group_->members.empty() && lease_share_group_->members.front() == this;
+}
+
 bool etcd_cluster::create_request_auth_authenticate() {
   if (!curl_multi_) {
     return false;
@@ -987,7 +1570,7 @@ bool etcd_cluster::create_request_auth_authenticate() {
     doc.AddMember("name", rapidjson::StringRef(username.c_str(), username.size()), doc.GetAllocator());
     doc.AddMember("password", rapidjson::StringRef(password.c_str(), password.size()), doc.GetAllocator());
 
-    setup_http_request(req, doc, get_http_timeout_ms());
+    setup_http_request(req, doc, get_http_timeout_ms(), request_type_t::kAuthenticate);
     req->set_priv_data(this);
     req->set_on_complete(libcurl_callback_on_auth_authenticate);
 
@@ -1028,6 +1611,7 @@ int etcd_cluster::libcurl_callback_on_auth_authenticate(atfw::util::network::htt
     FWLOGERROR("Etcd authenticate shouldn't has request without private data");
     return 0;
   }
+  self->add_stats_request_finished(req);
 
   atfw::util::network::http_request::ptr_t keep_rpc = self->rpc_authenticate_;
   self->rpc_authenticate_.reset();
@@ -1044,9 +1628,11 @@ int etcd_cluster::libcurl_callback_on_auth_authenticate(atfw::util::network::htt
     self->add_stats_error_request();
 
     std::string response_content = req.get_response_stream().str();
-    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(*self, "Etcd authenticate failed, error code: {}, http code: {}\n{}\n{}",
-                                          req.get_error_code(), req.get_response_code(), req.get_error_msg(),
-                                          response_content);
+    if (LIBATAPP_MACRO_ETCD_CLUSTER_LOG_RATE_LIMIT_CHECK(*self, atfw::util::log::log_level::kError)) {
+      LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(*self, "Etcd authenticate failed, error code: {}, http code: {}\n{}\n{}",
+                                            req.get_error_code(), req.get_response_code(), req.get_error_msg(),
+                                            response_content);
+    }
     self->check_authorization_expired(req.get_response_code(), response_content);
     return 0;
   }
@@ -1075,6 +1661,7 @@ int etcd_cluster::libcurl_callback_on_auth_authenticate(atfw::util::network::htt
 
     self->add_stats_success_request();
     self->retry_pending_actions();
+    self->sync_lease_share_followers();
 
     // Renew user token later
     if (std::chrono::system_clock::duration::zero() >= self->conf_.auth_user_get_retry_interval) {
@@ -1132,7 +1719,7 @@ bool etcd_cluster::create_request_auth_user_get() {
     doc.SetObject();
     doc.AddMember("name", rapidjson::StringRef(username.c_str(), username.size()), doc.GetAllocator());
 
-    setup_http_request(req, doc, get_http_timeout_ms());
+    setup_http_request(req, doc, get_http_timeout_ms(), request_type_t::kAuthUserGet);
     req->set_priv_data(this);
     req->set_on_complete(libcurl_callback_on_auth_user_get);
 
@@ -1168,6 +1755,7 @@ int etcd_cluster::libcurl_callback_on_auth_user_get(atfw::util::network::http_re
     FWLOGERROR("Etcd user get shouldn't has request without private data");
     return 0;
   }
+  self->add_stats_request_finished(req);
 
   atfw::util::network::http_request::ptr_t keep_rpc = self->rpc_authenticate_;
   self->rpc_authenticate_.reset();
@@ -1343,7 +1931,7 @@ bool etcd_cluster::create_request_member_update() {
     rapidjson::Document doc;
     doc.SetObject();
 
-    setup_http_request(req, doc, get_http_timeout_ms());
+    setup_http_request(req, doc, get_http_timeout_ms(), request_type_t::kMemberList);
     req->set_priv_data(this);
     req->set_on_complete(libcurl_callback_on_member_update);
 
@@ -1373,6 +1961,7 @@ int etcd_cluster::libcurl_callback_on_member_update(atfw::util::network::http_re
     FWLOGERROR("Etcd member list shouldn't has request without private data");
     return 0;
   }
+  self->add_stats_request_finished(req);
 
   atfw::util::network::http_request::ptr_t keep_rpc = self->rpc_update_members_;
   self->rpc_update_members_.reset();
@@ -1385,9 +1974,12 @@ int etcd_cluster::libcurl_callback_on_member_update(atfw::util::network::http_re
     if (0 != req.get_error_code()) {
       self->retry_request_member_update(req.get_url());
     }
-    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(*self, "Etcd member list failed, error code: {}, http code: {}\n{}\n{}",
-                                          req.get_error_code(), req.get_response_code(), req.get_error_msg(),
-                                          req.get_response_stream().str());
+    // Member update is retried on error, log may be flooded when etcd is unavailable
+    if (LIBATAPP_MACRO_ETCD_CLUSTER_LOG_RATE_LIMIT_CHECK(*self, atfw::util::log::log_level::kError)) {
+      LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(*self, "Etcd member list failed, error code: {}, http code: {}\n{}\n{}",
+                                            req.get_error_code(), req.get_response_code(), req.get_error_msg(),
+                                            req.get_response_stream().str());
+    }
     self->add_stats_error_request();
 
     return 0;
@@ -1439,6 +2031,7 @@ int etcd_cluster::libcurl_callback_on_member_update(atfw::util::network::http_re
       }
     }
 
+    self->cleanup_member_health();
     if (need_select_node) {
       self->select_cluster_member();
     }
@@ -1507,7 +2100,7 @@ bool etcd_cluster::create_request_lease_grant() {
         "TTL", static_cast<int64_t>(std::chrono::duration_cast<std::chrono::seconds>(conf_.keepalive_timeout).count()),
         doc.GetAllocator());
 
-    setup_http_request(req, doc, request_timeout_ms);
+    setup_http_request(req, doc, request_timeout_ms, request_type_t::kLeaseGrant);
     req->set_priv_data(this);
     req->set_on_complete(libcurl_callback_on_lease_keepalive);
 
@@ -1581,15 +2174,17 @@ bool etcd_cluster::create_request_lease_keepalive() {
     doc.SetObject();
     doc.AddMember("ID", get_lease(), doc.GetAllocator());
 
-    setup_http_request(req, doc, request_timeout_ms);
+    setup_http_request(req, doc, request_timeout_ms, request_type_t::kLeaseKeepalive);
     req->set_priv_data(this);
     req->set_on_complete(libcurl_callback_on_lease_keepalive);
 
     int res = req->start(atfw::util::network::http_request::method_t::EN_MT_POST, false);
     if (res != 0) {
       req->set_on_complete(nullptr);
-      LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(*this, "Etcd start keepalive lease {} request to {} failed, res: {}",
-                                            get_lease(), req->get_url().c_str(), res);
+      if (LIBATAPP_MACRO_ETCD_CLUSTER_LOG_RATE_LIMIT_CHECK(*this, atfw::util::log::log_level::kError)) {
+        LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(*this, "Etcd start keepalive lease {} request to {} failed, res: {}",
+                                              get_lease(), req->get_url().c_str(), res);
+      }
       add_stats_error_request();
       return false;
     }
@@ -1616,6 +2211,7 @@ int etcd_cluster::libcurl_callback_on_lease_keepalive(atfw::util::network::http_
     FWLOGERROR("Etcd lease keepalive shouldn't has request without private data");
     return 0;
   }
+  self->add_stats_request_finished(req);
 
   atfw::util::network::http_request::ptr_t keep_rpc = self->rpc_keepalive_;
   self->rpc_keepalive_.reset();
@@ -1720,7 +2316,7 @@ atfw::util::network::http_request::ptr_t etcd_cluster::create_request_lease_revo
     doc.SetObject();
     doc.AddMember("ID", get_lease(), doc.GetAllocator());
 
-    setup_http_request(ret, doc, get_http_timeout_ms());
+    setup_http_request(ret, doc, get_http_timeout_ms(), request_type_t::kLeaseRevoke);
   } else {
     add_stats_error_request();
   }
@@ -1747,7 +2343,7 @@ LIBATAPP_MACRO_API atfw::util::network::http_request::ptr_t etcd_cluster::create
     doc.AddMember("limit", limit, doc.GetAllocator());
     doc.AddMember("revision", revision, doc.GetAllocator());
 
-    setup_http_request(ret, doc, get_http_timeout_ms());
+    setup_http_request(ret, doc, get_http_timeout_ms(), request_type_t::kKvGet);
   } else {
     add_stats_error_request();
   }
@@ -1785,7 +2381,7 @@ LIBATAPP_MACRO_API atfw::util::network::http_request::ptr_t etcd_cluster::create
     doc.AddMember("ignore_value", ignore_value, doc.GetAllocator());
     doc.AddMember("ignore_lease", ignore_lease, doc.GetAllocator());
 
-    setup_http_request(ret, doc, get_http_timeout_ms());
+    setup_http_request(ret, doc, get_http_timeout_ms(), request_type_t::kKvSet);
   } else {
     add_stats_error_request();
   }
@@ -1811,7 +2407,7 @@ LIBATAPP_MACRO_API atfw::util::network::http_request::ptr_t etcd_cluster::create
     etcd_packer::pack_key_range(root, key, range_end, doc);
     doc.AddMember("prev_kv", prev_kv, doc.GetAllocator());
 
-    setup_http_request(ret, doc, get_http_timeout_ms());
+    setup_http_request(ret, doc, get_http_timeout_ms(), request_type_t::kKvDelete);
   } else {
     add_stats_error_request();
   }
@@ -1849,7 +2445,7 @@ LIBATAPP_MACRO_API atfw::util::network::http_request::ptr_t etcd_cluster::create
 
     root.AddMember("create_request", create_request, doc.GetAllocator());
 
-    setup_http_request(ret, doc, get_http_timeout_ms());
+    setup_http_request(ret, doc, get_http_timeout_ms(), request_type_t::kWatch);
     ret->set_opt_keepalive(75, 150);
     // 不能共享socket
     ret->set_opt_reuse_connection(false);
@@ -1926,6 +2522,120 @@ void etcd_cluster::add_stats_success_request() {
 
 void etcd_cluster::add_stats_create_request() { ++stats_.sum_create_requests; }
 
+void etcd_cluster::cleanup_stats_request_tracking(bool force) {
+  for (request_tracking_map_t::iterator iter = request_tracking_.begin(); iter != request_tracking_.end();) {
+    const atfw::util::network::http_request::ptr_t &req = iter->second.request;
+    if (!force && req && req->is_running()) {
+      ++iter;
+      continue;
+    }
+
+    // Request is stopped or finished without calling add_stats_request_finished()
+    request_stats_t &stats = stats_.requests_by_type[static_cast<size_t>(iter->second.request_type)];
+    if (stats.in_flight > 0) {
+      --stats.in_flight;
+    }
+    if (req && !req->is_running() && (0 != req->get_error_code() || 0 != req->get_response_code())) {
+      ++stats.sum_unhooked_requests;
+    } else {
+      ++stats.sum_cancelled_requests;
+    }
+    iter = request_tracking_.erase(iter);
+  }
+}
+
+LIBATAPP_MACRO_API void etcd_cluster::add_stats_request_finished(atfw::util::network::http_request &req) {
+  request_tracking_map_t::iterator iter = request_tracking_.find(&req);
+  if (iter == request_tracking_.end()) {
+    return;
+  }
+
+  request_type_t request_type = iter->second.request_type;
+  request_stats_t &stats = stats_.requests_by_type[static_cast<size_t>(request_type)];
+  std::chrono::steady_clock::time_point start_time = iter->second.start_time;
+  request_tracking_.erase(iter);
+
+  if (stats.in_flight > 0) {
+    --stats.in_flight;
+  }
+  ++stats.sum_finished_requests;
+  if (0 != req.get_error_code() ||
+      atfw::util::network::http_request::status_code_t::EN_ECG_SUCCESS !=
+          atfw::util::network::http_request::get_status_code_group(req.get_response_code())) {
+    ++stats.sum_error_requests;
+  }
+
+  int64_t latency_us = static_cast<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count());
+  if (latency_us < 0) {
+    latency_us = 0;
+  }
+  stats.sum_latency_us += latency_us;
+  if (latency_us > stats.max_latency_us) {
+    stats.max_latency_us = latency_us;
+  }
+  size_t bucket = 0;
+  while (bucket + 1 < kRequestLatencyBucketCount &&
+         get_request_latency_bucket_upper_bound(bucket).count() < latency_us) {
+    ++bucket;
+  }
+  ++stats.latency_buckets[bucket];
+
+  update_member_health(req, request_type, latency_us);
+
+  // CURLINFO_NUM_CONNECTS is the number of new connections made for the previous transfer
+  long new_connections = 0;
+  CURL *easy_handle = req.mutable_request();
+  if (nullptr != easy_handle && CURLE_OK == curl_easy_getinfo(easy_handle, CURLINFO_NUM_CONNECTS, &new_connections) &&
+      new_connections > 0) {
+    ++stats.sum_new_connections;
+  } else {
+    ++stats.sum_reused_connections;
+  }
+}
+
+LIBATAPP_MACRO_API const char *etcd_cluster::get_request_type_name(request_type_t type) noexcept {
+  switch (type) {
+    case request_type_t::kAuthenticate:
+      return "authenticate";
+    case request_type_t::kAuthUserGet:
+      return "auth_user_get";
+    case request_type_t::kMemberList:
+      return "member_list";
+    case request_type_t::kLeaseGrant:
+      return "lease_grant";
+    case request_type_t::kLeaseKeepalive:
+      return "lease_keepalive";
+    case request_type_t::kLeaseRevoke:
+      return "lease_revoke";
+    case request_type_t::kKvGet:
+      return "kv_get";
+    case request_type_t::kKvSet:
+      return "kv_set";
+    case request_type_t::kKvDelete:
+      return "kv_delete";
+    case request_type_t::kKvTxn:
+      return "kv_txn";
+    case request_type_t::kWatch:
+      return "watch";
+    case request_type_t::kMemberProbe:
+      return "member_probe";
+    default:
+      return "unknown";
+  }
+}
+
+LIBATAPP_MACRO_API std::chrono::microseconds etcd_cluster::get_request_latency_bucket_upper_bound(
+    size_t index) noexcept {
+  static const int64_t bucket_upper_bound_ms[kRequestLatencyBucketCount - 1] = {1,   2,   5,    10,   20,  50,
+                                                                                100, 200, 500, 1000, 5000};
+  if (index >= kRequestLatencyBucketCount - 1) {
+    return (std::chrono::microseconds::max)();
+  }
+
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::milliseconds(bucket_upper_bound_ms[index]));
+}
+
 bool etcd_cluster::check_authorization() const {
   if (conf_.authorization.empty()) {
     return true;
@@ -1975,7 +2685,14 @@ bool etcd_cluster::select_cluster_member() {
     if (1 == conf_.hosts.size()) {
       conf_.path_node = conf_.hosts[0];
     } else {
-      conf_.path_node = conf_.hosts[random_generator_.random_between<size_t>(0, conf_.hosts.size())];
+      const std::string *selected_host = nullptr;
+      if (conf_.etcd_members_latency_aware_select) {
+        selected_host = select_cluster_member_by_health(nullptr);
+      }
+      if (nullptr == selected_host) {
+        selected_host = &conf_.hosts[random_generator_.random_between<size_t>(0, conf_.hosts.size())];
+      }
+      conf_.path_node = *selected_host;
     }
 
     LIBATAPP_MACRO_ETCD_CLUSTER_LOG_INFO(*this, "Etcd cluster {} using node {}", reinterpret_cast<const void *>(this),
@@ -1984,32 +2701,342 @@ bool etcd_cluster::select_cluster_member() {
     conf_.path_node.clear();
   }
 
+  member_failover_pending_ = false;
   return !conf_.path_node.empty();
 }
 
+namespace {
+// Lower is better, members without any sample are unknown and will not be preferred
+static double get_member_health_score(const etcd_cluster::member_health_t *health) {
+  if (nullptr == health || 0 == health->sample_count) {
+    return (std::numeric_limits<double>::max)();
+  }
+
+  // tail latency estimation just like RTO in RFC 6298, penalized by error rate
+  double tail_latency_us = health->ewma_latency_us + 4 * health->ewma_latency_deviation_us;
+  return (tail_latency_us + 1.0) * (1.0 + 10.0 * health->ewma_error_rate);
+}
+
+// Request url must be host followed by path, query or nothing, so http://127.0.0.1:2379 will not match
+// http://127.0.0.1:23790/v3/kv/range
+static bool is_url_of_member_host(const std::string &url, const std::string &host) {
+  if (host.empty() || url.size() < host.size() || 0 != url.compare(0, host.size(), host)) {
+    return false;
+  }
+
+  if (url.size() == host.size() || '/' == host.back()) {
+    return true;
+  }
+
+  char delimiter = url[host.size()];
+  return '/' == delimiter || '?' == delimiter || '#' == delimiter;
+}
+}  // namespace
+
+const std::string *etcd_cluster::select_cluster_member_by_health(const std::string *exclude) {
+  // Power of two choices: pick two different members randomly and use the healthier one.
+  //   It prefers fast members but will not send all clients to the same member.
+  std::vector<const std::string *> candidates;
+  candidates.reserve(conf_.hosts.size());
+  for (auto &host : conf_.hosts) {
+    if (nullptr != exclude && host == *exclude) {
+      continue;
+    }
+    candidates.push_back(&host);
+  }
+
+  if (candidates.empty()) {
+    return nullptr;
+  }
+  if (1 == candidates.size()) {
+    return candidates[0];
+  }
+
+  size_t first = random_generator_.random_between<size_t>(0, candidates.size());
+  size_t second = random_generator_.random_between<size_t>(0, candidates.size() - 1);
+  if (second >= first) {
+    ++second;
+  }
+
+  double first_score = get_member_health_score(get_member_health(*candidates[first]));
+  double second_score = get_member_health_score(get_member_health(*candidates[second]));
+  return second_score < first_score ? candidates[second] : candidates[first];
+}
+
+const std::string *etcd_cluster::find_cluster_member_host(const std::string &url) const {
+  for (auto &host : conf_.hosts) {
+    if (is_url_of_member_host(url, host)) {
+      return &host;
+    }
+  }
+
+  for (auto &host : conf_.conf_hosts) {
+    if (is_url_of_member_host(url, host)) {
+      return &host;
+    }
+  }
+
+  return nullptr;
+}
+
+void etcd_cluster::update_member_health(const atfw::util::network::http_request &req, request_type_t request_type,
+                                        int64_t latency_us) {
+  bool is_timeout = CURLE_OPERATION_TIMEDOUT == req.get_error_code();
+  // Watch is a long polling request, its latency and timeout means nothing about the member
+  if (request_type_t::kWatch == request_type && (0 == req.get_error_code() || is_timeout)) {
+    return;
+  }
+
+  const std::string *host = find_cluster_member_host(req.get_url());
+  if (nullptr == host) {
+    return;
+  }
+
+  // Only network errors and server errors mean the member is unhealthy, 4XX is usually caused by request or
+  // authorization.
+  bool is_error = 0 != req.get_error_code() || req.get_response_code() >= 500;
+
+  member_health_t &health = member_health_[*host];
+  if (0 == health.sample_count) {
+    health.ewma_latency_us = static_cast<double>(latency_us);
+    health.ewma_latency_deviation_us = static_cast<double>(latency_us) / 2;
+    health.ewma_error_rate = is_error ? 1.0 : 0.0;
+  } else {
+    if (!is_error || is_timeout) {
+      double deviation = static_cast<double>(latency_us) - health.ewma_latency_us;
+      if (deviation < 0) {
+        deviation = -deviation;
+      }
+      health.ewma_latency_deviation_us +=
+          ETCD_MEMBER_HEALTH_LATENCY_BETA * (deviation - health.ewma_latency_deviation_us);
+      health.ewma_latency_us +=
+          ETCD_MEMBER_HEALTH_LATENCY_ALPHA * (static_cast<double>(latency_us) - health.ewma_latency_us);
+    }
+    health.ewma_error_rate += ETCD_MEMBER_HEALTH_ERROR_ALPHA * ((is_error ? 1.0 : 0.0) - health.ewma_error_rate);
+  }
+  ++health.sample_count;
+  health.last_sample_time = app::get_sys_now();
+
+  if (*host != conf_.path_node || member_failover_pending_ || conf_.hosts.size() <= 1) {
+    return;
+  }
+
+  if (health.sample_count < ETCD_MEMBER_HEALTH_MIN_SAMPLES) {
+    return;
+  }
+
+  // Proactive failover when selected member is much slower or less reliable than another member
+  double selected_tail_latency_us = health.ewma_latency_us + 4 * health.ewma_latency_deviation_us;
+  for (auto &other_host : conf_.hosts) {
+    if (other_host == conf_.path_node) {
+      continue;
+    }
+
+    const member_health_t *other = get_member_health(other_host);
+    if (nullptr == other || other->sample_count < ETCD_MEMBER_HEALTH_MIN_SAMPLES) {
+      continue;
+    }
+
+    double other_tail_latency_us = other->ewma_latency_us + 4 * other->ewma_latency_deviation_us;
+    if ((health.ewma_error_rate >= ETCD_MEMBER_HEALTH_FAILOVER_ERROR_RATE &&
+         other->ewma_error_rate < ETCD_MEMBER_HEALTH_FAILOVER_ERROR_RATE) ||
+        (other->ewma_error_rate < ETCD_MEMBER_HEALTH_FAILOVER_ERROR_RATE &&
+         selected_tail_latency_us > other_tail_latency_us * ETCD_MEMBER_HEALTH_FAILOVER_LATENCY_RATIO &&
+         selected_tail_latency_us > other_tail_latency_us + ETCD_MEMBER_HEALTH_FAILOVER_LATENCY_MARGIN_US)) {
+      LIBATAPP_MACRO_ETCD_CLUSTER_LOG_WARNING(
+          *this,
+          "Etcd cluster {} member {} degraded(tail latency: {}us, error rate: {}), member {}(tail latency: {}us, error "
+          "rate: {}) is better",
+          reinterpret_cast<const void *>(this), conf_.path_node, static_cast<int64_t>(selected_tail_latency_us),
+          health.ewma_error_rate, other_host, static_cast<int64_t>(other_tail_latency_us), other->ewma_error_rate);
+      member_failover_pending_ = true;
+      break;
+    }
+  }
+}
+
+void etcd_cluster::cleanup_member_health() {
+  for (member_health_map_t::iterator iter = member_health_.begin(); iter != member_health_.end();) {
+    if (conf_.hosts.end() == std::find(conf_.hosts.begin(), conf_.hosts.end(), iter->first) &&
+        conf_.conf_hosts.end() == std::find(conf_.conf_hosts.begin(), conf_.conf_hosts.end(), iter->first)) {
+      iter = member_health_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+bool etcd_cluster::check_member_failover() {
+  if (!member_failover_pending_) {
+    return false;
+  }
+
+  // Avoid switching member too frequently
+  if (app::get_sys_now() <= conf_.etcd_members_next_select_time) {
+    return false;
+  }
+
+  std::chrono::system_clock::duration select_interval = conf_.etcd_members_probe_interval;
+  if (select_interval <= std::chrono::system_clock::duration::zero()) {
+    select_interval = std::chrono::seconds(30);
+  }
+  conf_.etcd_members_next_select_time = app::get_sys_now() + select_interval;
+  member_failover_pending_ = false;
+
+  const std::string *selected_host = select_cluster_member_by_health(&conf_.path_node);
+  if (nullptr == selected_host ||
+      get_member_health_score(get_member_health(*selected_host)) >=
+          get_member_health_score(get_member_health(conf_.path_node))) {
+    return false;
+  }
+
+  LIBATAPP_MACRO_ETCD_CLUSTER_LOG_INFO(*this, "Etcd cluster {} switch node from {} to {}",
+                                       reinterpret_cast<const void *>(this), conf_.path_node, *selected_host);
+  // Requests already sent will finish on the old member, new requests will be sent to the new one
+  conf_.path_node = *selected_host;
+  return true;
+}
+
+bool etcd_cluster::create_request_member_probe() {
+  if (!curl_multi_ || check_flag(flag_t::kClosing) || conf_.hosts.size() <= 1) {
+    return false;
+  }
+
+  std::chrono::system_clock::duration probe_interval = conf_.etcd_members_probe_interval;
+  if (probe_interval <= std::chrono::system_clock::duration::zero()) {
+    probe_interval = std::chrono::seconds(30);
+  }
+  // Probe at most one member every time, so every member will be probed once in probe_interval
+  conf_.etcd_members_next_probe_time =
+      app::get_sys_now() + probe_interval / static_cast<std::chrono::system_clock::duration::rep>(conf_.hosts.size());
+
+  if (rpc_probe_member_) {
+    return false;
+  }
+
+  // Select the member with the oldest health data
+  const std::string *selected_host = nullptr;
+  std::chrono::system_clock::time_point selected_sample_time;
+  for (auto &host : conf_.hosts) {
+    const member_health_t *health = get_member_health(host);
+    std::chrono::system_clock::time_point sample_time =
+        nullptr == health ? std::chrono::system_clock::from_time_t(0) : health->last_sample_time;
+    if (sample_time + probe_interval > app::get_sys_now()) {
+      continue;
+    }
+
+    if (nullptr == selected_host || sample_time < selected_sample_time) {
+      selected_host = &host;
+      selected_sample_time = sample_time;
+    }
+  }
+
+  if (nullptr == selected_host) {
+    return false;
+  }
+
+  atfw::util::network::http_request::ptr_t req = atfw::util::network::http_request::create(
+      curl_multi_.get(), LOG_WRAPPER_FWAPI_FORMAT("{}{}", *selected_host, ETCD_API_V3_MAINTENANCE_STATUS));
+  if (!req) {
+    return false;
+  }
+
+  add_stats_create_request();
+
+  rapidjson::Document doc;
+  doc.SetObject();
+
+  setup_http_request(req, doc, get_http_timeout_ms(), request_type_t::kMemberProbe);
+  req->set_priv_data(this);
+  req->set_on_complete(libcurl_callback_on_member_probe);
+
+  int res = req->start(atfw::util::network::http_request::method_t::EN_MT_POST, false);
+  if (res != 0) {
+    req->set_on_complete(nullptr);
+    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(*this, "Etcd start probe member request to {} failed, res: {}",
+                                          req->get_url(), res);
+    return false;
+  }
+
+  LIBATAPP_MACRO_ETCD_CLUSTER_LOG_TRACE(*this, "Etcd start probe member request to {}", req->get_url());
+  rpc_probe_member_ = req;
+  return true;
+}
+
+int etcd_cluster::libcurl_callback_on_member_probe(atfw::util::network::http_request &req) {
+  etcd_cluster *self = reinterpret_cast<etcd_cluster *>(req.get_priv_data());
+  if (nullptr == self) {
+    FWLOGERROR("Etcd member probe shouldn't has request without private data");
+    return 0;
+  }
+  // Health data of member is updated here
+  self->add_stats_request_finished(req);
+
+  atfw::util::network::http_request::ptr_t keep_rpc = self->rpc_probe_member_;
+  self->rpc_probe_member_.reset();
+
+  // Probe failures only affect the health data of member, it do not mean the whole cluster is unavailable
+  if (0 != req.get_error_code() ||
+      atfw::util::network::http_request::status_code_t::EN_ECG_SUCCESS !=
+          atfw::util::network::http_request::get_status_code_group(req.get_response_code())) {
+    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(*self, "Etcd probe member {} failed, error code: {}, http code: {}\n{}",
+                                          req.get_url(), req.get_error_code(), req.get_response_code(),
+                                          req.get_error_msg());
+  }
+
+  return 0;
+}
+
+LIBATAPP_MACRO_API const etcd_cluster::member_health_t *etcd_cluster::get_member_health(
+    const std::string &host) const noexcept {
+  member_health_map_t::const_iterator iter = member_health_.find(host);
+  if (iter == member_health_.end()) {
+    return nullptr;
+  }
+
+  return &iter->second;
+}
+
 LIBATAPP_MACRO_API void etcd_cluster::check_authorization_expired(int http_code, const std::string &content) {
+  bool expired = false;
   if (ETCD_API_V3_ERROR_HTTP_CODE_AUTH == http_code) {
-    conf_.authorization_header.clear();
-    return;
+    expired = true;
   }
 
   rapidjson::Document doc;
-  if (atapp::etcd_packer::parse_object(doc, content.c_str())) {
+  if (!expired && atapp::etcd_packer::parse_object(doc, content.c_str())) {
     int64_t error_code = 0;
     atapp::etcd_packer::unpack_int(doc, "code", error_code);
     if (ETCD_API_V3_ERROR_GRPC_CODE_UNAUTHENTICATED == error_code) {
-      conf_.authorization_header.clear();
-      return;
+      expired = true;
     }
   }
 
-  if (ETCD_API_V3_ERROR_HTTP_INVALID_PARAM == http_code || ETCD_API_V3_ERROR_HTTP_PRECONDITION == http_code) {
+  if (!expired &&
+      (ETCD_API_V3_ERROR_HTTP_INVALID_PARAM == http_code || ETCD_API_V3_ERROR_HTTP_PRECONDITION == http_code)) {
     if (std::string::npos != content.find("authenticat")) {
-      conf_.authorization_header.clear();
+      expired = true;
+    }
+  }
+
+  if (!expired) {
+    return;
+  }
+
+  // The token is shared, all clusters in share group should wait for the leader to authenticate again
+  if (lease_share_group_) {
+    // Followers may be removed when syncing
+    std::vector<etcd_cluster *> members = lease_share_group_->members;
+    for (auto &member : members) {
+      member->reset_authorization_header();
     }
+  } else {
+    reset_authorization_header();
   }
 }
 
+void etcd_cluster::reset_authorization_header() { conf_.authorization_header.clear(); }
+
 void etcd_cluster::check_socket_error_code(int socket_code) {
   if (CURLE_OK == socket_code) {
     return;
@@ -2021,11 +3048,29 @@ void etcd_cluster::check_socket_error_code(int socket_code) {
 }
 
 LIBATAPP_MACRO_API void etcd_cluster::setup_http_request(atfw::util::network::http_request::ptr_t &req,
-                                                         rapidjson::Document &doc, time_t timeout) {
+                                                         rapidjson::Document &doc, time_t timeout,
+                                                         request_type_t request_type) {
   if (!req) {
     return;
   }
 
+  if (static_cast<size_t>(request_type) >= static_cast<size_t>(request_type_t::kMax)) {
+    request_type = request_type_t::kUnknown;
+  }
+  {
+    request_tracking_t &tracking = request_tracking_[req.get()];
+    if (!tracking.request) {
+      ++stats_.requests_by_type[static_cast<size_t>(request_type)].in_flight;
+    } else if (tracking.request_type != request_type) {
+      // Setup the same request again with another type
+      --stats_.requests_by_type[static_cast<size_t>(tracking.request_type)].in_flight;
+      ++stats_.requests_by_type[static_cast<size_t>(request_type)].in_flight;
+    }
+    tracking.request = req;
+    tracking.request_type = request_type;
+    tracking.start_time = std::chrono::steady_clock::now();
+  }
+
   if (timeout <= 0) {
     timeout = get_http_timeout_ms();
   }
@@ -2072,6 +3117,16 @@ LIBATAPP_MACRO_API void etcd_cluster::setup_http_request(atfw::util::network::ht
     req->set_opt_reuse_connection(false);
     set_flag(flag_t::kPreviousRequestTimeout, false);
   }
+  if (conf_.http2_multiplexing) {
+    // Use HTTP/2 for https(negotiated by ALPN) and multiplex requests into the existing connection of curl_multi_
+    // instead of opening a new one.
+#if LIBCURL_VERSION_NUM >= 0x072F00
+    req->set_opt_long(CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
+#if LIBCURL_VERSION_NUM >= 0x072B00
+    req->set_opt_long(CURLOPT_PIPEWAIT, 1L);
+#endif
+  }
 #if LIBCURL_VERSION_NUM >= 0x075500
   req->set_opt_string(CURLOPT_PROTOCOLS_STR, "http,https");
 #else
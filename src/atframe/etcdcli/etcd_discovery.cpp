@@ -11,6 +11,9 @@
 #include <atframe/etcdcli/etcd_discovery.h>
 
 #include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -131,21 +134,21 @@ static bool round_robin_compare_index(const etcd_discovery_node::ptr_t &l, const
     return reinterpret_cast<uintptr_t>(l.get()) < reinterpret_cast<uintptr_t>(r.get());
   }
 
-  const auto &ldi = l->get_discovery_info();
-  const auto &rdi = r->get_discovery_info();
-  if (ldi.runtime().stateful_pod_index() != rdi.runtime().stateful_pod_index()) {
-    return ldi.runtime().stateful_pod_index() < rdi.runtime().stateful_pod_index();
+  const auto &lhd = l->get_hot_data();
+  const auto &rhd = r->get_hot_data();
+  if (lhd.stateful_pod_index != rhd.stateful_pod_index) {
+    return lhd.stateful_pod_index < rhd.stateful_pod_index;
   }
 
-  if (ldi.id() != rdi.id()) {
-    return ldi.id() < rdi.id();
+  if (lhd.id != rhd.id) {
+    return lhd.id < rhd.id;
   }
 
-  if (l->get_name_hash() != r->get_name_hash()) {
-    return l->get_name_hash() < r->get_name_hash();
+  if (lhd.name_hash != rhd.name_hash) {
+    return lhd.name_hash < rhd.name_hash;
   }
 
-  return ldi.name() < rdi.name();
+  return l->get_discovery_info().name() < r->get_discovery_info().name();
 }
 
 static bool consistent_hash_compare_index(const etcd_discovery_set::node_hash_type &l,
@@ -189,8 +192,8 @@ static bool lower_bound_compare_index(const etcd_discovery_node::ptr_t &l, const
     return true;
   }
 
-  if (l->get_discovery_info().id() != r.id) {
-    return l->get_discovery_info().id() < r.id;
+  if (l->get_hot_data().id != r.id) {
+    return l->get_hot_data().id < r.id;
   }
 
   if (r.name.empty()) {
@@ -209,8 +212,8 @@ static bool upper_bound_compare_index(const lower_upper_bound_pred_t &l, const e
     return false;
   }
 
-  if (l.id != r->get_discovery_info().id()) {
-    return l.id < r->get_discovery_info().id();
+  if (l.id != r->get_hot_data().id) {
+    return l.id < r->get_hot_data().id;
   }
 
   if (l.name.empty()) {
@@ -247,16 +250,264 @@ static bool node_equal(const etcd_discovery_node::ptr_t &l, const etcd_discovery
     return false;
   }
 
-  if (l->get_discovery_info().id() != 0 && r->get_discovery_info().id() != 0) {
-    return l->get_discovery_info().id() == r->get_discovery_info().id();
+  if (l->get_hot_data().id != 0 && r->get_hot_data().id != 0) {
+    return l->get_hot_data().id == r->get_hot_data().id;
+  }
+
+  if (l->get_name_hash() != r->get_name_hash()) {
+    return false;
   }
 
   return l->get_discovery_info().name() == r->get_discovery_info().name();
 }
 
+// Copy fields of atapp_discovery except metadata and gateways, which are interned and shared by nodes.
+// Keep it in sync with atapp_discovery and discovery_equal_without_shared_fields().
+static void discovery_copy_without_shared_fields(const atapp::protocol::atapp_discovery &input,
+                                                 atapp::protocol::atapp_discovery &output) {
+  output.set_id(input.id());
+  output.set_name(input.name());
+  output.set_hostname(input.hostname());
+  output.set_pid(input.pid());
+  output.mutable_listen()->CopyFrom(input.listen());
+  output.set_hash_code(input.hash_code());
+  output.set_type_id(input.type_id());
+  output.set_type_name(input.type_name());
+  if (input.has_area()) {
+    output.mutable_area()->CopyFrom(input.area());
+  } else {
+    output.clear_area();
+  }
+  output.set_version(input.version());
+  output.set_custom_data(input.custom_data());
+  output.set_identity(input.identity());
+  if (input.has_runtime()) {
+    output.mutable_runtime()->CopyFrom(input.runtime());
+  } else {
+    output.clear_runtime();
+  }
+  output.set_atbus_protocol_version(input.atbus_protocol_version());
+  output.set_atbus_protocol_min_version(input.atbus_protocol_min_version());
+}
+
+static bool discovery_equal_without_shared_fields(const atapp::protocol::atapp_discovery &l,
+                                                  const atapp::protocol::atapp_discovery &r) {
+  if (l.id() != r.id() || l.pid() != r.pid() || l.type_id() != r.type_id() ||
+      l.atbus_protocol_version() != r.atbus_protocol_version() ||
+      l.atbus_protocol_min_version() != r.atbus_protocol_min_version()) {
+    return false;
+  }
+
+  if (l.name() != r.name() || l.hostname() != r.hostname() || l.hash_code() != r.hash_code() ||
+      l.type_name() != r.type_name() || l.version() != r.version() || l.custom_data() != r.custom_data() ||
+      l.identity() != r.identity()) {
+    return false;
+  }
+
+  if (l.listen_size() != r.listen_size()) {
+    return false;
+  }
+  for (int i = 0; i < l.listen_size(); ++i) {
+    if (l.listen(i) != r.listen(i)) {
+      return false;
+    }
+  }
+
+  if (l.has_area() != r.has_area() || (l.has_area() && !protobuf_equal(l.area(), r.area()))) {
+    return false;
+  }
+
+  return l.has_runtime() == r.has_runtime() && (!l.has_runtime() || protobuf_equal(l.runtime(), r.runtime()));
+}
+
+// Process-wide pool of immutable blocks shared by discovery nodes, only weak references are kept here so that blocks
+// are released with the last node.
+class discovery_shared_block_pool {
+ public:
+  static discovery_shared_block_pool &instance() {
+    static discovery_shared_block_pool ret;
+    return ret;
+  }
+
+  etcd_discovery_node::shared_metadata_ptr intern_metadata(const atapp::protocol::atapp_metadata &input) {
+    size_t hash_code = etcd_discovery_set::metadata_hash_type()(input);
+
+    std::lock_guard<std::mutex> lock_guard{lock_};
+    auto &bucket = metadata_[hash_code];
+    for (auto iter = bucket.begin(); iter != bucket.end();) {
+      etcd_discovery_node::shared_metadata_ptr block = iter->lock();
+      if (!block) {
+        iter = bucket.erase(iter);
+        continue;
+      }
+
+      if (etcd_discovery_set::metadata_equal_type()(*block, input)) {
+        return block;
+      }
+      ++iter;
+    }
+
+    etcd_discovery_node::shared_metadata_ptr ret = std::make_shared<atapp::protocol::atapp_metadata>(input);
+    bucket.push_back(ret);
+    sweep();
+    return ret;
+  }
+
+  etcd_discovery_node::shared_gateway_ptr intern_gateway(const atapp::protocol::atapp_gateway &input) {
+    std::lock_guard<std::mutex> lock_guard{lock_};
+    auto &bucket = gateways_[input.address()];
+    for (auto iter = bucket.begin(); iter != bucket.end();) {
+      etcd_discovery_node::shared_gateway_ptr block = iter->lock();
+      if (!block) {
+        iter = bucket.erase(iter);
+        continue;
+      }
+
+      if (gateway_equal(*block, input)) {
+        return block;
+      }
+      ++iter;
+    }
+
+    etcd_discovery_node::shared_gateway_ptr ret = std::make_shared<atapp::protocol::atapp_gateway>(input);
+    bucket.push_back(ret);
+    sweep();
+    return ret;
+  }
+
+  etcd_discovery_node::shared_gateway_ptr intern_listen_gateway(const std::string &address) {
+    std::lock_guard<std::mutex> lock_guard{lock_};
+    auto &bucket = gateways_[address];
+    for (auto iter = bucket.begin(); iter != bucket.end();) {
+      etcd_discovery_node::shared_gateway_ptr block = iter->lock();
+      if (!block) {
+        iter = bucket.erase(iter);
+        continue;
+      }
+
+      if (block->match_hosts_size() == 0 && block->match_namespaces_size() == 0 && block->match_labels_size() == 0) {
+        return block;
+      }
+      ++iter;
+    }
+
+    std::shared_ptr<atapp::protocol::atapp_gateway> ret = std::make_shared<atapp::protocol::atapp_gateway>();
+    ret->set_address(address);
+    bucket.push_back(ret);
+    sweep();
+    return ret;
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock_guard{lock_};
+    size_t ret = 0;
+    for (auto &bucket : metadata_) {
+      for (auto &block : bucket.second) {
+        if (!block.expired()) {
+          ++ret;
+        }
+      }
+    }
+
+    for (auto &bucket : gateways_) {
+      for (auto &block : bucket.second) {
+        if (!block.expired()) {
+          ++ret;
+        }
+      }
+    }
+    return ret;
+  }
+
+ private:
+  discovery_shared_block_pool() : insert_count_(0) {}
+
+  static bool gateway_equal(const atapp::protocol::atapp_gateway &l, const atapp::protocol::atapp_gateway &r) {
+    if (l.match_hosts_size() != r.match_hosts_size() || l.match_namespaces_size() != r.match_namespaces_size() ||
+        l.match_labels_size() != r.match_labels_size()) {
+      return false;
+    }
+
+    if (l.address() != r.address()) {
+      return false;
+    }
+
+    for (int i = 0; i < l.match_hosts_size(); ++i) {
+      if (l.match_hosts(i) != r.match_hosts(i)) {
+        return false;
+      }
+    }
+
+    for (int i = 0; i < l.match_namespaces_size(); ++i) {
+      if (l.match_namespaces(i) != r.match_namespaces(i)) {
+        return false;
+      }
+    }
+
+    for (auto &label : l.match_labels()) {
+      auto iter = r.match_labels().find(label.first);
+      if (iter == r.match_labels().end() || iter->second != label.second) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Expired entries are removed lazily, sweep all of them after a batch of insertions.
+  void sweep() {
+    if (++insert_count_ < 4096) {
+      return;
+    }
+    insert_count_ = 0;
+
+    for (auto iter = metadata_.begin(); iter != metadata_.end();) {
+      auto &bucket = iter->second;
+      bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                                  [](const std::weak_ptr<const atapp::protocol::atapp_metadata> &block) {
+                                    return block.expired();
+                                  }),
+                   bucket.end());
+      if (bucket.empty()) {
+        iter = metadata_.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+
+    for (auto iter = gateways_.begin(); iter != gateways_.end();) {
+      auto &bucket = iter->second;
+      bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                                  [](const std::weak_ptr<const atapp::protocol::atapp_gateway> &block) {
+                                    return block.expired();
+                                  }),
+                   bucket.end());
+      if (bucket.empty()) {
+        iter = gateways_.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+
+ private:
+  std::mutex lock_;
+  std::unordered_map<size_t, std::vector<std::weak_ptr<const atapp::protocol::atapp_metadata>>> metadata_;
+  // Gateways are grouped by address, listen addresses are interned as gateways without any match rule
+  std::unordered_map<std::string, std::vector<std::weak_ptr<const atapp::protocol::atapp_gateway>>> gateways_;
+  size_t insert_count_;
+};
+
 }  // namespace
 
-LIBATAPP_MACRO_API etcd_discovery_node::etcd_discovery_node() : context_addr_(0), name_hash_(0, 0), ingress_index_(0) {
+LIBATAPP_MACRO_API etcd_discovery_node::etcd_discovery_node()
+    : context_addr_(0), has_metadata_(false), ingress_index_(0) {
+  hot_data_.id = 0;
+  hot_data_.type_id = 0;
+  hot_data_.zone_id = 0;
+  hot_data_.name_hash = std::pair<uint64_t, uint64_t>(0, 0);
+  hot_data_.stateful_pod_index = 0;
+
   private_data_ptr_ = nullptr;
   private_data_u64_ = 0;
   private_data_uptr_ = 0;
@@ -270,11 +521,39 @@ LIBATAPP_MACRO_API etcd_discovery_node::~etcd_discovery_node() {
 
 LIBATAPP_MACRO_API void etcd_discovery_node::copy_from(const atapp::protocol::atapp_discovery &input,
                                                        const node_version &version, uintptr_t context_addr) {
-  node_info_.CopyFrom(input);
+  // Metadata and gateways are not copied into node_info_, nodes share the interned blocks of them.
+  discovery_copy_without_shared_fields(input, node_info_);
 
-  name_hash_ = consistent_hash_calc(
+  hot_data_.id = input.id();
+  hot_data_.type_id = input.type_id();
+  hot_data_.zone_id = input.area().zone_id();
+  hot_data_.name_hash = consistent_hash_calc(
       gsl::span<const unsigned char>{reinterpret_cast<const unsigned char *>(input.name().data()), input.name().size()},
       LIBATAPP_MACRO_HASH_MAGIC_NUMBER);
+  hot_data_.stateful_pod_index = input.runtime().stateful_pod_index();
+
+  discovery_shared_block_pool &pool = discovery_shared_block_pool::instance();
+  has_metadata_ = input.has_metadata();
+  if (has_metadata_ && !is_empty(input.metadata())) {
+    shared_metadata_ = pool.intern_metadata(input.metadata());
+  } else {
+    shared_metadata_.reset();
+  }
+
+  shared_gateways_.clear();
+  ingress_for_listen_.clear();
+  if (input.gateways_size() > 0) {
+    shared_gateways_.reserve(static_cast<size_t>(input.gateways_size()));
+    for (auto &gateway : input.gateways()) {
+      shared_gateways_.push_back(pool.intern_gateway(gateway));
+    }
+  } else if (input.listen_size() > 0) {
+    // Listen addresses are converted here, so next_ingress_gateway() can be called without lock of the pool
+    ingress_for_listen_.reserve(static_cast<size_t>(input.listen_size()));
+    for (auto &address : input.listen()) {
+      ingress_for_listen_.push_back(pool.intern_listen_gateway(address));
+    }
+  }
 
   context_addr_ = context_addr;
 
@@ -303,6 +582,18 @@ LIBATAPP_MACRO_API void etcd_discovery_node::update_version(const node_version &
 
 LIBATAPP_MACRO_API void etcd_discovery_node::copy_to(atapp::protocol::atapp_discovery &output) const {
   output.CopyFrom(node_info_);
+  if (has_metadata_) {
+    if (shared_metadata_) {
+      output.mutable_metadata()->CopyFrom(*shared_metadata_);
+    } else {
+      output.mutable_metadata();
+    }
+  }
+
+  output.mutable_gateways()->Reserve(static_cast<int>(shared_gateways_.size()));
+  for (auto &gateway : shared_gateways_) {
+    output.add_gateways()->CopyFrom(*gateway);
+  }
 }
 
 LIBATAPP_MACRO_API void etcd_discovery_node::copy_key_to(atapp::protocol::atapp_discovery &output) const {
@@ -318,6 +609,38 @@ LIBATAPP_MACRO_API void etcd_discovery_node::copy_key_to(atapp::protocol::atapp_
   output.set_hostname(node_info_.hostname());
 }
 
+LIBATAPP_MACRO_API bool etcd_discovery_node::equal_to(const atapp::protocol::atapp_discovery &input) const {
+  if (!discovery_equal_without_shared_fields(node_info_, input)) {
+    return false;
+  }
+
+  if (has_metadata_ != input.has_metadata()) {
+    return false;
+  }
+  if (has_metadata_ && !protobuf_equal(get_metadata(), input.metadata())) {
+    return false;
+  }
+
+  if (shared_gateways_.size() != static_cast<size_t>(input.gateways_size())) {
+    return false;
+  }
+  for (size_t i = 0; i < shared_gateways_.size(); ++i) {
+    if (!protobuf_equal(*shared_gateways_[i], input.gateways(static_cast<int>(i)))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+LIBATAPP_MACRO_API const atapp::protocol::atapp_metadata &etcd_discovery_node::get_metadata() const noexcept {
+  if (shared_metadata_) {
+    return *shared_metadata_;
+  }
+
+  return atapp::protocol::atapp_metadata::default_instance();
+}
+
 LIBATAPP_MACRO_API void etcd_discovery_node::set_on_destroy(on_destroy_fn_type fn) { on_destroy_fn_ = std::move(fn); }
 
 LIBATAPP_MACRO_API const etcd_discovery_node::on_destroy_fn_type &etcd_discovery_node::get_on_destroy() const {
@@ -336,28 +659,31 @@ LIBATAPP_MACRO_API const atapp::protocol::atapp_gateway &etcd_discovery_node::ne
     ingress_index_ = 0;
   }
 
-  if (node_info_.gateways_size() > 0) {
-    if (ingress_index_ >= node_info_.gateways_size()) {
-      ingress_index_ %= node_info_.gateways_size();
+  if (!shared_gateways_.empty()) {
+    if (static_cast<size_t>(ingress_index_) >= shared_gateways_.size()) {
+      ingress_index_ = static_cast<int32_t>(static_cast<size_t>(ingress_index_) % shared_gateways_.size());
     }
-    return node_info_.gateways(ingress_index_++);
+    return *shared_gateways_[static_cast<size_t>(ingress_index_++)];
   }
 
-  if (node_info_.listen_size() > 0) {
-    if (ingress_index_ >= node_info_.listen_size()) {
-      ingress_index_ %= node_info_.listen_size();
+  if (!ingress_for_listen_.empty()) {
+    if (static_cast<size_t>(ingress_index_) >= ingress_for_listen_.size()) {
+      ingress_index_ = static_cast<int32_t>(static_cast<size_t>(ingress_index_) % ingress_for_listen_.size());
     }
-    ingress_for_listen_.set_address(node_info_.listen(ingress_index_++));
-    return ingress_for_listen_;
+    return *ingress_for_listen_[static_cast<size_t>(ingress_index_++)];
   }
 
-  // if none of gateways or listen found, ingress_for_listen_ will always be empty
-  return ingress_for_listen_;
+  // if none of gateways or listen found, return an empty gateway
+  return atapp::protocol::atapp_gateway::default_instance();
+}
+
+LIBATAPP_MACRO_API size_t etcd_discovery_node::get_shared_block_count() {
+  return discovery_shared_block_pool::instance().size();
 }
 
 LIBATAPP_MACRO_API int32_t etcd_discovery_node::get_ingress_size() const {
-  if (node_info_.gateways_size() > 0) {
-    return node_info_.gateways_size();
+  if (!shared_gateways_.empty()) {
+    return static_cast<int32_t>(shared_gateways_.size());
   }
 
   return node_info_.listen_size();
@@ -863,8 +1189,8 @@ LIBATAPP_MACRO_API void etcd_discovery_set::add_node(const etcd_discovery_node::
     }
   }
 
-  if (node->get_discovery_info().has_metadata()) {
-    clear_cache(&node->get_discovery_info().metadata(), clear_cache_node_ptrs);
+  if (node->has_metadata()) {
+    clear_cache(&node->get_metadata(), clear_cache_node_ptrs);
   } else {
     clear_cache(nullptr, clear_cache_node_ptrs);
   }
@@ -895,8 +1221,8 @@ LIBATAPP_MACRO_API void etcd_discovery_set::remove_node(const etcd_discovery_nod
   }
 
   if (has_cleanup) {
-    if (node->get_discovery_info().has_metadata()) {
-      clear_cache(&node->get_discovery_info().metadata(), clear_cache_node_ptrs);
+    if (node->has_metadata()) {
+      clear_cache(&node->get_metadata(), clear_cache_node_ptrs);
     } else {
       clear_cache(nullptr, clear_cache_node_ptrs);
     }
@@ -918,8 +1244,8 @@ LIBATAPP_MACRO_API void etcd_discovery_set::remove_node(uint64_t id) {
     }
   }
 
-  if (iter_id->second->get_discovery_info().has_metadata()) {
-    clear_cache(&iter_id->second->get_discovery_info().metadata(), clear_cache_node_ptrs);
+  if (iter_id->second->has_metadata()) {
+    clear_cache(&iter_id->second->get_metadata(), clear_cache_node_ptrs);
   } else {
     clear_cache(nullptr, clear_cache_node_ptrs);
   }
@@ -942,8 +1268,8 @@ LIBATAPP_MACRO_API void etcd_discovery_set::remove_node(const std::string &name)
     }
   }
 
-  if (iter_name->second->get_discovery_info().has_metadata()) {
-    clear_cache(&iter_name->second->get_discovery_info().metadata(), clear_cache_node_ptrs);
+  if (iter_name->second->has_metadata()) {
+    clear_cache(&iter_name->second->get_metadata(), clear_cache_node_ptrs);
   } else {
     clear_cache(nullptr, clear_cache_node_ptrs);
   }
@@ -971,8 +1297,26 @@ void etcd_discovery_set::rebuild_cache(index_cache_type &cache_set, const metada
     cache_set.compact_hashing_ring.reserve(cache_set.normal_hashing_ring.capacity());
   }
 
+  // Nodes with the same metadata share the same interned block, so filter every block only once
+  std::unordered_map<const metadata_type *, bool> filter_results;
+  auto filter_node = [rule, &filter_results](const etcd_discovery_node &node) -> bool {
+    if (nullptr == rule) {
+      return true;
+    }
+
+    const metadata_type *metadata = node.get_shared_metadata().get();
+    auto iter = filter_results.find(metadata);
+    if (iter != filter_results.end()) {
+      return iter->second;
+    }
+
+    bool ret = metadata_equal_type::filter(*rule, nullptr == metadata ? metadata_type::default_instance() : *metadata);
+    filter_results[metadata] = ret;
+    return ret;
+  };
+
   for (node_by_name_type::const_iterator iter = node_by_name_.begin(); iter != node_by_name_.end(); ++iter) {
-    if (nullptr != rule && !metadata_equal_type::filter(*rule, iter->second->get_discovery_info().metadata())) {
+    if (!filter_node(*iter->second)) {
       continue;
     }
 
@@ -995,7 +1339,7 @@ void etcd_discovery_set::rebuild_cache(index_cache_type &cache_set, const metada
   }
 
   for (node_by_id_type::const_iterator iter = node_by_id_.begin(); iter != node_by_id_.end(); ++iter) {
-    if (nullptr != rule && !metadata_equal_type::filter(*rule, iter->second->get_discovery_info().metadata())) {
+    if (!filter_node(*iter->second)) {
       continue;
     }
 
@@ -1010,7 +1354,7 @@ void etcd_discovery_set::rebuild_cache(index_cache_type &cache_set, const metada
     for (size_t i = 0; i < node_hash_type::HASH_POINT_PER_INS; ++i) {
       node_hash_type hash_node;
       hash_node.node = iter->second;
-      uint64_t key = iter->second->get_discovery_info().id();
+      uint64_t key = iter->second->get_hot_data().id;
       hash_node.hash_code = consistent_hash_calc(consistent_hash_to_span(key), static_cast<uint32_t>(i));
 
       cache_set.normal_hashing_ring.push_back(hash_node);
@@ -36,9 +36,13 @@ bool etcd_keepalive::default_checker_t::operator()(const std::string &checked) c
   }
 
   if (!identity.empty()) {
-    ::atframework::atapp::protocol::atapp_discovery node;
-    if (::atframework::atapp::rapidjson_loader_parse(node, checked)) {
-      return node.identity().empty() || identity == node.identity();
+    // Checked on every keepalive, the temporary message is released by arena without heap allocation
+    ::atframework::atapp::rapidjson_loader_arena_scope arena_scope;
+    ::atframework::atapp::protocol::atapp_discovery *node =
+        ::atframework::atapp::rapidjson_loader_parse_on_arena<::atframework::atapp::protocol::atapp_discovery>(
+            arena_scope.get_arena(), checked);
+    if (nullptr != node) {
+      return node->identity().empty() || identity == node->identity();
     }
   }
 
@@ -53,6 +57,9 @@ LIBATAPP_MACRO_API etcd_keepalive::etcd_keepalive(etcd_cluster &owner, const std
   rpc_.is_actived = false;
   rpc_.is_value_changed = true;
   rpc_.has_data = false;
+  rpc_.is_batch_pending = false;
+  rpc_.batch_sequence = 0;
+  rpc_.skip_batch_once = false;
 }
 
 LIBATAPP_MACRO_API etcd_keepalive::~etcd_keepalive() { close(true); }
@@ -74,6 +81,10 @@ LIBATAPP_MACRO_API void etcd_keepalive::close(bool reset_has_data_flag) {
 
   rpc_.is_actived = false;
   rpc_.is_value_changed = true;
+  // The result of running batch request will be ignored
+  rpc_.is_batch_pending = false;
+  rpc_.batch_sequence = 0;
+  rpc_.skip_batch_once = false;
   if (reset_has_data_flag) {
     rpc_.has_data = false;
   }
@@ -113,7 +124,7 @@ LIBATAPP_MACRO_API void etcd_keepalive::active() {
 }
 
 void etcd_keepalive::process() {
-  if (rpc_.rpc_opr_) {
+  if (rpc_.rpc_opr_ || rpc_.is_batch_pending) {
     return;
   }
 
@@ -146,6 +157,13 @@ void etcd_keepalive::process() {
 
     // if check passed, set data
     if (checker_.is_check_run && checker_.is_check_passed && rpc_.is_value_changed) {
+      // merge into the batch(txn) request of etcd_cluster, it will be sent in the next tick
+      if (!rpc_.skip_batch_once && owner_->get_conf_keepalive_batch_set() &&
+          owner_->add_keepalive_batch_set(shared_from_this())) {
+        break;
+      }
+      rpc_.skip_batch_once = false;
+
       // create set data rpc
       rpc_.rpc_opr_ = owner_->create_request_kv_set(path_, value_, true);
       if (!rpc_.rpc_opr_) {
@@ -187,6 +205,7 @@ int etcd_keepalive::libcurl_callback_on_get_data(atfw::util::network::http_reque
     FWLOGERROR("Etcd keepalive get request shouldn't has request without private data");
     return 0;
   }
+  self->owner_->add_stats_request_finished(req);
   atfw::util::network::http_request::ptr_t keep_rpc = self->rpc_.rpc_opr_;
 
   self->rpc_.rpc_opr_.reset();
@@ -274,6 +293,7 @@ int etcd_keepalive::libcurl_callback_on_set_data(atfw::util::network::http_reque
     FWLOGERROR("Etcd keepalive set request shouldn't has request without private data");
     return 0;
   }
+  self->owner_->add_stats_request_finished(req);
 
   atfw::util::network::http_request::ptr_t keep_rpc = self->rpc_.rpc_opr_;
   self->rpc_.rpc_opr_.reset();
@@ -300,4 +320,26 @@ int etcd_keepalive::libcurl_callback_on_set_data(atfw::util::network::http_reque
   self->active();
   return 0;
 }
+
+void etcd_keepalive::on_batch_set_data(uint64_t batch_sequence, bool success, bool retry_alone) {
+  // Closed or restarted after the batch request sent
+  if (!rpc_.is_batch_pending || rpc_.batch_sequence != batch_sequence) {
+    return;
+  }
+
+  rpc_.is_batch_pending = false;
+  rpc_.batch_sequence = 0;
+
+  if (!success) {
+    rpc_.is_value_changed = true;
+    rpc_.skip_batch_once = retry_alone;
+    owner_->add_retry_keepalive(shared_from_this());
+    return;
+  }
+
+  rpc_.has_data = true;
+  LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(*owner_, "Etcd keepalive {} set data by batch request {} success",
+                                        reinterpret_cast<const void *>(this), batch_sequence);
+  active();
+}
 LIBATAPP_MACRO_NAMESPACE_END
@@ -7,18 +7,33 @@
 #include <algorithm/base64.h>
 
 #include <algorithm/murmur_hash.h>
+#include <common/file_system.h>
 #include <common/string_oprs.h>
 #include <log/log_wrapper.h>
 #include <random/random_generator.h>
 
+#include <config/compiler/template_prefix.h>
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include <config/compiler/template_suffix.h>
+
 #include <atframe/etcdcli/etcd_cluster.h>
 #include <atframe/etcdcli/etcd_watcher.h>
 
 #include <atframe/atapp.h>
 #include <atframe/atapp_conf.h>
+#include <atframe/modules/worker_pool_module.h>
 
+#include <cstdio>
+#include <deque>
+#include <fstream>
 #include <ios>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <utility>
 
 #ifdef GetObject
 #  undef GetObject
@@ -26,6 +41,28 @@
 
 LIBATAPP_MACRO_NAMESPACE_BEGIN
 
+// Shared with worker jobs, so the checkpoint can be written after the watcher is destroyed
+struct ATFW_UTIL_SYMBOL_LOCAL etcd_watcher::checkpoint_writer_t {
+  struct operation_t {
+    bool full_save = false;
+    std::string file_path;
+    std::string content;
+  };
+
+  std::mutex lock;
+  std::mutex io_lock;  // only one thread writes files at the same time
+  std::deque<operation_t> operations;
+  bool job_pending = false;
+  // Appending after a failed writing will make the journal unreadable, so all journal records are dropped until the
+  // whole checkpoint is rewritten
+  bool failed = false;
+  uint64_t failed_count = 0;
+  std::string checked_directory;
+
+  bool run(bool from_job);
+  bool write(const operation_t &operation);
+};
+
 LIBATAPP_MACRO_API etcd_watcher::etcd_watcher(etcd_cluster &owner, const std::string &path,
                                               const std::string &range_end, constrict_helper_t &)
     : owner_(&owner), path_(path), range_end_(range_end), rpc_data_brackets_(0) {
@@ -40,6 +77,19 @@ LIBATAPP_MACRO_API etcd_watcher::etcd_watcher(etcd_cluster &owner, const std::st
   rpc_.is_actived = false;
   rpc_.is_retry_mode = false;
   rpc_.last_revision = 0;
+
+  checkpoint_.interval = std::chrono::seconds(1);
+  checkpoint_.next_save_time = std::chrono::system_clock::from_time_t(0);
+  checkpoint_.resume_checked = false;
+  checkpoint_.notify_pending = false;
+  checkpoint_.confirmed = false;
+  checkpoint_.has_cache = false;
+  checkpoint_.dirty = false;
+  checkpoint_.full_save_required = false;
+  checkpoint_.revision = 0;
+  checkpoint_.journal_events = 0;
+  checkpoint_.writer = std::make_shared<checkpoint_writer_t>();
+  checkpoint_.writer_failed_count = 0;
 }
 
 LIBATAPP_MACRO_API etcd_watcher::~etcd_watcher() { close(); }
@@ -64,6 +114,23 @@ LIBATAPP_MACRO_API void etcd_watcher::close() {
   rpc_.is_retry_mode = false;
   rpc_.last_revision = 0;
 
+  // flush checkpoint and reload it when actived again
+  if (checkpoint_.dirty) {
+    flush_checkpoint(false);
+  }
+  // Wait for the pending jobs, so the files are complete after closed
+  checkpoint_.writer->run(false);
+  checkpoint_.resume_checked = false;
+  checkpoint_.notify_pending = false;
+  checkpoint_.confirmed = false;
+  checkpoint_.has_cache = false;
+  checkpoint_.dirty = false;
+  checkpoint_.full_save_required = false;
+  checkpoint_.revision = 0;
+  checkpoint_.journal_events = 0;
+  checkpoint_.journal.clear();
+  checkpoint_.kvs.clear();
+
   // destroy watcher handle
   evt_handle_ = nullptr;
 }
@@ -76,12 +143,29 @@ LIBATAPP_MACRO_API void etcd_watcher::active() {
 }
 
 void etcd_watcher::process() {
+  if (!checkpoint_.file_path.empty()) {
+    check_checkpoint_writer();
+  }
+
+  if (checkpoint_.dirty && checkpoint_.next_save_time <= app::get_sys_now()) {
+    checkpoint_.next_save_time = app::get_sys_now() + checkpoint_.interval;
+    flush_checkpoint(true);
+  }
+
+  // Snapshot from checkpoint is kept until the event handle is set
+  notify_checkpoint_snapshot();
+
   if (rpc_.rpc_opr_) {
     return;
   }
 
   rpc_.is_actived = false;
 
+  // Notify the snapshot from checkpoint before startup delay, so discovery can be ready without waiting for etcd
+  if (!checkpoint_.resume_checked && !checkpoint_.file_path.empty() && 0 == rpc_.last_revision) {
+    resume_from_checkpoint();
+  }
+
   if (rpc_.watcher_next_request_time > app::get_sys_now()) {
     return;
   }
@@ -195,6 +279,7 @@ int etcd_watcher::libcurl_callback_on_range_completed(atfw::util::network::http_
     FWLOGERROR("Etcd watcher range request shouldn't has request without private data");
     return 0;
   }
+  self->owner_->add_stats_request_finished(req);
   atfw::util::network::http_request::ptr_t keep_rpc = self->rpc_.rpc_opr_;
   self->rpc_.rpc_opr_.reset();
 
@@ -262,6 +347,7 @@ int etcd_watcher::libcurl_callback_on_range_completed(atfw::util::network::http_
 
   // save revision
   self->rpc_.last_revision = header.revision;
+  self->checkpoint_.resume_checked = true;
 
   // first event
   response_t response;
@@ -269,6 +355,7 @@ int etcd_watcher::libcurl_callback_on_range_completed(atfw::util::network::http_
   response.created = false;
   response.canceled = false;
   response.snapshot = true;
+  response.from_checkpoint = false;
   response.compact_revision = 0;
   {
     rapidjson::Document::ConstMemberIterator res = doc.FindMember("kvs");
@@ -295,14 +382,19 @@ int etcd_watcher::libcurl_callback_on_range_completed(atfw::util::network::http_
     }
   }
 
-  if (atfw::util::log::log_wrapper::check_level(WDTLOGGETCAT(atfw::util::log::log_wrapper::categorize_t::DEFAULT),
-                                                atfw::util::log::log_level::kDebug)) {
-    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(*self->owner_, "Etcd watcher {} got range response",
-                                          reinterpret_cast<const void *>(self));
+  // Only notify the changed key-values when we already have a cache from checkpoint
+  if (!self->checkpoint_.file_path.empty()) {
+    self->merge_checkpoint_snapshot(header.revision, response);
+  }
+
+  if (self->owner_->check_log_level(atfw::util::log::log_level::kDebug)) {
+    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(*self->owner_, "Etcd watcher {} got range response, snapshot: {}",
+                                          reinterpret_cast<const void *>(self), response.snapshot ? "Yes" : "No");
     for (size_t i = 0; i < response.events.size(); ++i) {
       etcd_key_value *kv = &response.events[i].kv;
-      LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(*self->owner_, "    InitEvt => type: PUT, key: {}, value: {}", kv->key,
-                                            kv->value);
+      LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(*self->owner_, "    InitEvt => type: {}, key: {}, value: {}",
+                                            etcd_watch_event::kPut == response.events[i].evt_type ? "PUT" : "DELETE",
+                                            kv->key, kv->value);
     }
   }
 
@@ -325,6 +417,7 @@ int etcd_watcher::libcurl_callback_on_watch_completed(atfw::util::network::http_
     FWLOGERROR("Etcd watcher watch request shouldn't has request without private data");
     return 0;
   }
+  self->owner_->add_stats_request_finished(req);
   atfw::util::network::http_request::ptr_t keep_rpc = self->rpc_.rpc_opr_;
   self->rpc_.rpc_opr_.reset();
   self->rpc_.is_retry_mode = true;
@@ -453,10 +546,6 @@ int etcd_watcher::libcurl_callback_on_watch_write(atfw::util::network::http_requ
       rapidjson::Document::ConstMemberIterator res = result->FindMember("header");
       if (res != result->MemberEnd()) {
         etcd_packer::unpack(header, res->value);
-        // save revision
-        if (0 != header.revision) {
-          self->rpc_.last_revision = header.revision;
-        }
       } else {
         LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(*self->owner_, "Etcd watcher {} got http trunk without header",
                                               reinterpret_cast<const void *>(self));
@@ -464,13 +553,25 @@ int etcd_watcher::libcurl_callback_on_watch_write(atfw::util::network::http_requ
     }
 
     response_t response;
+    response.watch_id = 0;
+    response.created = false;
+    response.canceled = false;
     response.snapshot = false;
+    response.from_checkpoint = false;
+    response.compact_revision = 0;
     // decode basic info
     etcd_packer::unpack_int(*result, "watch_id", response.watch_id);
     etcd_packer::unpack_int(*result, "compact_revision", response.compact_revision);
     etcd_packer::unpack_bool(*result, "created", response.created);
     etcd_packer::unpack_bool(*result, "canceled", response.canceled);
 
+    // save revision
+    // The header of created or canceled response is the current revision of server, but the history events after
+    // last_revision may not be received yet, so we can not resume from it.
+    if (0 != header.revision && !response.created && !response.canceled) {
+      self->rpc_.last_revision = header.revision;
+    }
+
     rapidjson::Document::ConstMemberIterator events = result->FindMember("events");
     if (result->MemberEnd() != events && events->value.IsArray()) {
       rapidjson::Document::ConstArray all_events = events->value.GetArray();
@@ -514,8 +615,7 @@ int etcd_watcher::libcurl_callback_on_watch_write(atfw::util::network::http_requ
       }
     }
 
-    if (atfw::util::log::log_wrapper::check_level(WDTLOGGETCAT(atfw::util::log::log_wrapper::categorize_t::DEFAULT),
-                                                  atfw::util::log::log_level::kDebug)) {
+    if (self->owner_->check_log_level(atfw::util::log::log_level::kDebug)) {
       LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(
           *self->owner_,
           "Etcd watcher {} got response: watch_id: {}, compact_revision: {}, created: {}, canceled: {}, event: {}",
@@ -534,6 +634,22 @@ int etcd_watcher::libcurl_callback_on_watch_write(atfw::util::network::http_requ
       }
     }
 
+    // Snapshot from checkpoint must be notified before the events after it
+    self->notify_checkpoint_snapshot();
+
+    // Watch of a compacted revision is also created and then canceled, so the checkpoint is confirmed only when the
+    // events or progress notify after it are received
+    if (self->checkpoint_.has_cache && !self->checkpoint_.confirmed && !response.created && !response.canceled &&
+        0 == response.compact_revision) {
+      self->checkpoint_.confirmed = true;
+      self->checkpoint_.notify_pending = true;
+      self->notify_checkpoint_snapshot();
+    }
+
+    if (self->checkpoint_.has_cache) {
+      self->apply_checkpoint_events(header, response);
+    }
+
     // trigger event
     if (self->evt_handle_) {
       self->evt_handle_(header, response);
@@ -575,6 +691,543 @@ LIBATAPP_MACRO_API void etcd_watcher::set_conf_from_protobuf(
   set_conf_startup_random_delay_max(
       protobuf_to_chrono_convert_duration_with_default<std::chrono::system_clock::duration>(
           config.startup_random_delay_max(), std::chrono::milliseconds(0)));
+  set_conf_checkpoint_interval(protobuf_to_chrono_convert_duration_with_default<std::chrono::system_clock::duration>(
+      config.checkpoint_interval(), std::chrono::milliseconds(1000)));
+
+  if (config.checkpoint_directory().empty()) {
+    set_conf_checkpoint_file(std::string());
+  } else {
+    // Escape the watch path into a file name
+    std::string file_name;
+    file_name.reserve(path_.size() + range_end_.size() + 17);
+    for (auto c : path_) {
+      if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '.') {
+        file_name.push_back(c);
+      } else {
+        file_name.push_back('_');
+      }
+    }
+    if (file_name.empty() || range_end_ != "+1") {
+      file_name += LOG_WRAPPER_FWAPI_FORMAT(
+          "_{:08x}", atfw::util::hash::murmur_hash3_x86_32(range_end_.c_str(), static_cast<int>(range_end_.size()),
+                                                          LIBATAPP_MACRO_HASH_MAGIC_NUMBER));
+    }
+
+    const std::string &directory = config.checkpoint_directory();
+    if (directory.back() == '/' || directory.back() == '\\') {
+      set_conf_checkpoint_file(LOG_WRAPPER_FWAPI_FORMAT("{}{}.checkpoint.json", directory, file_name));
+    } else {
+      set_conf_checkpoint_file(LOG_WRAPPER_FWAPI_FORMAT("{}/{}.checkpoint.json", directory, file_name));
+    }
+  }
+}
+
+LIBATAPP_MACRO_API void etcd_watcher::set_conf_checkpoint_file(const std::string &file_path) {
+  if (checkpoint_.file_path == file_path) {
+    return;
+  }
+
+  if (checkpoint_.dirty) {
+    flush_checkpoint(true);
+  }
+
+  checkpoint_.file_path = file_path;
+  checkpoint_.dirty = checkpoint_.has_cache && !file_path.empty();
+  checkpoint_.full_save_required = checkpoint_.dirty;
+  checkpoint_.journal_events = 0;
+  checkpoint_.journal.clear();
+}
+
+LIBATAPP_MACRO_API void etcd_watcher::set_conf_checkpoint_worker_pool(
+    const std::shared_ptr<worker_pool_module> &worker_pool) {
+  checkpoint_.worker_pool = worker_pool;
+}
+
+LIBATAPP_MACRO_API bool etcd_watcher::load_checkpoint() {
+  if (checkpoint_.file_path.empty()) {
+    return false;
+  }
+
+  std::string content;
+  {
+    std::ifstream checkpoint_file;
+    checkpoint_file.open(checkpoint_.file_path.c_str(), std::ios::in | std::ios::binary);
+    if (!checkpoint_file.is_open()) {
+      LIBATAPP_MACRO_ETCD_CLUSTER_LOG_DEBUG(*owner_, "Etcd watcher {} checkpoint {} not found",
+                                            reinterpret_cast<const void *>(this), checkpoint_.file_path);
+      return false;
+    }
+    std::stringstream ss;
+    ss << checkpoint_file.rdbuf();
+    ss.str().swap(content);
+  }
+
+  rapidjson::Document doc;
+  if (false == atapp::etcd_packer::parse_object(doc, content.c_str())) {
+    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_WARNING(*owner_, "Etcd watcher {} parse checkpoint {} failed, ignore it",
+                                            reinterpret_cast<const void *>(this), checkpoint_.file_path);
+    return false;
+  }
+
+  std::string path;
+  std::string range_end;
+  int64_t revision = 0;
+  etcd_packer::unpack_base64(doc, "key", path);
+  etcd_packer::unpack_base64(doc, "range_end", range_end);
+  etcd_packer::unpack_int(doc, "revision", revision);
+  if (path != path_ || range_end != range_end_ || revision <= 0) {
+    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_WARNING(
+        *owner_, "Etcd watcher {} checkpoint {} is for {}(range_end: {}) at revision {}, ignore it",
+        reinterpret_cast<const void *>(this), checkpoint_.file_path, path, range_end, revision);
+    return false;
+  }
+
+  std::map<std::string, etcd_key_value> kvs;
+  rapidjson::Document::ConstMemberIterator res = doc.FindMember("kvs");
+  if (doc.MemberEnd() != res && res->value.IsArray()) {
+    rapidjson::Document::ConstArray all_kvs = res->value.GetArray();
+    for (rapidjson::Document::Array::ConstValueIterator iter = all_kvs.Begin(); iter != all_kvs.End(); ++iter) {
+      etcd_key_value kv{};
+      etcd_packer::unpack(kv, *iter);
+      if (!kv.key.empty()) {
+        std::string key = kv.key;
+        kvs[key] = std::move(kv);
+      }
+    }
+  }
+
+  // Replay changes appended after the checkpoint file is saved
+  size_t journal_events = 0;
+  bool journal_broken = false;
+  {
+    std::ifstream journal_file;
+    journal_file.open(get_checkpoint_journal_file().c_str(), std::ios::in | std::ios::binary);
+    std::string line;
+    while (journal_file.is_open() && std::getline(journal_file, line)) {
+      rapidjson::Document record;
+      // The last record may be incomplete if the process crashed when writing it
+      if (line.empty() || false == atapp::etcd_packer::parse_object(record, line.c_str())) {
+        journal_broken = true;
+        break;
+      }
+
+      int64_t record_revision = 0;
+      etcd_packer::unpack_int(record, "revision", record_revision);
+      rapidjson::Document::ConstMemberIterator events = record.FindMember("events");
+      if (record.MemberEnd() != events && events->value.IsArray()) {
+        journal_events += events->value.Size();
+      }
+      if (record_revision <= revision) {
+        continue;
+      }
+
+      revision = record_revision;
+      if (record.MemberEnd() == events || !events->value.IsArray()) {
+        continue;
+      }
+      for (rapidjson::Value::ConstValueIterator iter = events->value.Begin(); iter != events->value.End(); ++iter) {
+        bool is_delete = false;
+        etcd_packer::unpack_bool(*iter, "delete", is_delete);
+        rapidjson::Value::ConstMemberIterator kv_iter = iter->FindMember("kv");
+        if (kv_iter == iter->MemberEnd()) {
+          continue;
+        }
+
+        etcd_key_value kv{};
+        etcd_packer::unpack(kv, kv_iter->value);
+        if (kv.key.empty()) {
+          continue;
+        }
+        if (is_delete) {
+          kvs.erase(kv.key);
+        } else {
+          std::string key = kv.key;
+          kvs[key] = std::move(kv);
+        }
+      }
+    }
+  }
+
+  checkpoint_.kvs.swap(kvs);
+  checkpoint_.revision = revision;
+  checkpoint_.has_cache = true;
+  checkpoint_.confirmed = false;
+  checkpoint_.dirty = journal_broken;
+  // Appending after a broken record will make the following records unreadable
+  checkpoint_.full_save_required = journal_broken;
+  checkpoint_.journal_events = journal_events;
+  checkpoint_.journal.clear();
+  return true;
+}
+
+LIBATAPP_MACRO_API bool etcd_watcher::save_checkpoint() {
+  if (checkpoint_.file_path.empty() || !checkpoint_.has_cache) {
+    return false;
+  }
+
+  checkpoint_.full_save_required = true;
+  return flush_checkpoint(false);
+}
+
+std::string etcd_watcher::pack_checkpoint() const {
+  rapidjson::Document doc;
+  doc.SetObject();
+  etcd_packer::pack_base64(doc, "key", path_, doc);
+  etcd_packer::pack_base64(doc, "range_end", range_end_, doc);
+  doc.AddMember("revision", checkpoint_.revision, doc.GetAllocator());
+
+  rapidjson::Value kvs(rapidjson::kArrayType);
+  kvs.Reserve(static_cast<rapidjson::SizeType>(checkpoint_.kvs.size()), doc.GetAllocator());
+  for (auto &kv : checkpoint_.kvs) {
+    rapidjson::Value kv_value(rapidjson::kObjectType);
+    etcd_packer::pack(kv.second, kv_value, doc);
+    kvs.PushBack(kv_value, doc.GetAllocator());
+  }
+  doc.AddMember("kvs", kvs, doc.GetAllocator());
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  doc.Accept(writer);
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+std::string etcd_watcher::get_checkpoint_journal_file() const {
+  return LOG_WRAPPER_FWAPI_FORMAT("{}.journal", checkpoint_.file_path);
+}
+
+bool etcd_watcher::flush_checkpoint(bool async) {
+  if (checkpoint_.file_path.empty() || !checkpoint_.has_cache) {
+    return false;
+  }
+
+  // Rewrite the whole checkpoint only when the journal is larger than the key-values, so the cost of writing is
+  // proportional to the changes
+  bool full_save = checkpoint_.full_save_required || checkpoint_.journal_events >= checkpoint_.kvs.size() + 64;
+  std::string content;
+  if (full_save) {
+    content = pack_checkpoint();
+    checkpoint_.journal_events = 0;
+  } else {
+    content.swap(checkpoint_.journal);
+  }
+  checkpoint_.dirty = false;
+  checkpoint_.full_save_required = false;
+  checkpoint_.journal.clear();
+
+  if (!full_save && content.empty()) {
+    return true;
+  }
+
+  if (!write_checkpoint(full_save, std::move(content), async)) {
+    // Failure of async writing is checked in process()
+    checkpoint_.dirty = true;
+    checkpoint_.full_save_required = true;
+    return false;
+  }
+
+  LIBATAPP_MACRO_ETCD_CLUSTER_LOG_TRACE(*owner_, "Etcd watcher {} {} checkpoint {} at revision {} with {} keys",
+                                        reinterpret_cast<const void *>(this), full_save ? "save" : "append journal of",
+                                        checkpoint_.file_path, checkpoint_.revision, checkpoint_.kvs.size());
+  return true;
+}
+
+bool etcd_watcher::write_checkpoint(bool full_save, std::string &&content, bool async) {
+  std::shared_ptr<checkpoint_writer_t> writer = checkpoint_.writer;
+  {
+    std::lock_guard<std::mutex> lock_guard{writer->lock};
+    writer->operations.push_back(checkpoint_writer_t::operation_t());
+    checkpoint_writer_t::operation_t &operation = writer->operations.back();
+    operation.full_save = full_save;
+    operation.file_path = checkpoint_.file_path;
+    operation.content = std::move(content);
+
+    // The running job will write it
+    if (async && writer->job_pending) {
+      return true;
+    }
+  }
+
+  std::shared_ptr<worker_pool_module> worker_pool = checkpoint_.worker_pool.lock();
+  if (async && worker_pool) {
+    {
+      std::lock_guard<std::mutex> lock_guard{writer->lock};
+      writer->job_pending = true;
+    }
+
+    int res = worker_pool->spawn([writer](const worker_context &) { writer->run(true); });
+    if (0 == res) {
+      return true;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock_guard{writer->lock};
+      writer->job_pending = false;
+    }
+    LIBATAPP_MACRO_ETCD_CLUSTER_LOG_WARNING(
+        *owner_, "Etcd watcher {} spawn job to write checkpoint {} failed, res: {}, write it in main thread",
+        reinterpret_cast<const void *>(this), checkpoint_.file_path, res);
+  }
+
+  return writer->run(false);
+}
+
+void etcd_watcher::check_checkpoint_writer() {
+  uint64_t failed_count;
+  {
+    std::lock_guard<std::mutex> lock_guard{checkpoint_.writer->lock};
+    failed_count = checkpoint_.writer->failed_count;
+  }
+
+  // Rewrite the whole checkpoint at next flush if the writing in worker pool failed
+  if (failed_count != checkpoint_.writer_failed_count) {
+    checkpoint_.writer_failed_count = failed_count;
+    checkpoint_.dirty = checkpoint_.has_cache;
+    checkpoint_.full_save_required = checkpoint_.has_cache;
+  }
+}
+
+bool etcd_watcher::checkpoint_writer_t::run(bool from_job) {
+  bool ret = true;
+  std::lock_guard<std::mutex> io_lock_guard{io_lock};
+  while (true) {
+    operation_t operation;
+    {
+      std::lock_guard<std::mutex> lock_guard{lock};
+      if (operations.empty()) {
+        if (from_job) {
+          job_pending = false;
+        }
+        break;
+      }
+
+      operation = std::move(operations.front());
+      operations.pop_front();
+      if (failed && !operation.full_save) {
+        ret = false;
+        continue;
+      }
+    }
+
+    ret = write(operation);
+
+    std::lock_guard<std::mutex> lock_guard{lock};
+    if (!ret) {
+      failed = true;
+      ++failed_count;
+    } else if (operation.full_save) {
+      failed = false;
+    }
+  }
+
+  return ret;
+}
+
+bool etcd_watcher::checkpoint_writer_t::write(const operation_t &operation) {
+  // Create the directory when writing first time, so configure does not block the main thread
+  if (checked_directory != operation.file_path) {
+    checked_directory = operation.file_path;
+    std::string directory;
+    if (atfw::util::file_system::dirname(operation.file_path.c_str(), 0, directory) && !directory.empty() &&
+        !atfw::util::file_system::is_exist(directory.c_str())) {
+      atfw::util::file_system::mkdir(directory.c_str(), true);
+    }
+  }
+
+  std::string journal_file_path = LOG_WRAPPER_FWAPI_FORMAT("{}.journal", operation.file_path);
+  if (!operation.full_save) {
+    std::ofstream journal_file;
+    journal_file.open(journal_file_path.c_str(), std::ios::out | std::ios::app | std::ios::binary);
+    if (!journal_file.is_open()) {
+      FWLOGERROR("Etcd watcher open checkpoint journal {} failed", journal_file_path);
+      return false;
+    }
+    journal_file.write(operation.content.c_str(), static_cast<std::streamsize>(operation.content.size()));
+    journal_file.close();
+    if (journal_file.fail()) {
+      FWLOGERROR("Etcd watcher write checkpoint journal {} failed", journal_file_path);
+      return false;
+    }
+    return true;
+  }
+
+  // Write into a temporary file and rename it, so the checkpoint file is always complete
+  std::string tmp_file_path = LOG_WRAPPER_FWAPI_FORMAT("{}.{}.tmp", operation.file_path, atbus::node::get_pid());
+  {
+    std::ofstream checkpoint_file;
+    checkpoint_file.open(tmp_file_path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!checkpoint_file.is_open()) {
+      FWLOGERROR("Etcd watcher open checkpoint {} failed", tmp_file_path);
+      return false;
+    }
+    checkpoint_file.write(operation.content.c_str(), static_cast<std::streamsize>(operation.content.size()));
+    checkpoint_file.close();
+    if (checkpoint_file.fail()) {
+      FWLOGERROR("Etcd watcher write checkpoint {} failed", tmp_file_path);
+      std::remove(tmp_file_path.c_str());
+      return false;
+    }
+  }
+
+#if defined(_WIN32)
+  std::remove(operation.file_path.c_str());
+#endif
+  if (0 != std::rename(tmp_file_path.c_str(), operation.file_path.c_str())) {
+    FWLOGERROR("Etcd watcher rename checkpoint {} to {} failed", tmp_file_path, operation.file_path);
+    std::remove(tmp_file_path.c_str());
+    return false;
+  }
+
+  // All changes in journal are already in the checkpoint file now
+  std::remove(journal_file_path.c_str());
+  return true;
+}
+
+void etcd_watcher::resume_from_checkpoint() {
+  checkpoint_.resume_checked = true;
+  if (!checkpoint_.has_cache && !load_checkpoint()) {
+    return;
+  }
+
+  rpc_.last_revision = checkpoint_.revision;
+  FWLOGINFO("Etcd watcher {} resume from checkpoint {} at revision {} with {} keys",
+            reinterpret_cast<const void *>(this), checkpoint_.file_path, checkpoint_.revision, checkpoint_.kvs.size());
+
+  checkpoint_.notify_pending = true;
+  checkpoint_.confirmed = false;
+  notify_checkpoint_snapshot();
+}
+
+void etcd_watcher::notify_checkpoint_snapshot() {
+  if (!checkpoint_.notify_pending || !evt_handle_) {
+    return;
+  }
+  checkpoint_.notify_pending = false;
+
+  etcd_response_header header{};
+  header.revision = checkpoint_.revision;
+
+  response_t response;
+  response.watch_id = 0;
+  response.created = false;
+  response.canceled = false;
+  response.snapshot = true;
+  response.from_checkpoint = !checkpoint_.confirmed;
+  response.compact_revision = 0;
+  response.events.reserve(checkpoint_.kvs.size());
+  for (auto &kv : checkpoint_.kvs) {
+    response.events.push_back(event_t());
+    event_t &evt = response.events.back();
+    evt.evt_type = etcd_watch_event::kPut;
+    evt.kv = kv.second;
+  }
+
+  evt_handle_(header, response);
+}
+
+void etcd_watcher::merge_checkpoint_snapshot(int64_t revision, response_t &response) {
+  std::map<std::string, etcd_key_value> kvs;
+  for (auto &evt : response.events) {
+    kvs[evt.kv.key] = evt.kv;
+  }
+
+  // The range response is a snapshot itself if the snapshot from checkpoint is not notified yet, or it's not confirmed
+  // by etcd and the receiver still waits for a snapshot to cleanup the stale data
+  if (checkpoint_.has_cache && !checkpoint_.notify_pending && checkpoint_.confirmed) {
+    std::vector<event_t> delta;
+    for (auto &kv : kvs) {
+      auto iter = checkpoint_.kvs.find(kv.first);
+      if (iter != checkpoint_.kvs.end() && iter->second.mod_revision == kv.second.mod_revision &&
+          iter->second.value == kv.second.value) {
+        continue;
+      }
+
+      delta.push_back(event_t());
+      event_t &evt = delta.back();
+      evt.evt_type = etcd_watch_event::kPut;
+      evt.kv = kv.second;
+      if (iter != checkpoint_.kvs.end()) {
+        evt.prev_kv = iter->second;
+      }
+    }
+
+    for (auto &kv : checkpoint_.kvs) {
+      if (kvs.end() != kvs.find(kv.first)) {
+        continue;
+      }
+
+      delta.push_back(event_t());
+      event_t &evt = delta.back();
+      evt.evt_type = etcd_watch_event::kDelete;
+      evt.kv.key = kv.first;
+      evt.kv.mod_revision = revision;
+      evt.prev_kv = kv.second;
+    }
+
+    FWLOGINFO("Etcd watcher {} merge range response at revision {} with checkpoint at revision {}, {} changes",
+              reinterpret_cast<const void *>(this), revision, checkpoint_.revision, delta.size());
+
+    response.snapshot = false;
+    response.events.swap(delta);
+  }
+
+  checkpoint_.kvs.swap(kvs);
+  checkpoint_.revision = revision;
+  checkpoint_.has_cache = true;
+  checkpoint_.notify_pending = false;
+  checkpoint_.confirmed = true;
+  checkpoint_.dirty = true;
+  checkpoint_.full_save_required = true;
+}
+
+void etcd_watcher::apply_checkpoint_events(const etcd_response_header &header, const response_t &response) {
+  if (response.canceled) {
+    return;
+  }
+
+  int64_t revision = checkpoint_.revision;
+  rapidjson::Document record;
+  rapidjson::Value journal_events(rapidjson::kArrayType);
+  for (auto &evt : response.events) {
+    const std::string &key = evt.kv.key.empty() ? evt.prev_kv.key : evt.kv.key;
+    rapidjson::Value journal_event(rapidjson::kObjectType);
+    rapidjson::Value journal_kv(rapidjson::kObjectType);
+    if (etcd_watch_event::kDelete == evt.evt_type) {
+      checkpoint_.kvs.erase(key);
+      etcd_packer::pack_base64(journal_kv, "key", key, record);
+      journal_event.AddMember("delete", true, record.GetAllocator());
+    } else {
+      checkpoint_.kvs[key] = evt.kv;
+      etcd_packer::pack(evt.kv, journal_kv, record);
+    }
+    journal_event.AddMember("kv", journal_kv, record.GetAllocator());
+    journal_events.PushBack(journal_event, record.GetAllocator());
+
+    if (evt.kv.mod_revision > revision) {
+      revision = evt.kv.mod_revision;
+    }
+  }
+
+  // Progress notify means all events before header.revision are received
+  if (response.events.empty() && !response.created && header.revision > revision) {
+    revision = header.revision;
+  }
+
+  if (revision != checkpoint_.revision || !response.events.empty()) {
+    // Only append the changes into journal, the whole checkpoint is rewritten when flushing if it's too large
+    checkpoint_.journal_events += response.events.size();
+    record.SetObject();
+    record.AddMember("revision", revision, record.GetAllocator());
+    record.AddMember("events", journal_events, record.GetAllocator());
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    record.Accept(writer);
+    checkpoint_.journal.append(buffer.GetString(), buffer.GetSize());
+    checkpoint_.journal.push_back('\n');
+
+    checkpoint_.revision = revision;
+    checkpoint_.dirty = true;
+  }
 }
 
 LIBATAPP_MACRO_API void etcd_watcher::set_evt_handle(watch_event_fn_t_ptr fn) {
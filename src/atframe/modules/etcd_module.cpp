@@ -19,6 +19,7 @@
 
 #include <atframe/atapp.h>
 #include <atframe/atapp_conf.h>
+#include <atframe/atapp_log_rate_limit.h>
 
 #include <atframe/etcdcli/etcd_cluster.h>
 #include <atframe/etcdcli/etcd_keepalive.h>
@@ -106,7 +107,17 @@ LIBATAPP_MACRO_API int etcd_module::reload(const atapp::protocol::atapp_etcd &co
   return 0;
 }
 
+LIBATAPP_MACRO_API int etcd_module::reload_logger(const atapp::protocol::atapp_etcd &conf,
+                                                  const atapp::protocol::atapp_log *ATFW_UTIL_MACRO_NULLABLE log_conf) {
+  if (atapp_ == nullptr) {
+    return 0;
+  }
+  load_logger_conf(conf, log_conf);
+  return 0;
+}
+
 LIBATAPP_MACRO_API void etcd_module::reset() {
+  log_rate_limiter::instance().release_extra_category(log_rate_limiter::kCategoryEtcd, this);
   conf_path_cache_.clear();
   conf_cache_.Clear();
   if (cleanup_request_) {
@@ -312,35 +323,7 @@ void etcd_module::load_cluster_conf(const atapp::protocol::atapp_etcd &conf,
   enable_ = conf.enable();
 
   // load logger
-  atfw::util::log::log_wrapper::ptr_t logger;
-  atfw::util::log::log_level startup_level = atfw::util::log::log_level::kDisabled;
-  do {
-    atapp::protocol::atapp_log etcd_log_conf;
-    if (log_conf != nullptr) {
-      etcd_log_conf = *log_conf;
-    } else {
-      atapp_->parse_log_configures_into(etcd_log_conf, std::vector<gsl::string_view>{"atapp", "etcd", "log"},
-                                        "ATAPP_ETCD_LOG");
-    }
-    if (etcd_log_conf.category_size() <= 0) {
-      break;
-    }
-
-    startup_level = atfw::util::log::log_formatter::get_level_by_name(conf.log().startup_level());
-    if (startup_level >= atfw::util::log::log_level::kDisabled &&
-        atfw::util::log::log_formatter::get_level_by_name(etcd_log_conf.level()) >=
-            atfw::util::log::log_level::kDisabled) {
-      break;
-    }
-
-    logger = atfw::util::log::log_wrapper::create_user_logger();
-    if (!logger) {
-      break;
-    }
-    logger->init(atfw::util::log::log_formatter::get_level_by_name(etcd_log_conf.level()));
-    atapp_->setup_logger(*logger, etcd_log_conf.level(), etcd_log_conf.category(0));
-  } while (false);
-  cluster_.set_logger(logger, startup_level);
+  load_logger_conf(conf, log_conf);
 
   // etcd context configure
   {
@@ -375,6 +358,10 @@ void etcd_module::load_cluster_conf(const atapp::protocol::atapp_etcd &conf,
   cluster_.set_conf_etcd_members_retry_interval(
       protobuf_to_chrono_convert_duration_with_default<std::chrono::system_clock::duration>(
           conf.cluster().retry_interval(), std::chrono::milliseconds(60000)));
+  cluster_.set_conf_etcd_members_latency_aware_select(conf.cluster().latency_aware_select());
+  cluster_.set_conf_etcd_members_probe_interval(
+      protobuf_to_chrono_convert_duration_with_default<std::chrono::system_clock::duration>(
+          conf.cluster().probe_interval(), std::chrono::milliseconds(30000)));
 
   cluster_.set_conf_keepalive_timeout(
       protobuf_to_chrono_convert_duration_with_default<std::chrono::system_clock::duration>(
@@ -385,6 +372,8 @@ void etcd_module::load_cluster_conf(const atapp::protocol::atapp_etcd &conf,
   cluster_.set_conf_keepalive_retry_interval(
       protobuf_to_chrono_convert_duration_with_default<std::chrono::system_clock::duration>(
           conf.keepalive().retry_interval(), std::chrono::milliseconds(3000)));
+  cluster_.set_conf_keepalive_batch_set(conf.keepalive().batch_write());
+  cluster_.set_conf_keepalive_share_lease(conf.keepalive().share_lease());
 
   // HTTP
   if (!conf.http().user_agent().empty()) {
@@ -404,6 +393,7 @@ void etcd_module::load_cluster_conf(const atapp::protocol::atapp_etcd &conf,
   }
 
   cluster_.set_conf_http_debug_mode(conf.http().debug());
+  cluster_.set_conf_http2_multiplexing(conf.http().http2_multiplexing());
 
   // SSL configure
   cluster_.set_conf_ssl_enable_alpn(conf.ssl().enable_alpn());
@@ -486,6 +476,46 @@ void etcd_module::load_cluster_conf(const atapp::protocol::atapp_etcd &conf,
   }
 }
 
+void etcd_module::load_logger_conf(const atapp::protocol::atapp_etcd &conf,
+                                   const atapp::protocol::atapp_log *ATFW_UTIL_MACRO_NULLABLE log_conf) {
+  atfw::util::log::log_wrapper::ptr_t logger;
+  atfw::util::log::log_level startup_level = atfw::util::log::log_level::kDisabled;
+  // Etcd logs are written into the default category only when there is no logger of etcd, use limits of it
+  log_rate_limiter::options_type rate_limit_options =
+      log_rate_limiter::instance().get_options(atfw::util::log::log_wrapper::categorize_t::DEFAULT);
+  do {
+    atapp::protocol::atapp_log etcd_log_conf;
+    if (log_conf != nullptr) {
+      etcd_log_conf = *log_conf;
+    } else {
+      atapp_->parse_log_configures_into(etcd_log_conf, std::vector<gsl::string_view>{"atapp", "etcd", "log"},
+                                        "ATAPP_ETCD_LOG");
+    }
+    if (etcd_log_conf.category_size() <= 0) {
+      break;
+    }
+
+    startup_level = atfw::util::log::log_formatter::get_level_by_name(conf.log().startup_level());
+    if (startup_level >= atfw::util::log::log_level::kDisabled &&
+        atfw::util::log::log_formatter::get_level_by_name(etcd_log_conf.level()) >=
+            atfw::util::log::log_level::kDisabled) {
+      break;
+    }
+
+    logger = atfw::util::log::log_wrapper::create_user_logger();
+    if (!logger) {
+      break;
+    }
+    logger->init(atfw::util::log::log_formatter::get_level_by_name(etcd_log_conf.level()));
+    atapp_->setup_logger(*logger, etcd_log_conf.level(), etcd_log_conf.category(0));
+    rate_limit_options = log_rate_limiter::make_options(etcd_log_conf.category(0).rate_limit());
+  } while (false);
+  cluster_.set_logger(logger, startup_level);
+
+  // The etcd category of log_rate_limiter is shared by all apps in this process, only the first one configures it
+  log_rate_limiter::instance().set_extra_category(log_rate_limiter::kCategoryEtcd, this, rate_limit_options, logger);
+}
+
 LIBATAPP_MACRO_API std::string etcd_module::generate_etcd_path(const std::string &path) {
   std::string gen_path = path;
   if (!gen_path.empty()) {
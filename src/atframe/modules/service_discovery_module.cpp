@@ -13,6 +13,7 @@
 #include <config/compiler/protobuf_suffix.h>
 // clang-format on
 
+#include <common/file_system.h>
 #include <common/string_oprs.h>
 #include <random/random_generator.h>
 
@@ -23,11 +24,15 @@
 #include <atframe/etcdcli/etcd_keepalive.h>
 #include <atframe/etcdcli/etcd_watcher.h>
 #include <atframe/modules/etcd_module.h>
+#include <atframe/modules/worker_pool_module.h>
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <list>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -45,6 +50,8 @@
 #define ETCD_MODULE_BY_NAME_DIR "by_name"
 #define ETCD_MODULE_TOPOLOGY_DIR "topology"
 
+#define SERVICE_DISCOVERY_CACHE_VERSION 1
+
 LIBATAPP_MACRO_NAMESPACE_BEGIN
 namespace {
 
@@ -176,6 +183,16 @@ struct ATFW_UTIL_SYMBOL_LOCAL service_discovery_module::watcher_internal_access_
                                          std::unordered_map<uint64_t, topology_storage_t> &old_ids);
 };
 
+// Shared with worker jobs, so the cache file can be written after the module is destroyed
+struct ATFW_UTIL_SYMBOL_LOCAL service_discovery_module::discovery_cache_writer_t {
+  std::mutex lock;
+  uint64_t sequence_allocator = 0;
+  uint64_t last_written_sequence = 0;
+  size_t pending_jobs = 0;
+
+  int write(const std::string &file_path, uint64_t sequence, const atapp::protocol::atapp_discovery_cache &data);
+};
+
 struct ATFW_UTIL_SYMBOL_LOCAL service_discovery_module::service_discovery_cluster_context_data {
   service_discovery_cluster_context_data()
       : last_etcd_event_topology_header_{},
@@ -224,8 +241,15 @@ service_discovery_module::service_discovery_module()
       maybe_update_internal_keepalive_discovery_value_(true),
       maybe_update_internal_keepalive_discovery_area_(false),
       maybe_update_internal_keepalive_discovery_metadata_(false),
-      tick_interval_(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::milliseconds(128))) {
+      tick_interval_(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::milliseconds(128))),
+      discovery_cache_save_interval_(
+          std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(10))),
+      discovery_cache_max_age_(std::chrono::system_clock::duration::zero()),
+      discovery_cache_dirty_(false),
+      keepalive_start_check_pending_(false),
+      discovery_cache_writer_(std::make_shared<discovery_cache_writer_t>()) {
   tick_next_timepoint_ = app::get_sys_now();
+  discovery_cache_next_save_time_ = app::get_sys_now();
 }
 
 LIBATAPP_MACRO_API int service_discovery_module::init() {
@@ -251,7 +275,15 @@ LIBATAPP_MACRO_API int service_discovery_module::init() {
     return 0;
   }
 
-  ret = init_service_discovery_keepalives_watchers(cluster_context_);
+  // Route by local cache before etcd is ready, it will be reconciled by snapshot of etcd later
+  bool wait_keepalive_start = true;
+  if (!discovery_cache_path_.empty() && load_discovery_cache(discovery_cache_path_) > 0) {
+    // Do not wait for etcd, keepalive actors will be checked in tick()
+    wait_keepalive_start = false;
+  }
+  discovery_cache_next_save_time_ = app::get_sys_now() + discovery_cache_save_interval_;
+
+  ret = init_service_discovery_keepalives_watchers(cluster_context_, wait_keepalive_start);
   if (ret < 0) {
     // TODO(yousongyang) init 失败stop不会tick 之后要手动tick 或者变为接管的 init_failed_cleanup 模式
     stop();
@@ -259,12 +291,13 @@ LIBATAPP_MACRO_API int service_discovery_module::init() {
   }
 
   for (const auto &external_cluster_context : external_cluster_contexts_) {
-    ret = init_service_discovery_keepalives_watchers(external_cluster_context);
+    ret = init_service_discovery_keepalives_watchers(external_cluster_context, wait_keepalive_start);
     if (ret < 0) {
       stop();
       return ret;
     }
   }
+  keepalive_start_check_pending_ = !wait_keepalive_start;
 
   // TODO(yousongyang) init_service_discovery_keepalives_watchers 内会等待success事件，可能会比较慢，需要优化成一批等待
   discovery_keepalives_watchers_inited_ = true;
@@ -281,6 +314,13 @@ LIBATAPP_MACRO_API service_discovery_module::service_discovery_cluster_context::
 
 LIBATAPP_MACRO_API int service_discovery_module::stop() {
   int ret = 0;
+
+  // Flush the latest data before the watchers are removed, but do not overwrite the cache file before reconciled by etcd
+  if (!discovery_cache_path_.empty() && discovery_cache_dirty_ && discovery_cache_stale_contexts_.empty() &&
+      topology_cache_stale_contexts_.empty()) {
+    save_discovery_cache(discovery_cache_path_, false);
+  }
+  keepalive_start_check_pending_ = false;
   // 逆序Stop
   for (auto iter = external_cluster_contexts_.rbegin(); iter != external_cluster_contexts_.rend(); ++iter) {
     int ext_ret = (*iter)->stop();
@@ -308,6 +348,23 @@ LIBATAPP_MACRO_API int service_discovery_module::reload() {
     tick_interval_ = std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::milliseconds(128));
   }
 
+  {
+    const atapp::protocol::atapp_etcd_discovery_cache &cache_conf =
+        get_app()->get_origin_configure().etcd().discovery_cache();
+    discovery_cache_path_ = cache_conf.path();
+    discovery_cache_save_interval_ =
+        protobuf_to_chrono_convert_duration_with_default<std::chrono::system_clock::duration>(
+            cache_conf.save_interval(), std::chrono::seconds(10));
+    discovery_cache_max_age_ = protobuf_to_chrono_convert_duration_with_default<std::chrono::system_clock::duration>(
+        cache_conf.max_age(), std::chrono::seconds(0));
+  }
+
+  // Skip reloading etcd cluster when etcd configure is not changed, it may reset some internal states.
+  // atapp.etcd.log.* is loaded by parse_log_configures_into and is not a part of atapp_etcd, always reload logger.
+  if (!get_app()->is_origin_configure_changed("etcd")) {
+    return cluster_context_->get_etcd_module().reload_logger(get_app()->get_origin_configure().etcd(), nullptr);
+  }
+
   // TODO(yousongyang) reload 不支持external cluster context的热更新，注意回收lease和错误重试流程
   return cluster_context_->reload(get_app()->get_origin_configure().etcd(), nullptr);
 }
@@ -359,6 +416,9 @@ LIBATAPP_MACRO_API int service_discovery_module::tick() {
     update_keepalive_discovery_value();
   }
 
+  tick_keepalive_start_check();
+  tick_discovery_cache();
+
   return 0;
 }
 
@@ -651,6 +711,7 @@ LIBATAPP_MACRO_API int service_discovery_module::init_discovery_watcher_by_id(
 
     context->data_->internal_discovery_watcher_by_id_->set_conf_from_protobuf(
         context->etcd_module_.get_configure().watcher());
+    context->data_->internal_discovery_watcher_by_id_->set_conf_checkpoint_worker_pool(app.get_worker_pool_module());
     context->etcd_module_.get_etcd_cluster().add_watcher(context->data_->internal_discovery_watcher_by_id_);
     LIBATAPP_MACRO_ETCD_CLUSTER_LOG_INFO(context->etcd_module_.get_etcd_cluster(),
                                          "create etcd_watcher for by_id index {} success", watch_path);
@@ -681,6 +742,7 @@ LIBATAPP_MACRO_API int service_discovery_module::init_discovery_watcher_by_name(
 
     context->data_->internal_discovery_watcher_by_name_->set_conf_from_protobuf(
         context->etcd_module_.get_configure().watcher());
+    context->data_->internal_discovery_watcher_by_name_->set_conf_checkpoint_worker_pool(app.get_worker_pool_module());
     context->etcd_module_.get_etcd_cluster().add_watcher(context->data_->internal_discovery_watcher_by_name_);
     LIBATAPP_MACRO_ETCD_CLUSTER_LOG_INFO(context->etcd_module_.get_etcd_cluster(),
                                          "create etcd_watcher for by_name index {} success", watch_path);
@@ -710,6 +772,7 @@ LIBATAPP_MACRO_API int service_discovery_module::init_topology_watcher(
     }
 
     context->data_->internal_topology_watcher_->set_conf_from_protobuf(context->etcd_module_.get_configure().watcher());
+    context->data_->internal_topology_watcher_->set_conf_checkpoint_worker_pool(app.get_worker_pool_module());
     context->etcd_module_.get_etcd_cluster().add_watcher(context->data_->internal_topology_watcher_);
     LIBATAPP_MACRO_ETCD_CLUSTER_LOG_INFO(context->etcd_module_.get_etcd_cluster(),
                                          "create etcd_watcher for topology index {} success", watch_path);
@@ -758,6 +821,26 @@ service_discovery_module::service_discovery_cluster_context::check_keepalive_act
   return etcd_module_.check_keepalive_actor_start_success(gsl::make_span(keepalive_actors));
 }
 
+LIBATAPP_MACRO_API int service_discovery_module::service_discovery_cluster_context::get_keepalive_actor_start_state()
+    const {
+  int ret = 1;
+  const std::list<etcd_keepalive::ptr_t> *keepalive_actors[] = {&data_->internal_discovery_keepalive_actors_,
+                                                                &data_->internal_topology_keepalive_actors_};
+  for (const auto *keepalive_actor_list : keepalive_actors) {
+    for (const auto &keepalive_actor : *keepalive_actor_list) {
+      if (!keepalive_actor->is_check_run()) {
+        ret = 0;
+      } else if (!keepalive_actor->is_check_passed()) {
+        LIBATAPP_MACRO_ETCD_CLUSTER_LOG_ERROR(etcd_module_.get_etcd_cluster(), "etcd_keepalive lock {} failed.",
+                                              keepalive_actor->get_path());
+        return -1;
+      }
+    }
+  }
+
+  return ret;
+}
+
 LIBATAPP_MACRO_API void
 service_discovery_module::service_discovery_cluster_context::add_discovery_watcher_by_id_callback(
     const discovery_watcher_list_callback_t &fn) {
@@ -1047,6 +1130,326 @@ LIBATAPP_MACRO_API void service_discovery_module::remove_on_topology_snapshot_lo
   handle = topology_on_snapshot_loaded_callbacks_.end();
 }
 
+LIBATAPP_MACRO_API int service_discovery_module::load_discovery_cache(const std::string &file_path) {
+  std::string content;
+  {
+    std::ifstream cache_file;
+    cache_file.open(file_path.c_str(), std::ios::in | std::ios::binary);
+    if (!cache_file.is_open()) {
+      FWLOGINFO("discovery cache {} not found, skip loading", file_path);
+      return EN_ATAPP_ERR_DISCOVERY_CACHE_IO;
+    }
+
+    std::stringstream ss;
+    ss << cache_file.rdbuf();
+    ss.str().swap(content);
+  }
+
+  atapp::protocol::atapp_discovery_cache cache_data;
+  if (!cache_data.ParseFromString(content) || SERVICE_DISCOVERY_CACHE_VERSION != cache_data.version()) {
+    FWLOGWARNING("discovery cache {} is invalid or has unsupported version {}, ignore it", file_path,
+                 cache_data.version());
+    return EN_ATAPP_ERR_DISCOVERY_CACHE_INVALID;
+  }
+
+  if (discovery_cache_max_age_ > std::chrono::system_clock::duration::zero()) {
+    std::chrono::system_clock::time_point save_time =
+        std::chrono::system_clock::from_time_t(0) + std::chrono::milliseconds(cache_data.save_timestamp_ms());
+    if (save_time + discovery_cache_max_age_ < app::get_sys_now()) {
+      FWLOGWARNING("discovery cache {} saved at {}ms is expired, ignore it", file_path,
+                   cache_data.save_timestamp_ms());
+      return EN_ATAPP_ERR_DISCOVERY_CACHE_INVALID;
+    }
+  }
+
+  int node_count = 0;
+  for (auto &cache_node : *cache_data.mutable_nodes()) {
+    service_discovery_cluster_context *ctx = find_cluster_context_by_path(cache_node.context_path());
+    if (nullptr == ctx) {
+      continue;
+    }
+
+    node_info_t node;
+    node.context_addr = reinterpret_cast<uintptr_t>(ctx);
+    node.action = node_action_t::kPut;
+    node.node_discovery.Swap(cache_node.mutable_discovery());
+    if (node.node_discovery.id() == 0 && node.node_discovery.name().empty()) {
+      continue;
+    }
+
+    etcd_discovery_node::node_version version;
+    version.create_revision = cache_node.create_revision();
+    version.modify_revision = cache_node.modify_revision();
+    version.version = cache_node.version();
+    if (update_internal_watcher_event(node, version)) {
+      ++node_count;
+      if (ctx->data_->discovery_watcher_snapshot_index_.empty()) {
+        discovery_cache_stale_contexts_.insert(reinterpret_cast<uintptr_t>(ctx));
+      }
+    }
+  }
+
+  int topology_count = 0;
+  for (auto &cache_topology : *cache_data.mutable_topologies()) {
+    service_discovery_cluster_context *ctx = find_cluster_context_by_path(cache_topology.context_path());
+    if (nullptr == ctx || 0 == cache_topology.info().id()) {
+      continue;
+    }
+
+    topology_info_t topology_info;
+    topology_info.action = topology_action_t::kPut;
+    topology_info.storage.context_addr = reinterpret_cast<uintptr_t>(ctx);
+    topology_info.storage.info = atfw::util::memory::make_strong_rc<atapp::protocol::atapp_topology_info>();
+    topology_info.storage.info->Swap(cache_topology.mutable_info());
+    topology_info.storage.version.create_revision = cache_topology.create_revision();
+    topology_info.storage.version.modify_revision = cache_topology.modify_revision();
+    topology_info.storage.version.version = cache_topology.version();
+    if (update_internal_watcher_event(topology_info)) {
+      ++topology_count;
+      if (ctx->data_->topology_watcher_snapshot_index_.empty()) {
+        topology_cache_stale_contexts_.insert(reinterpret_cast<uintptr_t>(ctx));
+      }
+    }
+  }
+
+  // Nothing changed by the cache, so it's not necessary to save it again
+  discovery_cache_dirty_ = false;
+
+  FWLOGINFO("load discovery cache {} saved at {}ms by {}(0x{:x}), {} nodes and {} topology peers loaded", file_path,
+            cache_data.save_timestamp_ms(), cache_data.app_name(), cache_data.app_id(), node_count, topology_count);
+  return node_count + topology_count;
+}
+
+LIBATAPP_MACRO_API int service_discovery_module::save_discovery_cache(const std::string &file_path, bool async) {
+  if (file_path.empty()) {
+    return EN_ATBUS_ERR_PARAMS;
+  }
+
+  std::shared_ptr<atapp::protocol::atapp_discovery_cache> cache_data =
+      std::make_shared<atapp::protocol::atapp_discovery_cache>();
+  cache_data->set_version(SERVICE_DISCOVERY_CACHE_VERSION);
+  cache_data->set_save_timestamp_ms(static_cast<int64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(app::get_sys_now().time_since_epoch()).count()));
+  if (nullptr != get_app()) {
+    cache_data->set_app_id(get_app()->get_id());
+    cache_data->set_app_name(get_app()->get_app_name());
+  }
+
+  cache_data->mutable_nodes()->Reserve(static_cast<int>(global_discovery_.get_sorted_nodes().size()));
+  for (const auto &node : global_discovery_.get_sorted_nodes()) {
+    if (!node) {
+      continue;
+    }
+
+    service_discovery_cluster_context *ctx = find_cluster_context_by_addr(node->get_context_addr());
+    if (nullptr == ctx) {
+      continue;
+    }
+
+    atapp::protocol::atapp_discovery_cache_node *cache_node = cache_data->add_nodes();
+    cache_node->set_context_path(ctx->get_etcd_module().get_configure_path());
+    cache_node->set_create_revision(node->get_version().create_revision);
+    cache_node->set_modify_revision(node->get_version().modify_revision);
+    cache_node->set_version(node->get_version().version);
+    node->copy_to(*cache_node->mutable_discovery());
+  }
+
+  cache_data->mutable_topologies()->Reserve(static_cast<int>(internal_topology_info_set_.size()));
+  for (const auto &topology : internal_topology_info_set_) {
+    if (!topology.second.info) {
+      continue;
+    }
+
+    service_discovery_cluster_context *ctx = find_cluster_context_by_addr(topology.second.context_addr);
+    if (nullptr == ctx) {
+      continue;
+    }
+
+    atapp::protocol::atapp_discovery_cache_topology *cache_topology = cache_data->add_topologies();
+    cache_topology->set_context_path(ctx->get_etcd_module().get_configure_path());
+    cache_topology->set_create_revision(topology.second.version.create_revision);
+    cache_topology->set_modify_revision(topology.second.version.modify_revision);
+    cache_topology->set_version(topology.second.version.version);
+    cache_topology->mutable_info()->CopyFrom(*topology.second.info);
+  }
+
+  std::shared_ptr<discovery_cache_writer_t> writer = discovery_cache_writer_;
+  uint64_t sequence;
+  {
+    std::lock_guard<std::mutex> lock_guard{writer->lock};
+    sequence = ++writer->sequence_allocator;
+  }
+
+  // Serialize and write file in worker pool
+  if (async && nullptr != get_app() && get_app()->get_worker_pool_module()) {
+    {
+      std::lock_guard<std::mutex> lock_guard{writer->lock};
+      ++writer->pending_jobs;
+    }
+
+    std::string async_file_path = file_path;
+    int res = get_app()->get_worker_pool_module()->spawn(
+        [writer, async_file_path, sequence, cache_data](const worker_context &) {
+          writer->write(async_file_path, sequence, *cache_data);
+
+          std::lock_guard<std::mutex> lock_guard{writer->lock};
+          --writer->pending_jobs;
+        });
+    if (0 == res) {
+      return 0;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock_guard{writer->lock};
+      --writer->pending_jobs;
+    }
+    FWLOGWARNING("spawn job to save discovery cache {} failed, res: {}, save it in main thread", file_path, res);
+  }
+
+  return writer->write(file_path, sequence, *cache_data);
+}
+
+LIBATAPP_MACRO_API bool service_discovery_module::is_discovery_cache_stale() const noexcept {
+  return !discovery_cache_stale_contexts_.empty();
+}
+
+LIBATAPP_MACRO_API bool service_discovery_module::is_topology_cache_stale() const noexcept {
+  return !topology_cache_stale_contexts_.empty();
+}
+
+void service_discovery_module::tick_keepalive_start_check() {
+  if (!keepalive_start_check_pending_) {
+    return;
+  }
+
+  // Same as the check in init(), but do not block when routing by local cache
+  int state = cluster_context_->get_keepalive_actor_start_state();
+  for (const auto &external_cluster_context : external_cluster_contexts_) {
+    if (state < 0) {
+      break;
+    }
+    int external_state = external_cluster_context->get_keepalive_actor_start_state();
+    if (external_state <= 0) {
+      state = external_state;
+    }
+  }
+
+  if (0 == state) {
+    return;
+  }
+
+  keepalive_start_check_pending_ = false;
+  if (state < 0) {
+    FWLOGERROR("etcd keepalive check failed after started by discovery cache, stop app");
+    get_app()->stop();
+  }
+}
+
+void service_discovery_module::tick_discovery_cache() {
+  if (discovery_cache_path_.empty() || !discovery_cache_dirty_) {
+    return;
+  }
+
+  // Do not overwrite the cache file before reconciled by etcd
+  if (!discovery_cache_stale_contexts_.empty() || !topology_cache_stale_contexts_.empty()) {
+    return;
+  }
+
+  if (discovery_cache_next_save_time_ > get_app()->get_last_tick_time()) {
+    return;
+  }
+
+  // Previous job is still running
+  {
+    std::lock_guard<std::mutex> lock_guard{discovery_cache_writer_->lock};
+    if (discovery_cache_writer_->pending_jobs > 0) {
+      return;
+    }
+  }
+
+  discovery_cache_next_save_time_ = get_app()->get_last_tick_time() + discovery_cache_save_interval_;
+  discovery_cache_dirty_ = false;
+  if (0 != save_discovery_cache(discovery_cache_path_, true)) {
+    discovery_cache_dirty_ = true;
+  }
+}
+
+service_discovery_module::service_discovery_cluster_context *service_discovery_module::find_cluster_context_by_addr(
+    uintptr_t context_addr) noexcept {
+  if (reinterpret_cast<uintptr_t>(cluster_context_.get()) == context_addr) {
+    return cluster_context_.get();
+  }
+
+  for (const auto &external_cluster_context : external_cluster_contexts_) {
+    if (reinterpret_cast<uintptr_t>(external_cluster_context.get()) == context_addr) {
+      return external_cluster_context.get();
+    }
+  }
+
+  return nullptr;
+}
+
+service_discovery_module::service_discovery_cluster_context *service_discovery_module::find_cluster_context_by_path(
+    const std::string &path) noexcept {
+  if (cluster_context_->get_etcd_module().get_configure_path() == path) {
+    return cluster_context_.get();
+  }
+
+  for (const auto &external_cluster_context : external_cluster_contexts_) {
+    if (external_cluster_context->get_etcd_module().get_configure_path() == path) {
+      return external_cluster_context.get();
+    }
+  }
+
+  return nullptr;
+}
+
+int service_discovery_module::discovery_cache_writer_t::write(const std::string &file_path, uint64_t sequence,
+                                                              const atapp::protocol::atapp_discovery_cache &data) {
+  std::string content;
+  if (!data.SerializeToString(&content)) {
+    FWLOGERROR("serialize discovery cache {} failed", file_path);
+    return EN_ATAPP_ERR_DISCOVERY_CACHE_INVALID;
+  }
+
+  std::lock_guard<std::mutex> lock_guard{lock};
+  // A newer cache is already written
+  if (sequence <= last_written_sequence) {
+    return 0;
+  }
+
+  // Write into a temporary file and rename it, so the cache file is always complete
+  std::string tmp_file_path = LOG_WRAPPER_FWAPI_FORMAT("{}.{}.{}.tmp", file_path, atbus::node::get_pid(), sequence);
+  {
+    std::ofstream cache_file;
+    cache_file.open(tmp_file_path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!cache_file.is_open()) {
+      FWLOGERROR("open discovery cache {} failed", tmp_file_path);
+      return EN_ATAPP_ERR_DISCOVERY_CACHE_IO;
+    }
+
+    cache_file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    cache_file.close();
+    if (cache_file.fail()) {
+      FWLOGERROR("write discovery cache {} failed", tmp_file_path);
+      std::remove(tmp_file_path.c_str());
+      return EN_ATAPP_ERR_DISCOVERY_CACHE_IO;
+    }
+  }
+
+#if defined(_WIN32)
+  std::remove(file_path.c_str());
+#endif
+  if (0 != std::rename(tmp_file_path.c_str(), file_path.c_str())) {
+    FWLOGERROR("rename discovery cache {} to {} failed", tmp_file_path, file_path);
+    std::remove(tmp_file_path.c_str());
+    return EN_ATAPP_ERR_DISCOVERY_CACHE_IO;
+  }
+
+  last_written_sequence = sequence;
+  return 0;
+}
+
 LIBATAPP_MACRO_API etcd_watcher::watch_event_fn_t_ptr
 service_discovery_module::create_discovery_watcher_callback_list_wrapper(
     const ::atfw::util::nostd::nonnull<std::shared_ptr<service_discovery_cluster_context>> &context) {
@@ -1302,7 +1705,12 @@ void service_discovery_module::discovery_watcher_callback_list_wrapper_t::operat
   }
   ctx_locked->data_->last_etcd_event_discovery_header_ = header;
 
-  bool enable_snapshot = body.snapshot && 0 != snapshot_index;
+  // Snapshot from the checkpoint of watcher is only a local cache, it's applied as puts and kept stale until etcd
+  // confirms it by another snapshot
+  bool enable_snapshot = body.snapshot && !body.from_checkpoint && 0 != snapshot_index;
+  if (body.from_checkpoint && ctx_locked->data_->discovery_watcher_snapshot_index_.empty()) {
+    mod->discovery_cache_stale_contexts_.insert(reinterpret_cast<uintptr_t>(ctx_locked.get()));
+  }
   if (enable_snapshot) {
     if (!has_insert_snapshot_index) {
       ctx_locked->data_->discovery_watcher_snapshot_index_.insert(snapshot_index);
@@ -1332,10 +1740,10 @@ void service_discovery_module::discovery_watcher_callback_list_wrapper_t::operat
     }
   }
 
-  // decode data
+  // decode data, node is reused by all events to reuse memory of fields, unpack() will reset it
+  node_info_t node;
   for (size_t i = 0; i < body.events.size(); ++i) {
     const ::atframework::atapp::etcd_watcher::event_t &evt_data = body.events[i];
-    node_info_t node;
     node.context_addr = reinterpret_cast<uintptr_t>(ctx_locked.get());
     etcd_discovery_node::node_version current_node_version;
 
@@ -1382,6 +1790,7 @@ void service_discovery_module::discovery_watcher_callback_list_wrapper_t::operat
   // cleanup old nodes when receive snapshot response
   if (enable_snapshot) {
     service_discovery_module::watcher_internal_access_t::cleanup_old_nodes(*mod, *ctx_locked, old_names, old_ids);
+    mod->discovery_cache_stale_contexts_.erase(reinterpret_cast<uintptr_t>(ctx_locked.get()));
 
     for (auto iter = mod->discovery_on_snapshot_loaded_callbacks_.begin();
          iter != mod->discovery_on_snapshot_loaded_callbacks_.end();) {
@@ -1434,7 +1843,12 @@ void service_discovery_module::topology_watcher_callback_list_wrapper_t::operato
   }
   ctx_locked->data_->last_etcd_event_topology_header_ = header;
 
-  bool enable_snapshot = body.snapshot && 0 != snapshot_index;
+  // Snapshot from the checkpoint of watcher is only a local cache, it's applied as puts and kept stale until etcd
+  // confirms it by another snapshot
+  bool enable_snapshot = body.snapshot && !body.from_checkpoint && 0 != snapshot_index;
+  if (body.from_checkpoint && ctx_locked->data_->topology_watcher_snapshot_index_.empty()) {
+    mod->topology_cache_stale_contexts_.insert(reinterpret_cast<uintptr_t>(ctx_locked.get()));
+  }
   if (enable_snapshot) {
     if (!has_insert_snapshot_index) {
       ctx_locked->data_->topology_watcher_snapshot_index_.insert(snapshot_index);
@@ -1508,6 +1922,7 @@ void service_discovery_module::topology_watcher_callback_list_wrapper_t::operato
   // cleanup old nodes when receive snapshot response
   if (enable_snapshot) {
     service_discovery_module::watcher_internal_access_t::cleanup_old_topology_peers(*mod, *ctx_locked, old_ids);
+    mod->topology_cache_stale_contexts_.erase(reinterpret_cast<uintptr_t>(ctx_locked.get()));
 
     for (auto iter = mod->topology_on_snapshot_loaded_callbacks_.begin();
          iter != mod->topology_on_snapshot_loaded_callbacks_.end();) {
@@ -1560,7 +1975,7 @@ bool service_discovery_module::update_internal_watcher_event(node_info_t &node,
               reinterpret_cast<void *>(local_cache_by_id->get_context_addr()));  // NOLINT(performance-no-int-to-ptr)
           return false;
         }
-        if (protobuf_equal(local_cache_by_id->get_discovery_info(), node.node_discovery)) {
+        if (local_cache_by_id->equal_to(node.node_discovery)) {
           local_cache_by_id->update_version(version, true);
           return false;
         }
@@ -1621,12 +2036,12 @@ bool service_discovery_module::update_internal_watcher_event(node_info_t &node,
           (!local_cache_by_name && !node.node_discovery.name().empty())) {
         has_event = true;
       } else if (local_cache_by_id &&
-                 (false == protobuf_equal(local_cache_by_id->get_discovery_info(), node.node_discovery) &&
+                 (false == local_cache_by_id->equal_to(node.node_discovery) &&
                   local_cache_by_id->get_context_addr() == node.context_addr)) {
         new_inst = local_cache_by_id;
         has_event = true;
       } else if (local_cache_by_name &&
-                 (false == protobuf_equal(local_cache_by_name->get_discovery_info(), node.node_discovery) &&
+                 (false == local_cache_by_name->equal_to(node.node_discovery) &&
                   local_cache_by_name->get_context_addr() == node.context_addr)) {
         new_inst = local_cache_by_name;
         has_event = true;
@@ -1653,6 +2068,7 @@ bool service_discovery_module::update_internal_watcher_event(node_info_t &node,
 
   // remove endpoint if got DELETE event
   if (has_event) {
+    discovery_cache_dirty_ = true;
     if (node_action_t::kDelete == node.action) {
       if (0 != node.node_discovery.id()) {
         get_app()->remove_endpoint(node.node_discovery.id());
@@ -1751,6 +2167,8 @@ bool service_discovery_module::update_internal_watcher_event(topology_info_t &to
     }
   }
 
+  discovery_cache_dirty_ = true;
+
   {
     std::lock_guard<std::recursive_mutex> lock_guard{topology_info_event_lock_};
     get_app()->trigger_event_on_topology_event(topology_info.action, info_ptr, topology_info.storage.version);
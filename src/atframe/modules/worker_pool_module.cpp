@@ -631,6 +631,10 @@ LIBATAPP_MACRO_API int worker_pool_module::init() {
 }
 
 LIBATAPP_MACRO_API int worker_pool_module::reload() {
+  if (!get_app()->is_origin_configure_changed("worker_pool")) {
+    return 0;
+  }
+
   const auto& cfg = get_app()->get_origin_configure().worker_pool();
   if (worker_set_) {
     int64_t tick_interval = (cfg.tick_max_interval().nanos() / 1000) + (cfg.tick_max_interval().seconds() * 1000000);
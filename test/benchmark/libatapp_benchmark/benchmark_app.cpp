@@ -0,0 +1,79 @@
+// Copyright 2026 atframework
+
+#include "benchmark_app.h"
+
+#include <common/file_system.h>
+#include <time/time_utility.h>
+
+#include <iostream>
+#include <map>
+#include <memory>
+
+#include "benchmark_frame.h"
+
+namespace atapp_benchmark {
+
+namespace {
+static std::map<std::string, std::unique_ptr<atframework::atapp::app>> &get_shared_apps() {
+  static std::map<std::string, std::unique_ptr<atframework::atapp::app>> ret;
+  return ret;
+}
+}  // namespace
+
+std::string get_test_case_path(const char *file_name) {
+  std::string ret;
+  // test/benchmark/libatapp_benchmark/benchmark_app.cpp -> test
+  atfw::util::file_system::dirname(__FILE__, 0, ret, 3);
+  ret += "/case/";
+  ret += file_name;
+  return ret;
+}
+
+atframework::atapp::app *get_shared_app(const char *conf_file_name) {
+  auto &apps = get_shared_apps();
+  auto iter = apps.find(conf_file_name);
+  if (iter != apps.end()) {
+    return iter->second.get();
+  }
+
+  if (apps.empty()) {
+    register_cleanup([]() { get_shared_apps().clear(); });
+  }
+
+  std::unique_ptr<atframework::atapp::app> &app = apps[conf_file_name];
+  std::string conf_path = get_test_case_path(conf_file_name);
+  if (!atfw::util::file_system::is_exist(conf_path.c_str())) {
+    std::cerr << conf_path << " not found" << std::endl;
+    return nullptr;
+  }
+
+  app.reset(new atframework::atapp::app());
+  const char *args[] = {"libatapp_benchmark", "-c", conf_path.c_str(), "start"};
+  if (0 != app->init(nullptr, 4, args, nullptr)) {
+    std::cerr << "Init app with " << conf_path << " failed" << std::endl;
+    app.reset();
+    return nullptr;
+  }
+
+  for (int i = 0; i < 32; ++i) {
+    app->run_noblock();
+  }
+
+  return app.get();
+}
+
+bool run_app_until(atframework::atapp::app &app, const std::function<bool()> &cond,
+                   std::chrono::system_clock::duration timeout) {
+  auto end_time = atfw::util::time::time_utility::sys_now() + timeout;
+  while (!cond()) {
+    if (atfw::util::time::time_utility::sys_now() >= end_time) {
+      return false;
+    }
+    app.run_noblock();
+    atfw::util::time::time_utility::update();
+  }
+
+  return true;
+}
+
+}  // namespace atapp_benchmark
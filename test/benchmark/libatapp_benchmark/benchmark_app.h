@@ -0,0 +1,33 @@
+// Copyright 2026 atframework
+// Shared app instances of libatapp_benchmark
+
+#pragma once
+
+#include <atframe/atapp.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace atapp_benchmark {
+
+/**
+ * @brief Get path of configure file in test/case
+ */
+std::string get_test_case_path(const char *file_name);
+
+/**
+ * @brief Get or create the app started by configure file in test/case
+ * @note Apps are shared by all benchmarks and destroyed after all benchmarks finished
+ * @return app, or nullptr if configure file is not found or init failed
+ */
+atframework::atapp::app *get_shared_app(const char *conf_file_name);
+
+/**
+ * @brief Run app until condition is true
+ * @return false if timeout
+ */
+bool run_app_until(atframework::atapp::app &app, const std::function<bool()> &cond,
+                   std::chrono::system_clock::duration timeout = std::chrono::seconds(8));
+
+}  // namespace atapp_benchmark
@@ -0,0 +1,96 @@
+// Copyright 2026 atframework
+// Benchmarks of configure loaders and environment expressions
+
+#include <atframe/atapp_conf.h>
+
+#include <common/file_system.h>
+#include <config/ini_loader.h>
+
+#include <cstdlib>
+#include <string>
+
+#include "benchmark_app.h"
+#include "benchmark_frame.h"
+
+#if defined(_WIN32)
+inline int setenv(const char *name, const char *value, int) { return _putenv_s(name, value); }
+#endif
+
+namespace {
+
+static void yaml_loader_dump_to_configure(atapp_benchmark::state &state) {
+  std::string conf_path = atapp_benchmark::get_test_case_path("atapp_configure_loader_test.yaml");
+  if (!atfw::util::file_system::is_exist(conf_path.c_str())) {
+    state.skip_with_error(conf_path + " not found");
+    return;
+  }
+
+  YAML::Node root = YAML::LoadFile(conf_path);
+  const YAML::Node atapp_node = atapp::yaml_loader_get_child_by_path(root, "atapp");
+  if (!atapp_node) {
+    state.skip_with_error("atapp not found in " + conf_path);
+    return;
+  }
+
+  atapp::protocol::atapp_configure output;
+  atapp::configure_key_set existed_keys;
+  while (state.keep_running()) {
+    output.Clear();
+    existed_keys.clear();
+    atapp::yaml_loader_dump_to(atapp_node, output, &existed_keys);
+  }
+  atapp_benchmark::do_not_optimize(output);
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(yaml_loader_dump_to_configure);
+
+static void ini_loader_dump_to_configure(atapp_benchmark::state &state) {
+  std::string conf_path = atapp_benchmark::get_test_case_path("atapp_configure_loader_test.conf");
+  atfw::util::config::ini_loader loader;
+  if (loader.load_file(conf_path.c_str(), false) < 0) {
+    state.skip_with_error("load " + conf_path + " failed");
+    return;
+  }
+
+  atfw::util::config::ini_value::ptr_t atapp_node = loader.get_root_node().get_child_by_path("atapp");
+  if (!atapp_node) {
+    state.skip_with_error("atapp not found in " + conf_path);
+    return;
+  }
+
+  atapp::protocol::atapp_configure output;
+  atapp::configure_key_set existed_keys;
+  while (state.keep_running()) {
+    output.Clear();
+    existed_keys.clear();
+    atapp::ini_loader_dump_to(*atapp_node, output, &existed_keys);
+  }
+  atapp_benchmark::do_not_optimize(output);
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(ini_loader_dump_to_configure);
+
+static void expand_environment_expression(atapp_benchmark::state &state) {
+  setenv("ATAPP_BENCHMARK_EXPR_NAME", "benchmark-node", 1);
+  setenv("ATAPP_BENCHMARK_EXPR_SUFFIX", "NAME", 1);
+
+  const char *inputs[] = {
+      "ipv4://127.0.0.1:21437/plain/text/without/expression",
+      "$ATAPP_BENCHMARK_EXPR_NAME",
+      "prefix_${ATAPP_BENCHMARK_EXPR_NAME}_${ATAPP_BENCHMARK_EXPR_MISSING:-default}_suffix",
+      "${ATAPP_BENCHMARK_EXPR_${ATAPP_BENCHMARK_EXPR_SUFFIX}:-${ATAPP_BENCHMARK_EXPR_MISSING:-fallback}}",
+  };
+  const char *labels[] = {"plain", "simple", "default", "nested"};
+  size_t index = static_cast<size_t>(state.range(0)) % (sizeof(inputs) / sizeof(inputs[0]));
+  gsl::string_view input = inputs[index];
+  state.set_label(labels[index]);
+
+  while (state.keep_running()) {
+    atapp_benchmark::do_not_optimize(atapp::expand_environment_expression(input));
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+  state.set_bytes_processed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+LIBATAPP_BENCHMARK(expand_environment_expression)->arg(0)->arg(1)->arg(2)->arg(3);
+
+}  // namespace
@@ -0,0 +1,152 @@
+// Copyright 2026 atframework
+// Memory benchmarks of etcd_discovery_set with a lot of nodes sharing metadata and gateways
+//
+// RSS of a process is not released after a case, run these cases separately by --benchmark_filter to compare
+// discovery_memory_load_shared with the discovery_memory_load_copy baseline.
+
+#include <atframe/etcdcli/etcd_discovery.h>
+
+#include <string/string_format.h>
+
+#include <uv.h>
+
+#include <string>
+#include <vector>
+
+#include "benchmark_frame.h"
+
+namespace {
+
+static constexpr const size_t kDiscoveryMemoryLabelSets = 8;
+
+static size_t get_rss() {
+  size_t ret = 0;
+  if (0 != uv_resident_set_memory(&ret)) {
+    return 0;
+  }
+  return ret;
+}
+
+static void make_discovery(size_t index, size_t gateway_count, atapp::protocol::atapp_discovery &output) {
+  size_t label_set = index % kDiscoveryMemoryLabelSets;
+
+  output.set_id(static_cast<uint64_t>(index + 1));
+  output.set_name(atfw::util::string::format("benchmark-node-{}", index));
+  output.set_hostname(atfw::util::string::format("benchmark-host-{}.cluster.local", index % 64));
+  output.set_pid(static_cast<int32_t>(10000 + index));
+  output.set_type_id(static_cast<uint64_t>(label_set + 1));
+  output.set_type_name(atfw::util::string::format("benchmark-type-{}", label_set));
+  output.set_version("1.0.0-benchmark");
+  output.mutable_area()->set_region("benchmark-region");
+  output.mutable_area()->set_district("benchmark-district");
+  output.mutable_area()->set_zone_id(static_cast<uint64_t>(label_set));
+  output.mutable_runtime()->set_stateful_pod_index(static_cast<int32_t>(index));
+  output.add_listen(atfw::util::string::format("ipv4://10.0.{}.{}:{}", (index / 250) % 250, index % 250, 16000));
+
+  for (size_t i = 0; i < gateway_count; ++i) {
+    atapp::protocol::atapp_gateway *gateway = output.add_gateways();
+    // Gateways are shared by all nodes of the same label set, only the listen address is unique
+    gateway->set_address(atfw::util::string::format("ipv4://gateway-{}.cluster.local:{}", i, 17000 + label_set));
+    gateway->add_match_hosts(atfw::util::string::format("benchmark-host-{}.cluster.local", i));
+    gateway->add_match_namespaces("benchmark-namespace");
+    (*gateway->mutable_match_labels())["deployment.environment"] = "production";
+  }
+
+  atapp::protocol::atapp_metadata *metadata = output.mutable_metadata();
+  metadata->set_api_version("v1");
+  metadata->set_kind("benchmark");
+  metadata->set_namespace_name("benchmark-namespace");
+  metadata->set_service_subset(atfw::util::string::format("subset-{}", label_set));
+  (*metadata->mutable_labels())["deployment.environment"] = "production";
+  (*metadata->mutable_labels())["app.kubernetes.io/name"] = "libatapp-benchmark";
+  (*metadata->mutable_labels())["app.kubernetes.io/component"] =
+      atfw::util::string::format("component-{}", label_set);
+}
+
+static void set_rss_label(atapp_benchmark::state &state, size_t rss_before, size_t rss_after, size_t node_count,
+                          const std::string &extra) {
+  size_t rss_used = rss_after > rss_before ? rss_after - rss_before : 0;
+  std::string label = atfw::util::string::format("rss/node: {} bytes", rss_used / (node_count > 0 ? node_count : 1));
+  if (!extra.empty()) {
+    label += ", ";
+    label += extra;
+  }
+  state.set_label(label);
+}
+
+// Nodes are loaded by etcd_discovery_node::copy_from(), metadata and gateways are interned
+static void discovery_memory_load_shared(atapp_benchmark::state &state) {
+  size_t node_count = static_cast<size_t>(state.range(0));
+  size_t gateway_count = static_cast<size_t>(state.range(1));
+
+  atapp::etcd_discovery_node::node_version version;
+  version.create_revision = 1;
+  version.modify_revision = 1;
+  version.version = 1;
+
+  size_t rss_before = get_rss();
+  atapp::etcd_discovery_set::ptr_t discovery_set;
+  while (state.keep_running()) {
+    discovery_set = atfw::util::memory::make_strong_rc<atapp::etcd_discovery_set>();
+    atapp::protocol::atapp_discovery discovery;
+    for (size_t i = 0; i < node_count; ++i) {
+      discovery.Clear();
+      make_discovery(i, gateway_count, discovery);
+
+      atapp::etcd_discovery_node::ptr_t node = atfw::util::memory::make_strong_rc<atapp::etcd_discovery_node>();
+      node->copy_from(discovery, version, 0);
+      discovery_set->add_node(node);
+    }
+  }
+  size_t rss_after = get_rss();
+
+  // Gateways of nodes in the same label set must be the same interned block
+  size_t shared_gateway_nodes = 0;
+  if (gateway_count > 0) {
+    const atapp::protocol::atapp_gateway *first_gateway = nullptr;
+    for (auto &node : discovery_set->get_sorted_nodes()) {
+      if (node->get_hot_data().type_id != 1) {
+        continue;
+      }
+      node->reset_ingress_index();
+      const atapp::protocol::atapp_gateway &gateway = node->next_ingress_gateway();
+      if (nullptr == first_gateway) {
+        first_gateway = &gateway;
+      }
+      if (first_gateway == &gateway) {
+        ++shared_gateway_nodes;
+      }
+    }
+  }
+
+  set_rss_label(state, rss_before, rss_after, node_count,
+                atfw::util::string::format("shared blocks: {}, nodes sharing a gateway: {}",
+                                           atapp::etcd_discovery_node::get_shared_block_count(),
+                                           shared_gateway_nodes));
+  state.set_items_processed(static_cast<int64_t>(state.iterations() * node_count));
+  discovery_set.reset();
+}
+LIBATAPP_BENCHMARK(discovery_memory_load_shared)->args({10000, 2})->iterations(1);
+
+// Baseline: every node keeps a full copy of metadata and gateways
+static void discovery_memory_load_copy(atapp_benchmark::state &state) {
+  size_t node_count = static_cast<size_t>(state.range(0));
+  size_t gateway_count = static_cast<size_t>(state.range(1));
+
+  size_t rss_before = get_rss();
+  std::vector<atapp::protocol::atapp_discovery> copies;
+  while (state.keep_running()) {
+    copies.clear();
+    copies.resize(node_count);
+    for (size_t i = 0; i < node_count; ++i) {
+      make_discovery(i, gateway_count, copies[i]);
+    }
+  }
+  size_t rss_after = get_rss();
+
+  set_rss_label(state, rss_before, rss_after, node_count, std::string());
+  state.set_items_processed(static_cast<int64_t>(state.iterations() * node_count));
+}
+LIBATAPP_BENCHMARK(discovery_memory_load_copy)->args({10000, 2})->iterations(1);
+
+}  // namespace
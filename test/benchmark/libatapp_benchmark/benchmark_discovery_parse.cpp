@@ -0,0 +1,189 @@
+// Copyright 2026 atframework
+// Parse benchmarks of discovery records, compare heap allocations of protobuf JSON, rapidjson_loader and arena
+
+#include <atframe/atapp_conf.h>
+#include <atframe/atapp_conf_rapidjson.h>
+
+#include <config/compiler/protobuf_prefix.h>
+
+#include <google/protobuf/util/json_util.h>
+
+#include <config/compiler/protobuf_suffix.h>
+
+#include <string/string_format.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "benchmark_frame.h"
+
+namespace {
+static std::atomic<uint64_t> g_benchmark_allocation_count{0};
+}  // namespace
+
+// Count all heap allocations of libatapp_benchmark, the cost is the same for all cases
+void *operator new(std::size_t size) {
+  g_benchmark_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void *ret = malloc(size > 0 ? size : 1);
+  if (nullptr == ret) {
+    throw std::bad_alloc();
+  }
+  return ret;
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { free(ptr); }
+
+namespace {
+
+static constexpr const size_t kDiscoveryParseRecordCount = 1024;
+
+struct discovery_parse_records_t {
+  // protobuf JSON use json_name and rapidjson_loader use field name, so prepare both of them
+  std::vector<std::string> protobuf_json;
+  std::vector<std::string> rapidjson;
+};
+
+static void make_discovery(size_t index, atapp::protocol::atapp_discovery &output) {
+  size_t label_set = index % 8;
+
+  output.set_id(static_cast<uint64_t>(index + 1));
+  output.set_name(atfw::util::string::format("benchmark-node-{}", index));
+  output.set_hostname(atfw::util::string::format("benchmark-host-{}.cluster.local", index % 64));
+  output.set_pid(static_cast<int32_t>(10000 + index));
+  output.set_identity(atfw::util::string::format("benchmark-identity-{}", index));
+  output.set_type_id(static_cast<uint64_t>(label_set + 1));
+  output.set_type_name(atfw::util::string::format("benchmark-type-{}", label_set));
+  output.set_version("1.0.0-benchmark");
+  output.mutable_area()->set_region("benchmark-region");
+  output.mutable_area()->set_district("benchmark-district");
+  output.mutable_area()->set_zone_id(static_cast<uint64_t>(label_set));
+  output.mutable_runtime()->set_stateful_pod_index(static_cast<int32_t>(index));
+  output.add_listen(atfw::util::string::format("ipv4://10.0.{}.{}:{}", (index / 250) % 250, index % 250, 16000));
+  output.add_listen(atfw::util::string::format("ipv6://fd00::{}:{}", index % 65536, 16001));
+
+  atapp::protocol::atapp_gateway *gateway = output.add_gateways();
+  gateway->set_address(atfw::util::string::format("ipv4://gateway.cluster.local:{}", 17000 + label_set));
+  gateway->add_match_namespaces("benchmark-namespace");
+  (*gateway->mutable_match_labels())["deployment.environment"] = "production";
+
+  atapp::protocol::atapp_metadata *metadata = output.mutable_metadata();
+  metadata->set_api_version("v1");
+  metadata->set_kind("benchmark");
+  metadata->set_namespace_name("benchmark-namespace");
+  metadata->set_service_subset(atfw::util::string::format("subset-{}", label_set));
+  (*metadata->mutable_labels())["deployment.environment"] = "production";
+  (*metadata->mutable_labels())["app.kubernetes.io/component"] =
+      atfw::util::string::format("component-{}", label_set);
+}
+
+static const discovery_parse_records_t &get_records() {
+  static discovery_parse_records_t ret;
+  if (!ret.rapidjson.empty()) {
+    return ret;
+  }
+
+  ret.protobuf_json.reserve(kDiscoveryParseRecordCount);
+  ret.rapidjson.reserve(kDiscoveryParseRecordCount);
+
+  atapp::protocol::atapp_discovery discovery;
+  ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::util::JsonPrintOptions print_options;
+  print_options.add_whitespace = false;
+  print_options.always_print_enums_as_ints = true;
+  for (size_t i = 0; i < kDiscoveryParseRecordCount; ++i) {
+    discovery.Clear();
+    make_discovery(i, discovery);
+
+    ret.protobuf_json.push_back(std::string());
+    (void)ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::util::MessageToJsonString(discovery, &ret.protobuf_json.back(),
+                                                                       print_options);
+    ret.rapidjson.push_back(atapp::rapidjson_loader_stringify(discovery));
+  }
+  return ret;
+}
+
+// Run parse function once for each iteration, then report allocations of each record
+template <class TFN>
+static void run_parse_benchmark(atapp_benchmark::state &state, const std::vector<std::string> &records, TFN &&fn) {
+  // Warm up thread local buffers and arena
+  fn(records[0]);
+
+  size_t index = 0;
+  size_t bytes = 0;
+  uint64_t allocation_begin = g_benchmark_allocation_count.load(std::memory_order_relaxed);
+  while (state.keep_running()) {
+    const std::string &record = records[index];
+    if (++index >= records.size()) {
+      index = 0;
+    }
+
+    if (!fn(record)) {
+      state.skip_with_error("parse discovery record failed");
+      break;
+    }
+    bytes += record.size();
+  }
+  uint64_t allocations = g_benchmark_allocation_count.load(std::memory_order_relaxed) - allocation_begin;
+
+  if (state.iterations() > 0) {
+    state.set_label(atfw::util::string::format(
+        "allocations/record: {:.2f}", static_cast<double>(allocations) / static_cast<double>(state.iterations())));
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+  state.set_bytes_processed(static_cast<int64_t>(bytes));
+}
+
+static void discovery_parse_protobuf_json_new_message(atapp_benchmark::state &state) {
+  ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::util::JsonParseOptions parse_options;
+  parse_options.ignore_unknown_fields = true;
+
+  run_parse_benchmark(state, get_records().protobuf_json, [&parse_options](const std::string &record) {
+    atapp::protocol::atapp_discovery node;
+    return ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::util::JsonStringToMessage(record, &node, parse_options).ok();
+  });
+}
+LIBATAPP_BENCHMARK(discovery_parse_protobuf_json_new_message);
+
+static void discovery_parse_protobuf_json_reused_message(atapp_benchmark::state &state) {
+  ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::util::JsonParseOptions parse_options;
+  parse_options.ignore_unknown_fields = true;
+
+  atapp::protocol::atapp_discovery node;
+  run_parse_benchmark(state, get_records().protobuf_json, [&node, &parse_options](const std::string &record) {
+    node.Clear();
+    return ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::util::JsonStringToMessage(record, &node, parse_options).ok();
+  });
+}
+LIBATAPP_BENCHMARK(discovery_parse_protobuf_json_reused_message);
+
+static void discovery_parse_rapidjson_loader_new_message(atapp_benchmark::state &state) {
+  run_parse_benchmark(state, get_records().rapidjson, [](const std::string &record) {
+    atapp::protocol::atapp_discovery node;
+    return atapp::rapidjson_loader_parse(node, record);
+  });
+}
+LIBATAPP_BENCHMARK(discovery_parse_rapidjson_loader_new_message);
+
+static void discovery_parse_rapidjson_loader_reused_message(atapp_benchmark::state &state) {
+  atapp::protocol::atapp_discovery node;
+  run_parse_benchmark(state, get_records().rapidjson, [&node](const std::string &record) {
+    node.Clear();
+    return atapp::rapidjson_loader_parse(node, record);
+  });
+}
+LIBATAPP_BENCHMARK(discovery_parse_rapidjson_loader_reused_message);
+
+static void discovery_parse_rapidjson_loader_arena(atapp_benchmark::state &state) {
+  run_parse_benchmark(state, get_records().rapidjson, [](const std::string &record) {
+    atapp::rapidjson_loader_arena_scope arena_scope;
+    return nullptr != atapp::rapidjson_loader_parse_on_arena<atapp::protocol::atapp_discovery>(
+                          arena_scope.get_arena(), record);
+  });
+}
+LIBATAPP_BENCHMARK(discovery_parse_rapidjson_loader_arena);
+
+}  // namespace
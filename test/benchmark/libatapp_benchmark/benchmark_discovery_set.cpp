@@ -0,0 +1,175 @@
+// Copyright 2026 atframework
+// Benchmarks of etcd_discovery_set lookups and index rebuilds
+
+#include <atframe/etcdcli/etcd_discovery.h>
+
+#include <string/string_format.h>
+
+#include <string>
+#include <vector>
+
+#include "benchmark_frame.h"
+
+namespace {
+
+static constexpr const size_t kDiscoverySetLabelSets = 8;
+
+struct discovery_set_fixture_t {
+  atapp::etcd_discovery_set::ptr_t discovery_set;
+  std::vector<atapp::etcd_discovery_node::ptr_t> nodes;
+  std::vector<std::string> names;
+  atapp::etcd_discovery_set::metadata_type metadata;
+};
+
+static void make_discovery(size_t index, atapp::protocol::atapp_discovery &output) {
+  size_t label_set = index % kDiscoverySetLabelSets;
+
+  output.set_id(static_cast<uint64_t>(index + 1));
+  output.set_name(atfw::util::string::format("benchmark-node-{}", index));
+  output.set_hostname(atfw::util::string::format("benchmark-host-{}.cluster.local", index % 64));
+  output.set_pid(static_cast<int32_t>(10000 + index));
+  output.set_identity(atfw::util::string::format("benchmark-identity-{}", index));
+  output.set_type_id(static_cast<uint64_t>(label_set + 1));
+  output.set_type_name(atfw::util::string::format("benchmark-type-{}", label_set));
+  output.add_listen(atfw::util::string::format("ipv4://10.0.{}.{}:{}", (index / 250) % 250, index % 250, 16000));
+
+  atapp::protocol::atapp_metadata *metadata = output.mutable_metadata();
+  metadata->set_namespace_name("benchmark-namespace");
+  (*metadata->mutable_labels())["deployment.environment"] = "production";
+  (*metadata->mutable_labels())["app.kubernetes.io/component"] =
+      atfw::util::string::format("component-{}", label_set);
+}
+
+static void setup_discovery_set(size_t node_count, discovery_set_fixture_t &fixture) {
+  atapp::etcd_discovery_node::node_version version;
+  version.create_revision = 1;
+  version.modify_revision = 1;
+  version.version = 1;
+
+  fixture.discovery_set = atfw::util::memory::make_strong_rc<atapp::etcd_discovery_set>();
+  fixture.nodes.reserve(node_count);
+  fixture.names.reserve(node_count);
+
+  atapp::protocol::atapp_discovery discovery;
+  for (size_t i = 0; i < node_count; ++i) {
+    discovery.Clear();
+    make_discovery(i, discovery);
+
+    atapp::etcd_discovery_node::ptr_t node = atfw::util::memory::make_strong_rc<atapp::etcd_discovery_node>();
+    node->copy_from(discovery, version, 0);
+    fixture.discovery_set->add_node(node);
+    fixture.nodes.push_back(node);
+    fixture.names.push_back(discovery.name());
+  }
+
+  fixture.metadata.set_namespace_name("benchmark-namespace");
+  (*fixture.metadata.mutable_labels())["app.kubernetes.io/component"] = "component-0";
+
+  // Build all indexes before timing
+  fixture.discovery_set->get_sorted_nodes();
+  fixture.discovery_set->get_sorted_nodes(&fixture.metadata);
+  fixture.discovery_set->get_node_by_consistent_hash(static_cast<uint64_t>(0));
+  fixture.discovery_set->get_node_by_consistent_hash(static_cast<uint64_t>(0), &fixture.metadata);
+}
+
+static void etcd_discovery_set_get_node_by_id(atapp_benchmark::state &state) {
+  discovery_set_fixture_t fixture;
+  setup_discovery_set(static_cast<size_t>(state.range(0)), fixture);
+
+  uint64_t index = 0;
+  size_t node_count = fixture.nodes.size();
+  while (state.keep_running()) {
+    atapp_benchmark::do_not_optimize(fixture.discovery_set->get_node_by_id(index % node_count + 1));
+    ++index;
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(etcd_discovery_set_get_node_by_id)->arg(64)->arg(1024)->arg(8192);
+
+static void etcd_discovery_set_get_node_by_name(atapp_benchmark::state &state) {
+  discovery_set_fixture_t fixture;
+  setup_discovery_set(static_cast<size_t>(state.range(0)), fixture);
+
+  size_t index = 0;
+  size_t node_count = fixture.nodes.size();
+  while (state.keep_running()) {
+    atapp_benchmark::do_not_optimize(fixture.discovery_set->get_node_by_name(fixture.names[index % node_count]));
+    ++index;
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(etcd_discovery_set_get_node_by_name)->arg(64)->arg(1024)->arg(8192);
+
+static void etcd_discovery_set_get_node_by_consistent_hash(atapp_benchmark::state &state) {
+  discovery_set_fixture_t fixture;
+  setup_discovery_set(static_cast<size_t>(state.range(0)), fixture);
+
+  uint64_t key = 0;
+  while (state.keep_running()) {
+    atapp_benchmark::do_not_optimize(fixture.discovery_set->get_node_by_consistent_hash(key++));
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(etcd_discovery_set_get_node_by_consistent_hash)->arg(64)->arg(1024)->arg(8192);
+
+static void etcd_discovery_set_get_node_by_consistent_hash_metadata(atapp_benchmark::state &state) {
+  discovery_set_fixture_t fixture;
+  setup_discovery_set(static_cast<size_t>(state.range(0)), fixture);
+
+  uint64_t key = 0;
+  while (state.keep_running()) {
+    atapp_benchmark::do_not_optimize(fixture.discovery_set->get_node_by_consistent_hash(key++, &fixture.metadata));
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(etcd_discovery_set_get_node_by_consistent_hash_metadata)->arg(64)->arg(1024)->arg(8192);
+
+static void etcd_discovery_set_get_node_by_round_robin(atapp_benchmark::state &state) {
+  discovery_set_fixture_t fixture;
+  setup_discovery_set(static_cast<size_t>(state.range(0)), fixture);
+
+  while (state.keep_running()) {
+    atapp_benchmark::do_not_optimize(fixture.discovery_set->get_node_by_round_robin());
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(etcd_discovery_set_get_node_by_round_robin)->arg(64)->arg(1024)->arg(8192);
+
+// Replace one node and lookup again, which rebuild the sorted list and hash ring of all nodes
+static void etcd_discovery_set_rebuild(atapp_benchmark::state &state) {
+  discovery_set_fixture_t fixture;
+  setup_discovery_set(static_cast<size_t>(state.range(0)), fixture);
+
+  size_t index = 0;
+  size_t node_count = fixture.nodes.size();
+  while (state.keep_running()) {
+    const atapp::etcd_discovery_node::ptr_t &node = fixture.nodes[index % node_count];
+    fixture.discovery_set->remove_node(node);
+    fixture.discovery_set->add_node(node);
+    atapp_benchmark::do_not_optimize(fixture.discovery_set->get_node_by_consistent_hash(static_cast<uint64_t>(index)));
+    ++index;
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(etcd_discovery_set_rebuild)->arg(64)->arg(1024)->arg(8192);
+
+static void etcd_discovery_set_rebuild_metadata(atapp_benchmark::state &state) {
+  discovery_set_fixture_t fixture;
+  setup_discovery_set(static_cast<size_t>(state.range(0)), fixture);
+
+  size_t index = 0;
+  size_t node_count = fixture.nodes.size();
+  while (state.keep_running()) {
+    // Only replace nodes matching the metadata filter, so index of the filter is always rebuilt
+    const atapp::etcd_discovery_node::ptr_t &node = fixture.nodes[(index * kDiscoverySetLabelSets) % node_count];
+    fixture.discovery_set->remove_node(node);
+    fixture.discovery_set->add_node(node);
+    atapp_benchmark::do_not_optimize(
+        fixture.discovery_set->get_node_by_consistent_hash(static_cast<uint64_t>(index), &fixture.metadata));
+    ++index;
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(etcd_discovery_set_rebuild_metadata)->arg(64)->arg(1024)->arg(8192);
+
+}  // namespace
@@ -0,0 +1,168 @@
+// Copyright 2026 atframework
+// Benchmarks of atapp_endpoint::push_forward_message and loopback connector
+
+#include <atframe/atapp.h>
+#include <atframe/connectors/atapp_endpoint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark_app.h"
+#include "benchmark_frame.h"
+
+namespace {
+
+static constexpr const int32_t kEndpointBenchmarkMessageType = 321;
+// Pending messages are only released with endpoint, so recreate endpoint after each batch
+static constexpr const uint64_t kEndpointBenchmarkPendingBatch = 4096;
+// Messages in loopback connector are limited by send_buffer_size(1MB) of atapp_test_0.yaml
+static constexpr const uint64_t kEndpointBenchmarkLoopbackBatch = 256;
+
+static gsl::span<const unsigned char> make_payload(std::vector<unsigned char> &buffer, int64_t size) {
+  buffer.resize(static_cast<size_t>(size > 0 ? size : 1));
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<unsigned char>('a' + i % 26);
+  }
+
+  return gsl::span<const unsigned char>{buffer.data(), buffer.size()};
+}
+
+static void set_forward_request_counter(atframework::atapp::app &app, uint64_t &counter) {
+  app.set_evt_on_forward_request(
+      [&counter](atframework::atapp::app &, const atframework::atapp::app::message_sender_t &,
+                 const atframework::atapp::app::message_t &) {
+        ++counter;
+        return 0;
+      });
+}
+
+// No ready handle, messages are appended into pending list of endpoint
+static void atapp_endpoint_push_forward_message_pending(atapp_benchmark::state &state) {
+  atframework::atapp::app app;
+  std::vector<unsigned char> buffer;
+  gsl::span<const unsigned char> payload = make_payload(buffer, state.range(0));
+
+  atapp::atapp_endpoint::ptr_t endpoint = atapp::atapp_endpoint::create(app);
+  uint64_t sequence = 0;
+  while (state.keep_running()) {
+    if (endpoint->get_pending_message_count() >= kEndpointBenchmarkPendingBatch) {
+      state.pause_timing();
+      endpoint.reset();
+      endpoint = atapp::atapp_endpoint::create(app);
+      state.resume_timing();
+    }
+
+    ++sequence;
+    if (0 != endpoint->push_forward_message(kEndpointBenchmarkMessageType, sequence, payload, nullptr)) {
+      state.skip_with_error("push_forward_message failed");
+      break;
+    }
+  }
+
+  state.pause_timing();
+  endpoint.reset();
+
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+  state.set_bytes_processed(static_cast<int64_t>(state.iterations() * payload.size()));
+}
+LIBATAPP_BENCHMARK(atapp_endpoint_push_forward_message_pending)->arg(64)->arg(1024);
+
+// Ready loopback handle, messages are sent by connector directly, dispatching is not timed
+static void atapp_endpoint_push_forward_message_ready(atapp_benchmark::state &state) {
+  atframework::atapp::app *app = atapp_benchmark::get_shared_app("atapp_test_0.yaml");
+  if (nullptr == app) {
+    state.skip_with_error("atapp_test_0.yaml is not available");
+    return;
+  }
+
+  uint64_t received = 0;
+  set_forward_request_counter(*app, received);
+
+  auto self_discovery = atfw::util::memory::make_strong_rc<atapp::etcd_discovery_node>();
+  {
+    atapp::protocol::atapp_discovery self_discovery_info;
+    app->pack(self_discovery_info);
+    self_discovery->copy_from(self_discovery_info, atapp::etcd_discovery_node::node_version(), 0);
+  }
+  atapp::atapp_endpoint::ptr_t endpoint = app->mutable_endpoint(self_discovery);
+  if (!endpoint || nullptr == endpoint->get_ready_connection_handle()) {
+    app->set_evt_on_forward_request(nullptr);
+    state.skip_with_error("loopback handle is not ready");
+    return;
+  }
+
+  std::vector<unsigned char> buffer;
+  gsl::span<const unsigned char> payload = make_payload(buffer, state.range(0));
+  uint64_t sequence = 0;
+  uint64_t sent = 0;
+  while (state.keep_running()) {
+    if (sent - received >= kEndpointBenchmarkLoopbackBatch) {
+      state.pause_timing();
+      if (!atapp_benchmark::run_app_until(*app, [&received, &sent]() { return received >= sent; })) {
+        state.skip_with_error("wait for loopback messages timeout");
+        break;
+      }
+      state.resume_timing();
+    }
+
+    ++sequence;
+    if (0 != endpoint->push_forward_message(kEndpointBenchmarkMessageType, sequence, payload, nullptr)) {
+      state.skip_with_error("push_forward_message failed");
+      break;
+    }
+    ++sent;
+  }
+
+  state.pause_timing();
+  atapp_benchmark::run_app_until(*app, [&received, &sent]() { return received >= sent; });
+  app->set_evt_on_forward_request(nullptr);
+
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+  state.set_bytes_processed(static_cast<int64_t>(state.iterations() * payload.size()));
+}
+LIBATAPP_BENCHMARK(atapp_endpoint_push_forward_message_ready)->arg(64)->arg(1024);
+
+// Full round-trip of app::send_message to self, including dispatching by loopback connector
+static void atapp_loopback_round_trip(atapp_benchmark::state &state) {
+  atframework::atapp::app *app = atapp_benchmark::get_shared_app("atapp_test_0.yaml");
+  if (nullptr == app) {
+    state.skip_with_error("atapp_test_0.yaml is not available");
+    return;
+  }
+
+  uint64_t received = 0;
+  set_forward_request_counter(*app, received);
+
+  std::vector<unsigned char> buffer;
+  gsl::span<const unsigned char> payload = make_payload(buffer, state.range(0));
+  uint64_t batch = static_cast<uint64_t>(state.range(1) > 0 ? state.range(1) : 1);
+  uint64_t sequence = 0;
+  uint64_t sent = 0;
+  while (state.keep_running()) {
+    ++sequence;
+    if (0 != app->send_message(app->get_app_id(), kEndpointBenchmarkMessageType, payload, &sequence)) {
+      state.skip_with_error("send_message failed");
+      break;
+    }
+    ++sent;
+
+    // Messages of the last batch are also waited in timing
+    bool last_iteration = state.iterations() >= state.max_iterations();
+    if ((last_iteration || sent - received >= batch) &&
+        !atapp_benchmark::run_app_until(*app, [&received, &sent]() { return received >= sent; })) {
+      state.skip_with_error("wait for loopback messages timeout");
+      break;
+    }
+  }
+
+  state.pause_timing();
+  atapp_benchmark::run_app_until(*app, [&received, &sent]() { return received >= sent; });
+  app->set_evt_on_forward_request(nullptr);
+
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+  state.set_bytes_processed(static_cast<int64_t>(state.iterations() * payload.size()));
+}
+LIBATAPP_BENCHMARK(atapp_loopback_round_trip)->args({64, 1})->args({64, 64})->args({1024, 64});
+
+}  // namespace
@@ -0,0 +1,280 @@
+// Copyright 2026 atframework
+// Discovery propagation benchmark of etcd_cluster/etcd_keepalive/etcd_watcher against the in-process fake etcd gateway
+//
+// One iteration is one churn round of all nodes, the args are {nodes, members of gateway, response delay(ms)}
+
+#include <atframe/etcdcli/etcd_cluster.h>
+#include <atframe/etcdcli/etcd_keepalive.h>
+#include <atframe/etcdcli/etcd_watcher.h>
+
+#include <network/http_request.h>
+#include <string/string_format.h>
+#include <time/time_utility.h>
+
+#include <uv.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "atapp_etcd_fake_gateway.h"
+#include "benchmark_frame.h"
+
+namespace {
+
+static constexpr const uint64_t kEtcdDiscoveryBenchmarkRounds = 20;
+
+struct etcd_discovery_node_t {
+  std::unique_ptr<atapp::etcd_cluster> cluster;
+  atapp::etcd_keepalive::ptr_t keepalive;
+  std::string path;
+  size_t version = 0;
+};
+
+struct etcd_discovery_context_t {
+  std::vector<etcd_discovery_node_t> nodes;
+  std::unique_ptr<atapp::etcd_cluster> observer;
+  atapp::etcd_watcher::ptr_t watcher;
+  bool observer_ready = false;
+
+  // path -> expected value and the time when it was changed
+  std::unordered_map<std::string, std::pair<std::string, std::chrono::steady_clock::time_point>> pending;
+  std::vector<int64_t> propagation_us;
+  size_t observed_events = 0;
+};
+
+static void tick_all(etcd_discovery_context_t &ctx) {
+  atfw::util::time::time_utility::update();
+  for (auto &node : ctx.nodes) {
+    node.cluster->tick();
+  }
+  if (ctx.observer) {
+    ctx.observer->tick();
+  }
+}
+
+template <typename CondFn>
+static bool run_until(etcd_discovery_context_t &ctx, CondFn &&cond, std::chrono::seconds timeout) {
+  auto end_time = std::chrono::steady_clock::now() + timeout;
+  while (!cond() && std::chrono::steady_clock::now() < end_time) {
+    uv_run(uv_default_loop(), UV_RUN_NOWAIT);
+    tick_all(ctx);
+  }
+
+  return cond();
+}
+
+static void setup_cluster(atapp::etcd_cluster &cluster, const std::vector<std::string> &hosts,
+                          const atfw::util::network::http_request::curl_m_bind_ptr_t &curl_multi) {
+  cluster.set_conf_hosts(hosts);
+  cluster.set_conf_http_request_timeout(std::chrono::seconds(10));
+  cluster.set_conf_keepalive_retry_interval(std::chrono::milliseconds(500));
+  cluster.set_conf_keepalive_interval(std::chrono::seconds(5));
+  cluster.set_conf_keepalive_timeout(std::chrono::seconds(16));
+  cluster.set_flag(atapp::etcd_cluster::flag_t::kEnableLease, true);
+  cluster.init(curl_multi);
+}
+
+static void on_watch_event(etcd_discovery_context_t &ctx, const atapp::etcd_watcher::response_t &evt_data) {
+  if (evt_data.snapshot) {
+    ctx.observer_ready = true;
+    return;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  for (const auto &evt : evt_data.events) {
+    ++ctx.observed_events;
+    auto iter = ctx.pending.find(evt.kv.key);
+    if (iter == ctx.pending.end()) {
+      continue;
+    }
+
+    // Empty expected value means waiting for DELETE
+    bool matched = iter->second.first.empty() ? evt.evt_type == atapp::etcd_watch_event::kDelete
+                                              : evt.evt_type == atapp::etcd_watch_event::kPut &&
+                                                    evt.kv.value == iter->second.first;
+    if (!matched) {
+      continue;
+    }
+
+    ctx.propagation_us.push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - iter->second.second).count());
+    ctx.pending.erase(iter);
+  }
+}
+
+static int64_t get_percentile(const std::vector<int64_t> &sorted, double percentile) {
+  if (sorted.empty()) {
+    return 0;
+  }
+
+  size_t index = static_cast<size_t>(percentile * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static void cleanup_context(etcd_discovery_context_t &ctx, atframework::atapp::test::etcd_fake_gateway &gateway,
+                            atfw::util::network::http_request::curl_m_bind_ptr_t &curl_multi) {
+  if (ctx.observer && ctx.watcher) {
+    ctx.observer->remove_watcher(ctx.watcher);
+  }
+  ctx.watcher.reset();
+  for (auto &node : ctx.nodes) {
+    node.cluster->close(false, false);
+    node.cluster->reset();
+  }
+  if (ctx.observer) {
+    ctx.observer->close(false, false);
+    ctx.observer->reset();
+  }
+
+  gateway.close();
+  if (curl_multi) {
+    atfw::util::network::http_request::destroy_curl_multi(curl_multi);
+  }
+  for (int i = 0; i < 16; ++i) {
+    uv_run(uv_default_loop(), UV_RUN_NOWAIT);
+  }
+
+  ctx.nodes.clear();
+  ctx.observer.reset();
+}
+
+static void etcd_discovery_propagation(atapp_benchmark::state &state) {
+  size_t node_count = static_cast<size_t>(std::max<int64_t>(1, state.range(0)));
+  size_t member_count = static_cast<size_t>(std::max<int64_t>(1, state.range(1)));
+  int64_t delay_ms = std::max<int64_t>(0, state.range(2));
+
+  if (CURLE_OK != curl_global_init(CURL_GLOBAL_ALL)) {
+    state.skip_with_error("curl_global_init failed");
+    return;
+  }
+
+  etcd_discovery_context_t ctx;
+  atfw::util::network::http_request::curl_m_bind_ptr_t curl_multi;
+  atframework::atapp::test::etcd_fake_gateway gateway(uv_default_loop());
+  do {
+    bool listen_failed = false;
+    for (size_t i = 0; i < member_count; ++i) {
+      if (gateway.listen().empty()) {
+        listen_failed = true;
+        break;
+      }
+    }
+    if (listen_failed) {
+      state.skip_with_error("fake etcd gateway listen failed");
+      break;
+    }
+    gateway.set_response_delay(std::chrono::milliseconds(delay_ms));
+
+    {
+      atfw::util::network::http_request::curl_share_options share_options;
+      atfw::util::network::http_request::curl_multi_options multi_options;
+      multi_options.ev_loop = uv_default_loop();
+      atfw::util::network::http_request::create_curl_share(share_options, multi_options.share_context);
+      atfw::util::network::http_request::create_curl_multi(multi_options, curl_multi);
+    }
+    if (!curl_multi) {
+      state.skip_with_error("create curl multi failed");
+      break;
+    }
+
+    const std::string prefix = "/atapp/benchmark/discovery/";
+    const std::chrono::seconds timeout = std::chrono::seconds(30 + delay_ms / 100);
+
+    // Observer
+    ctx.observer.reset(new atapp::etcd_cluster());
+    setup_cluster(*ctx.observer, gateway.get_urls(), curl_multi);
+    ctx.watcher = atapp::etcd_watcher::create(*ctx.observer, prefix, "+1");
+    ctx.watcher->set_evt_handle(
+        [&ctx](const atapp::etcd_response_header &, const atapp::etcd_watcher::response_t &evt_data) {
+          on_watch_event(ctx, evt_data);
+        });
+    ctx.observer->add_watcher(ctx.watcher);
+
+    // Nodes
+    ctx.nodes.resize(node_count);
+    for (size_t i = 0; i < ctx.nodes.size(); ++i) {
+      etcd_discovery_node_t &node = ctx.nodes[i];
+      node.cluster.reset(new atapp::etcd_cluster());
+      node.path = prefix + "node-" + std::to_string(i);
+      setup_cluster(*node.cluster, gateway.get_urls(), curl_multi);
+    }
+
+    atfw::util::time::time_utility::update();
+    if (!run_until(
+            ctx,
+            [&ctx]() {
+              if (!ctx.observer_ready) {
+                return false;
+              }
+              for (auto &node : ctx.nodes) {
+                if (0 == node.cluster->get_lease()) {
+                  return false;
+                }
+              }
+              return true;
+            },
+            timeout)) {
+      state.skip_with_error("wait for nodes ready timeout");
+      break;
+    }
+
+    size_t timeout_rounds = 0;
+    size_t round = 0;
+    while (state.keep_running()) {
+      // Churn: odd rounds remove half of nodes, others register or update all nodes
+      for (size_t i = 0; i < ctx.nodes.size(); ++i) {
+        etcd_discovery_node_t &node = ctx.nodes[i];
+        bool remove = (round & 1) && (i & 1) && node.keepalive;
+        if (remove) {
+          node.cluster->remove_keepalive(node.keepalive);
+          node.keepalive.reset();
+          ctx.pending[node.path] = std::make_pair(std::string(), std::chrono::steady_clock::now());
+          continue;
+        }
+
+        std::string value = "round-" + std::to_string(round) + "-version-" + std::to_string(++node.version);
+        if (!node.keepalive) {
+          node.keepalive = atapp::etcd_keepalive::create(*node.cluster, node.path);
+          node.keepalive->set_value(value);
+          node.cluster->add_keepalive(node.keepalive);
+        } else {
+          node.keepalive->set_value(value);
+        }
+        ctx.pending[node.path] = std::make_pair(value, std::chrono::steady_clock::now());
+      }
+
+      if (!run_until(ctx, [&ctx]() { return ctx.pending.empty(); }, timeout)) {
+        ++timeout_rounds;
+        ctx.pending.clear();
+      }
+      ++round;
+    }
+
+    std::sort(ctx.propagation_us.begin(), ctx.propagation_us.end());
+    const atframework::atapp::test::etcd_fake_gateway::stats_t &gateway_stats = gateway.get_stats();
+    state.set_label(atfw::util::string::format(
+        "propagation p50 {}us, p99 {}us, max {}us, observed events: {}, gateway requests: {}, keepalive: {}",
+        get_percentile(ctx.propagation_us, 0.5), get_percentile(ctx.propagation_us, 0.99),
+        ctx.propagation_us.empty() ? 0 : ctx.propagation_us.back(), ctx.observed_events,
+        gateway_stats.sum_requests, gateway_stats.lease_keepalive));
+    state.set_items_processed(static_cast<int64_t>(ctx.propagation_us.size()));
+    if (timeout_rounds > 0) {
+      state.skip_with_error(atfw::util::string::format("{} rounds timeout", timeout_rounds));
+    }
+  } while (false);
+
+  cleanup_context(ctx, gateway, curl_multi);
+  curl_global_cleanup();
+}
+LIBATAPP_BENCHMARK(etcd_discovery_propagation)
+    ->args({32, 1, 0})
+    ->args({32, 3, 0})
+    ->args({32, 1, 20})
+    ->iterations(kEtcdDiscoveryBenchmarkRounds);
+
+}  // namespace
@@ -0,0 +1,148 @@
+// Copyright 2026 atframework
+// Benchmarks of etcd_packer
+
+#include <config/compiler/template_prefix.h>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <config/compiler/template_suffix.h>
+
+#include <atframe/etcdcli/etcd_packer.h>
+
+#include <string/string_format.h>
+
+#include <string>
+
+#include "benchmark_frame.h"
+
+namespace {
+
+static void make_key_value(size_t index, size_t value_size, atapp::etcd_key_value &output) {
+  output.key = atfw::util::string::format("/atapp/services/benchmark/by_id/benchmark-node-{}", index);
+  output.value.resize(value_size);
+  for (size_t i = 0; i < value_size; ++i) {
+    output.value[i] = static_cast<char>('a' + (index + i) % 26);
+  }
+  output.create_revision = static_cast<int64_t>(index + 1);
+  output.mod_revision = static_cast<int64_t>(index + 100);
+  output.version = 3;
+  output.lease = 9876543210LL;
+}
+
+// Make response of range request, which is the same as the response of etcd when watcher or module load all nodes
+static std::string make_range_response(size_t kv_count, size_t value_size) {
+  rapidjson::Document doc;
+  doc.SetObject();
+
+  atapp::etcd_response_header header;
+  header.cluster_id = 12345678ULL;
+  header.member_id = 87654321ULL;
+  header.revision = 42;
+  header.raft_term = 7;
+  rapidjson::Value header_value(rapidjson::kObjectType);
+  atapp::etcd_packer::pack(header, header_value, doc);
+  doc.AddMember("header", header_value, doc.GetAllocator());
+
+  rapidjson::Value kvs(rapidjson::kArrayType);
+  atapp::etcd_key_value kv;
+  for (size_t i = 0; i < kv_count; ++i) {
+    make_key_value(i, value_size, kv);
+    rapidjson::Value kv_value(rapidjson::kObjectType);
+    atapp::etcd_packer::pack(kv, kv_value, doc);
+    kvs.PushBack(kv_value, doc.GetAllocator());
+  }
+  doc.AddMember("kvs", kvs, doc.GetAllocator());
+
+  std::string count = atfw::util::string::format("{}", kv_count);
+  atapp::etcd_packer::pack_string(doc, "count", count.c_str(), doc);
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  doc.Accept(writer);
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+static void etcd_packer_pack_key_value(atapp_benchmark::state &state) {
+  atapp::etcd_key_value kv;
+  make_key_value(0, static_cast<size_t>(state.range(0)), kv);
+
+  while (state.keep_running()) {
+    rapidjson::Document doc;
+    doc.SetObject();
+    rapidjson::Value json_val(rapidjson::kObjectType);
+    atapp::etcd_packer::pack(kv, json_val, doc);
+    atapp_benchmark::do_not_optimize(json_val);
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+  state.set_bytes_processed(static_cast<int64_t>(state.iterations() * (kv.key.size() + kv.value.size())));
+}
+LIBATAPP_BENCHMARK(etcd_packer_pack_key_value)->arg(64)->arg(1024);
+
+static void etcd_packer_unpack_key_value(atapp_benchmark::state &state) {
+  atapp::etcd_key_value kv;
+  make_key_value(0, static_cast<size_t>(state.range(0)), kv);
+
+  rapidjson::Document doc;
+  doc.SetObject();
+  rapidjson::Value json_val(rapidjson::kObjectType);
+  atapp::etcd_packer::pack(kv, json_val, doc);
+
+  atapp::etcd_key_value output;
+  while (state.keep_running()) {
+    atapp::etcd_packer::unpack(output, json_val);
+    atapp_benchmark::do_not_optimize(output);
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+  state.set_bytes_processed(static_cast<int64_t>(state.iterations() * (kv.key.size() + kv.value.size())));
+}
+LIBATAPP_BENCHMARK(etcd_packer_unpack_key_value)->arg(64)->arg(1024);
+
+static void etcd_packer_pack_key_range(atapp_benchmark::state &state) {
+  std::string key = "/atapp/services/benchmark/by_id/";
+  while (state.keep_running()) {
+    rapidjson::Document doc;
+    doc.SetObject();
+    atapp::etcd_packer::pack_key_range(doc, key, "+1", doc);
+    atapp_benchmark::do_not_optimize(doc);
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(etcd_packer_pack_key_range);
+
+// Parse the whole range response and unpack all key-values
+static void etcd_packer_parse_range_response(atapp_benchmark::state &state) {
+  size_t kv_count = static_cast<size_t>(state.range(0));
+  std::string response = make_range_response(kv_count, static_cast<size_t>(state.range(1)));
+
+  atapp::etcd_response_header header;
+  atapp::etcd_key_value kv;
+  while (state.keep_running()) {
+    rapidjson::Document doc;
+    if (!atapp::etcd_packer::parse_object(doc, response.c_str())) {
+      state.skip_with_error("parse range response failed");
+      break;
+    }
+
+    rapidjson::Document::ConstMemberIterator header_iter = doc.FindMember("header");
+    if (header_iter != doc.MemberEnd()) {
+      atapp::etcd_packer::unpack(header, header_iter->value);
+    }
+
+    rapidjson::Document::ConstMemberIterator kvs_iter = doc.FindMember("kvs");
+    if (kvs_iter == doc.MemberEnd() || !kvs_iter->value.IsArray()) {
+      state.skip_with_error("kvs not found in range response");
+      break;
+    }
+
+    for (rapidjson::Value::ConstValueIterator iter = kvs_iter->value.Begin(); iter != kvs_iter->value.End(); ++iter) {
+      atapp::etcd_packer::unpack(kv, *iter);
+      atapp_benchmark::do_not_optimize(kv);
+    }
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations() * kv_count));
+  state.set_bytes_processed(static_cast<int64_t>(state.iterations() * response.size()));
+}
+LIBATAPP_BENCHMARK(etcd_packer_parse_range_response)->args({1, 256})->args({64, 256})->args({1024, 256});
+
+}  // namespace
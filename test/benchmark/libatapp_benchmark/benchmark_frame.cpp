@@ -0,0 +1,478 @@
+// Copyright 2026 atframework
+
+#include "benchmark_frame.h"
+
+#include <atframe/atapp_config.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace atapp_benchmark {
+
+namespace {
+
+struct benchmark_options_t {
+  std::string filter = ".";
+  double min_time = 0.5;
+  std::string out;
+  std::string out_format = "json";
+  bool list_tests = false;
+};
+
+struct benchmark_result_t {
+  std::string name;
+  std::string run_name;
+  size_t family_index = 0;
+  size_t per_family_instance_index = 0;
+  std::vector<int64_t> args;
+  uint64_t iterations = 0;
+  double real_time_ns = 0.0;
+  double cpu_time_ns = 0.0;
+  double items_per_second = 0.0;
+  double bytes_per_second = 0.0;
+  std::string label;
+  bool error_occurred = false;
+  std::string error_message;
+};
+
+static constexpr const uint64_t kBenchmarkMaxIterations = 1000000000;
+
+static std::vector<std::unique_ptr<benchmark_case>> &get_benchmark_cases() {
+  static std::vector<std::unique_ptr<benchmark_case>> ret;
+  return ret;
+}
+
+static std::vector<std::function<void()>> &get_cleanup_functions() {
+  static std::vector<std::function<void()>> ret;
+  return ret;
+}
+
+static bool parse_option_value(const std::string &arg, const char *key, std::string &value) {
+  size_t key_len = strlen(key);
+  if (0 != arg.compare(0, key_len, key)) {
+    return false;
+  }
+
+  if (arg.size() == key_len) {
+    value.clear();
+    return true;
+  }
+
+  if ('=' != arg[key_len]) {
+    return false;
+  }
+
+  value = arg.substr(key_len + 1);
+  return true;
+}
+
+static bool parse_options(int argc, char *argv[], benchmark_options_t &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    std::string value;
+    if (arg == "-h" || arg == "--help") {
+      return false;
+    } else if (parse_option_value(arg, "--benchmark_filter", value)) {
+      options.filter = value.empty() || value == "all" ? "." : value;
+    } else if (parse_option_value(arg, "--benchmark_min_time", value)) {
+      // Google Benchmark also accept "<N>s" and "<N>x", we only support time here
+      if (!value.empty() && 'x' == value.back()) {
+        std::cerr << "Iterations of --benchmark_min_time is not supported, use seconds instead" << std::endl;
+        return false;
+      }
+      options.min_time = std::max(0.0, strtod(value.c_str(), nullptr));
+    } else if (parse_option_value(arg, "--benchmark_out", value)) {
+      options.out = value;
+    } else if (parse_option_value(arg, "--benchmark_out_format", value)) {
+      if (value != "json") {
+        std::cerr << "Only json is supported by --benchmark_out_format" << std::endl;
+        return false;
+      }
+      options.out_format = value;
+    } else if (parse_option_value(arg, "--benchmark_list_tests", value)) {
+      options.list_tests = value.empty() || value == "true" || value == "1";
+    } else {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static std::string make_instance_name(const benchmark_case &c, const std::vector<int64_t> &args) {
+  std::string ret = c.get_name();
+  for (auto &arg : args) {
+    ret += "/";
+    ret += std::to_string(arg);
+  }
+  if (c.get_iterations() > 0) {
+    ret += "/iterations:";
+    ret += std::to_string(c.get_iterations());
+  }
+  return ret;
+}
+
+static void run_instance(const benchmark_options_t &options, const benchmark_case &c, const std::vector<int64_t> &args,
+                         benchmark_result_t &result) {
+  uint64_t iterations = c.get_iterations() > 0 ? c.get_iterations() : 1;
+  while (true) {
+    state st(iterations, args);
+    c.get_function()(st);
+
+    double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(st.get_real_time()).count();
+    bool done = st.is_error_occurred() || c.get_iterations() > 0 || seconds >= options.min_time ||
+                iterations >= kBenchmarkMaxIterations;
+    if (done) {
+      result.iterations = st.iterations();
+      result.error_occurred = st.is_error_occurred();
+      result.error_message = st.get_error_message();
+      result.label = st.get_label();
+      if (result.iterations > 0) {
+        result.real_time_ns = seconds * 1000000000.0 / static_cast<double>(result.iterations);
+        result.cpu_time_ns = st.get_cpu_time_seconds() * 1000000000.0 / static_cast<double>(result.iterations);
+      }
+      if (seconds > 0.0) {
+        result.items_per_second = static_cast<double>(st.get_items_processed()) / seconds;
+        result.bytes_per_second = static_cast<double>(st.get_bytes_processed()) / seconds;
+      }
+      return;
+    }
+
+    // The same strategy as Google Benchmark to predict iterations
+    double multiplier = options.min_time * 1.4 / std::max(seconds, 1e-9);
+    if (seconds / std::max(options.min_time, 1e-9) <= 0.1) {
+      multiplier = std::min(multiplier, 10.0);
+    }
+    double next_iterations =
+        std::max(multiplier * static_cast<double>(iterations), static_cast<double>(iterations + 1));
+    iterations = static_cast<uint64_t>(std::min(next_iterations, static_cast<double>(kBenchmarkMaxIterations)));
+  }
+}
+
+static std::string format_rate(double value, const char *unit) {
+  static const char *prefixes[] = {"", "k", "M", "G", "T"};
+  size_t index = 0;
+  while (value >= 1000.0 && index + 1 < sizeof(prefixes) / sizeof(prefixes[0])) {
+    value /= 1000.0;
+    ++index;
+  }
+
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3) << value << prefixes[index] << unit;
+  return ss.str();
+}
+
+static void print_result(const benchmark_result_t &result, size_t name_width) {
+  std::cout << std::left << std::setw(static_cast<int>(name_width)) << result.name << std::right;
+  if (result.error_occurred) {
+    std::cout << " ERROR OCCURRED: '" << result.error_message << "'" << std::endl;
+    return;
+  }
+
+  std::cout << std::fixed << std::setprecision(1) << std::setw(15) << result.real_time_ns << " ns" << std::setw(15)
+            << result.cpu_time_ns << " ns" << std::setw(13) << result.iterations;
+  if (result.bytes_per_second > 0.0) {
+    std::cout << " bytes_per_second=" << format_rate(result.bytes_per_second, "/s");
+  }
+  if (result.items_per_second > 0.0) {
+    std::cout << " items_per_second=" << format_rate(result.items_per_second, "/s");
+  }
+  if (!result.label.empty()) {
+    std::cout << " " << result.label;
+  }
+  std::cout << std::endl;
+}
+
+static std::string escape_json_string(const std::string &input) {
+  std::string ret;
+  ret.reserve(input.size() + 2);
+  ret.push_back('"');
+  for (char c : input) {
+    switch (c) {
+      case '"':
+        ret += "\\\"";
+        break;
+      case '\\':
+        ret += "\\\\";
+        break;
+      case '\n':
+        ret += "\\n";
+        break;
+      case '\r':
+        ret += "\\r";
+        break;
+      case '\t':
+        ret += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buffer[8];
+          snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(c)));
+          ret += buffer;
+        } else {
+          ret.push_back(c);
+        }
+        break;
+    }
+  }
+  ret.push_back('"');
+  return ret;
+}
+
+static std::string get_date_string() {
+  time_t now = time(nullptr);
+  struct tm tm_now;
+#if defined(_WIN32)
+  localtime_s(&tm_now, &now);
+#else
+  localtime_r(&now, &tm_now);
+#endif
+
+  char buffer[64] = {0};
+  strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S%z", &tm_now);
+  return buffer;
+}
+
+static bool write_json_report(const std::string &path, const char *executable,
+                              const std::vector<benchmark_result_t> &results) {
+  std::ofstream ofs;
+  ofs.open(path.c_str(), std::ios::out | std::ios::trunc);
+  if (!ofs.is_open()) {
+    std::cerr << "Can not open " << path << std::endl;
+    return false;
+  }
+
+  ofs << "{\n  \"context\": {\n";
+  ofs << "    \"date\": " << escape_json_string(get_date_string()) << ",\n";
+  ofs << "    \"executable\": " << escape_json_string(executable) << ",\n";
+  ofs << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#if defined(NDEBUG)
+  ofs << "    \"library_build_type\": \"release\",\n";
+#else
+  ofs << "    \"library_build_type\": \"debug\",\n";
+#endif
+#if defined(LIBATAPP_VERSION)
+  ofs << "    \"libatapp_version\": " << escape_json_string(LIBATAPP_VERSION) << "\n";
+#else
+  ofs << "    \"libatapp_version\": \"" << LIBATAPP_VERSION_MAJOR << "." << LIBATAPP_VERSION_MINOR << "."
+      << LIBATAPP_VERSION_PATCH << "\"\n";
+#endif
+  ofs << "  },\n  \"benchmarks\": [";
+
+  ofs << std::setprecision(17);
+  for (size_t i = 0; i < results.size(); ++i) {
+    const benchmark_result_t &result = results[i];
+    ofs << (0 == i ? "\n" : ",\n") << "    {\n";
+    ofs << "      \"name\": " << escape_json_string(result.name) << ",\n";
+    ofs << "      \"family_index\": " << result.family_index << ",\n";
+    ofs << "      \"per_family_instance_index\": " << result.per_family_instance_index << ",\n";
+    ofs << "      \"run_name\": " << escape_json_string(result.run_name) << ",\n";
+    ofs << "      \"run_type\": \"iteration\",\n";
+    ofs << "      \"repetitions\": 1,\n";
+    ofs << "      \"repetition_index\": 0,\n";
+    ofs << "      \"threads\": 1,\n";
+    if (result.error_occurred) {
+      ofs << "      \"error_occurred\": true,\n";
+      ofs << "      \"error_message\": " << escape_json_string(result.error_message) << ",\n";
+    }
+    ofs << "      \"iterations\": " << result.iterations << ",\n";
+    ofs << "      \"real_time\": " << result.real_time_ns << ",\n";
+    ofs << "      \"cpu_time\": " << result.cpu_time_ns << ",\n";
+    ofs << "      \"time_unit\": \"ns\"";
+    if (result.bytes_per_second > 0.0) {
+      ofs << ",\n      \"bytes_per_second\": " << result.bytes_per_second;
+    }
+    if (result.items_per_second > 0.0) {
+      ofs << ",\n      \"items_per_second\": " << result.items_per_second;
+    }
+    if (!result.label.empty()) {
+      ofs << ",\n      \"label\": " << escape_json_string(result.label);
+    }
+    ofs << "\n    }";
+  }
+  ofs << "\n  ]\n}\n";
+
+  return ofs.good();
+}
+
+}  // namespace
+
+state::state(uint64_t max_iterations, const std::vector<int64_t> &args)
+    : max_iterations_(max_iterations),
+      iterations_(0),
+      args_(args),
+      running_(false),
+      finished_(false),
+      cpu_start_(0),
+      real_time_(std::chrono::steady_clock::duration::zero()),
+      cpu_clock_(0),
+      items_processed_(0),
+      bytes_processed_(0),
+      error_occurred_(false) {}
+
+void state::pause_timing() {
+  if (!running_) {
+    return;
+  }
+
+  real_time_ += std::chrono::steady_clock::now() - real_start_;
+  cpu_clock_ += std::clock() - cpu_start_;
+  running_ = false;
+}
+
+void state::resume_timing() {
+  if (running_ || finished_) {
+    return;
+  }
+
+  start_timer();
+}
+
+void state::skip_with_error(const std::string &message) {
+  error_occurred_ = true;
+  error_message_ = message;
+  pause_timing();
+}
+
+void state::start_timer() {
+  running_ = true;
+  real_start_ = std::chrono::steady_clock::now();
+  cpu_start_ = std::clock();
+}
+
+void state::finish() {
+  if (finished_) {
+    return;
+  }
+
+  pause_timing();
+  finished_ = true;
+}
+
+benchmark_case::benchmark_case(const char *name, benchmark_function_type fn)
+    : name_(name), fn_(std::move(fn)), iterations_(0) {}
+
+benchmark_case *benchmark_case::arg(int64_t value) {
+  args_.push_back(std::vector<int64_t>{value});
+  return this;
+}
+
+benchmark_case *benchmark_case::args(const std::vector<int64_t> &values) {
+  args_.push_back(values);
+  return this;
+}
+
+benchmark_case *benchmark_case::iterations(uint64_t value) {
+  iterations_ = value;
+  return this;
+}
+
+benchmark_case *register_benchmark(const char *name, benchmark_function_type fn) {
+  get_benchmark_cases().emplace_back(new benchmark_case(name, std::move(fn)));
+  return get_benchmark_cases().back().get();
+}
+
+void register_cleanup(std::function<void()> fn) { get_cleanup_functions().emplace_back(std::move(fn)); }
+
+int run_benchmarks(int argc, char *argv[]) {
+  benchmark_options_t options;
+  if (!parse_options(argc, argv, options)) {
+    std::cout << "Usage: " << argv[0]
+              << " [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>] [--benchmark_out=<file>]"
+                 " [--benchmark_out_format=json] [--benchmark_list_tests]"
+              << std::endl;
+    return 1;
+  }
+
+  std::regex filter;
+  try {
+    filter = std::regex(options.filter);
+  } catch (const std::regex_error &e) {
+    std::cerr << "Invalid --benchmark_filter " << options.filter << ": " << e.what() << std::endl;
+    return 1;
+  }
+
+  // Sort by name, so cases in different files are always reported in the same order
+  std::vector<benchmark_case *> cases;
+  for (auto &c : get_benchmark_cases()) {
+    cases.push_back(c.get());
+  }
+  std::stable_sort(cases.begin(), cases.end(),
+                   [](const benchmark_case *l, const benchmark_case *r) { return l->get_name() < r->get_name(); });
+
+  std::vector<benchmark_result_t> results;
+  size_t name_width = 10;
+  for (size_t family_index = 0; family_index < cases.size(); ++family_index) {
+    const benchmark_case &c = *cases[family_index];
+    std::vector<std::vector<int64_t>> instances = c.get_args();
+    if (instances.empty()) {
+      instances.push_back(std::vector<int64_t>());
+    }
+
+    size_t per_family_instance_index = 0;
+    for (auto &args : instances) {
+      std::string name = make_instance_name(c, args);
+      if (!std::regex_search(name, filter)) {
+        continue;
+      }
+
+      if (options.list_tests) {
+        std::cout << name << std::endl;
+        continue;
+      }
+
+      results.push_back(benchmark_result_t());
+      benchmark_result_t &result = results.back();
+      result.name = name;
+      result.run_name = name;
+      result.family_index = family_index;
+      result.per_family_instance_index = per_family_instance_index++;
+      result.args = args;
+      name_width = std::max(name_width, name.size() + 1);
+    }
+  }
+
+  if (options.list_tests) {
+    return 0;
+  }
+
+  std::cout << std::left << std::setw(static_cast<int>(name_width)) << "Benchmark" << std::right << std::setw(18)
+            << "Time" << std::setw(18) << "CPU" << std::setw(13) << "Iterations" << std::endl;
+  std::cout << std::string(name_width + 49, '-') << std::endl;
+
+  int ret = 0;
+  for (auto &result : results) {
+    const benchmark_case &c = *cases[result.family_index];
+    run_instance(options, c, result.args, result);
+    print_result(result, name_width);
+    if (result.error_occurred) {
+      ret = 1;
+    }
+  }
+
+  for (auto &fn : get_cleanup_functions()) {
+    if (fn) {
+      fn();
+    }
+  }
+  get_cleanup_functions().clear();
+
+  if (!options.out.empty() && !write_json_report(options.out, argv[0], results)) {
+    return 1;
+  }
+
+  return ret;
+}
+
+}  // namespace atapp_benchmark
@@ -0,0 +1,188 @@
+// Copyright 2026 atframework
+// Minimal micro benchmark frame of libatapp_benchmark, command line and JSON report are compatible with Google
+// Benchmark, so tools/compare.py of Google Benchmark can be used to compare results across commits.
+
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace atapp_benchmark {
+
+class state {
+ public:
+  state(uint64_t max_iterations, const std::vector<int64_t> &args);
+
+  state(const state &) = delete;
+  state &operator=(const state &) = delete;
+
+  /**
+   * @brief Main loop of benchmark case, timer starts at first call and stops when it returns false
+   * @note Usage: while (state.keep_running()) { ... }
+   */
+  inline bool keep_running() {
+    if (iterations_ < max_iterations_ && !error_occurred_) {
+      if (0 == iterations_) {
+        start_timer();
+      }
+      ++iterations_;
+      return true;
+    }
+
+    finish();
+    return false;
+  }
+
+  /**
+   * @brief Stop timer, used to exclude setup and cleanup in main loop
+   */
+  void pause_timing();
+
+  /**
+   * @brief Restart timer after pause_timing()
+   */
+  void resume_timing();
+
+  void skip_with_error(const std::string &message);
+
+  inline int64_t range(size_t index = 0) const noexcept { return index < args_.size() ? args_[index] : 0; }
+
+  inline uint64_t max_iterations() const noexcept { return max_iterations_; }
+
+  inline uint64_t iterations() const noexcept { return iterations_; }
+
+  inline void set_items_processed(int64_t items) noexcept { items_processed_ = items; }
+
+  inline void set_bytes_processed(int64_t bytes) noexcept { bytes_processed_ = bytes; }
+
+  inline void set_label(const std::string &label) { label_ = label; }
+
+  inline int64_t get_items_processed() const noexcept { return items_processed_; }
+
+  inline int64_t get_bytes_processed() const noexcept { return bytes_processed_; }
+
+  inline const std::string &get_label() const noexcept { return label_; }
+
+  inline bool is_error_occurred() const noexcept { return error_occurred_; }
+
+  inline const std::string &get_error_message() const noexcept { return error_message_; }
+
+  inline std::chrono::steady_clock::duration get_real_time() const noexcept { return real_time_; }
+
+  inline double get_cpu_time_seconds() const noexcept {
+    return static_cast<double>(cpu_clock_) / static_cast<double>(CLOCKS_PER_SEC);
+  }
+
+ private:
+  void start_timer();
+  void finish();
+
+ private:
+  uint64_t max_iterations_;
+  uint64_t iterations_;
+  std::vector<int64_t> args_;
+
+  bool running_;
+  bool finished_;
+  std::chrono::steady_clock::time_point real_start_;
+  std::clock_t cpu_start_;
+  std::chrono::steady_clock::duration real_time_;
+  std::clock_t cpu_clock_;
+
+  int64_t items_processed_;
+  int64_t bytes_processed_;
+  std::string label_;
+  bool error_occurred_;
+  std::string error_message_;
+};
+
+using benchmark_function_type = std::function<void(state &)>;
+
+class benchmark_case {
+ public:
+  benchmark_case(const char *name, benchmark_function_type fn);
+
+  benchmark_case(const benchmark_case &) = delete;
+  benchmark_case &operator=(const benchmark_case &) = delete;
+
+  /**
+   * @brief Add one instance with argument, name of instance will be "<name>/<arg>"
+   */
+  benchmark_case *arg(int64_t value);
+
+  /**
+   * @brief Add one instance with multiple arguments, name of instance will be "<name>/<arg0>/<arg1>..."
+   */
+  benchmark_case *args(const std::vector<int64_t> &values);
+
+  /**
+   * @brief Use fixed iterations instead of growing iterations until reaching minimal running time
+   * @note Used by cases which can not be called many times, such as cases which have large setup cost
+   */
+  benchmark_case *iterations(uint64_t value);
+
+  inline const std::string &get_name() const noexcept { return name_; }
+
+  inline const benchmark_function_type &get_function() const noexcept { return fn_; }
+
+  inline const std::vector<std::vector<int64_t>> &get_args() const noexcept { return args_; }
+
+  inline uint64_t get_iterations() const noexcept { return iterations_; }
+
+ private:
+  std::string name_;
+  benchmark_function_type fn_;
+  std::vector<std::vector<int64_t>> args_;
+  uint64_t iterations_;
+};
+
+benchmark_case *register_benchmark(const char *name, benchmark_function_type fn);
+
+/**
+ * @brief Register cleanup function which will be called after all benchmarks finished
+ * @note Shared fixtures such as app instances should be destroyed here instead of static destructors
+ */
+void register_cleanup(std::function<void()> fn);
+
+/**
+ * @brief Run all registered benchmarks
+ * @note Supported options: --benchmark_filter=<regex>, --benchmark_min_time=<seconds>[s],
+ *       --benchmark_out=<file>, --benchmark_out_format=json, --benchmark_list_tests[=true]
+ * @return exit code of process
+ */
+int run_benchmarks(int argc, char *argv[]);
+
+/**
+ * @brief Prevent compiler to optimize out value
+ */
+template <class T>
+inline void do_not_optimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void *sink;
+  sink = static_cast<const volatile void *>(&value);
+#endif
+}
+
+}  // namespace atapp_benchmark
+
+#define LIBATAPP_BENCHMARK_CONCAT_IMPL(A, B) A##B
+#define LIBATAPP_BENCHMARK_CONCAT(A, B) LIBATAPP_BENCHMARK_CONCAT_IMPL(A, B)
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define LIBATAPP_BENCHMARK_UNUSED __attribute__((unused))
+#else
+#  define LIBATAPP_BENCHMARK_UNUSED
+#endif
+
+/**
+ * @brief Register benchmark function, arguments can be appended like LIBATAPP_BENCHMARK(fn)->arg(8)->arg(64);
+ */
+#define LIBATAPP_BENCHMARK(FN)                                                                          \
+  static ::atapp_benchmark::benchmark_case *LIBATAPP_BENCHMARK_CONCAT(libatapp_benchmark_case_, __LINE__) \
+      LIBATAPP_BENCHMARK_UNUSED = ::atapp_benchmark::register_benchmark(#FN, FN)
@@ -0,0 +1,139 @@
+// Copyright 2026 atframework
+// Benchmarks of log calls, compare the text file sink with the binlog sink and the mmap file sink
+//
+// Cases with "_latency" suffix measure every log call and report tail latency in label, they include the cost of
+// std::chrono::steady_clock::now().
+
+#include <atframe/atapp_log_sink_binlog.h>
+#include <atframe/atapp_log_sink_mmap_file.h>
+
+#include <log/log_sink_file_backend.h>
+#include <log/log_wrapper.h>
+
+#include <string/string_format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark_frame.h"
+
+namespace {
+
+static constexpr const uint64_t kLogSinkLatencyIterations = 200000;
+static constexpr const char *kLogSinkTextPrefix = "[%L][%F %T.%f][%s:%n(%C)]: ";
+
+static void remove_log_files() {
+  std::remove("libatapp_benchmark_log_sink.0.log");
+  std::remove("libatapp_benchmark_log_sink.0.binlog");
+  for (int i = 0; i < 4; ++i) {
+    std::remove(atfw::util::string::format("libatapp_benchmark_log_sink.mmap.{}.log", i).c_str());
+  }
+}
+
+static atfw::util::log::log_sink_file_backend make_file_sink() {
+  atfw::util::log::log_sink_file_backend ret;
+  ret.set_file_pattern("libatapp_benchmark_log_sink.%N.log");
+  ret.set_max_file_size(static_cast<size_t>(1) << 40);
+  ret.set_rotate_size(1);
+  return ret;
+}
+
+static atapp::log_sink_binlog_backend make_binlog_sink() {
+  atapp::log_sink_binlog_backend::options_type options;
+  options.file_pattern = "libatapp_benchmark_log_sink.%N.binlog";
+  options.max_file_size = static_cast<size_t>(1) << 40;
+  options.rotate_size = 1;
+  return atapp::log_sink_binlog_backend(options);
+}
+
+static atapp::log_sink_mmap_file_backend make_mmap_file_sink() {
+  // Rotate several times to include the cost of switching segments
+  atapp::log_sink_mmap_file_backend::options_type options;
+  options.file_pattern = "libatapp_benchmark_log_sink.mmap.%N.log";
+  options.max_file_size = 64 * 1024 * 1024;
+  options.rotate_size = 4;
+  return atapp::log_sink_mmap_file_backend(options);
+}
+
+template <class TSINK>
+static void run_log_sink_benchmark(atapp_benchmark::state &state, const char *prefix, TSINK &&sink,
+                                   bool measure_latency) {
+  remove_log_files();
+
+  atfw::util::log::log_wrapper *logger = WLOG_GETCAT(atfw::util::log::log_wrapper::categorize_t::DEFAULT);
+  logger->clear_sinks();
+  logger->set_prefix_format(prefix);
+  logger->init(atfw::util::log::log_level::kDebug);
+  logger->add_sink(std::forward<TSINK>(sink));
+
+  std::vector<int64_t> latency_ns;
+  if (measure_latency) {
+    latency_ns.reserve(static_cast<size_t>(state.max_iterations()));
+  }
+
+  size_t i = 0;
+  while (state.keep_running()) {
+    if (measure_latency) {
+      auto call_begin = std::chrono::steady_clock::now();
+      FWLOGINFO("benchmark log {} from player {}, gold: {}, reason: {}", i, 100000 + (i & 0xFF), i * 3,
+                "daily reward");
+      latency_ns.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - call_begin)
+              .count());
+    } else {
+      FWLOGINFO("benchmark log {} from player {}, gold: {}, reason: {}", i, 100000 + (i & 0xFF), i * 3,
+                "daily reward");
+    }
+    ++i;
+  }
+
+  state.pause_timing();
+  logger->clear_sinks();
+  remove_log_files();
+
+  if (!latency_ns.empty()) {
+    std::sort(latency_ns.begin(), latency_ns.end());
+    size_t count = latency_ns.size();
+    state.set_label(atfw::util::string::format("p50 {}ns, p99 {}ns, p99.9 {}ns, max {}ns", latency_ns[count / 2],
+                                               latency_ns[count * 99 / 100], latency_ns[count * 999 / 1000],
+                                               latency_ns.back()));
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+
+static void log_sink_file(atapp_benchmark::state &state) {
+  run_log_sink_benchmark(state, kLogSinkTextPrefix, make_file_sink(), false);
+}
+LIBATAPP_BENCHMARK(log_sink_file);
+
+static void log_sink_file_latency(atapp_benchmark::state &state) {
+  run_log_sink_benchmark(state, kLogSinkTextPrefix, make_file_sink(), true);
+}
+LIBATAPP_BENCHMARK(log_sink_file_latency)->iterations(kLogSinkLatencyIterations);
+
+// Level, time and call site are stored in binary, no text prefix is needed
+static void log_sink_binlog(atapp_benchmark::state &state) {
+  run_log_sink_benchmark(state, "", make_binlog_sink(), false);
+}
+LIBATAPP_BENCHMARK(log_sink_binlog);
+
+static void log_sink_binlog_latency(atapp_benchmark::state &state) {
+  run_log_sink_benchmark(state, "", make_binlog_sink(), true);
+}
+LIBATAPP_BENCHMARK(log_sink_binlog_latency)->iterations(kLogSinkLatencyIterations);
+
+static void log_sink_mmap_file(atapp_benchmark::state &state) {
+  run_log_sink_benchmark(state, kLogSinkTextPrefix, make_mmap_file_sink(), false);
+}
+LIBATAPP_BENCHMARK(log_sink_mmap_file);
+
+static void log_sink_mmap_file_latency(atapp_benchmark::state &state) {
+  run_log_sink_benchmark(state, kLogSinkTextPrefix, make_mmap_file_sink(), true);
+}
+LIBATAPP_BENCHMARK(log_sink_mmap_file_latency)->iterations(kLogSinkLatencyIterations);
+
+}  // namespace
@@ -0,0 +1,12 @@
+// Copyright 2026 atframework
+// Micro benchmarks of libatapp internals
+//
+// Usage: libatapp_benchmark [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]
+//                           [--benchmark_out=<file>] [--benchmark_out_format=json] [--benchmark_list_tests]
+//
+// Compare JSON reports of two commits with tools/compare.py of Google Benchmark:
+//   compare.py benchmarks baseline.json contender.json
+
+#include "benchmark_frame.h"
+
+int main(int argc, char *argv[]) { return atapp_benchmark::run_benchmarks(argc, argv); }
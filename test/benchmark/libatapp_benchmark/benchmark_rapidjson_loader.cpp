@@ -0,0 +1,215 @@
+// Copyright 2026 atframework
+// Throughput benchmarks of rapidjson_loader with discovery and configure payloads
+
+#include <atframe/atapp_conf.h>
+#include <atframe/atapp_conf_rapidjson.h>
+
+#include <string/string_format.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark_frame.h"
+
+namespace {
+
+static constexpr const size_t kRapidjsonLoaderRecordCount = 1024;
+
+// range(0): 0 for discovery payload and 1 for configure payload
+// range(1): 0 for kRaw, 1 for kUri and 2 for kUriComponent
+enum class rapidjson_loader_payload_type : int64_t {
+  kDiscovery = 0,
+  kConfigure = 1,
+};
+
+struct rapidjson_loader_payload_t {
+  std::vector<std::unique_ptr<ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message>> messages;
+  std::vector<std::string> json;
+};
+
+static const char *get_simd_backend_name() {
+#if defined(RAPIDJSON_SSE42)
+  return "SSE4.2";
+#elif defined(RAPIDJSON_SSE2)
+  return "SSE2";
+#elif defined(RAPIDJSON_NEON)
+  return "NEON";
+#else
+  return "scalar";
+#endif
+}
+
+static atapp::rapidjson_loader_string_mode get_string_mode(int64_t value) {
+  switch (value) {
+    case 1:
+      return atapp::rapidjson_loader_string_mode::kUri;
+    case 2:
+      return atapp::rapidjson_loader_string_mode::kUriComponent;
+    default:
+      return atapp::rapidjson_loader_string_mode::kRaw;
+  }
+}
+
+static const char *get_string_mode_name(atapp::rapidjson_loader_string_mode mode) {
+  switch (mode) {
+    case atapp::rapidjson_loader_string_mode::kUri:
+      return "uri";
+    case atapp::rapidjson_loader_string_mode::kUriComponent:
+      return "uri_component";
+    default:
+      return "raw";
+  }
+}
+
+static void make_discovery(size_t index, atapp::protocol::atapp_discovery &output) {
+  size_t label_set = index % 8;
+
+  output.set_id(static_cast<uint64_t>(index + 1));
+  output.set_name(atfw::util::string::format("benchmark-node-{}", index));
+  output.set_hostname(atfw::util::string::format("benchmark-host-{}.cluster.local", index % 64));
+  output.set_pid(static_cast<int32_t>(10000 + index));
+  output.set_identity(atfw::util::string::format("benchmark-identity-{}", index));
+  output.set_type_id(static_cast<uint64_t>(label_set + 1));
+  output.set_type_name(atfw::util::string::format("benchmark-type-{}", label_set));
+  output.set_version("1.0.0-benchmark");
+  output.mutable_area()->set_region("benchmark-region");
+  output.mutable_area()->set_district("benchmark-district");
+  output.add_listen(atfw::util::string::format("ipv4://10.0.{}.{}:{}", (index / 250) % 250, index % 250, 16000));
+
+  atapp::protocol::atapp_gateway *gateway = output.add_gateways();
+  gateway->set_address(atfw::util::string::format("ipv4://gateway.cluster.local:{}", 17000 + label_set));
+  gateway->add_match_namespaces("benchmark-namespace");
+  (*gateway->mutable_match_labels())["deployment.environment"] = "production";
+
+  atapp::protocol::atapp_metadata *metadata = output.mutable_metadata();
+  metadata->set_api_version("v1");
+  metadata->set_kind("benchmark");
+  metadata->set_namespace_name("benchmark-namespace");
+  (*metadata->mutable_labels())["app.kubernetes.io/component"] =
+      atfw::util::string::format("component-{}", label_set);
+}
+
+static void make_configure(size_t index, atapp::protocol::atapp_configure &output) {
+  output.set_id(atfw::util::string::format("0x{:08x}", index + 1));
+  output.set_name(atfw::util::string::format("benchmark-server-{}", index));
+  output.set_type_id(static_cast<uint64_t>(index % 8 + 1));
+  output.set_type_name("benchmark-server");
+  output.set_hostname(atfw::util::string::format("benchmark-host-{}.cluster.local", index % 64));
+  output.set_identity(atfw::util::string::format("benchmark-identity-{}", index));
+  output.mutable_area()->set_region("benchmark-region");
+  (*output.mutable_metadata()->mutable_labels())["deployment.environment"] = "production";
+
+  atapp::protocol::atapp_etcd *etcd = output.mutable_etcd();
+  etcd->set_enable(true);
+  etcd->set_path("/atapp/services/benchmark");
+  etcd->set_authorization("benchmark-user:benchmark-password");
+  for (size_t i = 0; i < 3; ++i) {
+    etcd->add_hosts(atfw::util::string::format("http://etcd-{}.cluster.local:2379", i));
+  }
+
+  atapp::protocol::atapp_etcd *external = output.add_external_discovery();
+  external->set_enable(true);
+  external->set_path("/atapp/services/external");
+  external->add_hosts("https://etcd-external.cluster.local:2379");
+}
+
+static void setup_payload(const atapp_benchmark::state &state, atapp::rapidjson_loader_string_mode mode,
+                          rapidjson_loader_payload_t &payload) {
+  atapp::rapidjson_loader_load_options load_options;
+  load_options.string_mode = mode;
+
+  bool is_configure = static_cast<int64_t>(rapidjson_loader_payload_type::kConfigure) == state.range(0);
+  payload.messages.reserve(kRapidjsonLoaderRecordCount);
+  payload.json.reserve(kRapidjsonLoaderRecordCount);
+  for (size_t i = 0; i < kRapidjsonLoaderRecordCount; ++i) {
+    if (is_configure) {
+      std::unique_ptr<atapp::protocol::atapp_configure> configure{new atapp::protocol::atapp_configure()};
+      make_configure(i, *configure);
+      payload.messages.emplace_back(std::move(configure));
+    } else {
+      std::unique_ptr<atapp::protocol::atapp_discovery> discovery{new atapp::protocol::atapp_discovery()};
+      make_discovery(i, *discovery);
+      payload.messages.emplace_back(std::move(discovery));
+    }
+    payload.json.push_back(atapp::rapidjson_loader_stringify(*payload.messages.back(), load_options));
+  }
+}
+
+static std::string make_label(const atapp_benchmark::state &state, atapp::rapidjson_loader_string_mode mode) {
+  return atfw::util::string::format(
+      "{}/{}/{}",
+      static_cast<int64_t>(rapidjson_loader_payload_type::kConfigure) == state.range(0) ? "configure" : "discovery",
+      get_string_mode_name(mode), get_simd_backend_name());
+}
+
+static void rapidjson_loader_stringify_throughput(atapp_benchmark::state &state) {
+  atapp::rapidjson_loader_string_mode mode = get_string_mode(state.range(1));
+  rapidjson_loader_payload_t payload;
+  setup_payload(state, mode, payload);
+
+  atapp::rapidjson_loader_load_options load_options;
+  load_options.string_mode = mode;
+
+  size_t index = 0;
+  size_t bytes = 0;
+  while (state.keep_running()) {
+    std::string output = atapp::rapidjson_loader_stringify(*payload.messages[index], load_options);
+    bytes += output.size();
+    atapp_benchmark::do_not_optimize(output);
+    if (++index >= payload.messages.size()) {
+      index = 0;
+    }
+  }
+
+  state.set_label(make_label(state, mode));
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+  state.set_bytes_processed(static_cast<int64_t>(bytes));
+}
+LIBATAPP_BENCHMARK(rapidjson_loader_stringify_throughput)
+    ->args({0, 0})
+    ->args({0, 1})
+    ->args({0, 2})
+    ->args({1, 0})
+    ->args({1, 1})
+    ->args({1, 2});
+
+static void rapidjson_loader_parse_throughput(atapp_benchmark::state &state) {
+  atapp::rapidjson_loader_string_mode mode = get_string_mode(state.range(1));
+  rapidjson_loader_payload_t payload;
+  setup_payload(state, mode, payload);
+
+  atapp::rapidjson_loader_dump_options dump_options;
+  dump_options.string_mode = mode;
+
+  std::unique_ptr<ATBUS_MACRO_PROTOBUF_NAMESPACE_ID::Message> output{payload.messages.front()->New()};
+  size_t index = 0;
+  size_t bytes = 0;
+  while (state.keep_running()) {
+    const std::string &json = payload.json[index];
+    if (++index >= payload.json.size()) {
+      index = 0;
+    }
+
+    output->Clear();
+    if (!atapp::rapidjson_loader_parse(*output, json, dump_options)) {
+      state.skip_with_error("rapidjson_loader_parse failed");
+      break;
+    }
+    bytes += json.size();
+  }
+
+  state.set_label(make_label(state, mode));
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+  state.set_bytes_processed(static_cast<int64_t>(bytes));
+}
+LIBATAPP_BENCHMARK(rapidjson_loader_parse_throughput)
+    ->args({0, 0})
+    ->args({0, 1})
+    ->args({0, 2})
+    ->args({1, 0})
+    ->args({1, 1})
+    ->args({1, 2});
+
+}  // namespace
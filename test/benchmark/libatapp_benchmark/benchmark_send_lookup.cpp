@@ -0,0 +1,159 @@
+// Copyright 2026 atframework
+// Benchmarks of endpoint lookup on send path, compare std::unordered_map with flat_hash_map
+
+#include <atframe/atapp_flat_hash_map.h>
+
+#include <string/string_format.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "benchmark_frame.h"
+
+namespace {
+
+struct fake_endpoint_t {
+  uint64_t id;
+  std::string name;
+};
+
+using fake_endpoint_ptr_t = std::shared_ptr<fake_endpoint_t>;
+
+struct send_lookup_fixture_t {
+  std::vector<fake_endpoint_ptr_t> endpoints;
+  // Names are usually received as a view of message header
+  std::vector<gsl::string_view> name_views;
+};
+
+static void setup_endpoints(size_t endpoint_count, send_lookup_fixture_t &fixture) {
+  fixture.endpoints.reserve(endpoint_count);
+  fixture.name_views.reserve(endpoint_count);
+  for (size_t i = 0; i < endpoint_count; ++i) {
+    fake_endpoint_ptr_t ep = std::make_shared<fake_endpoint_t>();
+    // Bus ids are allocated in segments, low bits are always the same
+    ep->id = (static_cast<uint64_t>(i + 1) << 8) | 0x01;
+    ep->name = atfw::util::string::format("benchmark-service-{}.cluster.local", i);
+    fixture.endpoints.push_back(ep);
+  }
+  for (auto &ep : fixture.endpoints) {
+    fixture.name_views.push_back(gsl::string_view{ep->name.data(), ep->name.size()});
+  }
+}
+
+static void send_lookup_std_map_by_id(atapp_benchmark::state &state) {
+  send_lookup_fixture_t fixture;
+  setup_endpoints(static_cast<size_t>(state.range(0)), fixture);
+  std::unordered_map<uint64_t, fake_endpoint_ptr_t> by_id;
+  for (auto &ep : fixture.endpoints) {
+    by_id[ep->id] = ep;
+  }
+
+  size_t count = fixture.endpoints.size();
+  size_t index = 0;
+  while (state.keep_running()) {
+    index = (index + 7) % count;
+    atapp_benchmark::do_not_optimize(by_id.find(fixture.endpoints[index]->id));
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(send_lookup_std_map_by_id)->arg(1000);
+
+static void send_lookup_flat_map_by_id(atapp_benchmark::state &state) {
+  send_lookup_fixture_t fixture;
+  setup_endpoints(static_cast<size_t>(state.range(0)), fixture);
+  atapp::flat_hash_map<uint64_t, fake_endpoint_ptr_t> by_id;
+  for (auto &ep : fixture.endpoints) {
+    by_id[ep->id] = ep;
+  }
+
+  size_t count = fixture.endpoints.size();
+  size_t index = 0;
+  while (state.keep_running()) {
+    index = (index + 7) % count;
+    atapp_benchmark::do_not_optimize(by_id.find(fixture.endpoints[index]->id));
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(send_lookup_flat_map_by_id)->arg(1000);
+
+// std::unordered_map need a std::string temporary to lookup by a view
+static void send_lookup_std_map_by_name_view(atapp_benchmark::state &state) {
+  send_lookup_fixture_t fixture;
+  setup_endpoints(static_cast<size_t>(state.range(0)), fixture);
+  std::unordered_map<std::string, fake_endpoint_ptr_t> by_name;
+  for (auto &ep : fixture.endpoints) {
+    by_name[ep->name] = ep;
+  }
+
+  size_t count = fixture.endpoints.size();
+  size_t index = 0;
+  while (state.keep_running()) {
+    index = (index + 7) % count;
+    const gsl::string_view &view = fixture.name_views[index];
+    atapp_benchmark::do_not_optimize(by_name.find(std::string(view.data(), view.size())));
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(send_lookup_std_map_by_name_view)->arg(1000);
+
+static void send_lookup_flat_map_by_name_view(atapp_benchmark::state &state) {
+  send_lookup_fixture_t fixture;
+  setup_endpoints(static_cast<size_t>(state.range(0)), fixture);
+  atapp::flat_hash_map<std::string, fake_endpoint_ptr_t, atapp::flat_string_hash, atapp::flat_string_equal> by_name;
+  for (auto &ep : fixture.endpoints) {
+    by_name[ep->name] = ep;
+  }
+
+  size_t count = fixture.endpoints.size();
+  size_t index = 0;
+  while (state.keep_running()) {
+    index = (index + 7) % count;
+    atapp_benchmark::do_not_optimize(by_name.find(fixture.name_views[index]));
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(send_lookup_flat_map_by_name_view)->arg(1000);
+
+// Endpoint handle set, almost always one or two handles
+static void send_lookup_std_set_handle_iterate(atapp_benchmark::state &state) {
+  send_lookup_fixture_t fixture;
+  setup_endpoints(2, fixture);
+  std::unordered_set<fake_endpoint_t *> handles;
+  for (auto &ep : fixture.endpoints) {
+    handles.insert(ep.get());
+  }
+
+  while (state.keep_running()) {
+    size_t ret = 0;
+    for (auto &handle : handles) {
+      ret += handle->id & 0x01;
+    }
+    atapp_benchmark::do_not_optimize(ret);
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(send_lookup_std_set_handle_iterate);
+
+static void send_lookup_small_pointer_set_handle_iterate(atapp_benchmark::state &state) {
+  send_lookup_fixture_t fixture;
+  setup_endpoints(2, fixture);
+  atapp::small_pointer_set<fake_endpoint_t, 2> handles;
+  for (auto &ep : fixture.endpoints) {
+    handles.insert(ep.get());
+  }
+
+  while (state.keep_running()) {
+    size_t ret = 0;
+    for (auto &handle : handles) {
+      ret += handle->id & 0x01;
+    }
+    atapp_benchmark::do_not_optimize(ret);
+  }
+  state.set_items_processed(static_cast<int64_t>(state.iterations()));
+}
+LIBATAPP_BENCHMARK(send_lookup_small_pointer_set_handle_iterate);
+
+}  // namespace
@@ -0,0 +1,96 @@
+// Copyright 2026 atframework
+// Benchmarks of worker_pool_module::spawn
+
+#include <atframe/atapp.h>
+#include <atframe/modules/worker_pool_module.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "benchmark_app.h"
+#include "benchmark_frame.h"
+
+namespace {
+
+static std::shared_ptr<atframework::atapp::worker_pool_module> get_worker_pool_module() {
+  atframework::atapp::app *app = atapp_benchmark::get_shared_app("atapp_test_1.yaml");
+  if (nullptr == app) {
+    return nullptr;
+  }
+
+  return app->get_worker_pool_module();
+}
+
+static bool wait_for_jobs(atframework::atapp::worker_pool_module &worker_pool, const std::atomic<uint64_t> &finished,
+                          uint64_t expect) {
+  auto end_time = std::chrono::steady_clock::now() + std::chrono::seconds(8);
+  while (finished.load(std::memory_order_acquire) < expect) {
+    if (std::chrono::steady_clock::now() >= end_time) {
+      return false;
+    }
+    worker_pool.tick(std::chrono::system_clock::now());
+    std::this_thread::yield();
+  }
+
+  return true;
+}
+
+// Spawn jobs and wait for all of them to finish, throughput of the whole pool is measured
+static void worker_pool_module_spawn(atapp_benchmark::state &state) {
+  std::shared_ptr<atframework::atapp::worker_pool_module> worker_pool = get_worker_pool_module();
+  if (!worker_pool) {
+    state.skip_with_error("worker pool module is not available");
+    return;
+  }
+
+  // Jobs may be still running after timeout, so counter must be kept alive by jobs
+  bool shared_action = 0 != state.range(0);
+  std::shared_ptr<std::atomic<uint64_t>> finished = std::make_shared<std::atomic<uint64_t>>(0);
+  atapp::worker_job_action_pointer action = atfw::util::memory::make_strong_rc<atapp::worker_job_action_type>(
+      [finished](const atapp::worker_context &) { finished->fetch_add(1, std::memory_order_release); });
+
+  // Start workers before timing
+  worker_pool->tick(std::chrono::system_clock::now());
+
+  uint64_t spawned = 0;
+  while (state.keep_running()) {
+    int res;
+    while (true) {
+      if (shared_action) {
+        res = worker_pool->spawn(action);
+      } else {
+        res = worker_pool->spawn(
+            [finished](const atapp::worker_context &) { finished->fetch_add(1, std::memory_order_release); });
+      }
+
+      // Queue is full, wait for workers
+      if (EN_ATAPP_ERR_WORKER_POOL_BUSY != res) {
+        break;
+      }
+      worker_pool->tick(std::chrono::system_clock::now());
+      std::this_thread::yield();
+    }
+
+    if (0 != res) {
+      state.skip_with_error("spawn failed");
+      break;
+    }
+    ++spawned;
+
+    // Waiting for the last job is also timed
+    if (state.iterations() >= state.max_iterations() && !wait_for_jobs(*worker_pool, *finished, spawned)) {
+      state.skip_with_error("wait for jobs timeout");
+      break;
+    }
+  }
+
+  state.pause_timing();
+  wait_for_jobs(*worker_pool, *finished, spawned);
+
+  state.set_items_processed(static_cast<int64_t>(spawned));
+}
+LIBATAPP_BENCHMARK(worker_pool_module_spawn)->arg(0)->arg(1);
+
+}  // namespace
@@ -0,0 +1,126 @@
+// Copyright 2026 atframework
+// Tests of batch sending and receiving of C binding
+
+#include <atframe/libatapp_c.h>
+
+#include <common/file_system.h>
+#include <time/time_utility.h>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+namespace {
+
+static constexpr const int32_t kCBindingTestMessageTypeById = 1201;
+static constexpr const int32_t kCBindingTestMessageTypeByName = 1202;
+static constexpr const int32_t kCBindingTestMessageTypeByNameOnly = 1203;
+
+struct c_binding_batch_state {
+  uint64_t callback_count = 0;
+  uint64_t max_batch_count = 0;
+  std::vector<int32_t> types;
+  std::vector<std::string> data;
+  std::vector<std::string> source_names;
+};
+
+static int32_t on_msg_batch(libatapp_c_context, const libatapp_c_message_view_t *msgs, uint64_t msg_count,
+                            void *priv_data) {
+  c_binding_batch_state *state = reinterpret_cast<c_binding_batch_state *>(priv_data);
+  ++state->callback_count;
+  if (msg_count > state->max_batch_count) {
+    state->max_batch_count = msg_count;
+  }
+
+  for (uint64_t i = 0; i < msg_count; ++i) {
+    state->types.push_back(msgs[i].type);
+    state->data.push_back(
+        std::string(reinterpret_cast<const char *>(msgs[i].data), static_cast<size_t>(msgs[i].data_len)));
+    state->source_names.push_back(std::string(msgs[i].source_name, static_cast<size_t>(msgs[i].source_name_len)));
+  }
+  return 0;
+}
+
+static void fill_send_message(libatapp_c_send_message_t &msg, int32_t target_type, int32_t type, uint64_t target_id,
+                              const char *target_name, const char *data) {
+  memset(&msg, 0, sizeof(msg));
+  msg.target_type = target_type;
+  msg.type = type;
+  msg.target_id = target_id;
+  msg.target_buffer = target_name;
+  msg.target_buffer_len = nullptr == target_name ? 0 : static_cast<uint64_t>(strlen(target_name));
+  msg.data = data;
+  msg.data_len = static_cast<uint64_t>(strlen(data));
+}
+
+}  // namespace
+
+CASE_TEST(atapp_c_binding, send_many_and_msg_batch) {
+  std::string conf_path_base;
+  atfw::util::file_system::dirname(__FILE__, 0, conf_path_base);
+  std::string conf_path = conf_path_base + "/atapp_test_0.yaml";
+  if (!atfw::util::file_system::is_exist(conf_path.c_str())) {
+    CASE_MSG_INFO() << CASE_MSG_FCOLOR(YELLOW) << conf_path << " not found, skip this test" << '\n';
+    return;
+  }
+
+  libatapp_c_context context = libatapp_c_create();
+  CASE_EXPECT_TRUE(nullptr != context);
+  if (nullptr == context) {
+    return;
+  }
+
+  c_binding_batch_state state;
+  libatapp_c_set_on_msg_batch_fn(context, on_msg_batch, 2, &state);
+
+  const char *args[] = {"app", "-c", conf_path.c_str(), "start"};
+  CASE_EXPECT_EQ(0, libatapp_c_init(context, 4, args, nullptr));
+
+  uint64_t self_id = libatapp_c_get_id(context);
+  libatapp_c_send_message_t messages[3];
+  fill_send_message(messages[0], LIBATAPP_C_MESSAGE_TARGET_BY_ID, kCBindingTestMessageTypeById, self_id, nullptr,
+                    "by id");
+  fill_send_message(messages[1], LIBATAPP_C_MESSAGE_TARGET_BY_NAME, kCBindingTestMessageTypeByName, 0, "unit-test-0",
+                    "by name");
+  fill_send_message(messages[2], LIBATAPP_C_MESSAGE_TARGET_BY_NAME, kCBindingTestMessageTypeByName, 0,
+                    "unit-test-not-found", "not found");
+  CASE_EXPECT_EQ(2, libatapp_c_send_many(context, messages, 3));
+  CASE_EXPECT_GE(messages[0].result, 0);
+  CASE_EXPECT_GE(messages[1].result, 0);
+  CASE_EXPECT_LT(messages[2].result, 0);
+
+  const char *name_only_data = "by name only";
+  CASE_EXPECT_EQ(0, libatapp_c_send_message_by_name(context, "unit-test-0", strlen("unit-test-0"),
+                                                    kCBindingTestMessageTypeByNameOnly, name_only_data,
+                                                    strlen(name_only_data), nullptr));
+
+  auto end_time = atfw::util::time::time_utility::sys_now() + std::chrono::seconds(3);
+  while (state.types.size() < 3 && atfw::util::time::time_utility::sys_now() < end_time) {
+    libatapp_c_run_noblock(context, 20000);
+    atfw::util::time::time_utility::update();
+  }
+
+  CASE_EXPECT_EQ(3, state.types.size());
+  // max_batch_size is 2, so 3 messages are delivered by at least 2 callbacks
+  CASE_EXPECT_GE(state.callback_count, 2);
+  CASE_EXPECT_LE(state.max_batch_count, 2);
+  for (size_t i = 0; i < state.types.size(); ++i) {
+    CASE_EXPECT_EQ("unit-test-0", state.source_names[i]);
+    if (kCBindingTestMessageTypeById == state.types[i]) {
+      CASE_EXPECT_EQ("by id", state.data[i]);
+    } else if (kCBindingTestMessageTypeByName == state.types[i]) {
+      CASE_EXPECT_EQ("by name", state.data[i]);
+    } else {
+      CASE_EXPECT_EQ(kCBindingTestMessageTypeByNameOnly, state.types[i]);
+      CASE_EXPECT_EQ(std::string(name_only_data), state.data[i]);
+    }
+  }
+
+  // Nothing is pending now
+  CASE_EXPECT_EQ(0, libatapp_c_flush_msg_batch(context));
+
+  libatapp_c_destroy(context);
+}
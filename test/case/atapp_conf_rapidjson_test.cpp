@@ -0,0 +1,123 @@
+// Copyright 2026 atframework
+// rapidjson loader unit tests
+
+#include <atframe/atapp_conf.h>
+#include <atframe/atapp_conf_rapidjson.h>
+
+#include <string/tquerystring.h>
+
+#include <string>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+CASE_TEST(atapp_conf_rapidjson, parse_on_arena) {
+  atapp::protocol::atapp_discovery discovery;
+  discovery.set_id(0x12345678);
+  discovery.set_name("arena-node");
+  discovery.set_identity("arena-identity");
+  discovery.add_listen("ipv4://127.0.0.1:16000");
+  discovery.add_listen("ipv6://::1:16001");
+  (*discovery.mutable_metadata()->mutable_labels())["deployment.environment"] = "test";
+  std::string json = atapp::rapidjson_loader_stringify(discovery);
+
+  // Parse stack also use the shared buffer, result should be the same as before
+  atapp::protocol::atapp_discovery heap_node;
+  CASE_EXPECT_TRUE(atapp::rapidjson_loader_parse(heap_node, json));
+  CASE_EXPECT_EQ(discovery.id(), heap_node.id());
+  CASE_EXPECT_EQ(discovery.name(), heap_node.name());
+  CASE_EXPECT_EQ(2, heap_node.listen_size());
+  CASE_EXPECT_EQ("test", heap_node.metadata().labels().at("deployment.environment"));
+
+  {
+    atapp::rapidjson_loader_arena_scope outer_scope;
+    atapp::protocol::atapp_discovery *outer_node =
+        atapp::rapidjson_loader_parse_on_arena<atapp::protocol::atapp_discovery>(outer_scope.get_arena(), json);
+    CASE_EXPECT_TRUE(nullptr != outer_node);
+    if (nullptr == outer_node) {
+      return;
+    }
+    CASE_EXPECT_TRUE(&outer_scope.get_arena() == outer_node->GetArena());
+
+    {
+      // Nested scope share the same arena and do not release messages of outer scope
+      atapp::rapidjson_loader_arena_scope inner_scope;
+      CASE_EXPECT_TRUE(&outer_scope.get_arena() == &inner_scope.get_arena());
+      CASE_EXPECT_TRUE(nullptr == atapp::rapidjson_loader_parse_on_arena<atapp::protocol::atapp_discovery>(
+                                      inner_scope.get_arena(), "not json"));
+    }
+
+    CASE_EXPECT_EQ(discovery.identity(), outer_node->identity());
+    CASE_EXPECT_EQ(2, outer_node->listen_size());
+    CASE_EXPECT_EQ("test", outer_node->metadata().labels().at("deployment.environment"));
+  }
+
+  // Arena is reset and reused by next scope
+  for (int i = 0; i < 64; ++i) {
+    atapp::rapidjson_loader_arena_scope scope;
+    atapp::protocol::atapp_discovery *node = scope.create<atapp::protocol::atapp_discovery>();
+    CASE_EXPECT_TRUE(atapp::rapidjson_loader_parse(*node, json));
+    CASE_EXPECT_EQ(discovery.id(), node->id());
+  }
+}
+
+CASE_TEST(atapp_conf_rapidjson, uri_string_mode) {
+  // Cover both vectorized blocks and tails, result must be the same as escaping functions
+  std::vector<std::string> inputs;
+  inputs.push_back("");
+  inputs.push_back("benchmark-node-0123456789_ABC.xyz~");
+  inputs.push_back("ipv4://10.0.0.1:16000/path?query=1&other=a+b#fragment");
+  inputs.push_back(std::string(40, 'a') + "%2F" + std::string(17, 'Z') + " space");
+  inputs.push_back("0123456789abcdef0123456789ABCDEF%");
+  std::string all_bytes;
+  for (int i = 1; i < 256; ++i) {
+    all_bytes.push_back(static_cast<char>(i));
+  }
+  inputs.push_back(all_bytes);
+  for (size_t i = 0; i < 48; ++i) {
+    inputs.push_back(std::string(i, 'x') + "/" + std::string(48 - i, '-'));
+  }
+
+  atapp::rapidjson_loader_string_mode modes[] = {atapp::rapidjson_loader_string_mode::kUri,
+                                          atapp::rapidjson_loader_string_mode::kUriComponent};
+  for (auto mode : modes) {
+    atapp::protocol::atapp_discovery discovery;
+    for (auto &input : inputs) {
+      discovery.add_listen(input);
+    }
+
+    atapp::rapidjson_loader_load_options load_options;
+    load_options.string_mode = mode;
+    rapidjson::Document doc;
+    atapp::rapidjson_loader_load_from(doc, discovery, load_options);
+    CASE_EXPECT_TRUE(doc.IsObject() && doc.HasMember("listen") && doc["listen"].IsArray());
+    if (!doc.IsObject() || !doc.HasMember("listen") || !doc["listen"].IsArray()) {
+      continue;
+    }
+
+    const rapidjson::Value &listen = doc["listen"];
+    CASE_EXPECT_EQ(inputs.size(), static_cast<size_t>(listen.Size()));
+    for (rapidjson::SizeType i = 0; i < listen.Size() && i < inputs.size(); ++i) {
+      std::string expect = atapp::rapidjson_loader_string_mode::kUri == mode
+                               ? atfw::util::uri::encode_uri(inputs[i].c_str(), inputs[i].size())
+                               : atfw::util::uri::encode_uri_component(inputs[i].c_str(), inputs[i].size());
+      CASE_EXPECT_EQ(expect, std::string(listen[i].GetString(), listen[i].GetStringLength()));
+    }
+
+    // Unescape raw inputs directly, which also contain '%' and '+'
+    rapidjson::Document raw_doc;
+    atapp::rapidjson_loader_load_from(raw_doc, discovery, atapp::rapidjson_loader_load_options());
+    atapp::rapidjson_loader_dump_options dump_options;
+    dump_options.string_mode = mode;
+    atapp::protocol::atapp_discovery output;
+    atapp::rapidjson_loader_dump_to(raw_doc, output, dump_options);
+    CASE_EXPECT_EQ(discovery.listen_size(), output.listen_size());
+    for (int i = 0; i < output.listen_size() && i < discovery.listen_size(); ++i) {
+      const std::string &input = discovery.listen(i);
+      std::string expect = atapp::rapidjson_loader_string_mode::kUri == mode
+                               ? atfw::util::uri::decode_uri(input.c_str(), input.size())
+                               : atfw::util::uri::decode_uri_component(input.c_str(), input.size());
+      CASE_EXPECT_EQ(expect, output.listen(i));
+    }
+  }
+}
@@ -4,12 +4,14 @@
 
 #include <common/file_system.h>
 
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -326,6 +328,193 @@ CASE_TEST(atapp_configure, load_environment) {
   }
 }
 
+CASE_TEST(atapp_configure, load_yaml_repeated) {
+  atframework::atapp::app app;
+  std::string conf_path;
+  atfw::util::file_system::dirname(__FILE__, 0, conf_path);
+  conf_path += "/atapp_configure_loader_test.yaml";
+
+  if (!atfw::util::file_system::is_exist(conf_path.c_str())) {
+    CASE_MSG_INFO() << CASE_MSG_FCOLOR(YELLOW) << conf_path << " not found, skip atapp_configure.load_yaml_repeated"
+                    << '\n';
+    return;
+  }
+
+  const char *argv[] = {"unit-test", "-c", &conf_path[0], "--version"};
+  app.init(nullptr, 4, argv);
+  app.reload();
+
+  // The second pass hits the cached per-descriptor configure metadata and must produce the same result
+  atapp::configure_key_set existed_keys_1;
+  atapp::configure_key_set existed_keys_2;
+  atapp::protocol::atapp_configure app_cfg_1;
+  atapp::protocol::atapp_configure app_cfg_2;
+  app.parse_configures_into(app_cfg_1, "atapp", "", &existed_keys_1);
+  app.parse_configures_into(app_cfg_2, "atapp", "", &existed_keys_2);
+
+  CASE_EXPECT_TRUE(atapp::protobuf_equal(app_cfg_1, app_cfg_2));
+  CASE_EXPECT_EQ(existed_keys_1.size(), existed_keys_2.size());
+
+  app.reload();
+  atapp::protocol::atapp_configure app_cfg_3;
+  app.parse_configures_into(app_cfg_3, "atapp", "");
+  CASE_EXPECT_TRUE(atapp::protobuf_equal(app_cfg_1, app_cfg_3));
+
+  WLOG_GETCAT(0)->clear_sinks();
+  WLOG_GETCAT(1)->clear_sinks();
+}
+
+CASE_TEST(atapp_configure, configure_snapshot) {
+  atframework::atapp::app app;
+  std::string conf_path;
+  atfw::util::file_system::dirname(__FILE__, 0, conf_path);
+  conf_path += "/atapp_configure_loader_test.yaml";
+
+  if (!atfw::util::file_system::is_exist(conf_path.c_str())) {
+    CASE_MSG_INFO() << CASE_MSG_FCOLOR(YELLOW) << conf_path << " not found, skip atapp_configure.configure_snapshot"
+                    << '\n';
+    return;
+  }
+
+  const char *argv[] = {"unit-test", "-c", &conf_path[0], "--version"};
+  app.init(nullptr, 4, argv);
+  app.reload();
+
+  atapp::configure_snapshot::ptr_t snapshot = app.get_configure_snapshot();
+  CASE_EXPECT_TRUE(!!snapshot);
+  if (!snapshot) {
+    return;
+  }
+  CASE_EXPECT_EQ(app.get_configure_generation(), snapshot->get_generation());
+  // Snapshot is reused before reload
+  CASE_EXPECT_EQ(snapshot.get(), app.get_configure_snapshot().get());
+
+  const atapp::configure_snapshot::value_list_t *values = snapshot->find("atapp.bus.listen");
+  CASE_EXPECT_TRUE(nullptr != values);
+  if (nullptr != values) {
+    CASE_EXPECT_EQ(1, values->size());
+    CASE_EXPECT_EQ("atcp://:::21437", values->front());
+  }
+  values = snapshot->find("atapp.bus.ping_interval");
+  CASE_EXPECT_TRUE(nullptr != values);
+  if (nullptr != values) {
+    CASE_EXPECT_EQ("60s", values->front());
+  }
+  // Default values of origin configure are also available
+  CASE_EXPECT_TRUE(nullptr != snapshot->find("atapp.bus.send_buffer_number"));
+  CASE_EXPECT_TRUE(nullptr == snapshot->find("atapp.bus.not_exists"));
+
+  // Old snapshot keeps valid after reload
+  app.reload();
+  atapp::configure_snapshot::ptr_t new_snapshot = app.get_configure_snapshot();
+  CASE_EXPECT_NE(snapshot.get(), new_snapshot.get());
+  CASE_EXPECT_EQ(snapshot->get_generation() + 1, new_snapshot->get_generation());
+  CASE_EXPECT_EQ(snapshot->size(), new_snapshot->size());
+  CASE_EXPECT_TRUE(nullptr != snapshot->find("atapp.bus.listen"));
+
+  // Custom sections, arrays are stored in the same path and later sources replace former ones
+  atapp::configure_snapshot custom{1};
+  custom.append(YAML::Load("custom:\n  hosts: [a, b]\n  nodes:\n    - { id: 1 }\n    - { id: 2 }\n"), "");
+  custom.append(YAML::Load("custom:\n  hosts: [c]\n"), "");
+  values = custom.find("custom.hosts");
+  CASE_EXPECT_TRUE(nullptr != values);
+  if (nullptr != values) {
+    CASE_EXPECT_EQ(1, values->size());
+    CASE_EXPECT_EQ("c", values->front());
+  }
+  values = custom.find("custom.nodes.1.id");
+  CASE_EXPECT_TRUE(nullptr != values);
+  if (nullptr != values) {
+    CASE_EXPECT_EQ("2", values->front());
+  }
+
+  WLOG_GETCAT(0)->clear_sinks();
+  WLOG_GETCAT(1)->clear_sinks();
+}
+
+// Snapshot is published by reload(), readers in other threads never see a partial loaded configure
+CASE_TEST(atapp_configure, configure_snapshot_concurrent_reload) {
+  atframework::atapp::app app;
+  std::string conf_path;
+  atfw::util::file_system::dirname(__FILE__, 0, conf_path);
+  conf_path += "/atapp_configure_loader_test.yaml";
+
+  if (!atfw::util::file_system::is_exist(conf_path.c_str())) {
+    CASE_MSG_INFO() << CASE_MSG_FCOLOR(YELLOW) << conf_path
+                    << " not found, skip atapp_configure.configure_snapshot_concurrent_reload" << '\n';
+    return;
+  }
+
+  const char *argv[] = {"unit-test", "-c", &conf_path[0], "--version"};
+  app.init(nullptr, 4, argv);
+  app.reload();
+
+  uint64_t start_generation = app.get_configure_generation();
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> missing_count{0};
+  std::atomic<size_t> rollback_count{0};
+  std::thread reader([&app, &stop, &missing_count, &rollback_count]() {
+    uint64_t last_generation = 0;
+    while (!stop.load(std::memory_order_acquire)) {
+      atapp::configure_snapshot::ptr_t snapshot = app.get_configure_snapshot();
+      if (!snapshot || nullptr == snapshot->find("atapp.bus.listen")) {
+        ++missing_count;
+        continue;
+      }
+      if (snapshot->get_generation() < last_generation) {
+        ++rollback_count;
+      }
+      last_generation = snapshot->get_generation();
+    }
+  });
+
+  for (int i = 0; i < 8; ++i) {
+    app.reload();
+  }
+  stop.store(true, std::memory_order_release);
+  reader.join();
+
+  CASE_EXPECT_EQ(0, missing_count.load());
+  CASE_EXPECT_EQ(0, rollback_count.load());
+  CASE_EXPECT_EQ(start_generation + 8, app.get_configure_generation());
+  CASE_EXPECT_EQ(app.get_configure_generation(), app.get_configure_snapshot()->get_generation());
+
+  WLOG_GETCAT(0)->clear_sinks();
+  WLOG_GETCAT(1)->clear_sinks();
+}
+
+CASE_TEST(atapp_configure, protobuf_diff) {
+  atapp::protocol::atapp_configure l;
+  atapp::protocol::atapp_configure r;
+  l.set_name("diff-app");
+  r.set_name("diff-app");
+  l.mutable_etcd()->add_hosts("http://127.0.0.1:2379");
+  r.mutable_etcd()->add_hosts("http://127.0.0.1:2379");
+  l.mutable_worker_pool()->mutable_tick_max_interval()->set_seconds(1);
+  r.mutable_worker_pool()->mutable_tick_max_interval()->set_seconds(1);
+
+  atapp::configure_key_set changed_paths;
+  CASE_EXPECT_FALSE(atapp::protobuf_diff(l, r, changed_paths));
+  CASE_EXPECT_TRUE(changed_paths.empty());
+
+  r.mutable_etcd()->mutable_init()->mutable_tick_interval()->set_seconds(3);
+  r.set_hostname("diff-host");
+  CASE_EXPECT_TRUE(atapp::protobuf_diff(l, r, changed_paths));
+
+  CASE_EXPECT_TRUE(changed_paths.end() != changed_paths.find("hostname"));
+  CASE_EXPECT_TRUE(changed_paths.end() != changed_paths.find("etcd"));
+  CASE_EXPECT_TRUE(changed_paths.end() != changed_paths.find("etcd.init"));
+  CASE_EXPECT_TRUE(changed_paths.end() != changed_paths.find("etcd.init.tick_interval"));
+  CASE_EXPECT_TRUE(changed_paths.end() == changed_paths.find("etcd.hosts"));
+  CASE_EXPECT_TRUE(changed_paths.end() == changed_paths.find("worker_pool"));
+  CASE_EXPECT_TRUE(changed_paths.end() == changed_paths.find("name"));
+
+  changed_paths.clear();
+  CASE_EXPECT_TRUE(atapp::protobuf_diff(l.etcd(), r.etcd(), changed_paths, "etcd"));
+  CASE_EXPECT_TRUE(changed_paths.end() != changed_paths.find("etcd.init"));
+  CASE_EXPECT_TRUE(changed_paths.end() == changed_paths.find("etcd"));
+}
+
 // =============================================================================
 // Expression expansion tests
 // =============================================================================
@@ -535,6 +724,43 @@ CASE_TEST(atapp_configure, expression_expand_direct) {
   unsetenv("area.region");
 }
 
+// Expanded results are cached per environment generation and must be refreshed after the environment changes
+CASE_TEST(atapp_configure, expression_cache_generation) {
+  setenv("ATAPP_EXPR_CACHE_VALUE", "v1", 1);
+  unsetenv("ATAPP_EXPR_CACHE_UNSET");
+
+  uint64_t generation = atapp::refresh_environment_expression_generation();
+  CASE_EXPECT_EQ(generation, atapp::refresh_environment_expression_generation());
+
+  CASE_EXPECT_EQ("prefix-v1-suffix", atapp::expand_environment_expression("prefix-${ATAPP_EXPR_CACHE_VALUE}-suffix"));
+  CASE_EXPECT_EQ("prefix-v1-suffix", atapp::expand_environment_expression("prefix-${ATAPP_EXPR_CACHE_VALUE}-suffix"));
+  CASE_EXPECT_EQ("fallback", atapp::expand_environment_expression("${ATAPP_EXPR_CACHE_UNSET:-fallback}"));
+  CASE_EXPECT_EQ("literal \\ only", atapp::expand_environment_expression("literal \\ only"));
+
+  // Unchanged environment keeps the generation
+  CASE_EXPECT_EQ(generation, atapp::refresh_environment_expression_generation());
+
+  setenv("ATAPP_EXPR_CACHE_VALUE", "v2", 1);
+  setenv("ATAPP_EXPR_CACHE_UNSET", "now_set", 1);
+  CASE_EXPECT_NE(generation, atapp::refresh_environment_expression_generation());
+  CASE_EXPECT_EQ("prefix-v2-suffix", atapp::expand_environment_expression("prefix-${ATAPP_EXPR_CACHE_VALUE}-suffix"));
+  CASE_EXPECT_EQ("now_set", atapp::expand_environment_expression("${ATAPP_EXPR_CACHE_UNSET:-fallback}"));
+
+  // Many generated fields templated off the same variables
+  size_t mismatch_count = 0;
+  for (int i = 0; i < 5000; ++i) {
+    std::string input = atfw::util::log::format("${{ATAPP_EXPR_CACHE_VALUE}}-field-{}-${{ATAPP_EXPR_CACHE_UNSET:+x}}", i);
+    std::string expect = atfw::util::log::format("v2-field-{}-x", i);
+    if (expect != atapp::expand_environment_expression(input)) {
+      ++mismatch_count;
+    }
+  }
+  CASE_EXPECT_EQ(0, mismatch_count);
+
+  unsetenv("ATAPP_EXPR_CACHE_VALUE");
+  unsetenv("ATAPP_EXPR_CACHE_UNSET");
+}
+
 // Test expression expansion via YAML config loading path
 CASE_TEST(atapp_configure, expression_yaml) {
   atframework::atapp::app app;
@@ -0,0 +1,124 @@
+// Copyright 2026 atframework
+// Discovery cache tests against the in-process fake etcd gateway (no etcd service required)
+
+#include <atframe/atapp.h>
+#include <atframe/modules/service_discovery_module.h>
+
+#include <common/file_system.h>
+#include <time/time_utility.h>
+
+#include <uv.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "atapp_etcd_fake_gateway.h"
+#include "frame/test_macros.h"
+
+#if defined(_WIN32)
+inline int setenv(const char *name, const char *value, int) { return _putenv_s(name, value); }
+inline int unsetenv(const char *name) { return _putenv_s(name, ""); }
+#endif
+
+namespace {
+
+static constexpr const uint64_t kDiscoveryCachePeerId = 51;
+static constexpr const char *kDiscoveryCachePeerKey = "/atapp/unit-test/discovery_cache/by_id/discovery-cache-peer-51";
+static constexpr const char *kDiscoveryCachePeerValue =
+    "{\"id\":\"51\",\"name\":\"discovery-cache-peer\",\"listen\":[\"ipv4://127.0.0.1:22503\"]}";
+
+template <typename CondFn>
+static bool run_app_until(atframework::atapp::app &app, CondFn &&cond,
+                          std::chrono::seconds timeout_sec = std::chrono::seconds(15)) {
+  auto end_time = atfw::util::time::time_utility::sys_now() + timeout_sec;
+  while (!cond() && atfw::util::time::time_utility::sys_now() < end_time) {
+    app.run_noblock();
+    atfw::util::time::time_utility::update();
+  }
+
+  return cond();
+}
+
+static bool has_peer(const std::shared_ptr<atframework::atapp::service_discovery_module> &discovery_module) {
+  return !!discovery_module->get_global_discovery().get_node_by_id(kDiscoveryCachePeerId);
+}
+
+}  // namespace
+
+CASE_TEST(atapp_discovery_cache, save_load_and_reconcile) {
+  std::string conf_path_base;
+  atfw::util::file_system::dirname(__FILE__, 0, conf_path_base);
+  std::string conf_path = conf_path_base + "/atapp_test_discovery_cache.yaml";
+  if (!atfw::util::file_system::is_exist(conf_path.c_str())) {
+    CASE_MSG_INFO() << CASE_MSG_FCOLOR(YELLOW) << conf_path << " not found, skip this test" << '\n';
+    return;
+  }
+
+  atframework::atapp::test::etcd_fake_gateway gateway(uv_default_loop());
+  std::string url = gateway.listen();
+  CASE_EXPECT_FALSE(url.empty());
+  if (url.empty()) {
+    return;
+  }
+
+  std::string cache_path = "atapp_discovery_cache_test.bin";
+  std::remove(cache_path.c_str());
+  setenv("ATAPP_UNIT_TEST_DISCOVERY_CACHE_ETCD_HOST", url.c_str(), 1);
+  setenv("ATAPP_UNIT_TEST_DISCOVERY_CACHE_PATH", cache_path.c_str(), 1);
+  gateway.put(kDiscoveryCachePeerKey, kDiscoveryCachePeerValue);
+
+  const char *args[] = {"app", "-c", conf_path.c_str(), "start"};
+
+  // Save the discovery set loaded from etcd
+  {
+    atframework::atapp::app app;
+    CASE_EXPECT_EQ(0, app.init(nullptr, 4, args, nullptr));
+    auto discovery_module = app.get_service_discovery_module();
+    CASE_EXPECT_TRUE(!!discovery_module);
+    if (!discovery_module) {
+      return;
+    }
+
+    CASE_EXPECT_TRUE(run_app_until(app, [&discovery_module]() {
+      return discovery_module->has_discovery_snapshot() && has_peer(discovery_module);
+    }));
+    CASE_EXPECT_FALSE(discovery_module->is_discovery_cache_stale());
+    CASE_EXPECT_EQ(0, discovery_module->save_discovery_cache(cache_path, false));
+    CASE_EXPECT_TRUE(atfw::util::file_system::is_exist(cache_path.c_str()));
+  }
+
+  // The peer is removed when this app is offline, and etcd is slow when restarting
+  gateway.remove(kDiscoveryCachePeerKey);
+  gateway.set_response_delay(std::chrono::milliseconds(1500));
+
+  // Init continues from the cache without waiting for etcd, and the stale data is reconciled by snapshot of etcd
+  {
+    atframework::atapp::app app;
+    CASE_EXPECT_EQ(0, app.init(nullptr, 4, args, nullptr));
+    auto discovery_module = app.get_service_discovery_module();
+    CASE_EXPECT_TRUE(!!discovery_module);
+    if (!discovery_module) {
+      return;
+    }
+
+    CASE_EXPECT_FALSE(discovery_module->has_discovery_snapshot());
+    CASE_EXPECT_TRUE(discovery_module->is_discovery_cache_stale());
+    CASE_EXPECT_TRUE(has_peer(discovery_module));
+
+    CASE_EXPECT_TRUE(
+        run_app_until(app, [&discovery_module]() { return !discovery_module->is_discovery_cache_stale(); }));
+    CASE_EXPECT_TRUE(discovery_module->has_discovery_snapshot());
+    CASE_EXPECT_FALSE(has_peer(discovery_module));
+  }
+
+  gateway.set_response_delay(std::chrono::milliseconds(0));
+  gateway.close();
+  uv_run(uv_default_loop(), UV_RUN_NOWAIT);
+
+  unsetenv("ATAPP_UNIT_TEST_DISCOVERY_CACHE_ETCD_HOST");
+  unsetenv("ATAPP_UNIT_TEST_DISCOVERY_CACHE_PATH");
+  std::remove(cache_path.c_str());
+}
@@ -735,3 +735,92 @@ CASE_TEST(atapp_discovery_reconnect, reconnect_timer_skip_if_later) {
   atframework::atapp::app::set_sys_now(atfw::util::time::time_utility::sys_now());
 #endif
 }
+
+// ============================================================
+// E.6: reconnect_scheduler_bucket
+// Reconnect timeouts are rounded into scheduler buckets, one wakeup of a bucket
+// starts the reconnect and the scheduler stats are updated.
+// ============================================================
+CASE_TEST(atapp_discovery_reconnect, reconnect_scheduler_bucket) {
+#if defined(NDEBUG)
+  CASE_MSG_INFO() << CASE_MSG_FCOLOR(YELLOW) << "set_sys_now() only available in Debug builds, skip" << '\n';
+  return;
+#else
+  reset_disc_test_context();
+
+  std::string conf1 = get_disc_test_conf_path("atapp_test_discovery_1.yaml");
+  std::string conf2 = get_disc_test_conf_path("atapp_test_discovery_2.yaml");
+  std::string conf3 = get_disc_test_conf_path("atapp_test_discovery_3.yaml");
+
+  if (check_disc_and_skip_if_missing(conf1)) return;
+  if (check_disc_and_skip_if_missing(conf2)) return;
+  if (check_disc_and_skip_if_missing(conf3)) return;
+
+  atframework::atapp::app node1;
+  atframework::atapp::app node2;
+  atframework::atapp::app upstream;
+
+  const char *args3[] = {"upstream", "-c", conf3.c_str(), "start"};
+  CASE_EXPECT_EQ(0, upstream.init(nullptr, 4, args3, nullptr));
+  const char *args1[] = {"node1", "-c", conf1.c_str(), "start"};
+  CASE_EXPECT_EQ(0, node1.init(nullptr, 4, args1, nullptr));
+  const char *args2[] = {"node2", "-c", conf2.c_str(), "start"};
+  CASE_EXPECT_EQ(0, node2.init(nullptr, 4, args2, nullptr));
+
+  pump_apps_until(
+      [&]() {
+        auto b1 = node1.get_bus_node();
+        auto b2 = node2.get_bus_node();
+        return b1 && b1->get_upstream_endpoint() != nullptr && b2 && b2->get_upstream_endpoint() != nullptr;
+      },
+      std::chrono::seconds(8), upstream, node1, node2);
+
+  atfw::util::memory::strong_rc_ptr<atapp::etcd_discovery_node> n1_disc, n2_disc, up_disc;
+  setup_discovery_test_env(node1, node2, upstream, n1_disc, n2_disc, up_disc);
+
+  pump_apps_until(
+      [&]() {
+        auto *ep = node1.get_endpoint(node2.get_app_id());
+        return ep != nullptr && ep->get_ready_connection_handle() != nullptr;
+      },
+      std::chrono::seconds(8), upstream, node1, node2);
+
+  auto n1_conn = node1.get_atbus_connector();
+  CASE_EXPECT_TRUE(n1_conn != nullptr);
+  if (!n1_conn) return;
+
+  auto stats_before = n1_conn->get_reconnect_scheduler_stats();
+
+  n1_conn->set_handle_unready_by_bus_id(node2.get_app_id());
+  node1.tick();
+
+  auto dbg = n1_conn->get_connection_handle_debug_info(node2.get_app_id());
+  CASE_EXPECT_TRUE(dbg.exists);
+  CASE_EXPECT_FALSE(dbg.timer_handle_expired);
+  CASE_EXPECT_NE(std::chrono::system_clock::from_time_t(0), dbg.pending_timer_timeout);
+  // Default reconnect_bucket_interval is 32ms
+  CASE_EXPECT_EQ(0, std::chrono::duration_cast<std::chrono::microseconds>(dbg.pending_timer_timeout.time_since_epoch())
+                            .count() %
+                        32000);
+  CASE_EXPECT_GE(dbg.pending_timer_timeout, dbg.reconnect_next_timepoint);
+
+  auto stats_pending = n1_conn->get_reconnect_scheduler_stats();
+  CASE_EXPECT_GE(stats_pending.pending_buckets, static_cast<size_t>(1));
+  CASE_EXPECT_GE(stats_pending.pending_handles, static_cast<size_t>(1));
+
+  // Wakeup the bucket
+  atframework::atapp::app::set_sys_now(dbg.pending_timer_timeout + std::chrono::milliseconds(100));
+  node1.tick();
+
+  auto stats_after = n1_conn->get_reconnect_scheduler_stats();
+  CASE_EXPECT_GT(stats_after.wakeup_times, stats_before.wakeup_times);
+  CASE_EXPECT_GT(stats_after.reconnect_started, stats_before.reconnect_started);
+  CASE_EXPECT_EQ(stats_before.reconnect_deferred, stats_after.reconnect_deferred);
+  CASE_MSG_INFO() << "E.6: wakeup_times=" << stats_after.wakeup_times
+                  << ", reconnect_started=" << stats_after.reconnect_started
+                  << ", max_bucket_handles=" << stats_after.max_bucket_handles << '\n';
+
+  // Restore system time
+  atframework::atapp::app::set_sys_now(atfw::util::time::time_utility::sys_now());
+#endif
+}
@@ -604,6 +604,128 @@ CASE_TEST(atapp_discovery, discovery_node_ingress_round_robin) {
   CASE_EXPECT_EQ("ipv6://[::1]:9000", ingress.address());
 }
 
+// Hot data and interned blocks shared by nodes with the same metadata and listen addresses
+CASE_TEST(atapp_discovery, discovery_node_shared_blocks) {
+  atapp::etcd_discovery_node::node_version fake_version;
+  fake_version.create_revision = 1;
+  fake_version.modify_revision = 1;
+  fake_version.version = 1;
+
+  std::vector<atapp::etcd_discovery_node::ptr_t> nodes;
+  for (uint64_t i = 0; i < 4; ++i) {
+    auto node = atfw::util::memory::make_strong_rc<atapp::etcd_discovery_node>();
+    atapp::protocol::atapp_discovery fake_info;
+    fake_info.set_id(400 + i);
+    fake_info.set_name(atfw::util::string::format("shared-node-{}", i));
+    fake_info.set_type_id(7);
+    fake_info.mutable_area()->set_zone_id(3);
+    fake_info.mutable_runtime()->set_stateful_pod_index(static_cast<int32_t>(i));
+    fake_info.add_listen("ipv4://127.0.0.1:9400");
+    fake_info.mutable_metadata()->set_namespace_name("shared-ns");
+    (*fake_info.mutable_metadata()->mutable_labels())["deployment.environment"] = i < 2 ? "blue" : "green";
+    node->copy_from(fake_info, fake_version, 0);
+    nodes.push_back(node);
+  }
+
+  CASE_EXPECT_EQ(static_cast<uint64_t>(401), nodes[1]->get_hot_data().id);
+  CASE_EXPECT_EQ(static_cast<uint64_t>(7), nodes[1]->get_hot_data().type_id);
+  CASE_EXPECT_EQ(static_cast<uint64_t>(3), nodes[1]->get_hot_data().zone_id);
+  CASE_EXPECT_EQ(1, nodes[1]->get_hot_data().stateful_pod_index);
+  CASE_EXPECT_TRUE(nodes[1]->get_hot_data().name_hash == nodes[1]->get_name_hash());
+
+  // Same metadata share the same block, and the protobuf message is still complete
+  CASE_EXPECT_TRUE(!!nodes[0]->get_shared_metadata());
+  CASE_EXPECT_TRUE(nodes[0]->get_shared_metadata() == nodes[1]->get_shared_metadata());
+  CASE_EXPECT_TRUE(nodes[2]->get_shared_metadata() == nodes[3]->get_shared_metadata());
+  CASE_EXPECT_TRUE(nodes[0]->get_shared_metadata() != nodes[2]->get_shared_metadata());
+  CASE_EXPECT_EQ("shared-ns", nodes[3]->get_metadata().namespace_name());
+  CASE_EXPECT_EQ(&nodes[3]->get_metadata(), nodes[3]->get_shared_metadata().get());
+  // Shared blocks are never aliased into the protobuf message of the node
+  CASE_EXPECT_FALSE(nodes[3]->get_discovery_info().has_metadata());
+
+  // Gateways converted from the same listen address are shared
+  const atapp::protocol::atapp_gateway *gateway0 = &nodes[0]->next_ingress_gateway();
+  const atapp::protocol::atapp_gateway *gateway1 = &nodes[1]->next_ingress_gateway();
+  CASE_EXPECT_EQ(gateway0, gateway1);
+  CASE_EXPECT_EQ("ipv4://127.0.0.1:9400", gateway1->address());
+  CASE_EXPECT_GE(atapp::etcd_discovery_node::get_shared_block_count(), static_cast<size_t>(3));
+
+  // Filter by label still works with shared metadata
+  auto discovery_set = atfw::util::memory::make_strong_rc<atapp::etcd_discovery_set>();
+  for (auto &node : nodes) {
+    discovery_set->add_node(node);
+  }
+  atapp::etcd_discovery_set::metadata_type rule;
+  (*rule.mutable_labels())["deployment.environment"] = "green";
+  const auto &green_nodes = discovery_set->get_sorted_nodes(&rule);
+  CASE_EXPECT_EQ(static_cast<size_t>(2), green_nodes.size());
+  for (auto &node : green_nodes) {
+    CASE_EXPECT_TRUE(node->get_shared_metadata() == nodes[2]->get_shared_metadata());
+  }
+
+  // Node without metadata has no shared block
+  auto empty_node = atfw::util::memory::make_strong_rc<atapp::etcd_discovery_node>();
+  atapp::protocol::atapp_discovery empty_info;
+  empty_info.set_id(500);
+  empty_node->copy_from(empty_info, fake_version, 0);
+  CASE_EXPECT_FALSE(!!empty_node->get_shared_metadata());
+  CASE_EXPECT_EQ(0, empty_node->get_ingress_size());
+  CASE_EXPECT_TRUE(empty_node->next_ingress_gateway().address().empty());
+}
+
+// Gateways with the same rules are shared by nodes, and shared blocks are kept when one node is updated
+CASE_TEST(atapp_discovery, discovery_node_shared_gateways) {
+  atapp::etcd_discovery_node::node_version fake_version;
+  fake_version.create_revision = 1;
+  fake_version.modify_revision = 1;
+  fake_version.version = 1;
+
+  atapp::protocol::atapp_discovery fake_info;
+  fake_info.set_id(600);
+  fake_info.set_name("shared-gateway-node");
+  fake_info.mutable_metadata()->set_namespace_name("shared-gateway-ns");
+  for (int i = 0; i < 2; ++i) {
+    atapp::protocol::atapp_gateway *gateway = fake_info.add_gateways();
+    gateway->set_address(atfw::util::string::format("ipv4://10.0.0.{}:9600", i + 1));
+    gateway->add_match_namespaces("shared-gateway-ns");
+    (*gateway->mutable_match_labels())["deployment.environment"] = "production";
+  }
+
+  auto node1 = atfw::util::memory::make_strong_rc<atapp::etcd_discovery_node>();
+  auto node2 = atfw::util::memory::make_strong_rc<atapp::etcd_discovery_node>();
+  node1->copy_from(fake_info, fake_version, 0);
+  fake_info.set_id(601);
+  node2->copy_from(fake_info, fake_version, 0);
+
+  CASE_EXPECT_EQ(2, node1->get_ingress_size());
+  CASE_EXPECT_EQ(node1->get_gateways()[0].get(), node2->get_gateways()[0].get());
+  CASE_EXPECT_EQ(node1->get_gateways()[1].get(), node2->get_gateways()[1].get());
+  CASE_EXPECT_EQ(&node1->next_ingress_gateway(), &node2->next_ingress_gateway());
+
+  // Gateway with different rules is not shared
+  (*fake_info.mutable_gateways(0)->mutable_match_labels())["deployment.environment"] = "staging";
+  node2->copy_from(fake_info, fake_version, 0);
+  CASE_EXPECT_NE(node1->get_gateways()[0].get(), node2->get_gateways()[0].get());
+  CASE_EXPECT_EQ(node1->get_gateways()[1].get(), node2->get_gateways()[1].get());
+  CASE_EXPECT_EQ("staging", node2->get_gateways()[0]->match_labels().at("deployment.environment"));
+
+  // Updating node2 must not modify blocks still used by node1
+  CASE_EXPECT_EQ("production", node1->get_gateways()[0]->match_labels().at("deployment.environment"));
+  CASE_EXPECT_EQ("shared-gateway-ns", node1->get_metadata().namespace_name());
+
+  atapp::protocol::atapp_discovery output;
+  node1->copy_to(output);
+  CASE_EXPECT_EQ(2, output.gateways_size());
+  CASE_EXPECT_EQ("ipv4://10.0.0.2:9600", output.gateways(1).address());
+  CASE_EXPECT_EQ("shared-gateway-ns", output.metadata().namespace_name());
+  CASE_EXPECT_TRUE(node1->equal_to(output));
+  output.mutable_gateways(1)->set_address("ipv4://10.0.0.3:9600");
+  CASE_EXPECT_FALSE(node1->equal_to(output));
+
+  node2.reset();
+  CASE_EXPECT_EQ("ipv4://10.0.0.1:9600", node1->get_gateways()[0]->address());
+}
+
 // H.2.5 All query operations on empty set return nullptr/empty without crash
 CASE_TEST(atapp_discovery, discovery_empty_set_operations) {
   auto discovery_set = atfw::util::memory::make_strong_rc<atapp::etcd_discovery_set>();
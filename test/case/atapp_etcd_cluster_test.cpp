@@ -268,6 +268,19 @@ CASE_TEST(atapp_etcd_cluster, cluster_member_list_discovery) {
   // Selected host should be set
   CASE_EXPECT_FALSE(cluster.get_selected_host().empty());
   CASE_MSG_INFO() << "selected host: " << cluster.get_selected_host() << '\n';
+
+  // Requests to selected host should have been sampled for latency aware selection
+  CASE_EXPECT_TRUE(cluster.get_conf_etcd_members_latency_aware_select());
+  const auto *health = cluster.get_member_health(cluster.get_selected_host());
+  CASE_EXPECT_TRUE(nullptr != health);
+  if (nullptr != health) {
+    CASE_EXPECT_GT(health->sample_count, static_cast<size_t>(0));
+    CASE_EXPECT_GE(health->ewma_latency_us, 0.0);
+    CASE_EXPECT_LE(health->ewma_error_rate, 1.0);
+    CASE_MSG_INFO() << "selected host health: samples=" << health->sample_count
+                    << " ewma_latency_us=" << health->ewma_latency_us
+                    << " ewma_error_rate=" << health->ewma_error_rate << '\n';
+  }
 }
 
 // ============================================================
@@ -379,6 +392,33 @@ CASE_TEST(atapp_etcd_cluster, cluster_stats_tracking) {
 
   CASE_MSG_INFO() << "stats: create=" << stats.sum_create_requests << " success=" << stats.sum_success_requests
                   << " error=" << stats.sum_error_requests << '\n';
+
+  // Per request type stats
+  const auto &lease_grant_stats =
+      cluster.get_request_stats(atframework::atapp::etcd_cluster::request_type_t::kLeaseGrant);
+  CASE_EXPECT_GT(lease_grant_stats.sum_finished_requests, static_cast<size_t>(0));
+  CASE_EXPECT_EQ(lease_grant_stats.sum_finished_requests,
+                 lease_grant_stats.sum_new_connections + lease_grant_stats.sum_reused_connections);
+
+  size_t total_finished = 0;
+  for (size_t i = 0; i < static_cast<size_t>(atframework::atapp::etcd_cluster::request_type_t::kMax); ++i) {
+    const auto &type_stats = stats.requests_by_type[i];
+    size_t bucket_count = 0;
+    for (size_t j = 0; j < atframework::atapp::etcd_cluster::kRequestLatencyBucketCount; ++j) {
+      bucket_count += type_stats.latency_buckets[j];
+    }
+    CASE_EXPECT_EQ(type_stats.sum_finished_requests, bucket_count);
+    total_finished += type_stats.sum_finished_requests;
+
+    CASE_MSG_INFO() << "  "
+                    << atframework::atapp::etcd_cluster::get_request_type_name(
+                           static_cast<atframework::atapp::etcd_cluster::request_type_t>(i))
+                    << ": in_flight=" << type_stats.in_flight << " finished=" << type_stats.sum_finished_requests
+                    << " new_connections=" << type_stats.sum_new_connections
+                    << " reused_connections=" << type_stats.sum_reused_connections
+                    << " max_latency_us=" << type_stats.max_latency_us << '\n';
+  }
+  CASE_EXPECT_LE(total_finished, stats.sum_create_requests);
 }
 
 // ============================================================
@@ -0,0 +1,1456 @@
+// Copyright 2026 atframework
+
+#include "atapp_etcd_fake_gateway.h"
+
+#include <atframe/etcdcli/etcd_packer.h>
+
+#include <config/compiler/template_prefix.h>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <config/compiler/template_suffix.h>
+
+#include <common/string_oprs.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+namespace atframework {
+namespace atapp {
+namespace test {
+
+// Max size of http request header and body
+#define ETCD_FAKE_GATEWAY_MAX_REQUEST_SIZE (64 * 1024 * 1024)
+#define ETCD_FAKE_GATEWAY_CLUSTER_ID 0x61746170ULL
+#define ETCD_FAKE_GATEWAY_LEASE_TICK_MS 50
+
+// @see https://github.com/grpc/grpc/blob/master/doc/statuscodes.md
+#define ETCD_FAKE_GATEWAY_GRPC_INVALID_ARGUMENT 3
+#define ETCD_FAKE_GATEWAY_GRPC_NOT_FOUND 5
+#define ETCD_FAKE_GATEWAY_GRPC_ALREADY_EXISTS 6
+#define ETCD_FAKE_GATEWAY_GRPC_UNAVAILABLE 14
+
+struct etcd_fake_gateway::listener_t {
+  uv_tcp_t handle;
+  etcd_fake_gateway *owner;
+  size_t index;
+  std::string url;
+};
+
+struct etcd_fake_gateway::connection_t {
+  uv_tcp_t handle;
+  etcd_fake_gateway *owner;
+  uint64_t id;
+  size_t listener_index;
+  std::string url;
+  std::string recv_buffer;
+  bool closing;
+  bool is_stream;
+  bool continue_sent;
+};
+
+struct etcd_fake_gateway::delayed_write_t {
+  uv_timer_t timer;
+  etcd_fake_gateway *owner;
+  uint64_t connection_id;
+  std::string data;
+  bool close_after_write;
+};
+
+namespace {
+struct write_request_t {
+  uv_write_t req;
+  std::string data;
+  bool close_after_write;
+};
+
+static const char *get_http_status_text(int http_code) {
+  switch (http_code) {
+    case 200:
+      return "OK";
+    case 400:
+      return "Bad Request";
+    case 404:
+      return "Not Found";
+    case 405:
+      return "Method Not Allowed";
+    case 500:
+      return "Internal Server Error";
+    case 503:
+      return "Service Unavailable";
+    default:
+      return "Unknown";
+  }
+}
+
+static std::string to_json_string(const rapidjson::Value &val) {
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  val.Accept(writer);
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+static void add_string_member(rapidjson::Value &json_val, const char *key, const std::string &val,
+                              rapidjson::Document &doc) {
+  rapidjson::Value k;
+  rapidjson::Value v;
+  k.SetString(key, doc.GetAllocator());
+  v.SetString(val.c_str(), static_cast<rapidjson::SizeType>(val.size()), doc.GetAllocator());
+  json_val.AddMember(k, v, doc.GetAllocator());
+}
+
+// grpc-gateway encode 64-bit integers as strings
+static void add_int_member(rapidjson::Value &json_val, const char *key, int64_t val, rapidjson::Document &doc) {
+  add_string_member(json_val, key, std::to_string(val), doc);
+}
+
+static void pack_header(rapidjson::Value &json_val, rapidjson::Document &doc, size_t member_index, int64_t revision) {
+  rapidjson::Value header(rapidjson::kObjectType);
+  add_string_member(header, "cluster_id", std::to_string(ETCD_FAKE_GATEWAY_CLUSTER_ID), doc);
+  add_string_member(header, "member_id", std::to_string(member_index + 1), doc);
+  add_int_member(header, "revision", revision, doc);
+  add_string_member(header, "raft_term", "1", doc);
+  json_val.AddMember("header", header, doc.GetAllocator());
+}
+
+static int64_t unpack_json_int(const rapidjson::Value &json_val, const char *key) {
+  int64_t ret = 0;
+  atframework::atapp::etcd_packer::unpack_int(json_val, key, ret);
+  return ret;
+}
+
+static bool unpack_json_bool(const rapidjson::Value &json_val, const char *key) {
+  bool ret = false;
+  atframework::atapp::etcd_packer::unpack_bool(json_val, key, ret);
+  return ret;
+}
+
+static std::string unpack_json_base64(const rapidjson::Value &json_val, const char *key) {
+  std::string ret;
+  atframework::atapp::etcd_packer::unpack_base64(json_val, key, ret);
+  return ret;
+}
+
+// Enum fields of etcd can be names or numbers
+static int32_t unpack_json_enum(const rapidjson::Value &json_val, const char *key, const char *const *names,
+                                int32_t name_count) {
+  rapidjson::Value::ConstMemberIterator iter = json_val.FindMember(key);
+  if (iter == json_val.MemberEnd()) {
+    return 0;
+  }
+
+  if (iter->value.IsString()) {
+    for (int32_t i = 0; i < name_count; ++i) {
+      if (0 == UTIL_STRFUNC_STRCASE_CMP(names[i], iter->value.GetString())) {
+        return i;
+      }
+    }
+  }
+
+  return static_cast<int32_t>(unpack_json_int(json_val, key));
+}
+}  // namespace
+
+etcd_fake_gateway::etcd_fake_gateway(uv_loop_t *loop)
+    : loop_(loop),
+      closing_(false),
+      lease_timer_(nullptr),
+      connection_id_allocator_(0),
+      default_delay_(std::chrono::milliseconds::zero()),
+      revision_(1),
+      compact_revision_(0),
+      lease_id_allocator_(0x10000),
+      watch_id_allocator_(0),
+      max_history_(100000) {
+  memset(&stats_, 0, sizeof(stats_));
+}
+
+etcd_fake_gateway::~etcd_fake_gateway() { close(); }
+
+std::string etcd_fake_gateway::listen(const std::string &host, int port) {
+  if (nullptr == loop_ || closing_) {
+    return std::string();
+  }
+
+  listener_t *listener = new listener_t();
+  listener->owner = this;
+  listener->index = listeners_.size();
+  uv_tcp_init(loop_, &listener->handle);
+  listener->handle.data = listener;
+
+  bool is_ipv6 = std::string::npos != host.find(':');
+  sockaddr_storage addr;
+  memset(&addr, 0, sizeof(addr));
+  int res;
+  if (is_ipv6) {
+    res = uv_ip6_addr(host.c_str(), port, reinterpret_cast<sockaddr_in6 *>(&addr));
+  } else {
+    res = uv_ip4_addr(host.c_str(), port, reinterpret_cast<sockaddr_in *>(&addr));
+  }
+  if (0 == res) {
+    res = uv_tcp_bind(&listener->handle, reinterpret_cast<const sockaddr *>(&addr), 0);
+  }
+  if (0 == res) {
+    res = uv_listen(reinterpret_cast<uv_stream_t *>(&listener->handle), 128, on_new_connection);
+  }
+
+  int addr_len = static_cast<int>(sizeof(addr));
+  if (0 == res) {
+    res = uv_tcp_getsockname(&listener->handle, reinterpret_cast<sockaddr *>(&addr), &addr_len);
+  }
+
+  if (0 != res) {
+    uv_close(reinterpret_cast<uv_handle_t *>(&listener->handle),
+             [](uv_handle_t *handle) { delete reinterpret_cast<listener_t *>(handle->data); });
+    return std::string();
+  }
+
+  int real_port;
+  if (is_ipv6) {
+    real_port = ntohs(reinterpret_cast<sockaddr_in6 *>(&addr)->sin6_port);
+    listener->url = "http://[" + host + "]:" + std::to_string(real_port);
+  } else {
+    real_port = ntohs(reinterpret_cast<sockaddr_in *>(&addr)->sin_port);
+    listener->url = "http://" + host + ":" + std::to_string(real_port);
+  }
+
+  listeners_.push_back(listener);
+  urls_.push_back(listener->url);
+
+  if (nullptr == lease_timer_) {
+    lease_timer_ = new uv_timer_t();
+    uv_timer_init(loop_, lease_timer_);
+    lease_timer_->data = this;
+    uv_timer_start(lease_timer_, on_lease_timer, ETCD_FAKE_GATEWAY_LEASE_TICK_MS, ETCD_FAKE_GATEWAY_LEASE_TICK_MS);
+    // Do not keep the loop alive just for lease timer
+    uv_unref(reinterpret_cast<uv_handle_t *>(lease_timer_));
+  }
+
+  return listener->url;
+}
+
+void etcd_fake_gateway::close() {
+  if (closing_) {
+    return;
+  }
+  closing_ = true;
+
+  for (auto &listener : listeners_) {
+    listener->owner = nullptr;
+    uv_close(reinterpret_cast<uv_handle_t *>(&listener->handle),
+             [](uv_handle_t *handle) { delete reinterpret_cast<listener_t *>(handle->data); });
+  }
+  listeners_.clear();
+
+  while (!connections_.empty()) {
+    close_connection(*connections_.begin()->second);
+  }
+
+  for (auto &delayed : delayed_writes_) {
+    delayed->owner = nullptr;
+    uv_timer_stop(&delayed->timer);
+    uv_close(reinterpret_cast<uv_handle_t *>(&delayed->timer),
+             [](uv_handle_t *handle) { delete reinterpret_cast<delayed_write_t *>(handle->data); });
+  }
+  delayed_writes_.clear();
+
+  if (nullptr != lease_timer_) {
+    uv_timer_stop(lease_timer_);
+    uv_close(reinterpret_cast<uv_handle_t *>(lease_timer_),
+             [](uv_handle_t *handle) { delete reinterpret_cast<uv_timer_t *>(handle); });
+    lease_timer_ = nullptr;
+  }
+
+  watchers_.clear();
+}
+
+void etcd_fake_gateway::set_response_delay(std::chrono::milliseconds delay) noexcept { default_delay_ = delay; }
+
+void etcd_fake_gateway::set_response_delay(const std::string &url, std::chrono::milliseconds delay) {
+  member_delay_[url] = delay;
+}
+
+void etcd_fake_gateway::inject_fault(const std::string &api_path, fault_type type, size_t count, int http_code) {
+  if (0 == count) {
+    return;
+  }
+
+  fault_rule_t rule;
+  rule.api_path = api_path;
+  rule.type = type;
+  rule.http_code = http_code;
+  rule.remain_count = count;
+  faults_.push_back(rule);
+}
+
+void etcd_fake_gateway::clear_faults() noexcept { faults_.clear(); }
+
+int64_t etcd_fake_gateway::put(const std::string &key, const std::string &value, int64_t lease) {
+  mutation_t mutation;
+  int http_code = 200;
+  std::string error;
+  if (!apply_put(mutation, key, value, lease, false, false, nullptr, http_code, error)) {
+    return 0;
+  }
+  commit(mutation);
+  return revision_;
+}
+
+size_t etcd_fake_gateway::remove(const std::string &key, const std::string &range_end) {
+  mutation_t mutation;
+  size_t ret = apply_delete(mutation, key, range_end, nullptr);
+  commit(mutation);
+  return ret;
+}
+
+const etcd_key_value *etcd_fake_gateway::get(const std::string &key) const {
+  std::map<std::string, etcd_key_value>::const_iterator iter = kvs_.find(key);
+  if (iter == kvs_.end()) {
+    return nullptr;
+  }
+
+  return &iter->second;
+}
+
+std::vector<etcd_key_value> etcd_fake_gateway::range(const std::string &key, const std::string &range_end) const {
+  std::vector<etcd_key_value> ret;
+  if (range_end.empty()) {
+    const etcd_key_value *kv = get(key);
+    if (nullptr != kv) {
+      ret.push_back(*kv);
+    }
+    return ret;
+  }
+
+  for (std::map<std::string, etcd_key_value>::const_iterator iter = kvs_.lower_bound(key); iter != kvs_.end();
+       ++iter) {
+    if (!match_key_range(iter->first, key, range_end)) {
+      break;
+    }
+    ret.push_back(iter->second);
+  }
+  return ret;
+}
+
+int64_t etcd_fake_gateway::grant_lease(int64_t ttl_seconds, int64_t id) {
+  if (0 == id) {
+    do {
+      id = ++lease_id_allocator_;
+    } while (leases_.end() != leases_.find(id));
+  } else if (leases_.end() != leases_.find(id)) {
+    return 0;
+  }
+
+  if (ttl_seconds <= 0) {
+    ttl_seconds = 1;
+  }
+
+  lease_t &lease = leases_[id];
+  lease.id = id;
+  lease.ttl = ttl_seconds;
+  lease.expire_time = std::chrono::steady_clock::now() + std::chrono::seconds(ttl_seconds);
+  return id;
+}
+
+bool etcd_fake_gateway::expire_lease(int64_t id) {
+  std::unordered_map<int64_t, lease_t>::iterator iter = leases_.find(id);
+  if (iter == leases_.end()) {
+    return false;
+  }
+
+  std::set<std::string> keys;
+  keys.swap(iter->second.keys);
+  leases_.erase(iter);
+
+  mutation_t mutation;
+  for (auto &key : keys) {
+    apply_delete(mutation, key, std::string(), nullptr);
+  }
+  commit(mutation);
+  return true;
+}
+
+void etcd_fake_gateway::compact(int64_t revision) {
+  if (revision <= compact_revision_) {
+    return;
+  }
+  if (revision > revision_) {
+    revision = revision_;
+  }
+
+  std::vector<history_event_t>::iterator end_iter = history_.begin();
+  while (end_iter != history_.end() && end_iter->kv.mod_revision < revision) {
+    ++end_iter;
+  }
+  history_.erase(history_.begin(), end_iter);
+  compact_revision_ = revision;
+}
+
+void etcd_fake_gateway::on_new_connection(uv_stream_t *server, int status) {
+  listener_t *listener = reinterpret_cast<listener_t *>(server->data);
+  if (status < 0 || nullptr == listener || nullptr == listener->owner) {
+    return;
+  }
+
+  etcd_fake_gateway *self = listener->owner;
+  connection_t *conn = new connection_t();
+  conn->owner = self;
+  conn->id = ++self->connection_id_allocator_;
+  conn->listener_index = listener->index;
+  conn->url = listener->url;
+  conn->closing = false;
+  conn->is_stream = false;
+  conn->continue_sent = false;
+  uv_tcp_init(self->loop_, &conn->handle);
+  conn->handle.data = conn;
+
+  if (0 != uv_accept(server, reinterpret_cast<uv_stream_t *>(&conn->handle))) {
+    uv_close(reinterpret_cast<uv_handle_t *>(&conn->handle),
+             [](uv_handle_t *handle) { delete reinterpret_cast<connection_t *>(handle->data); });
+    return;
+  }
+
+  uv_tcp_nodelay(&conn->handle, 1);
+  self->connections_[conn->id] = conn;
+  ++self->stats_.sum_connections;
+  uv_read_start(reinterpret_cast<uv_stream_t *>(&conn->handle), on_alloc, on_read);
+}
+
+void etcd_fake_gateway::on_alloc(uv_handle_t *, size_t, uv_buf_t *buf) {
+  // All callbacks run in the loop thread, so just share one buffer
+  static char recv_buffer[65536];
+  buf->base = recv_buffer;
+  buf->len = sizeof(recv_buffer);
+}
+
+void etcd_fake_gateway::on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+  connection_t *conn = reinterpret_cast<connection_t *>(stream->data);
+  if (nullptr == conn || nullptr == conn->owner || conn->closing) {
+    return;
+  }
+
+  if (nread < 0) {
+    conn->owner->close_connection(*conn);
+    return;
+  }
+
+  if (0 == nread) {
+    return;
+  }
+
+  // Streaming connection do not accept more requests
+  if (conn->is_stream) {
+    return;
+  }
+
+  conn->recv_buffer.append(buf->base, static_cast<size_t>(nread));
+  conn->owner->process_connection_data(*conn);
+}
+
+void etcd_fake_gateway::on_write(uv_write_t *req, int) {
+  write_request_t *write_req = reinterpret_cast<write_request_t *>(req->data);
+  connection_t *conn = reinterpret_cast<connection_t *>(req->handle->data);
+  if (nullptr != write_req && write_req->close_after_write && nullptr != conn && nullptr != conn->owner &&
+      !conn->closing) {
+    conn->owner->close_connection(*conn);
+  }
+
+  delete write_req;
+}
+
+void etcd_fake_gateway::on_delay_timer(uv_timer_t *handle) {
+  delayed_write_t *delayed = reinterpret_cast<delayed_write_t *>(handle->data);
+  if (nullptr != delayed->owner) {
+    delayed->owner->delayed_writes_.erase(delayed);
+    delayed->owner->write_raw(delayed->connection_id, std::move(delayed->data), delayed->close_after_write);
+  }
+
+  uv_close(reinterpret_cast<uv_handle_t *>(handle),
+           [](uv_handle_t *h) { delete reinterpret_cast<delayed_write_t *>(h->data); });
+}
+
+void etcd_fake_gateway::on_lease_timer(uv_timer_t *handle) {
+  etcd_fake_gateway *self = reinterpret_cast<etcd_fake_gateway *>(handle->data);
+  if (nullptr == self || self->closing_) {
+    return;
+  }
+
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::vector<int64_t> expired;
+  for (auto &lease : self->leases_) {
+    if (lease.second.expire_time <= now) {
+      expired.push_back(lease.first);
+    }
+  }
+
+  for (auto &id : expired) {
+    if (self->expire_lease(id)) {
+      ++self->stats_.lease_expired;
+    }
+  }
+}
+
+void etcd_fake_gateway::process_connection_data(connection_t &conn) {
+  while (!conn.closing && !conn.is_stream && !closing_) {
+    http_request_t req;
+    if (!parse_http_request(conn, req)) {
+      break;
+    }
+
+    dispatch_request(conn, req);
+  }
+}
+
+bool etcd_fake_gateway::parse_http_request(connection_t &conn, http_request_t &out) {
+  size_t header_end = conn.recv_buffer.find("\r\n\r\n");
+  if (std::string::npos == header_end) {
+    if (conn.recv_buffer.size() > ETCD_FAKE_GATEWAY_MAX_REQUEST_SIZE) {
+      close_connection(conn);
+    }
+    return false;
+  }
+
+  size_t content_length = 0;
+  bool expect_continue = false;
+  out.keep_alive = true;
+
+  size_t line_begin = 0;
+  bool is_first_line = true;
+  while (line_begin < header_end) {
+    size_t line_end = conn.recv_buffer.find("\r\n", line_begin);
+    if (std::string::npos == line_end || line_end > header_end) {
+      line_end = header_end;
+    }
+
+    std::string line = conn.recv_buffer.substr(line_begin, line_end - line_begin);
+    line_begin = line_end + 2;
+
+    if (is_first_line) {
+      is_first_line = false;
+      size_t method_end = line.find(' ');
+      size_t path_end = std::string::npos == method_end ? std::string::npos : line.find(' ', method_end + 1);
+      if (std::string::npos == method_end || std::string::npos == path_end) {
+        close_connection(conn);
+        return false;
+      }
+      out.method = line.substr(0, method_end);
+      out.path = line.substr(method_end + 1, path_end - method_end - 1);
+      if (line.substr(path_end + 1) == "HTTP/1.0") {
+        out.keep_alive = false;
+      }
+      continue;
+    }
+
+    size_t colon = line.find(':');
+    if (std::string::npos == colon) {
+      continue;
+    }
+    std::string name = line.substr(0, colon);
+    size_t value_begin = colon + 1;
+    while (value_begin < line.size() && (line[value_begin] == ' ' || line[value_begin] == '\t')) {
+      ++value_begin;
+    }
+    std::string value = line.substr(value_begin);
+
+    if (0 == UTIL_STRFUNC_STRCASE_CMP(name.c_str(), "Content-Length")) {
+      ::atfw::util::string::str2int(content_length, value.c_str());
+    } else if (0 == UTIL_STRFUNC_STRCASE_CMP(name.c_str(), "Expect")) {
+      expect_continue = 0 == UTIL_STRFUNC_STRCASE_CMP(value.c_str(), "100-continue");
+    } else if (0 == UTIL_STRFUNC_STRCASE_CMP(name.c_str(), "Connection")) {
+      if (0 == UTIL_STRFUNC_STRCASE_CMP(value.c_str(), "close")) {
+        out.keep_alive = false;
+      } else if (0 == UTIL_STRFUNC_STRCASE_CMP(value.c_str(), "keep-alive")) {
+        out.keep_alive = true;
+      }
+    }
+  }
+
+  if (content_length > ETCD_FAKE_GATEWAY_MAX_REQUEST_SIZE) {
+    close_connection(conn);
+    return false;
+  }
+
+  size_t body_begin = header_end + 4;
+  if (conn.recv_buffer.size() < body_begin + content_length) {
+    if (expect_continue && !conn.continue_sent) {
+      conn.continue_sent = true;
+      write_raw(conn.id, "HTTP/1.1 100 Continue\r\n\r\n", false);
+    }
+    return false;
+  }
+
+  out.body = conn.recv_buffer.substr(body_begin, content_length);
+  conn.recv_buffer.erase(0, body_begin + content_length);
+  conn.continue_sent = false;
+
+  size_t query_begin = out.path.find('?');
+  if (std::string::npos != query_begin) {
+    out.path.resize(query_begin);
+  }
+  return true;
+}
+
+void etcd_fake_gateway::dispatch_request(connection_t &conn, const http_request_t &req) {
+  ++stats_.sum_requests;
+
+  if (check_fault(conn, req)) {
+    return;
+  }
+
+  if (req.method != "POST") {
+    send_response(conn, 405, make_error(ETCD_FAKE_GATEWAY_GRPC_INVALID_ARGUMENT, "method not allowed"),
+                  req.keep_alive);
+    return;
+  }
+
+  if (req.path == "/v3/watch") {
+    handle_watch(conn, req.body);
+    return;
+  }
+
+  int http_code = 200;
+  std::string body;
+  if (req.path == "/v3/kv/range") {
+    body = handle_kv_range(conn, req.body, http_code);
+  } else if (req.path == "/v3/kv/put") {
+    body = handle_kv_put(conn, req.body, http_code);
+  } else if (req.path == "/v3/kv/deleterange") {
+    body = handle_kv_delete(conn, req.body, http_code);
+  } else if (req.path == "/v3/kv/txn") {
+    body = handle_kv_txn(conn, req.body, http_code);
+  } else if (req.path == "/v3/lease/grant") {
+    body = handle_lease_grant(conn, req.body, http_code);
+  } else if (req.path == "/v3/lease/keepalive") {
+    body = handle_lease_keepalive(conn, req.body, http_code);
+  } else if (req.path == "/v3/kv/lease/revoke" || req.path == "/v3/lease/revoke") {
+    body = handle_lease_revoke(conn, req.body, http_code);
+  } else if (req.path == "/v3/cluster/member/list") {
+    body = handle_member_list(conn, req.body, http_code);
+  } else if (req.path == "/v3/maintenance/status") {
+    body = handle_maintenance_status(conn, req.body, http_code);
+  } else {
+    http_code = 404;
+    body = make_error(ETCD_FAKE_GATEWAY_GRPC_NOT_FOUND, "Not Found");
+  }
+
+  send_response(conn, http_code, body, req.keep_alive);
+}
+
+bool etcd_fake_gateway::check_fault(connection_t &conn, const http_request_t &req) {
+  for (std::vector<fault_rule_t>::iterator iter = faults_.begin(); iter != faults_.end(); ++iter) {
+    if (!iter->api_path.empty() && iter->api_path != req.path) {
+      continue;
+    }
+
+    fault_rule_t rule = *iter;
+    if (--iter->remain_count == 0) {
+      faults_.erase(iter);
+    }
+    ++stats_.injected_faults;
+
+    switch (rule.type) {
+      case fault_type::kHttpError:
+        send_response(conn, rule.http_code, make_error(ETCD_FAKE_GATEWAY_GRPC_UNAVAILABLE, "injected fault"),
+                      req.keep_alive);
+        break;
+      case fault_type::kCloseConnection:
+        close_connection(conn);
+        break;
+      default:
+        break;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+void etcd_fake_gateway::write_raw(uint64_t connection_id, std::string &&data, bool close_after_write) {
+  std::unordered_map<uint64_t, connection_t *>::iterator iter = connections_.find(connection_id);
+  if (iter == connections_.end() || iter->second->closing) {
+    return;
+  }
+
+  write_request_t *write_req = new write_request_t();
+  write_req->data = std::move(data);
+  write_req->close_after_write = close_after_write;
+  write_req->req.data = write_req;
+
+  uv_buf_t buf = uv_buf_init(&write_req->data[0], static_cast<unsigned int>(write_req->data.size()));
+  if (0 != uv_write(&write_req->req, reinterpret_cast<uv_stream_t *>(&iter->second->handle), &buf, 1, on_write)) {
+    delete write_req;
+    close_connection(*iter->second);
+  }
+}
+
+void etcd_fake_gateway::write_delayed(uint64_t connection_id, std::string &&data, bool close_after_write,
+                                      std::chrono::milliseconds delay) {
+  if (delay <= std::chrono::milliseconds::zero()) {
+    write_raw(connection_id, std::move(data), close_after_write);
+    return;
+  }
+
+  // Timers are started in order, so responses of the same connection will not be reordered
+  delayed_write_t *delayed = new delayed_write_t();
+  delayed->owner = this;
+  delayed->connection_id = connection_id;
+  delayed->data = std::move(data);
+  delayed->close_after_write = close_after_write;
+  uv_timer_init(loop_, &delayed->timer);
+  delayed->timer.data = delayed;
+  uv_timer_start(&delayed->timer, on_delay_timer, static_cast<uint64_t>(delay.count()), 0);
+  delayed_writes_.insert(delayed);
+}
+
+void etcd_fake_gateway::send_response(connection_t &conn, int http_code, const std::string &body, bool keep_alive) {
+  std::string data;
+  data.reserve(body.size() + 160);
+  data += "HTTP/1.1 " + std::to_string(http_code) + " " + get_http_status_text(http_code) + "\r\n";
+  data += "Content-Type: application/json\r\n";
+  data += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+  if (!keep_alive) {
+    data += "Connection: close\r\n";
+  }
+  data += "\r\n";
+  data += body;
+
+  write_delayed(conn.id, std::move(data), !keep_alive, get_response_delay(conn));
+}
+
+void etcd_fake_gateway::send_stream_chunk(uint64_t connection_id, const std::string &body, bool finish) {
+  std::unordered_map<uint64_t, connection_t *>::iterator iter = connections_.find(connection_id);
+  if (iter == connections_.end()) {
+    return;
+  }
+
+  char chunk_size[32] = {0};
+  // etcd send a new line after every message
+  snprintf(chunk_size, sizeof(chunk_size), "%zx\r\n", body.size() + 1);
+  std::string data;
+  data.reserve(body.size() + 48);
+  data += chunk_size;
+  data += body;
+  data += "\n\r\n";
+  if (finish) {
+    data += "0\r\n\r\n";
+  }
+
+  write_delayed(connection_id, std::move(data), false, get_response_delay(*iter->second));
+}
+
+void etcd_fake_gateway::close_connection(connection_t &conn) {
+  if (conn.closing) {
+    return;
+  }
+
+  conn.closing = true;
+  cancel_watchers(conn.id);
+  connections_.erase(conn.id);
+  conn.owner = nullptr;
+
+  uv_read_stop(reinterpret_cast<uv_stream_t *>(&conn.handle));
+  uv_close(reinterpret_cast<uv_handle_t *>(&conn.handle),
+           [](uv_handle_t *handle) { delete reinterpret_cast<connection_t *>(handle->data); });
+}
+
+std::chrono::milliseconds etcd_fake_gateway::get_response_delay(const connection_t &conn) const {
+  std::unordered_map<std::string, std::chrono::milliseconds>::const_iterator iter = member_delay_.find(conn.url);
+  if (iter != member_delay_.end()) {
+    return iter->second;
+  }
+
+  return default_delay_;
+}
+
+std::string etcd_fake_gateway::handle_kv_range(connection_t &conn, const std::string &body, int &http_code) {
+  ++stats_.kv_range;
+
+  rapidjson::Document req;
+  if (!atframework::atapp::etcd_packer::parse_object(req, body.c_str())) {
+    http_code = 400;
+    return make_error(ETCD_FAKE_GATEWAY_GRPC_INVALID_ARGUMENT, "invalid json");
+  }
+
+  std::vector<etcd_key_value> kvs = range(unpack_json_base64(req, "key"), unpack_json_base64(req, "range_end"));
+  int64_t limit = unpack_json_int(req, "limit");
+  bool count_only = unpack_json_bool(req, "count_only");
+  bool keys_only = unpack_json_bool(req, "keys_only");
+
+  rapidjson::Document doc;
+  rapidjson::Value &root = doc.SetObject();
+  pack_header(root, doc, conn.listener_index, revision_);
+
+  if (!count_only && !kvs.empty()) {
+    rapidjson::Value kvs_json(rapidjson::kArrayType);
+    size_t max_count = kvs.size();
+    if (limit > 0 && static_cast<size_t>(limit) < max_count) {
+      max_count = static_cast<size_t>(limit);
+      root.AddMember("more", true, doc.GetAllocator());
+    }
+    for (size_t i = 0; i < max_count; ++i) {
+      if (keys_only) {
+        kvs[i].value.clear();
+      }
+      rapidjson::Value kv_json(rapidjson::kObjectType);
+      atframework::atapp::etcd_packer::pack(kvs[i], kv_json, doc);
+      kvs_json.PushBack(kv_json, doc.GetAllocator());
+    }
+    root.AddMember("kvs", kvs_json, doc.GetAllocator());
+  }
+  add_int_member(root, "count", static_cast<int64_t>(kvs.size()), doc);
+
+  return to_json_string(doc);
+}
+
+std::string etcd_fake_gateway::handle_kv_put(connection_t &conn, const std::string &body, int &http_code) {
+  ++stats_.kv_put;
+
+  rapidjson::Document req;
+  if (!atframework::atapp::etcd_packer::parse_object(req, body.c_str())) {
+    http_code = 400;
+    return make_error(ETCD_FAKE_GATEWAY_GRPC_INVALID_ARGUMENT, "invalid json");
+  }
+
+  mutation_t mutation;
+  etcd_key_value prev_kv{};
+  std::string error;
+  if (!apply_put(mutation, unpack_json_base64(req, "key"), unpack_json_base64(req, "value"),
+                 unpack_json_int(req, "lease"), unpack_json_bool(req, "ignore_lease"),
+                 unpack_json_bool(req, "ignore_value"), &prev_kv, http_code, error)) {
+    return error;
+  }
+  commit(mutation);
+
+  rapidjson::Document doc;
+  rapidjson::Value &root = doc.SetObject();
+  pack_header(root, doc, conn.listener_index, revision_);
+  if (unpack_json_bool(req, "prev_kv") && !prev_kv.key.empty()) {
+    rapidjson::Value prev_kv_json(rapidjson::kObjectType);
+    atframework::atapp::etcd_packer::pack(prev_kv, prev_kv_json, doc);
+    root.AddMember("prev_kv", prev_kv_json, doc.GetAllocator());
+  }
+
+  return to_json_string(doc);
+}
+
+std::string etcd_fake_gateway::handle_kv_delete(connection_t &conn, const std::string &body, int &http_code) {
+  ++stats_.kv_delete;
+
+  rapidjson::Document req;
+  if (!atframework::atapp::etcd_packer::parse_object(req, body.c_str())) {
+    http_code = 400;
+    return make_error(ETCD_FAKE_GATEWAY_GRPC_INVALID_ARGUMENT, "invalid json");
+  }
+
+  mutation_t mutation;
+  std::vector<etcd_key_value> prev_kvs;
+  size_t deleted =
+      apply_delete(mutation, unpack_json_base64(req, "key"), unpack_json_base64(req, "range_end"), &prev_kvs);
+  commit(mutation);
+
+  rapidjson::Document doc;
+  rapidjson::Value &root = doc.SetObject();
+  pack_header(root, doc, conn.listener_index, revision_);
+  if (deleted > 0) {
+    add_int_member(root, "deleted", static_cast<int64_t>(deleted), doc);
+  }
+  if (unpack_json_bool(req, "prev_kv") && !prev_kvs.empty()) {
+    rapidjson::Value prev_kvs_json(rapidjson::kArrayType);
+    for (auto &prev_kv : prev_kvs) {
+      rapidjson::Value prev_kv_json(rapidjson::kObjectType);
+      atframework::atapp::etcd_packer::pack(prev_kv, prev_kv_json, doc);
+      prev_kvs_json.PushBack(prev_kv_json, doc.GetAllocator());
+    }
+    root.AddMember("prev_kvs", prev_kvs_json, doc.GetAllocator());
+  }
+
+  return to_json_string(doc);
+}
+
+std::string etcd_fake_gateway::handle_kv_txn(connection_t &conn, const std::string &body, int &http_code) {
+  ++stats_.kv_txn;
+
+  rapidjson::Document req;
+  if (!atframework::atapp::etcd_packer::parse_object(req, body.c_str())) {
+    http_code = 400;
+    return make_error(ETCD_FAKE_GATEWAY_GRPC_INVALID_ARGUMENT, "invalid json");
+  }
+
+  // Evaluate compares
+  static const char *const compare_target_names[] = {"VERSION", "CREATE", "MOD", "VALUE", "LEASE"};
+  static const char *const compare_result_names[] = {"EQUAL", "GREATER", "LESS", "NOT_EQUAL"};
+  bool succeeded = true;
+  rapidjson::Value::ConstMemberIterator compares = req.FindMember("compare");
+  if (compares != req.MemberEnd() && compares->value.IsArray()) {
+    for (auto &cmp : compares->value.GetArray()) {
+      const etcd_key_value *kv = get(unpack_json_base64(cmp, "key"));
+      int32_t target = unpack_json_enum(cmp, "target", compare_target_names, 5);
+      int32_t result = unpack_json_enum(cmp, "result", compare_result_names, 4);
+
+      int compare_res = 0;
+      switch (target) {
+        case 1:
+          compare_res = (nullptr == kv ? 0 : kv->create_revision) < unpack_json_int(cmp, "create_revision")   ? -1
+                        : (nullptr == kv ? 0 : kv->create_revision) > unpack_json_int(cmp, "create_revision") ? 1
+                                                                                                               : 0;
+          break;
+        case 2:
+          compare_res = (nullptr == kv ? 0 : kv->mod_revision) < unpack_json_int(cmp, "mod_revision")   ? -1
+                        : (nullptr == kv ? 0 : kv->mod_revision) > unpack_json_int(cmp, "mod_revision") ? 1
+                                                                                                         : 0;
+          break;
+        case 3: {
+          std::string value = unpack_json_base64(cmp, "value");
+          compare_res = (nullptr == kv ? std::string() : kv->value).compare(value);
+          break;
+        }
+        case 4:
+          compare_res = (nullptr == kv ? 0 : kv->lease) < unpack_json_int(cmp, "lease")   ? -1
+                        : (nullptr == kv ? 0 : kv->lease) > unpack_json_int(cmp, "lease") ? 1
+                                                                                           : 0;
+          break;
+        default:
+          compare_res = (nullptr == kv ? 0 : kv->version) < unpack_json_int(cmp, "version")   ? -1
+                        : (nullptr == kv ? 0 : kv->version) > unpack_json_int(cmp, "version") ? 1
+                                                                                               : 0;
+          break;
+      }
+
+      bool match;
+      switch (result) {
+        case 1:
+          match = compare_res > 0;
+          break;
+        case 2:
+          match = compare_res < 0;
+          break;
+        case 3:
+          match = compare_res != 0;
+          break;
+        default:
+          match = compare_res == 0;
+          break;
+      }
+
+      if (!match) {
+        succeeded = false;
+        break;
+      }
+    }
+  }
+
+  rapidjson::Value::ConstMemberIterator ops = req.FindMember(succeeded ? "success" : "failure");
+  bool has_ops = ops != req.MemberEnd() && ops->value.IsArray();
+
+  // Validate all puts first, txn is atomic
+  if (has_ops) {
+    for (auto &op : ops->value.GetArray()) {
+      rapidjson::Value::ConstMemberIterator put_req = op.FindMember("request_put");
+      if (put_req == op.MemberEnd()) {
+        continue;
+      }
+      int64_t lease = unpack_json_int(put_req->value, "lease");
+      if (!unpack_json_bool(put_req->value, "ignore_lease") && 0 != lease && leases_.end() == leases_.find(lease)) {
+        http_code = 404;
+        return make_error(ETCD_FAKE_GATEWAY_GRPC_NOT_FOUND, "etcdserver: requested lease not found");
+      }
+    }
+  }
+
+  rapidjson::Document doc;
+  rapidjson::Value &root = doc.SetObject();
+  rapidjson::Value responses(rapidjson::kArrayType);
+  mutation_t mutation;
+  if (has_ops) {
+    for (auto &op : ops->value.GetArray()) {
+      rapidjson::Value response_op(rapidjson::kObjectType);
+      rapidjson::Value response(rapidjson::kObjectType);
+
+      rapidjson::Value::ConstMemberIterator sub_req = op.FindMember("request_range");
+      if (sub_req != op.MemberEnd()) {
+        std::vector<etcd_key_value> kvs =
+            range(unpack_json_base64(sub_req->value, "key"), unpack_json_base64(sub_req->value, "range_end"));
+        if (!kvs.empty()) {
+          rapidjson::Value kvs_json(rapidjson::kArrayType);
+          for (auto &kv : kvs) {
+            rapidjson::Value kv_json(rapidjson::kObjectType);
+            atframework::atapp::etcd_packer::pack(kv, kv_json, doc);
+            kvs_json.PushBack(kv_json, doc.GetAllocator());
+          }
+          response.AddMember("kvs", kvs_json, doc.GetAllocator());
+        }
+        add_int_member(response, "count", static_cast<int64_t>(kvs.size()), doc);
+        response_op.AddMember("response_range", response, doc.GetAllocator());
+        responses.PushBack(response_op, doc.GetAllocator());
+        continue;
+      }
+
+      sub_req = op.FindMember("request_put");
+      if (sub_req != op.MemberEnd()) {
+        etcd_key_value prev_kv{};
+        int put_http_code = 200;
+        std::string error;
+        apply_put(mutation, unpack_json_base64(sub_req->value, "key"), unpack_json_base64(sub_req->value, "value"),
+                  unpack_json_int(sub_req->value, "lease"), unpack_json_bool(sub_req->value, "ignore_lease"),
+                  unpack_json_bool(sub_req->value, "ignore_value"), &prev_kv, put_http_code, error);
+        if (unpack_json_bool(sub_req->value, "prev_kv") && !prev_kv.key.empty()) {
+          rapidjson::Value prev_kv_json(rapidjson::kObjectType);
+          atframework::atapp::etcd_packer::pack(prev_kv, prev_kv_json, doc);
+          response.AddMember("prev_kv", prev_kv_json, doc.GetAllocator());
+        }
+        response_op.AddMember("response_put", response, doc.GetAllocator());
+        responses.PushBack(response_op, doc.GetAllocator());
+        continue;
+      }
+
+      sub_req = op.FindMember("request_delete_range");
+      if (sub_req != op.MemberEnd()) {
+        size_t deleted = apply_delete(mutation, unpack_json_base64(sub_req->value, "key"),
+                                      unpack_json_base64(sub_req->value, "range_end"), nullptr);
+        if (deleted > 0) {
+          add_int_member(response, "deleted", static_cast<int64_t>(deleted), doc);
+        }
+        response_op.AddMember("response_delete_range", response, doc.GetAllocator());
+        responses.PushBack(response_op, doc.GetAllocator());
+        continue;
+      }
+    }
+  }
+  commit(mutation);
+
+  // All responses of txn share the same revision
+  for (auto &response_op : responses.GetArray()) {
+    for (auto &response : response_op.GetObject()) {
+      pack_header(response.value, doc, conn.listener_index, revision_);
+    }
+  }
+
+  pack_header(root, doc, conn.listener_index, revision_);
+  if (succeeded) {
+    root.AddMember("succeeded", true, doc.GetAllocator());
+  }
+  if (!responses.Empty()) {
+    root.AddMember("responses", responses, doc.GetAllocator());
+  }
+
+  return to_json_string(doc);
+}
+
+std::string etcd_fake_gateway::handle_lease_grant(connection_t &conn, const std::string &body, int &http_code) {
+  ++stats_.lease_grant;
+
+  rapidjson::Document req;
+  if (!atframework::atapp::etcd_packer::parse_object(req, body.c_str())) {
+    http_code = 400;
+    return make_error(ETCD_FAKE_GATEWAY_GRPC_INVALID_ARGUMENT, "invalid json");
+  }
+
+  int64_t id = grant_lease(unpack_json_int(req, "TTL"), unpack_json_int(req, "ID"));
+  if (0 == id) {
+    http_code = 400;
+    return make_error(ETCD_FAKE_GATEWAY_GRPC_ALREADY_EXISTS, "etcdserver: lease already exists");
+  }
+
+  rapidjson::Document doc;
+  rapidjson::Value &root = doc.SetObject();
+  pack_header(root, doc, conn.listener_index, revision_);
+  add_int_member(root, "ID", id, doc);
+  add_int_member(root, "TTL", leases_[id].ttl, doc);
+
+  return to_json_string(doc);
+}
+
+std::string etcd_fake_gateway::handle_lease_keepalive(connection_t &conn, const std::string &body, int &http_code) {
+  ++stats_.lease_keepalive;
+
+  rapidjson::Document req;
+  if (!atframework::atapp::etcd_packer::parse_object(req, body.c_str())) {
+    http_code = 400;
+    return make_error(ETCD_FAKE_GATEWAY_GRPC_INVALID_ARGUMENT, "invalid json");
+  }
+
+  int64_t id = unpack_json_int(req, "ID");
+
+  rapidjson::Document doc;
+  rapidjson::Value &root = doc.SetObject();
+  rapidjson::Value result(rapidjson::kObjectType);
+  pack_header(result, doc, conn.listener_index, revision_);
+  add_int_member(result, "ID", id, doc);
+
+  // TTL will be absent if lease not found
+  std::unordered_map<int64_t, lease_t>::iterator iter = leases_.find(id);
+  if (iter != leases_.end()) {
+    iter->second.expire_time = std::chrono::steady_clock::now() + std::chrono::seconds(iter->second.ttl);
+    add_int_member(result, "TTL", iter->second.ttl, doc);
+  }
+  root.AddMember("result", result, doc.GetAllocator());
+
+  return to_json_string(doc);
+}
+
+std::string etcd_fake_gateway::handle_lease_revoke(connection_t &conn, const std::string &body, int &http_code) {
+  ++stats_.lease_revoke;
+
+  rapidjson::Document req;
+  if (!atframework::atapp::etcd_packer::parse_object(req, body.c_str())) {
+    http_code = 400;
+    return make_error(ETCD_FAKE_GATEWAY_GRPC_INVALID_ARGUMENT, "invalid json");
+  }
+
+  if (!expire_lease(unpack_json_int(req, "ID"))) {
+    http_code = 404;
+    return make_error(ETCD_FAKE_GATEWAY_GRPC_NOT_FOUND, "etcdserver: requested lease not found");
+  }
+
+  rapidjson::Document doc;
+  rapidjson::Value &root = doc.SetObject();
+  pack_header(root, doc, conn.listener_index, revision_);
+  return to_json_string(doc);
+}
+
+std::string etcd_fake_gateway::handle_member_list(connection_t &conn, const std::string &, int &) {
+  ++stats_.member_list;
+
+  rapidjson::Document doc;
+  rapidjson::Value &root = doc.SetObject();
+  pack_header(root, doc, conn.listener_index, revision_);
+
+  rapidjson::Value members(rapidjson::kArrayType);
+  for (auto &listener : listeners_) {
+    rapidjson::Value member(rapidjson::kObjectType);
+    add_int_member(member, "ID", static_cast<int64_t>(listener->index + 1), doc);
+    add_string_member(member, "name", "fake-etcd-" + std::to_string(listener->index + 1), doc);
+
+    rapidjson::Value urls(rapidjson::kArrayType);
+    rapidjson::Value url;
+    url.SetString(listener->url.c_str(), static_cast<rapidjson::SizeType>(listener->url.size()), doc.GetAllocator());
+    urls.PushBack(url, doc.GetAllocator());
+    member.AddMember("clientURLs", urls, doc.GetAllocator());
+
+    members.PushBack(member, doc.GetAllocator());
+  }
+  root.AddMember("members", members, doc.GetAllocator());
+
+  return to_json_string(doc);
+}
+
+std::string etcd_fake_gateway::handle_maintenance_status(connection_t &conn, const std::string &, int &) {
+  ++stats_.maintenance_status;
+
+  rapidjson::Document doc;
+  rapidjson::Value &root = doc.SetObject();
+  pack_header(root, doc, conn.listener_index, revision_);
+  add_string_member(root, "version", "3.5.0", doc);
+  add_int_member(root, "dbSize", static_cast<int64_t>(kvs_.size()), doc);
+  add_string_member(root, "leader", "1", doc);
+  add_int_member(root, "raftIndex", revision_, doc);
+  add_string_member(root, "raftTerm", "1", doc);
+
+  return to_json_string(doc);
+}
+
+void etcd_fake_gateway::handle_watch(connection_t &conn, const std::string &body) {
+  rapidjson::Document req;
+  rapidjson::Value::ConstMemberIterator create_request;
+  if (!atframework::atapp::etcd_packer::parse_object(req, body.c_str()) ||
+      (create_request = req.FindMember("create_request")) == req.MemberEnd() || !create_request->value.IsObject()) {
+    send_response(conn, 400, make_error(ETCD_FAKE_GATEWAY_GRPC_INVALID_ARGUMENT, "invalid watch request"), true);
+    return;
+  }
+
+  conn.is_stream = true;
+  conn.recv_buffer.clear();
+  write_raw(conn.id, "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nTransfer-Encoding: chunked\r\n\r\n",
+            false);
+
+  watcher_t watcher;
+  watcher.connection_id = conn.id;
+  watcher.watch_id = ++watch_id_allocator_;
+  watcher.key = unpack_json_base64(create_request->value, "key");
+  watcher.range_end = unpack_json_base64(create_request->value, "range_end");
+  watcher.prev_kv = unpack_json_bool(create_request->value, "prev_kv");
+  int64_t start_revision = unpack_json_int(create_request->value, "start_revision");
+
+  {
+    rapidjson::Document doc;
+    rapidjson::Value &root = doc.SetObject();
+    rapidjson::Value result(rapidjson::kObjectType);
+    pack_header(result, doc, conn.listener_index, revision_);
+    add_int_member(result, "watch_id", watcher.watch_id, doc);
+    result.AddMember("created", true, doc.GetAllocator());
+    root.AddMember("result", result, doc.GetAllocator());
+    send_stream_chunk(conn.id, to_json_string(doc), false);
+  }
+  ++stats_.watch_created;
+
+  // Required revision is compacted
+  if (start_revision > 0 && start_revision < compact_revision_) {
+    rapidjson::Document doc;
+    rapidjson::Value &root = doc.SetObject();
+    rapidjson::Value result(rapidjson::kObjectType);
+    pack_header(result, doc, conn.listener_index, revision_);
+    add_int_member(result, "watch_id", watcher.watch_id, doc);
+    result.AddMember("canceled", true, doc.GetAllocator());
+    add_int_member(result, "compact_revision", compact_revision_, doc);
+    add_string_member(result, "cancel_reason", "etcdserver: mvcc: required revision has been compacted", doc);
+    root.AddMember("result", result, doc.GetAllocator());
+    send_stream_chunk(conn.id, to_json_string(doc), true);
+    ++stats_.watch_canceled;
+    return;
+  }
+
+  const watcher_t &new_watcher = watchers_[watcher.watch_id] = watcher;
+
+  // Replay history
+  if (start_revision > 0 && start_revision <= revision_) {
+    std::vector<history_event_t> events;
+    for (auto &evt : history_) {
+      if (evt.kv.mod_revision >= start_revision) {
+        events.push_back(evt);
+      }
+    }
+
+    // Send events of each revision in one message, just like etcd
+    std::vector<history_event_t>::const_iterator begin = events.begin();
+    while (begin != events.end()) {
+      std::vector<history_event_t>::const_iterator end = begin;
+      while (end != events.end() && end->kv.mod_revision == begin->kv.mod_revision) {
+        ++end;
+      }
+      notify_watcher(new_watcher, std::vector<history_event_t>(begin, end));
+      begin = end;
+    }
+  }
+}
+
+bool etcd_fake_gateway::apply_put(mutation_t &mutation, const std::string &key, const std::string &value,
+                                  int64_t lease, bool ignore_lease, bool ignore_value, etcd_key_value *prev_kv,
+                                  int &http_code, std::string &error) {
+  if (key.empty()) {
+    http_code = 400;
+    error = make_error(ETCD_FAKE_GATEWAY_GRPC_INVALID_ARGUMENT, "etcdserver: key is not provided");
+    return false;
+  }
+
+  std::map<std::string, etcd_key_value>::iterator iter = kvs_.find(key);
+  if ((ignore_lease || ignore_value) && iter == kvs_.end()) {
+    http_code = 404;
+    error = make_error(ETCD_FAKE_GATEWAY_GRPC_NOT_FOUND, "etcdserver: key not found");
+    return false;
+  }
+
+  if (!ignore_lease && 0 != lease && leases_.end() == leases_.find(lease)) {
+    http_code = 404;
+    error = make_error(ETCD_FAKE_GATEWAY_GRPC_NOT_FOUND, "etcdserver: requested lease not found");
+    return false;
+  }
+
+  int64_t revision = revision_ + 1;
+  history_event_t evt;
+  evt.evt_type = etcd_watch_event::kPut;
+  evt.prev_kv = etcd_key_value{};
+  if (iter == kvs_.end()) {
+    etcd_key_value &kv = kvs_[key];
+    kv.key = key;
+    kv.create_revision = revision;
+    kv.mod_revision = revision;
+    kv.version = 1;
+    kv.value = value;
+    kv.lease = lease;
+    if (0 != lease) {
+      leases_[lease].keys.insert(key);
+    }
+    evt.kv = kv;
+  } else {
+    evt.prev_kv = iter->second;
+    if (nullptr != prev_kv) {
+      *prev_kv = iter->second;
+    }
+
+    etcd_key_value &kv = iter->second;
+    kv.mod_revision = revision;
+    ++kv.version;
+    if (!ignore_value) {
+      kv.value = value;
+    }
+    if (!ignore_lease && kv.lease != lease) {
+      remove_lease_key(kv.lease, key);
+      kv.lease = lease;
+      if (0 != lease) {
+        leases_[lease].keys.insert(key);
+      }
+    }
+    evt.kv = kv;
+  }
+
+  mutation.events.push_back(evt);
+  return true;
+}
+
+size_t etcd_fake_gateway::apply_delete(mutation_t &mutation, const std::string &key, const std::string &range_end,
+                                       std::vector<etcd_key_value> *prev_kvs) {
+  std::vector<std::string> keys;
+  if (range_end.empty()) {
+    if (kvs_.end() != kvs_.find(key)) {
+      keys.push_back(key);
+    }
+  } else {
+    for (std::map<std::string, etcd_key_value>::iterator iter = kvs_.lower_bound(key); iter != kvs_.end(); ++iter) {
+      if (!match_key_range(iter->first, key, range_end)) {
+        break;
+      }
+      keys.push_back(iter->first);
+    }
+  }
+
+  int64_t revision = revision_ + 1;
+  for (auto &delete_key : keys) {
+    std::map<std::string, etcd_key_value>::iterator iter = kvs_.find(delete_key);
+    history_event_t evt;
+    evt.evt_type = etcd_watch_event::kDelete;
+    evt.prev_kv = iter->second;
+    evt.kv = etcd_key_value{};
+    evt.kv.key = delete_key;
+    evt.kv.mod_revision = revision;
+    if (nullptr != prev_kvs) {
+      prev_kvs->push_back(iter->second);
+    }
+
+    remove_lease_key(iter->second.lease, delete_key);
+    kvs_.erase(iter);
+    mutation.events.push_back(evt);
+  }
+
+  return keys.size();
+}
+
+void etcd_fake_gateway::commit(mutation_t &mutation) {
+  if (mutation.events.empty()) {
+    return;
+  }
+
+  ++revision_;
+  history_.insert(history_.end(), mutation.events.begin(), mutation.events.end());
+
+  // Drop the oldest revisions
+  if (max_history_ > 0 && history_.size() > max_history_) {
+    std::vector<history_event_t>::iterator end_iter = history_.begin() + (history_.size() - max_history_);
+    int64_t last_revision = (end_iter - 1)->kv.mod_revision;
+    while (end_iter != history_.end() && end_iter->kv.mod_revision == last_revision) {
+      ++end_iter;
+    }
+    history_.erase(history_.begin(), end_iter);
+    compact_revision_ = last_revision + 1;
+  }
+
+  notify_watchers(mutation.events);
+}
+
+void etcd_fake_gateway::remove_lease_key(int64_t lease, const std::string &key) {
+  if (0 == lease) {
+    return;
+  }
+
+  std::unordered_map<int64_t, lease_t>::iterator iter = leases_.find(lease);
+  if (iter != leases_.end()) {
+    iter->second.keys.erase(key);
+  }
+}
+
+void etcd_fake_gateway::notify_watchers(const std::vector<history_event_t> &events) {
+  if (events.empty() || watchers_.empty()) {
+    return;
+  }
+
+  for (auto &watcher_pair : watchers_) {
+    notify_watcher(watcher_pair.second, events);
+  }
+}
+
+void etcd_fake_gateway::notify_watcher(const watcher_t &watcher, const std::vector<history_event_t> &events) {
+  std::unordered_map<uint64_t, connection_t *>::iterator conn_iter = connections_.find(watcher.connection_id);
+  if (conn_iter == connections_.end()) {
+    return;
+  }
+
+  rapidjson::Document doc;
+  rapidjson::Value &root = doc.SetObject();
+  rapidjson::Value result(rapidjson::kObjectType);
+  rapidjson::Value events_json(rapidjson::kArrayType);
+  for (auto &evt : events) {
+    if (!match_key_range(evt.kv.key, watcher.key, watcher.range_end)) {
+      continue;
+    }
+
+    rapidjson::Value evt_json(rapidjson::kObjectType);
+    // etcd omit default value PUT
+    if (etcd_watch_event::kDelete == evt.evt_type) {
+      add_string_member(evt_json, "type", "DELETE", doc);
+    }
+
+    rapidjson::Value kv_json(rapidjson::kObjectType);
+    atframework::atapp::etcd_packer::pack(evt.kv, kv_json, doc);
+    evt_json.AddMember("kv", kv_json, doc.GetAllocator());
+
+    if (watcher.prev_kv && !evt.prev_kv.key.empty()) {
+      rapidjson::Value prev_kv_json(rapidjson::kObjectType);
+      atframework::atapp::etcd_packer::pack(evt.prev_kv, prev_kv_json, doc);
+      evt_json.AddMember("prev_kv", prev_kv_json, doc.GetAllocator());
+    }
+
+    events_json.PushBack(evt_json, doc.GetAllocator());
+    ++stats_.watch_events;
+  }
+
+  if (events_json.Empty()) {
+    return;
+  }
+
+  pack_header(result, doc, conn_iter->second->listener_index, revision_);
+  add_int_member(result, "watch_id", watcher.watch_id, doc);
+  result.AddMember("events", events_json, doc.GetAllocator());
+  root.AddMember("result", result, doc.GetAllocator());
+  send_stream_chunk(watcher.connection_id, to_json_string(doc), false);
+}
+
+void etcd_fake_gateway::cancel_watchers(uint64_t connection_id) {
+  for (std::map<int64_t, watcher_t>::iterator iter = watchers_.begin(); iter != watchers_.end();) {
+    if (iter->second.connection_id == connection_id) {
+      iter = watchers_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+bool etcd_fake_gateway::match_key_range(const std::string &key, const std::string &range_begin,
+                                        const std::string &range_end) {
+  if (range_end.empty()) {
+    return key == range_begin;
+  }
+
+  // range_end = '\0' means all keys greater than or equal to the key
+  if (1 == range_end.size() && '\0' == range_end[0]) {
+    return key >= range_begin;
+  }
+
+  return key >= range_begin && key < range_end;
+}
+
+std::string etcd_fake_gateway::make_error(int grpc_code, const std::string &message) const {
+  rapidjson::Document doc;
+  rapidjson::Value &root = doc.SetObject();
+  add_string_member(root, "error", message, doc);
+  root.AddMember("code", grpc_code, doc.GetAllocator());
+  add_string_member(root, "message", message, doc);
+  return to_json_string(doc);
+}
+
+}  // namespace test
+}  // namespace atapp
+}  // namespace atframework
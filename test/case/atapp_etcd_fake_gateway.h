@@ -0,0 +1,234 @@
+// Copyright 2026 atframework
+// In-process fake etcd v3 JSON gateway, used by unit tests and benchmarks which should not depend on a real etcd
+
+#pragma once
+
+#include <uv.h>
+
+#include <atframe/etcdcli/etcd_def.h>
+
+#include <stdint.h>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace atframework {
+namespace atapp {
+namespace test {
+
+/**
+ * @brief A fake etcd v3 JSON gateway running on a libuv loop
+ * @note Supported APIs:
+ *         /v3/kv/range, /v3/kv/put, /v3/kv/deleterange, /v3/kv/txn
+ *         /v3/lease/grant, /v3/lease/keepalive, /v3/kv/lease/revoke
+ *         /v3/watch (streaming, with history replay and compaction)
+ *         /v3/cluster/member/list, /v3/maintenance/status
+ *       Authorization is not supported.
+ * @note Every listen() creates a new fake member of the cluster, they share the same data. Latency and faults can be
+ *       injected to test or benchmark the client.
+ */
+class etcd_fake_gateway {
+ public:
+  enum class fault_type : int32_t {
+    kHttpError = 0,        // response with http error code
+    kCloseConnection = 1,  // close the connection without response
+    kNoResponse = 2,       // never response, the client will timeout
+  };
+
+  struct stats_t {
+    size_t sum_connections;
+    size_t sum_requests;
+    size_t kv_range;
+    size_t kv_put;
+    size_t kv_delete;
+    size_t kv_txn;
+    size_t lease_grant;
+    size_t lease_keepalive;
+    size_t lease_revoke;
+    size_t lease_expired;
+    size_t watch_created;
+    size_t watch_canceled;
+    size_t watch_events;
+    size_t member_list;
+    size_t maintenance_status;
+    size_t injected_faults;
+  };
+
+  struct connection_t;
+  struct listener_t;
+  struct delayed_write_t;
+
+ public:
+  explicit etcd_fake_gateway(uv_loop_t *loop);
+  ~etcd_fake_gateway();
+
+  etcd_fake_gateway(const etcd_fake_gateway &) = delete;
+  etcd_fake_gateway &operator=(const etcd_fake_gateway &) = delete;
+
+  /**
+   * @brief listen a new fake member
+   * @param host ip address to listen
+   * @param port port to listen, 0 means select one by system
+   * @return url of this member(http://HOST:PORT), empty when failed
+   */
+  std::string listen(const std::string &host = "127.0.0.1", int port = 0);
+
+  /**
+   * @brief close all listeners and connections
+   * @note libuv handles are released in close callbacks, run the loop for a while after close
+   */
+  void close();
+
+  inline const std::vector<std::string> &get_urls() const noexcept { return urls_; }
+  inline uv_loop_t *get_loop() const noexcept { return loop_; }
+
+  // Latency injection
+  void set_response_delay(std::chrono::milliseconds delay) noexcept;
+  void set_response_delay(const std::string &url, std::chrono::milliseconds delay);
+
+  // Fault injection, api_path is like /v3/kv/put, empty means all APIs
+  void inject_fault(const std::string &api_path, fault_type type, size_t count, int http_code = 503);
+  void clear_faults() noexcept;
+
+  // Direct data access, changes will also be sent to watchers
+  int64_t put(const std::string &key, const std::string &value, int64_t lease = 0);
+  size_t remove(const std::string &key, const std::string &range_end = "");
+  const etcd_key_value *get(const std::string &key) const;
+  std::vector<etcd_key_value> range(const std::string &key, const std::string &range_end) const;
+
+  int64_t grant_lease(int64_t ttl_seconds, int64_t id = 0);
+  bool expire_lease(int64_t id);
+  void compact(int64_t revision);
+
+  inline int64_t get_revision() const noexcept { return revision_; }
+  inline int64_t get_compact_revision() const noexcept { return compact_revision_; }
+  inline size_t get_key_count() const noexcept { return kvs_.size(); }
+  inline size_t get_lease_count() const noexcept { return leases_.size(); }
+  inline size_t get_connection_count() const noexcept { return connections_.size(); }
+  inline size_t get_watch_count() const noexcept { return watchers_.size(); }
+  inline const stats_t &get_stats() const noexcept { return stats_; }
+
+  inline void set_max_history(size_t v) noexcept { max_history_ = v; }
+
+ private:
+  struct lease_t {
+    int64_t id;
+    int64_t ttl;
+    std::chrono::steady_clock::time_point expire_time;
+    std::set<std::string> keys;
+  };
+
+  struct history_event_t {
+    etcd_watch_event evt_type;
+    etcd_key_value kv;
+    etcd_key_value prev_kv;
+  };
+
+  struct watcher_t {
+    uint64_t connection_id;
+    int64_t watch_id;
+    std::string key;
+    std::string range_end;
+    bool prev_kv;
+  };
+
+  struct fault_rule_t {
+    std::string api_path;
+    fault_type type;
+    int http_code;
+    size_t remain_count;
+  };
+
+  struct http_request_t {
+    std::string method;
+    std::string path;
+    std::string body;
+    bool keep_alive;
+  };
+
+  struct mutation_t {
+    std::vector<history_event_t> events;
+  };
+
+  friend struct connection_t;
+  friend struct listener_t;
+  friend struct delayed_write_t;
+
+  static void on_new_connection(uv_stream_t *server, int status);
+  static void on_alloc(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf);
+  static void on_read(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
+  static void on_write(uv_write_t *req, int status);
+  static void on_delay_timer(uv_timer_t *handle);
+  static void on_lease_timer(uv_timer_t *handle);
+
+  void process_connection_data(connection_t &conn);
+  bool parse_http_request(connection_t &conn, http_request_t &out);
+  void dispatch_request(connection_t &conn, const http_request_t &req);
+  bool check_fault(connection_t &conn, const http_request_t &req);
+
+  void write_raw(uint64_t connection_id, std::string &&data, bool close_after_write);
+  void write_delayed(uint64_t connection_id, std::string &&data, bool close_after_write,
+                     std::chrono::milliseconds delay);
+  void send_response(connection_t &conn, int http_code, const std::string &body, bool keep_alive);
+  void send_stream_chunk(uint64_t connection_id, const std::string &body, bool finish);
+  void close_connection(connection_t &conn);
+  std::chrono::milliseconds get_response_delay(const connection_t &conn) const;
+
+  std::string handle_kv_range(connection_t &conn, const std::string &body, int &http_code);
+  std::string handle_kv_put(connection_t &conn, const std::string &body, int &http_code);
+  std::string handle_kv_delete(connection_t &conn, const std::string &body, int &http_code);
+  std::string handle_kv_txn(connection_t &conn, const std::string &body, int &http_code);
+  std::string handle_lease_grant(connection_t &conn, const std::string &body, int &http_code);
+  std::string handle_lease_keepalive(connection_t &conn, const std::string &body, int &http_code);
+  std::string handle_lease_revoke(connection_t &conn, const std::string &body, int &http_code);
+  std::string handle_member_list(connection_t &conn, const std::string &body, int &http_code);
+  std::string handle_maintenance_status(connection_t &conn, const std::string &body, int &http_code);
+  void handle_watch(connection_t &conn, const std::string &body);
+
+  bool apply_put(mutation_t &mutation, const std::string &key, const std::string &value, int64_t lease,
+                 bool ignore_lease, bool ignore_value, etcd_key_value *prev_kv, int &http_code, std::string &error);
+  size_t apply_delete(mutation_t &mutation, const std::string &key, const std::string &range_end,
+                      std::vector<etcd_key_value> *prev_kvs);
+  void commit(mutation_t &mutation);
+  void remove_lease_key(int64_t lease, const std::string &key);
+  void notify_watchers(const std::vector<history_event_t> &events);
+  void notify_watcher(const watcher_t &watcher, const std::vector<history_event_t> &events);
+  void cancel_watchers(uint64_t connection_id);
+
+  static bool match_key_range(const std::string &key, const std::string &range_begin, const std::string &range_end);
+  std::string make_error(int grpc_code, const std::string &message) const;
+
+ private:
+  uv_loop_t *loop_;
+  bool closing_;
+  uv_timer_t *lease_timer_;
+  std::vector<listener_t *> listeners_;
+  std::vector<std::string> urls_;
+  std::unordered_map<uint64_t, connection_t *> connections_;
+  uint64_t connection_id_allocator_;
+
+  std::chrono::milliseconds default_delay_;
+  std::unordered_map<std::string, std::chrono::milliseconds> member_delay_;
+  std::vector<fault_rule_t> faults_;
+  std::set<delayed_write_t *> delayed_writes_;
+
+  int64_t revision_;
+  int64_t compact_revision_;
+  int64_t lease_id_allocator_;
+  int64_t watch_id_allocator_;
+  size_t max_history_;
+  std::map<std::string, etcd_key_value> kvs_;
+  std::unordered_map<int64_t, lease_t> leases_;
+  std::vector<history_event_t> history_;
+  std::map<int64_t, watcher_t> watchers_;
+
+  stats_t stats_;
+};
+
+}  // namespace test
+}  // namespace atapp
+}  // namespace atframework
@@ -0,0 +1,827 @@
+// Copyright 2026 atframework
+// etcd_cluster / etcd_keepalive / etcd_watcher tests against the in-process fake etcd gateway (no etcd service required)
+
+#include <atframe/etcdcli/etcd_cluster.h>
+#include <atframe/etcdcli/etcd_keepalive.h>
+#include <atframe/etcdcli/etcd_watcher.h>
+
+#include <common/file_system.h>
+#include <network/http_request.h>
+#include <time/time_utility.h>
+
+#include <uv.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "atapp_etcd_fake_gateway.h"
+#include "frame/test_macros.h"
+
+namespace {
+
+struct fake_etcd_setup {
+  atframework::atapp::test::etcd_fake_gateway gateway;
+  atfw::util::network::http_request::curl_m_bind_ptr_t curl_multi;
+  std::string url;
+
+  fake_etcd_setup() : gateway(uv_default_loop()) {
+    static CURLcode curl_init_res = curl_global_init(CURL_GLOBAL_ALL);
+    if (CURLE_OK != curl_init_res) {
+      return;
+    }
+
+    url = gateway.listen();
+
+    atfw::util::network::http_request::curl_share_options share_options;
+    atfw::util::network::http_request::curl_multi_options multi_options;
+    multi_options.ev_loop = uv_default_loop();
+    atfw::util::network::http_request::create_curl_share(share_options, multi_options.share_context);
+    atfw::util::network::http_request::create_curl_multi(multi_options, curl_multi);
+  }
+
+  ~fake_etcd_setup() {
+    gateway.close();
+    if (curl_multi) {
+      atfw::util::network::http_request::destroy_curl_multi(curl_multi);
+    }
+
+    // Release all closing handles
+    for (int i = 0; i < 16; ++i) {
+      uv_run(uv_default_loop(), UV_RUN_NOWAIT);
+    }
+  }
+
+  bool available() const { return !url.empty() && !!curl_multi; }
+
+  void setup_cluster(atapp::etcd_cluster &cluster) {
+    cluster.set_conf_hosts({url});
+    cluster.set_conf_http_request_timeout(std::chrono::seconds(3));
+    cluster.set_conf_keepalive_retry_interval(std::chrono::milliseconds(200));
+    cluster.set_conf_keepalive_interval(std::chrono::seconds(1));
+    cluster.set_conf_keepalive_timeout(std::chrono::seconds(5));
+    cluster.set_flag(atapp::etcd_cluster::flag_t::kEnableLease, true);
+    cluster.init(curl_multi);
+  }
+
+  template <typename CondFn>
+  bool run_until(const std::vector<atapp::etcd_cluster *> &clusters, CondFn &&cond,
+                 std::chrono::seconds timeout_sec = std::chrono::seconds(10)) {
+    atfw::util::time::time_utility::update();
+    auto end_time = atfw::util::time::time_utility::sys_now() + timeout_sec;
+
+    while (!cond() && atfw::util::time::time_utility::sys_now() < end_time) {
+      uv_run(uv_default_loop(), UV_RUN_NOWAIT);
+      atfw::util::time::time_utility::update();
+      for (auto &cluster : clusters) {
+        cluster->tick();
+      }
+    }
+
+    return cond();
+  }
+
+  template <typename CondFn>
+  bool run_until(atapp::etcd_cluster &cluster, CondFn &&cond,
+                 std::chrono::seconds timeout_sec = std::chrono::seconds(10)) {
+    return run_until(std::vector<atapp::etcd_cluster *>{&cluster}, std::forward<CondFn>(cond), timeout_sec);
+  }
+};
+
+}  // namespace
+
+CASE_TEST(atapp_etcd_fake_gateway, lease_and_keepalive) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  atapp::etcd_cluster cluster;
+  setup.setup_cluster(cluster);
+
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&cluster]() { return 0 != cluster.get_lease(); }));
+  CASE_EXPECT_EQ(1, static_cast<int>(setup.gateway.get_lease_count()));
+
+  std::string key = "/atapp/unit-test/fake_gateway/keepalive/node-1";
+  auto keepalive = atapp::etcd_keepalive::create(cluster, key);
+  CASE_EXPECT_TRUE(!!keepalive);
+  if (!keepalive) {
+    return;
+  }
+  keepalive->set_value("value-1");
+  CASE_EXPECT_TRUE(cluster.add_keepalive(keepalive));
+
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup, &key]() { return nullptr != setup.gateway.get(key); }));
+  const atapp::etcd_key_value *kv = setup.gateway.get(key);
+  if (nullptr != kv) {
+    CASE_EXPECT_EQ("value-1", kv->value);
+    CASE_EXPECT_EQ(cluster.get_lease(), kv->lease);
+  }
+
+  // Lease should be renewed but not granted again
+  size_t keepalive_count = setup.gateway.get_stats().lease_keepalive;
+  int64_t lease = cluster.get_lease();
+  CASE_EXPECT_TRUE(setup.run_until(
+      cluster, [&setup, keepalive_count]() { return setup.gateway.get_stats().lease_keepalive > keepalive_count; }));
+  CASE_EXPECT_EQ(lease, cluster.get_lease());
+
+  // Expired lease will be granted again
+  CASE_EXPECT_TRUE(setup.gateway.expire_lease(lease));
+  CASE_EXPECT_TRUE(nullptr == setup.gateway.get(key));
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup, &key]() { return nullptr != setup.gateway.get(key); }));
+  CASE_EXPECT_NE(lease, cluster.get_lease());
+
+  cluster.remove_keepalive(keepalive);
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup, &key]() { return nullptr == setup.gateway.get(key); }));
+
+  cluster.close(false, true);
+  cluster.reset();
+}
+
+CASE_TEST(atapp_etcd_fake_gateway, watcher_events) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  atapp::etcd_cluster cluster;
+  setup.setup_cluster(cluster);
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&cluster]() { return cluster.is_available(); }));
+
+  std::string prefix = "/atapp/unit-test/fake_gateway/watcher/";
+  setup.gateway.put(prefix + "exists", "exists-value");
+
+  size_t snapshot_count = 0;
+  size_t put_count = 0;
+  size_t delete_count = 0;
+  auto watcher = atapp::etcd_watcher::create(cluster, prefix, "+1");
+  CASE_EXPECT_TRUE(!!watcher);
+  if (!watcher) {
+    return;
+  }
+
+  watcher->set_evt_handle([&snapshot_count, &put_count, &delete_count](const atapp::etcd_response_header &,
+                                                                       const atapp::etcd_watcher::response_t &evt_data) {
+    if (evt_data.snapshot) {
+      snapshot_count += evt_data.events.size();
+      return;
+    }
+
+    for (const auto &evt : evt_data.events) {
+      if (evt.evt_type == atapp::etcd_watch_event::kPut) {
+        ++put_count;
+      } else {
+        ++delete_count;
+      }
+    }
+  });
+  CASE_EXPECT_TRUE(cluster.add_watcher(watcher));
+
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&snapshot_count]() { return snapshot_count > 0; }));
+  CASE_EXPECT_EQ(1, static_cast<int>(snapshot_count));
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup]() { return setup.gateway.get_watch_count() > 0; }));
+
+  setup.gateway.put(prefix + "new-key", "new-value");
+  setup.gateway.put("/atapp/unit-test/fake_gateway/other", "ignored");
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&put_count]() { return put_count > 0; }));
+  CASE_EXPECT_EQ(1, static_cast<int>(put_count));
+
+  // range end of prefix "/.../watcher/" is "/.../watcher0"
+  setup.gateway.remove(prefix, prefix.substr(0, prefix.size() - 1) + "0");
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&delete_count]() { return delete_count >= 2; }));
+  CASE_EXPECT_EQ(2, static_cast<int>(delete_count));
+
+  cluster.remove_watcher(watcher);
+  cluster.close(false, false);
+  cluster.reset();
+}
+
+namespace {
+struct checkpoint_watcher_events {
+  size_t checkpoint_snapshot_count = 0;
+  size_t snapshot_count = 0;
+  size_t snapshot_keys = 0;
+  size_t put_count = 0;
+  size_t delete_count = 0;
+
+  void operator()(const atapp::etcd_response_header &, const atapp::etcd_watcher::response_t &evt_data) {
+    if (evt_data.snapshot) {
+      if (evt_data.from_checkpoint) {
+        ++checkpoint_snapshot_count;
+      } else {
+        ++snapshot_count;
+      }
+      snapshot_keys = evt_data.events.size();
+      return;
+    }
+
+    for (const auto &evt : evt_data.events) {
+      if (evt.evt_type == atapp::etcd_watch_event::kPut) {
+        ++put_count;
+      } else {
+        ++delete_count;
+      }
+    }
+  }
+};
+}  // namespace
+
+CASE_TEST(atapp_etcd_fake_gateway, watcher_checkpoint) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  std::string checkpoint_file = "atapp_etcd_fake_gateway_watcher_checkpoint.json";
+  std::string journal_file = checkpoint_file + ".journal";
+  std::remove(checkpoint_file.c_str());
+  std::remove(journal_file.c_str());
+
+  atapp::etcd_cluster cluster;
+  setup.setup_cluster(cluster);
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&cluster]() { return cluster.is_available(); }));
+
+  std::string prefix = "/atapp/unit-test/fake_gateway/checkpoint/";
+  setup.gateway.put(prefix + "node-1", "value-1");
+  setup.gateway.put(prefix + "node-2", "value-2");
+
+  // First start without checkpoint, load all data by range request
+  {
+    checkpoint_watcher_events events;
+    auto watcher = atapp::etcd_watcher::create(cluster, prefix, "+1");
+    CASE_EXPECT_TRUE(!!watcher);
+    if (!watcher) {
+      return;
+    }
+    watcher->set_conf_checkpoint_file(checkpoint_file);
+    watcher->set_evt_handle(std::ref(events));
+    cluster.add_watcher(watcher);
+
+    CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup]() { return setup.gateway.get_watch_count() > 0; }));
+    CASE_EXPECT_EQ(0, static_cast<int>(events.checkpoint_snapshot_count));
+    CASE_EXPECT_EQ(1, static_cast<int>(events.snapshot_count));
+    CASE_EXPECT_EQ(2, static_cast<int>(events.snapshot_keys));
+
+    setup.gateway.put(prefix + "node-3", "value-3");
+    CASE_EXPECT_TRUE(setup.run_until(cluster, [&events]() { return events.put_count > 0; }));
+    CASE_EXPECT_EQ(3, static_cast<int>(watcher->get_checkpoint_key_count()));
+    CASE_EXPECT_EQ(setup.gateway.get_revision(), watcher->get_checkpoint_revision());
+
+    // Checkpoint will be saved when closing, only changes after the range response are appended into journal
+    cluster.remove_watcher(watcher);
+    CASE_EXPECT_TRUE(atfw::util::file_system::is_exist(checkpoint_file.c_str()));
+    CASE_EXPECT_TRUE(atfw::util::file_system::is_exist(journal_file.c_str()));
+  }
+
+  // Changed when offline
+  setup.gateway.remove(prefix + "node-1");
+  setup.gateway.put(prefix + "node-4", "value-4");
+
+  // Restart, resume from checkpoint without range request
+  {
+    size_t range_count = setup.gateway.get_stats().kv_range;
+    checkpoint_watcher_events events;
+    auto watcher = atapp::etcd_watcher::create(cluster, prefix, "+1");
+    CASE_EXPECT_TRUE(!!watcher);
+    if (!watcher) {
+      return;
+    }
+    watcher->set_conf_checkpoint_file(checkpoint_file);
+    watcher->set_evt_handle(std::ref(events));
+    cluster.add_watcher(watcher);
+    cluster.tick();
+
+    // Snapshot from checkpoint is notified immediately, but it's not confirmed by etcd yet
+    CASE_EXPECT_EQ(1, static_cast<int>(events.checkpoint_snapshot_count));
+    CASE_EXPECT_EQ(0, static_cast<int>(events.snapshot_count));
+    CASE_EXPECT_EQ(3, static_cast<int>(events.snapshot_keys));
+
+    // The first events after the checkpoint revision confirm it
+    CASE_EXPECT_TRUE(
+        setup.run_until(cluster, [&events]() { return events.put_count >= 1 && events.delete_count >= 1; }));
+    CASE_EXPECT_EQ(1, static_cast<int>(events.checkpoint_snapshot_count));
+    CASE_EXPECT_EQ(1, static_cast<int>(events.snapshot_count));
+    CASE_EXPECT_EQ(3, static_cast<int>(events.snapshot_keys));
+    CASE_EXPECT_EQ(1, static_cast<int>(events.put_count));
+    CASE_EXPECT_EQ(1, static_cast<int>(events.delete_count));
+    CASE_EXPECT_EQ(range_count, setup.gateway.get_stats().kv_range);
+    CASE_EXPECT_EQ(3, static_cast<int>(watcher->get_checkpoint_key_count()));
+
+    cluster.remove_watcher(watcher);
+  }
+
+  // Checkpoint revision is compacted, load by range request and notify it as a snapshot to replace the stale one
+  setup.gateway.put(prefix + "node-2", "value-2-changed");
+  setup.gateway.put("/atapp/unit-test/fake_gateway/other", "ignored");
+  setup.gateway.compact(setup.gateway.get_revision());
+  {
+    size_t range_count = setup.gateway.get_stats().kv_range;
+    checkpoint_watcher_events events;
+    auto watcher = atapp::etcd_watcher::create(cluster, prefix, "+1");
+    CASE_EXPECT_TRUE(!!watcher);
+    if (!watcher) {
+      return;
+    }
+    watcher->set_conf_checkpoint_file(checkpoint_file);
+    watcher->set_conf_retry_interval(std::chrono::milliseconds(100));
+    watcher->set_evt_handle(std::ref(events));
+    cluster.add_watcher(watcher);
+
+    CASE_EXPECT_TRUE(setup.run_until(cluster, [&events]() { return events.snapshot_count > 0; }));
+    CASE_EXPECT_EQ(1, static_cast<int>(events.checkpoint_snapshot_count));
+    CASE_EXPECT_EQ(1, static_cast<int>(events.snapshot_count));
+    CASE_EXPECT_EQ(3, static_cast<int>(events.snapshot_keys));
+    CASE_EXPECT_EQ(0, static_cast<int>(events.put_count));
+    CASE_EXPECT_EQ(0, static_cast<int>(events.delete_count));
+    CASE_EXPECT_LT(range_count, setup.gateway.get_stats().kv_range);
+    CASE_EXPECT_EQ(setup.gateway.get_revision(), watcher->get_checkpoint_revision());
+
+    // Range response rewrites the whole checkpoint and drops the journal
+    CASE_EXPECT_TRUE(setup.run_until(cluster, [&journal_file]() {
+      return !atfw::util::file_system::is_exist(journal_file.c_str());
+    }));
+
+    cluster.remove_watcher(watcher);
+  }
+
+  cluster.close(false, false);
+  cluster.reset();
+  std::remove(checkpoint_file.c_str());
+  std::remove(journal_file.c_str());
+}
+
+CASE_TEST(atapp_etcd_fake_gateway, watcher_checkpoint_set_handle_later) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  std::string checkpoint_file = "atapp_etcd_fake_gateway_watcher_checkpoint_later.json";
+  std::string journal_file = checkpoint_file + ".journal";
+  std::remove(checkpoint_file.c_str());
+  std::remove(journal_file.c_str());
+
+  atapp::etcd_cluster cluster;
+  setup.setup_cluster(cluster);
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&cluster]() { return cluster.is_available(); }));
+
+  std::string prefix = "/atapp/unit-test/fake_gateway/checkpoint_later/";
+  setup.gateway.put(prefix + "node-1", "value-1");
+  setup.gateway.put(prefix + "node-2", "value-2");
+
+  {
+    checkpoint_watcher_events events;
+    auto watcher = atapp::etcd_watcher::create(cluster, prefix, "+1");
+    CASE_EXPECT_TRUE(!!watcher);
+    if (!watcher) {
+      return;
+    }
+    watcher->set_conf_checkpoint_file(checkpoint_file);
+    watcher->set_evt_handle(std::ref(events));
+    cluster.add_watcher(watcher);
+    CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup]() { return setup.gateway.get_watch_count() > 0; }));
+    cluster.remove_watcher(watcher);
+  }
+
+  // Resume without event handle, the snapshot should be kept until the handle is set
+  {
+    checkpoint_watcher_events events;
+    auto watcher = atapp::etcd_watcher::create(cluster, prefix, "+1");
+    CASE_EXPECT_TRUE(!!watcher);
+    if (!watcher) {
+      return;
+    }
+    watcher->set_conf_checkpoint_file(checkpoint_file);
+    cluster.add_watcher(watcher);
+    cluster.tick();
+    CASE_EXPECT_TRUE(watcher->has_checkpoint());
+    CASE_EXPECT_EQ(0, static_cast<int>(events.checkpoint_snapshot_count));
+
+    watcher->set_evt_handle(std::ref(events));
+    CASE_EXPECT_TRUE(setup.run_until(cluster, [&events]() { return events.checkpoint_snapshot_count > 0; }));
+    CASE_EXPECT_EQ(1, static_cast<int>(events.checkpoint_snapshot_count));
+    CASE_EXPECT_EQ(0, static_cast<int>(events.snapshot_count));
+    CASE_EXPECT_EQ(2, static_cast<int>(events.snapshot_keys));
+
+    cluster.remove_watcher(watcher);
+  }
+
+  cluster.close(false, false);
+  cluster.reset();
+  std::remove(checkpoint_file.c_str());
+  std::remove(journal_file.c_str());
+}
+
+CASE_TEST(atapp_etcd_fake_gateway, fault_injection) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  setup.gateway.inject_fault("/v3/lease/grant", atframework::atapp::test::etcd_fake_gateway::fault_type::kHttpError,
+                             2);
+
+  atapp::etcd_cluster cluster;
+  setup.setup_cluster(cluster);
+
+  // Client should retry and get lease after injected faults
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&cluster]() { return 0 != cluster.get_lease(); }));
+  CASE_EXPECT_EQ(2, static_cast<int>(setup.gateway.get_stats().injected_faults));
+  CASE_EXPECT_EQ(1, static_cast<int>(setup.gateway.get_stats().lease_grant));
+  CASE_EXPECT_LE(2, static_cast<int>(cluster.get_stats().sum_error_requests));
+
+  cluster.close(false, true);
+  cluster.reset();
+}
+
+CASE_TEST(atapp_etcd_fake_gateway, member_health_host_port) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  // http://127.0.0.1:4512 must not be matched by requests to http://127.0.0.1:45123
+  std::string prefix_host = setup.url.substr(0, setup.url.size() - 1);
+
+  atapp::etcd_cluster cluster;
+  cluster.set_conf_hosts({prefix_host, setup.url});
+  cluster.set_conf_etcd_members_auto_update_hosts(false);
+  cluster.set_conf_etcd_members_latency_aware_select(true);
+  cluster.set_conf_http_request_timeout(std::chrono::seconds(3));
+  cluster.set_conf_keepalive_retry_interval(std::chrono::milliseconds(200));
+  cluster.set_conf_keepalive_interval(std::chrono::seconds(1));
+  cluster.set_conf_keepalive_timeout(std::chrono::seconds(5));
+  cluster.set_flag(atapp::etcd_cluster::flag_t::kEnableLease, true);
+  cluster.init(setup.curl_multi);
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&cluster]() { return 0 != cluster.get_lease(); }));
+
+  const atapp::etcd_cluster::member_health_t *health = cluster.get_member_health(setup.url);
+  CASE_EXPECT_TRUE(nullptr != health);
+  if (nullptr != health) {
+    CASE_EXPECT_LT(0, static_cast<int>(health->sample_count));
+  }
+
+  // Prefix host is never available, it should only have failed samples if any
+  const atapp::etcd_cluster::member_health_t *prefix_health = cluster.get_member_health(prefix_host);
+  if (nullptr != prefix_health) {
+    CASE_EXPECT_LT(0.99, prefix_health->ewma_error_rate);
+  }
+
+  cluster.close(false, true);
+  cluster.reset();
+}
+
+CASE_TEST(atapp_etcd_fake_gateway, request_stats_unhooked) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  atapp::etcd_cluster cluster;
+  setup.setup_cluster(cluster);
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&cluster]() { return 0 != cluster.get_lease(); }));
+
+  const atapp::etcd_cluster::request_stats_t &kv_get_stats =
+      cluster.get_stats().requests_by_type[static_cast<size_t>(atapp::etcd_cluster::request_type_t::kKvGet)];
+  size_t cancelled_count = kv_get_stats.sum_cancelled_requests;
+
+  // Finished request without completion callback should not be counted as cancelled
+  {
+    auto req = cluster.create_request_kv_get("/atapp/unit-test/fake_gateway/stats/unhooked");
+    CASE_EXPECT_TRUE(!!req);
+    if (!req) {
+      return;
+    }
+    CASE_EXPECT_EQ(0, req->start(atfw::util::network::http_request::method_t::EN_MT_POST, false));
+  }
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&kv_get_stats]() { return 0 < kv_get_stats.sum_unhooked_requests; }));
+  CASE_EXPECT_EQ(1, static_cast<int>(kv_get_stats.sum_unhooked_requests));
+  CASE_EXPECT_EQ(cancelled_count, kv_get_stats.sum_cancelled_requests);
+  CASE_EXPECT_EQ(0, static_cast<int>(kv_get_stats.in_flight));
+
+  // Stopped request is still counted as cancelled
+  {
+    auto req = cluster.create_request_kv_get("/atapp/unit-test/fake_gateway/stats/cancelled");
+    CASE_EXPECT_TRUE(!!req);
+    if (!req) {
+      return;
+    }
+    setup.gateway.set_response_delay(std::chrono::milliseconds(500));
+    CASE_EXPECT_EQ(0, req->start(atfw::util::network::http_request::method_t::EN_MT_POST, false));
+    req->stop();
+  }
+  CASE_EXPECT_TRUE(setup.run_until(
+      cluster, [&kv_get_stats, cancelled_count]() { return cancelled_count < kv_get_stats.sum_cancelled_requests; }));
+  CASE_EXPECT_EQ(1, static_cast<int>(kv_get_stats.sum_unhooked_requests));
+  setup.gateway.set_response_delay(std::chrono::milliseconds::zero());
+
+  cluster.close(false, true);
+  cluster.reset();
+}
+
+CASE_TEST(atapp_etcd_fake_gateway, keepalive_batch_set) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  atapp::etcd_cluster cluster;
+  setup.setup_cluster(cluster);
+  cluster.set_conf_keepalive_batch_set(true);
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&cluster]() { return 0 != cluster.get_lease(); }));
+
+  std::vector<std::string> keys = {"/atapp/unit-test/fake_gateway/batch/node-1",
+                                   "/atapp/unit-test/fake_gateway/batch/node-2",
+                                   "/atapp/unit-test/fake_gateway/batch/node-3"};
+  std::vector<atapp::etcd_keepalive::ptr_t> keepalives;
+  for (auto &key : keys) {
+    auto keepalive = atapp::etcd_keepalive::create(cluster, key);
+    CASE_EXPECT_TRUE(!!keepalive);
+    if (!keepalive) {
+      return;
+    }
+    keepalive->set_value(key + "-value");
+    CASE_EXPECT_TRUE(cluster.add_keepalive(keepalive));
+    keepalives.push_back(keepalive);
+  }
+
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup, &keys]() {
+    for (auto &key : keys) {
+      if (nullptr == setup.gateway.get(key)) {
+        return false;
+      }
+    }
+    return true;
+  }));
+  for (auto &key : keys) {
+    const atapp::etcd_key_value *kv = setup.gateway.get(key);
+    if (nullptr != kv) {
+      CASE_EXPECT_EQ(key + "-value", kv->value);
+      CASE_EXPECT_EQ(cluster.get_lease(), kv->lease);
+    }
+  }
+
+  // All data should be written by txn requests
+  CASE_EXPECT_EQ(0, static_cast<int>(setup.gateway.get_stats().kv_put));
+  CASE_EXPECT_LE(1, static_cast<int>(setup.gateway.get_stats().kv_txn));
+  CASE_EXPECT_GE(3, static_cast<int>(setup.gateway.get_stats().kv_txn));
+  for (auto &keepalive : keepalives) {
+    CASE_EXPECT_TRUE(keepalive->has_data());
+  }
+
+  // Value changes are also written by txn requests
+  size_t txn_count = setup.gateway.get_stats().kv_txn;
+  keepalives[0]->set_value("changed-value");
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup, &keys]() {
+    const atapp::etcd_key_value *kv = setup.gateway.get(keys[0]);
+    return nullptr != kv && kv->value == "changed-value";
+  }));
+  CASE_EXPECT_EQ(txn_count + 1, setup.gateway.get_stats().kv_txn);
+  CASE_EXPECT_EQ(0, static_cast<int>(setup.gateway.get_stats().kv_put));
+
+  for (auto &keepalive : keepalives) {
+    cluster.remove_keepalive(keepalive);
+  }
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup]() { return 0 == setup.gateway.get_key_count(); }));
+
+  cluster.close(false, true);
+  cluster.reset();
+}
+
+CASE_TEST(atapp_etcd_fake_gateway, keepalive_batch_set_remove_running) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  atapp::etcd_cluster cluster;
+  setup.setup_cluster(cluster);
+  cluster.set_conf_keepalive_batch_set(true);
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&cluster]() { return 0 != cluster.get_lease(); }));
+
+  std::string key = "/atapp/unit-test/fake_gateway/batch_remove/node-1";
+  auto keepalive = atapp::etcd_keepalive::create(cluster, key);
+  CASE_EXPECT_TRUE(!!keepalive);
+  if (!keepalive) {
+    return;
+  }
+  keepalive->set_value("value-1");
+
+  // Delay responses, so the txn request is still running after the gateway applied it
+  setup.gateway.set_response_delay(std::chrono::milliseconds(500));
+  CASE_EXPECT_TRUE(cluster.add_keepalive(keepalive));
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup]() { return 0 < setup.gateway.get_stats().kv_txn; }));
+  CASE_EXPECT_TRUE(nullptr != setup.gateway.get(key));
+  CASE_EXPECT_FALSE(keepalive->has_data());
+
+  // The path should be deleted after the running txn request finished
+  size_t delete_count = setup.gateway.get_stats().kv_delete;
+  CASE_EXPECT_TRUE(cluster.remove_keepalive(keepalive));
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup, delete_count]() {
+    return setup.gateway.get_stats().kv_delete > delete_count;
+  }));
+  setup.gateway.set_response_delay(std::chrono::milliseconds::zero());
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup, &key]() { return nullptr == setup.gateway.get(key); }));
+  CASE_EXPECT_FALSE(keepalive->has_data());
+
+  cluster.close(false, true);
+  cluster.reset();
+}
+
+CASE_TEST(atapp_etcd_fake_gateway, keepalive_batch_set_failed) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  atapp::etcd_cluster cluster;
+  setup.setup_cluster(cluster);
+  cluster.set_conf_keepalive_batch_set(true);
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&cluster]() { return 0 != cluster.get_lease(); }));
+
+  setup.gateway.inject_fault("/v3/kv/txn", atframework::atapp::test::etcd_fake_gateway::fault_type::kHttpError, 1);
+
+  std::string key = "/atapp/unit-test/fake_gateway/batch_failed/node-1";
+  auto keepalive = atapp::etcd_keepalive::create(cluster, key);
+  CASE_EXPECT_TRUE(!!keepalive);
+  if (!keepalive) {
+    return;
+  }
+  keepalive->set_value("value-1");
+  CASE_EXPECT_TRUE(cluster.add_keepalive(keepalive));
+
+  // Failed txn request should be retried
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&keepalive]() { return keepalive->has_data(); }));
+  CASE_EXPECT_EQ(1, static_cast<int>(setup.gateway.get_stats().injected_faults));
+  CASE_EXPECT_EQ(1, static_cast<int>(setup.gateway.get_stats().kv_txn));
+  const atapp::etcd_key_value *kv = setup.gateway.get(key);
+  CASE_EXPECT_TRUE(nullptr != kv);
+  if (nullptr != kv) {
+    CASE_EXPECT_EQ("value-1", kv->value);
+  }
+
+  cluster.remove_keepalive(keepalive);
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&setup, &key]() { return nullptr == setup.gateway.get(key); }));
+
+  cluster.close(false, true);
+  cluster.reset();
+}
+
+CASE_TEST(atapp_etcd_fake_gateway, keepalive_batch_set_rejected) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  atapp::etcd_cluster cluster;
+  setup.setup_cluster(cluster);
+  cluster.set_conf_keepalive_batch_set(true);
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&cluster]() { return 0 != cluster.get_lease(); }));
+
+  setup.gateway.inject_fault("/v3/kv/txn", atframework::atapp::test::etcd_fake_gateway::fault_type::kHttpError, 1);
+
+  std::vector<std::string> keys = {"/atapp/unit-test/fake_gateway/batch_rejected/node-1",
+                                   "/atapp/unit-test/fake_gateway/batch_rejected/node-2"};
+  std::vector<atapp::etcd_keepalive::ptr_t> keepalives;
+  for (auto &key : keys) {
+    auto keepalive = atapp::etcd_keepalive::create(cluster, key);
+    CASE_EXPECT_TRUE(!!keepalive);
+    if (!keepalive) {
+      return;
+    }
+    keepalive->set_value(key + "-value");
+    CASE_EXPECT_TRUE(cluster.add_keepalive(keepalive));
+    keepalives.push_back(keepalive);
+  }
+
+  // Keys of a rejected txn are retried by their own put requests
+  CASE_EXPECT_TRUE(setup.run_until(cluster, [&keepalives]() {
+    for (auto &keepalive : keepalives) {
+      if (!keepalive->has_data()) {
+        return false;
+      }
+    }
+    return true;
+  }));
+  CASE_EXPECT_EQ(1, static_cast<int>(setup.gateway.get_stats().injected_faults));
+  CASE_EXPECT_EQ(0, static_cast<int>(setup.gateway.get_stats().kv_txn));
+  CASE_EXPECT_EQ(2, static_cast<int>(setup.gateway.get_stats().kv_put));
+  for (auto &key : keys) {
+    const atapp::etcd_key_value *kv = setup.gateway.get(key);
+    CASE_EXPECT_TRUE(nullptr != kv);
+    if (nullptr != kv) {
+      CASE_EXPECT_EQ(key + "-value", kv->value);
+    }
+  }
+
+  // Later changes are merged into txn requests again
+  keepalives[0]->set_value("value-changed");
+  CASE_EXPECT_TRUE(setup.run_until(
+      cluster, [&setup]() { return 1 == static_cast<int>(setup.gateway.get_stats().kv_txn); }));
+
+  for (auto &keepalive : keepalives) {
+    cluster.remove_keepalive(keepalive);
+  }
+  cluster.close(false, true);
+  cluster.reset();
+}
+
+CASE_TEST(atapp_etcd_fake_gateway, share_lease) {
+  fake_etcd_setup setup;
+  CASE_EXPECT_TRUE(setup.available());
+  if (!setup.available()) {
+    return;
+  }
+
+  atapp::etcd_cluster cluster1;
+  atapp::etcd_cluster cluster2;
+  atapp::etcd_cluster cluster3;
+  std::vector<atapp::etcd_cluster *> clusters = {&cluster1, &cluster2, &cluster3};
+  for (auto &cluster : clusters) {
+    setup.setup_cluster(*cluster);
+    cluster->set_conf_keepalive_share_lease(true);
+  }
+  // Different keepalive timeout means different TTL, should not share lease
+  cluster3.set_conf_keepalive_timeout(std::chrono::seconds(7));
+
+  CASE_EXPECT_TRUE(setup.run_until(clusters, [&clusters]() {
+    for (auto &cluster : clusters) {
+      if (0 == cluster->get_lease()) {
+        return false;
+      }
+    }
+    return true;
+  }));
+  CASE_EXPECT_EQ(cluster1.get_lease(), cluster2.get_lease());
+  CASE_EXPECT_NE(cluster1.get_lease(), cluster3.get_lease());
+  CASE_EXPECT_EQ(2, static_cast<int>(setup.gateway.get_lease_count()));
+  CASE_EXPECT_EQ(2, static_cast<int>(cluster1.get_lease_share_count()));
+  CASE_EXPECT_EQ(1, static_cast<int>(cluster3.get_lease_share_count()));
+  CASE_EXPECT_TRUE(cluster1.is_lease_share_leader());
+  CASE_EXPECT_FALSE(cluster2.is_lease_share_leader());
+
+  std::string key1 = "/atapp/unit-test/fake_gateway/share_lease/node-1";
+  std::string key2 = "/atapp/unit-test/fake_gateway/share_lease/node-2";
+  auto keepalive1 = atapp::etcd_keepalive::create(cluster1, key1);
+  auto keepalive2 = atapp::etcd_keepalive::create(cluster2, key2);
+  CASE_EXPECT_TRUE(!!keepalive1 && !!keepalive2);
+  if (!keepalive1 || !keepalive2) {
+    return;
+  }
+  keepalive1->set_value("value-1");
+  keepalive2->set_value("value-2");
+  cluster1.add_keepalive(keepalive1);
+  cluster2.add_keepalive(keepalive2);
+  CASE_EXPECT_TRUE(setup.run_until(clusters, [&setup, &key1, &key2]() {
+    return nullptr != setup.gateway.get(key1) && nullptr != setup.gateway.get(key2);
+  }));
+
+  // Only the leader renews the shared lease
+  size_t grant_count = setup.gateway.get_stats().lease_grant;
+  int64_t shared_lease = cluster1.get_lease();
+
+  // Leader leaves, follower takes over the lease and removes data of leader, failed deletion should be retried
+  size_t injected_faults = setup.gateway.get_stats().injected_faults;
+  setup.gateway.inject_fault("/v3/kv/deleterange", atframework::atapp::test::etcd_fake_gateway::fault_type::kHttpError,
+                             1);
+  auto close_req = cluster1.close(false, true);
+  CASE_EXPECT_FALSE(!!close_req);
+  CASE_EXPECT_TRUE(setup.run_until(clusters, [&setup, &key1]() { return nullptr == setup.gateway.get(key1); }));
+  CASE_EXPECT_EQ(injected_faults + 1, setup.gateway.get_stats().injected_faults);
+  CASE_EXPECT_TRUE(nullptr != setup.gateway.get(key2));
+  CASE_EXPECT_TRUE(cluster2.is_lease_share_leader());
+  CASE_EXPECT_EQ(1, static_cast<int>(cluster2.get_lease_share_count()));
+
+  size_t keepalive_count = setup.gateway.get_stats().lease_keepalive;
+  CASE_EXPECT_TRUE(setup.run_until(
+      clusters, [&setup, keepalive_count]() { return setup.gateway.get_stats().lease_keepalive > keepalive_count; }));
+  CASE_EXPECT_EQ(shared_lease, cluster2.get_lease());
+  CASE_EXPECT_EQ(grant_count, setup.gateway.get_stats().lease_grant);
+
+  // Last one revokes the lease
+  close_req = cluster2.close(false, true);
+  CASE_EXPECT_TRUE(!!close_req);
+  CASE_EXPECT_TRUE(setup.run_until(clusters, [&setup, &key2]() { return nullptr == setup.gateway.get(key2); }));
+  CASE_EXPECT_EQ(1, static_cast<int>(setup.gateway.get_lease_count()));
+
+  close_req = cluster3.close(false, true);
+  setup.run_until(clusters, [&setup]() { return 0 == setup.gateway.get_lease_count(); });
+  close_req.reset();
+  for (auto &cluster : clusters) {
+    cluster->reset();
+  }
+}
@@ -1617,7 +1617,7 @@ CASE_TEST(atapp_etcd_module, tick_keepalive_updates) {
     if (!node) {
       return false;
     }
-    return node->get_discovery_info().metadata().kind() == "test_kind_tick_verify";
+    return node->get_metadata().kind() == "test_kind_tick_verify";
   });
   CASE_EXPECT_TRUE(kind_updated);
 
@@ -5,7 +5,9 @@
 //   1. atapp_area comparison semantics (atapp_discovery_equal logic)
 //   2. atapp::service_discovery_module::topology_storage_t version update semantics (topology_update_version logic)
 //   3. etcd_module pack/unpack round-trip for topology_info_t and node_info_t
+//   4. etcd logger reload when only atapp.etcd.log.* is changed
 
+#include <atframe/atapp.h>
 #include <atframe/modules/etcd_module.h>
 #include <atframe/modules/service_discovery_module.h>
 
@@ -21,13 +23,22 @@
 #include <config/compiler/protobuf_suffix.h>
 // clang-format on
 
+#include <common/file_system.h>
+#include <log/log_formatter.h>
+
 #include <cstdint>
+#include <cstdlib>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "frame/test_macros.h"
 
+#if defined(_WIN32)
+inline int setenv(const char *name, const char *value, int) { return _putenv_s(name, value); }
+inline int unsetenv(const char *name) { return setenv(name, "", 1); }
+#endif
+
 // ==================== atapp_area comparison tests ====================
 // These tests verify the same comparison semantics as the internal
 // atapp_discovery_equal() function in etcd_module.cpp.
@@ -773,3 +784,47 @@ CASE_TEST(atapp_etcd_module_unit, generate_etcd_path_preserve_slash) {
 CASE_TEST(atapp_etcd_module_unit, generate_etcd_path_preserve_backslash) {
   CASE_EXPECT_EQ(std::string("service\\discovery\\"), atapp::etcd_module::generate_etcd_path("service\\discovery\\"));
 }
+
+// ---- I.40 reload: etcd logger is reloaded even when atapp.etcd is not changed ----
+CASE_TEST(atapp_etcd_module_unit, reload_etcd_logger_only) {
+  std::string conf_path;
+  atfw::util::file_system::dirname(__FILE__, 0, conf_path);
+  conf_path += "/atapp_test_etcd_log_reload.yaml";
+  if (!atfw::util::file_system::is_exist(conf_path.c_str())) {
+    CASE_MSG_INFO() << CASE_MSG_FCOLOR(YELLOW) << conf_path << " not found, skip this test" << '
+';
+    return;
+  }
+
+  setenv("ATAPP_UNIT_TEST_ETCD_LOG_LEVEL", "info", 1);
+
+  atframework::atapp::app app;
+  const char *args[] = {"app", "-c", conf_path.c_str(), "start"};
+  CASE_EXPECT_EQ(0, app.init(nullptr, 4, args, nullptr));
+
+  auto discovery_module = app.get_service_discovery_module();
+  CASE_EXPECT_TRUE(!!discovery_module);
+  if (!discovery_module) {
+    unsetenv("ATAPP_UNIT_TEST_ETCD_LOG_LEVEL");
+    return;
+  }
+
+  const atapp::etcd_cluster &cluster = discovery_module->get_raw_etcd_ctx();
+  if (!cluster.get_logger()) {
+    CASE_MSG_INFO() << CASE_MSG_FCOLOR(YELLOW) << "etcd logger is not created, skip this test" << '
+';
+    unsetenv("ATAPP_UNIT_TEST_ETCD_LOG_LEVEL");
+    return;
+  }
+  CASE_EXPECT_TRUE(atfw::util::log::log_formatter::get_level_by_name("info") == cluster.get_runtime_log_level());
+
+  // Only atapp.etcd.log.level is changed, atapp_etcd is the same
+  setenv("ATAPP_UNIT_TEST_ETCD_LOG_LEVEL", "debug", 1);
+  CASE_EXPECT_EQ(0, app.reload());
+
+  CASE_EXPECT_FALSE(app.is_origin_configure_changed("etcd"));
+  CASE_EXPECT_TRUE(!!cluster.get_logger());
+  CASE_EXPECT_TRUE(atfw::util::log::log_formatter::get_level_by_name("debug") == cluster.get_runtime_log_level());
+
+  unsetenv("ATAPP_UNIT_TEST_ETCD_LOG_LEVEL");
+}
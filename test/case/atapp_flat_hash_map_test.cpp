@@ -0,0 +1,142 @@
+// Copyright 2026 atframework
+// flat_hash_map and small_pointer_set unit tests
+
+#include <atframe/atapp_flat_hash_map.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "frame/test_macros.h"
+
+CASE_TEST(atapp_flat_hash_map, insert_find_erase) {
+  atapp::flat_hash_map<uint64_t, std::shared_ptr<uint64_t>> container;
+  std::unordered_map<uint64_t, uint64_t> expect;
+
+  // Keys with the same low bits used to collide on power of two tables without mixing
+  for (uint64_t i = 0; i < 4096; ++i) {
+    uint64_t key = (i << 16) | 0x10;
+    container[key] = std::make_shared<uint64_t>(i);
+    expect[key] = i;
+  }
+  CASE_EXPECT_EQ(expect.size(), container.size());
+
+  // Erase every third key, remaining keys must still be found after backward shift
+  for (uint64_t i = 0; i < 4096; i += 3) {
+    uint64_t key = (i << 16) | 0x10;
+    CASE_EXPECT_EQ(1, container.erase(key));
+    CASE_EXPECT_EQ(0, container.erase(key));
+    expect.erase(key);
+  }
+  CASE_EXPECT_EQ(expect.size(), container.size());
+
+  for (auto &kv : expect) {
+    auto iter = container.find(kv.first);
+    CASE_EXPECT_TRUE(iter != container.end());
+    if (iter != container.end() && iter->second) {
+      CASE_EXPECT_EQ(kv.second, *iter->second);
+    }
+  }
+  CASE_EXPECT_TRUE(container.find(0x10000000) == container.end());
+
+  size_t iterated = 0;
+  for (auto &kv : container) {
+    CASE_EXPECT_EQ(1, expect.count(kv.first));
+    ++iterated;
+  }
+  CASE_EXPECT_EQ(expect.size(), iterated);
+
+  auto emplace_result = container.emplace(static_cast<uint64_t>(0x10), std::make_shared<uint64_t>(0));
+  CASE_EXPECT_TRUE(emplace_result.second);
+  emplace_result = container.emplace(static_cast<uint64_t>(0x10), std::make_shared<uint64_t>(1));
+  CASE_EXPECT_FALSE(emplace_result.second);
+
+  atapp::flat_hash_map<uint64_t, std::shared_ptr<uint64_t>> swapped;
+  swapped.swap(container);
+  CASE_EXPECT_TRUE(container.empty());
+  CASE_EXPECT_EQ(expect.size() + 1, swapped.size());
+
+  swapped.clear();
+  CASE_EXPECT_TRUE(swapped.empty());
+  CASE_EXPECT_TRUE(swapped.begin() == swapped.end());
+}
+
+CASE_TEST(atapp_flat_hash_map, string_view_lookup) {
+  atapp::flat_hash_map<std::string, int, atapp::flat_string_hash, atapp::flat_string_equal> container;
+  container["node-1"] = 1;
+  container[std::string("node-2")] = 2;
+
+  std::string buffer = "prefix:node-2";
+  gsl::string_view name{buffer.data() + 7, buffer.size() - 7};
+  auto iter = container.find(name);
+  CASE_EXPECT_TRUE(iter != container.end());
+  if (iter != container.end()) {
+    CASE_EXPECT_EQ(2, iter->second);
+  }
+
+  CASE_EXPECT_EQ(1, container.count("node-1"));
+  CASE_EXPECT_EQ(0, container.count(gsl::string_view{"node-3"}));
+
+  const auto &const_container = container;
+  CASE_EXPECT_TRUE(const_container.find(gsl::string_view{"node-1"}) != const_container.end());
+
+  CASE_EXPECT_EQ(1, container.erase(name));
+  CASE_EXPECT_EQ(1, container.size());
+}
+
+CASE_TEST(atapp_flat_hash_map, small_pointer_set) {
+  int values[5] = {0, 1, 2, 3, 4};
+  atapp::small_pointer_set<int, 2> container;
+
+  CASE_EXPECT_TRUE(container.insert(&values[0]).second);
+  CASE_EXPECT_FALSE(container.insert(&values[0]).second);
+  CASE_EXPECT_TRUE(container.insert(&values[1]).second);
+  CASE_EXPECT_EQ(2, container.size());
+
+  // Spill to heap
+  CASE_EXPECT_TRUE(container.insert(&values[2]).second);
+  CASE_EXPECT_TRUE(container.insert(&values[3]).second);
+  CASE_EXPECT_EQ(4, container.size());
+
+  CASE_EXPECT_EQ(1, container.erase(&values[1]));
+  CASE_EXPECT_EQ(0, container.erase(&values[4]));
+  CASE_EXPECT_EQ(1, container.erase(&values[0]));
+  CASE_EXPECT_EQ(2, container.size());
+  CASE_EXPECT_EQ(1, container.count(&values[2]));
+  CASE_EXPECT_EQ(1, container.count(&values[3]));
+
+  int sum = 0;
+  for (int *value : container) {
+    sum += *value;
+  }
+  CASE_EXPECT_EQ(5, sum);
+
+  atapp::small_pointer_set<int, 2> swapped;
+  swapped.swap(container);
+  CASE_EXPECT_TRUE(container.empty());
+  CASE_EXPECT_EQ(2, swapped.size());
+  CASE_EXPECT_TRUE(container.begin() == container.end());
+}
+
+namespace {
+struct flat_hash_map_throwing_move_value {
+  flat_hash_map_throwing_move_value() {}
+  flat_hash_map_throwing_move_value(const flat_hash_map_throwing_move_value &) {}
+  flat_hash_map_throwing_move_value &operator=(const flat_hash_map_throwing_move_value &) { return *this; }
+};
+}  // namespace
+
+CASE_TEST(atapp_flat_hash_map, erase_noexcept) {
+  atapp::flat_hash_map<uint64_t, std::shared_ptr<uint64_t>> nothrow_container;
+  atapp::flat_hash_map<uint64_t, flat_hash_map_throwing_move_value> throwing_container;
+
+  // erase() is noexcept only when elements can be moved without exceptions
+  CASE_EXPECT_TRUE(noexcept(nothrow_container.erase(static_cast<uint64_t>(1))));
+  CASE_EXPECT_FALSE(noexcept(throwing_container.erase(static_cast<uint64_t>(1))));
+
+  throwing_container[1] = flat_hash_map_throwing_move_value();
+  throwing_container[2] = flat_hash_map_throwing_move_value();
+  CASE_EXPECT_EQ(1, throwing_container.erase(static_cast<uint64_t>(1)));
+  CASE_EXPECT_EQ(1, throwing_container.size());
+}
@@ -0,0 +1,152 @@
+// Copyright 2026 atframework
+// Log rate limit unit tests
+
+#include <atframe/atapp_log_rate_limit.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+namespace {
+static int32_t rate_limit_test_call_site(int32_t times) {
+  int32_t ret = 0;
+  for (int32_t i = 0; i < times; ++i) {
+    if (LIBATAPP_MACRO_LOG_RATE_LIMIT_CHECK(atfw::util::log::log_wrapper::categorize_t::DEFAULT)) {
+      ++ret;
+    }
+  }
+  return ret;
+}
+}  // namespace
+
+CASE_TEST(atapp_log_rate_limit, call_site_token_bucket) {
+  atapp::log_rate_limiter &limiter = atapp::log_rate_limiter::instance();
+  atapp::log_rate_limiter::options_type backup =
+      limiter.get_options(atfw::util::log::log_wrapper::categorize_t::DEFAULT);
+
+  // No limit by default
+  CASE_EXPECT_EQ(1000, rate_limit_test_call_site(1000));
+
+  atapp::log_rate_limiter::options_type options;
+  options.call_site.rate = 10;
+  options.call_site.burst = 20;
+  options.summary_interval = std::chrono::seconds{1};
+  limiter.set_options(atfw::util::log::log_wrapper::categorize_t::DEFAULT, options);
+
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  limiter.tick(now);
+  uint64_t suppressed_before = limiter.get_suppressed_count();
+  CASE_EXPECT_EQ(20, rate_limit_test_call_site(1000));
+  CASE_EXPECT_EQ(suppressed_before + 980, limiter.get_suppressed_count());
+
+  // 5 tokens are refilled in 500ms
+  now += std::chrono::milliseconds{500};
+  limiter.tick(now);
+  CASE_EXPECT_EQ(5, rate_limit_test_call_site(1000));
+
+  // Suppressed logs are summarized
+  now += std::chrono::milliseconds{600};
+  CASE_EXPECT_GE(limiter.tick(now), 1);
+
+  limiter.set_options(atfw::util::log::log_wrapper::categorize_t::DEFAULT, backup);
+  CASE_EXPECT_EQ(1000, rate_limit_test_call_site(1000));
+}
+
+CASE_TEST(atapp_log_rate_limit, category_limit_multi_thread) {
+  atapp::log_rate_limiter &limiter = atapp::log_rate_limiter::instance();
+  atapp::log_rate_limiter::options_type backup =
+      limiter.get_options(atfw::util::log::log_wrapper::categorize_t::DEFAULT);
+
+  atapp::log_rate_limiter::options_type options;
+  options.category.rate = 100;
+  limiter.set_options(atfw::util::log::log_wrapper::categorize_t::DEFAULT, options);
+
+  std::atomic<int32_t> passed{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&passed]() {
+      for (int j = 0; j < 10000; ++j) {
+        if (LIBATAPP_MACRO_LOG_RATE_LIMIT_CHECK(atfw::util::log::log_wrapper::categorize_t::DEFAULT)) {
+          ++passed;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // All call sites share the tokens of category
+  CASE_EXPECT_EQ(100, passed.load());
+
+  limiter.set_options(atfw::util::log::log_wrapper::categorize_t::DEFAULT, backup);
+}
+
+CASE_TEST(atapp_log_rate_limit, extra_category) {
+  atapp::log_rate_limiter &limiter = atapp::log_rate_limiter::instance();
+  atapp::log_rate_limiter::options_type backup = limiter.get_options(atapp::log_rate_limiter::kCategoryEtcd);
+  atapp::log_rate_limiter::options_type default_backup =
+      limiter.get_options(atfw::util::log::log_wrapper::categorize_t::DEFAULT);
+
+  atapp::log_rate_limiter::options_type options;
+  options.category.rate = 10;
+  options.summary_interval = std::chrono::seconds{1};
+  limiter.set_options(atapp::log_rate_limiter::kCategoryEtcd, options);
+  // Limits of etcd logs are independent of the default category
+  limiter.set_options(atfw::util::log::log_wrapper::categorize_t::DEFAULT, atapp::log_rate_limiter::options_type());
+
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  limiter.tick(now);
+  int32_t passed = 0;
+  int32_t default_passed = 0;
+  for (int32_t i = 0; i < 100; ++i) {
+    if (LIBATAPP_MACRO_LOG_RATE_LIMIT_CHECK(atapp::log_rate_limiter::kCategoryEtcd)) {
+      ++passed;
+    }
+    if (LIBATAPP_MACRO_LOG_RATE_LIMIT_CHECK(atfw::util::log::log_wrapper::categorize_t::DEFAULT)) {
+      ++default_passed;
+    }
+  }
+  CASE_EXPECT_EQ(10, passed);
+  CASE_EXPECT_EQ(100, default_passed);
+
+  // Summary of extra category without logger is written into the default category
+  now += std::chrono::milliseconds{1100};
+  CASE_EXPECT_GE(limiter.tick(now), 1);
+
+  limiter.set_options(atapp::log_rate_limiter::kCategoryEtcd, backup);
+  limiter.set_options(atfw::util::log::log_wrapper::categorize_t::DEFAULT, default_backup);
+}
+
+CASE_TEST(atapp_log_rate_limit, extra_category_owner) {
+  atapp::log_rate_limiter &limiter = atapp::log_rate_limiter::instance();
+  int first_owner = 0;
+  int second_owner = 0;
+
+  atapp::log_rate_limiter::options_type first_options;
+  first_options.category.rate = 10;
+  atapp::log_rate_limiter::options_type second_options;
+  second_options.category.rate = 20;
+
+  CASE_EXPECT_TRUE(
+      limiter.set_extra_category(atapp::log_rate_limiter::kCategoryEtcd, &first_owner, first_options, nullptr));
+  // Only the owner can change an extra category
+  CASE_EXPECT_FALSE(
+      limiter.set_extra_category(atapp::log_rate_limiter::kCategoryEtcd, &second_owner, second_options, nullptr));
+  CASE_EXPECT_EQ(10, limiter.get_options(atapp::log_rate_limiter::kCategoryEtcd).category.rate);
+
+  limiter.release_extra_category(atapp::log_rate_limiter::kCategoryEtcd, &second_owner);
+  CASE_EXPECT_EQ(10, limiter.get_options(atapp::log_rate_limiter::kCategoryEtcd).category.rate);
+
+  // Options are reset after the owner releases it
+  limiter.release_extra_category(atapp::log_rate_limiter::kCategoryEtcd, &first_owner);
+  CASE_EXPECT_EQ(0, limiter.get_options(atapp::log_rate_limiter::kCategoryEtcd).category.rate);
+
+  CASE_EXPECT_TRUE(
+      limiter.set_extra_category(atapp::log_rate_limiter::kCategoryEtcd, &second_owner, second_options, nullptr));
+  CASE_EXPECT_EQ(20, limiter.get_options(atapp::log_rate_limiter::kCategoryEtcd).category.rate);
+  limiter.release_extra_category(atapp::log_rate_limiter::kCategoryEtcd, &second_owner);
+}
@@ -0,0 +1,182 @@
+// Copyright 2026 atframework
+// Asynchronous file log sink unit tests
+
+#include <atframe/atapp_conf.h>
+#include <atframe/atapp_log_sink_async_file.h>
+#include <atframe/atapp_log_sink_maker.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+namespace {
+static atfw::util::log::log_sink_file_backend make_test_file_backend(const char *file_path) {
+  atfw::util::log::log_sink_file_backend ret;
+  ret.set_file_pattern(file_path);
+  ret.set_max_file_size(16 * 1024 * 1024);
+  ret.set_rotate_size(1);
+  return ret;
+}
+}  // namespace
+
+CASE_TEST(atapp_log_sink_async_file, multi_thread_write) {
+  const char *file_path = "atapp_log_sink_async_file_test.multi_thread.log";
+  std::remove(file_path);
+
+  atapp::log_sink_async_file_backend::options_type options;
+  options.policy = atapp::log_sink_async_file_backend::overflow_policy::kBlock;
+  options.buffer_size = 16 * 1024;
+  atapp::log_sink_async_file_backend sink(make_test_file_backend(file_path), options);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&sink, i]() {
+      std::string content;
+      for (int j = 0; j < 2000; ++j) {
+        content = "async log from thread " + std::to_string(i) + " line " + std::to_string(j);
+        sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, "Info", __FILE__,
+                                                         __LINE__, __FUNCTION__),
+             atfw::util::nostd::string_view{content.data(), content.size()});
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  CASE_EXPECT_TRUE(sink.flush(std::chrono::milliseconds{8000}));
+
+  atapp::log_sink_async_file_backend::stats_type stats = sink.get_stats();
+  // Block policy never drop logs
+  CASE_EXPECT_EQ(8000, stats.pushed_records);
+  CASE_EXPECT_EQ(8000, stats.written_records);
+  CASE_EXPECT_EQ(0, stats.dropped_records);
+  CASE_EXPECT_GT(stats.written_batches, 0);
+  // Logs are written in batches, much less than one write per log
+  CASE_EXPECT_LT(stats.written_batches, stats.written_records);
+  CASE_MSG_INFO() << "async file sink: written " << stats.written_records << " logs in " << stats.written_batches
+                  << " batches, blocked " << stats.blocked_times << " times" << std::endl;
+
+  std::remove(file_path);
+}
+
+CASE_TEST(atapp_log_sink_async_file, release_rings_of_exited_threads) {
+  const char *file_path = "atapp_log_sink_async_file_test.exited_threads.log";
+  std::remove(file_path);
+
+  atapp::log_sink_async_file_backend::options_type options;
+  options.policy = atapp::log_sink_async_file_backend::overflow_policy::kBlock;
+  options.buffer_size = 16 * 1024;
+  atapp::log_sink_async_file_backend sink(make_test_file_backend(file_path), options);
+
+  // Short-lived threads must not leave their rings in the sink
+  for (int round = 0; round < 8; ++round) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&sink, round, i]() {
+        std::string content = "async log from round " + std::to_string(round) + " thread " + std::to_string(i);
+        for (int j = 0; j < 16; ++j) {
+          sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, "Info", __FILE__,
+                                                           __LINE__, __FUNCTION__),
+               atfw::util::nostd::string_view{content.data(), content.size()});
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    CASE_EXPECT_TRUE(sink.flush(std::chrono::milliseconds{8000}));
+    CASE_EXPECT_EQ(0, sink.get_thread_ring_count());
+  }
+
+  atapp::log_sink_async_file_backend::stats_type stats = sink.get_stats();
+  CASE_EXPECT_EQ(8 * 4 * 16, stats.pushed_records);
+  CASE_EXPECT_EQ(8 * 4 * 16, stats.written_records);
+
+  // The current thread still owns its ring
+  std::string content = "async log from main thread";
+  sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, "Info", __FILE__, __LINE__,
+                                                   __FUNCTION__),
+       atfw::util::nostd::string_view{content.data(), content.size()});
+  CASE_EXPECT_TRUE(sink.flush(std::chrono::milliseconds{8000}));
+  CASE_EXPECT_EQ(1, sink.get_thread_ring_count());
+
+  std::remove(file_path);
+}
+
+CASE_TEST(atapp_log_sink_async_file, overflow_drop_and_sample) {
+  const char *file_path = "atapp_log_sink_async_file_test.overflow.log";
+  std::remove(file_path);
+
+  std::string content(1000, 'x');
+  for (auto policy : {atapp::log_sink_async_file_backend::overflow_policy::kDrop,
+                      atapp::log_sink_async_file_backend::overflow_policy::kSample}) {
+    atapp::log_sink_async_file_backend::options_type options;
+    options.policy = policy;
+    options.buffer_size = 4096;
+    // Writer thread will not wake up by timer during this test
+    options.writer_interval = std::chrono::seconds{10};
+    atapp::log_sink_async_file_backend sink(make_test_file_backend(file_path), options);
+
+    for (int i = 0; i < 64; ++i) {
+      sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kWarning, "Warning", __FILE__,
+                                                       __LINE__, __FUNCTION__),
+           atfw::util::nostd::string_view{content.data(), content.size()});
+    }
+    CASE_EXPECT_TRUE(sink.flush(std::chrono::milliseconds{8000}));
+
+    atapp::log_sink_async_file_backend::stats_type stats = sink.get_stats();
+    CASE_EXPECT_EQ(64, stats.pushed_records + stats.dropped_records + stats.sampled_out_records);
+    CASE_EXPECT_EQ(stats.pushed_records, stats.written_records);
+    if (policy == atapp::log_sink_async_file_backend::overflow_policy::kSample) {
+      CASE_EXPECT_GT(stats.sampled_out_records, 0);
+    } else {
+      CASE_EXPECT_EQ(0, stats.sampled_out_records);
+      CASE_EXPECT_GT(stats.dropped_records, 0);
+    }
+  }
+
+  std::remove(file_path);
+}
+
+CASE_TEST(atapp_log_sink_async_file, sink_maker) {
+  CASE_EXPECT_TRUE(atapp::log_sink_async_file_backend::overflow_policy::kBlock ==
+                   atapp::log_sink_async_file_backend::parse_overflow_policy("BLOCK"));
+  CASE_EXPECT_TRUE(atapp::log_sink_async_file_backend::overflow_policy::kSample ==
+                   atapp::log_sink_async_file_backend::parse_overflow_policy("sample"));
+  CASE_EXPECT_TRUE(atapp::log_sink_async_file_backend::overflow_policy::kDrop ==
+                   atapp::log_sink_async_file_backend::parse_overflow_policy("unknown"));
+
+  const char *file_path = "atapp_log_sink_async_file_test.maker.log";
+  std::remove(file_path);
+
+  atapp::protocol::atapp_log log_cfg;
+  atapp::protocol::atapp_log_category cat_cfg;
+  atapp::protocol::atapp_log_sink sink_cfg;
+  sink_cfg.set_type(static_cast<std::string>(atapp::log_sink_maker::get_async_file_sink_name()));
+  sink_cfg.mutable_log_backend_async_file()->set_file(file_path);
+  sink_cfg.mutable_log_backend_async_file()->set_overflow_policy("block");
+
+  atapp::log_sink_async_file_backend::stats_type before = atapp::log_sink_async_file_backend::get_global_stats();
+  {
+    atfw::util::log::log_wrapper::log_handler_t handler = atapp::log_sink_maker::get_async_file_sink_reg()(
+        *WLOG_GETCAT(atfw::util::log::log_wrapper::categorize_t::DEFAULT), 0, log_cfg, cat_cfg, sink_cfg);
+    CASE_EXPECT_TRUE(!!handler);
+    if (handler) {
+      handler(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kError, "Error", __FILE__,
+                                                          __LINE__, __FUNCTION__),
+              "async file sink created by log_sink_maker");
+    }
+    // All pending logs are written when the sink is destroyed
+  }
+  atapp::log_sink_async_file_backend::stats_type after = atapp::log_sink_async_file_backend::get_global_stats();
+  CASE_EXPECT_EQ(before.written_records + 1, after.written_records);
+
+  std::remove(file_path);
+}
@@ -0,0 +1,235 @@
+// Copyright 2026 atframework
+// Binary log sink unit tests
+
+#include <atframe/atapp_conf.h>
+#include <atframe/atapp_log_sink_binlog.h>
+#include <atframe/atapp_log_sink_maker.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+namespace {
+static std::string read_whole_file(const char *file_path) {
+  std::ifstream input(file_path, std::ios::in | std::ios::binary);
+  if (!input.is_open()) {
+    return std::string();
+  }
+  return std::string{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+}
+
+static std::vector<std::string> decode_binlog(const std::string &data) {
+  std::vector<std::string> ret;
+  atapp::log_binlog_reader reader;
+  CASE_EXPECT_TRUE(atapp::log_binlog_reader::read_result::kOk == reader.reset(data));
+
+  atapp::log_binlog_reader::record_type record;
+  while (atapp::log_binlog_reader::read_result::kOk == reader.next(record)) {
+    ret.push_back(std::string(record.content.data(), record.content.size()));
+  }
+  return ret;
+}
+}  // namespace
+
+CASE_TEST(atapp_log_sink_binlog, round_trip) {
+  const char *file_path = "atapp_log_sink_binlog_test.round_trip.0.binlog";
+  std::remove(file_path);
+
+  {
+    atapp::log_sink_binlog_backend::options_type options;
+    options.file_pattern = "atapp_log_sink_binlog_test.round_trip.%N.binlog";
+    options.rotate_size = 1;
+    atapp::log_sink_binlog_backend sink(options);
+
+    for (int i = 0; i < 100; ++i) {
+      std::string content = "binlog round trip " + std::to_string(i);
+      // Two call sites
+      if (i & 1) {
+        sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, "Info", __FILE__, 1001,
+                                                         "test_func_info"),
+             atfw::util::nostd::string_view{content.data(), content.size()});
+      } else {
+        sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kError, "Error", __FILE__, 1002,
+                                                         "test_func_error"),
+             atfw::util::nostd::string_view{content.data(), content.size()});
+      }
+    }
+
+    CASE_EXPECT_EQ(100, sink.get_written_records());
+    CASE_EXPECT_EQ(2, sink.get_call_site_count());
+    sink.flush();
+  }
+
+  std::string data = read_whole_file(file_path);
+  atapp::log_binlog_reader reader;
+  CASE_EXPECT_TRUE(atapp::log_binlog_reader::read_result::kOk == reader.reset(data));
+
+  int count = 0;
+  atapp::log_binlog_reader::record_type record;
+  atapp::log_binlog_reader::read_result res;
+  while (atapp::log_binlog_reader::read_result::kOk == (res = reader.next(record))) {
+    CASE_EXPECT_EQ("binlog round trip " + std::to_string(count),
+                   std::string(record.content.data(), record.content.size()));
+    CASE_EXPECT_TRUE(nullptr != record.call_site);
+    if (nullptr != record.call_site) {
+      CASE_EXPECT_EQ((count & 1) ? 1001 : 1002, record.call_site->line_number);
+      CASE_EXPECT_EQ((count & 1) ? "Info" : "Error", record.call_site->level_name);
+    }
+    ++count;
+  }
+  CASE_EXPECT_TRUE(atapp::log_binlog_reader::read_result::kEof == res);
+  CASE_EXPECT_EQ(100, count);
+
+  std::string text = atapp::log_binlog_reader::format(record);
+  CASE_EXPECT_NE(std::string::npos, text.find("[Info]["));
+  CASE_EXPECT_NE(std::string::npos, text.find(":1001(test_func_info)]: binlog round trip 99"));
+  CASE_MSG_INFO() << "binlog decoded: " << text << std::endl;
+
+  // Partially written record
+  CASE_EXPECT_TRUE(atapp::log_binlog_reader::read_result::kOk == reader.reset(data.substr(0, data.size() - 3)));
+  while (atapp::log_binlog_reader::read_result::kOk == (res = reader.next(record))) {
+  }
+  CASE_EXPECT_TRUE(atapp::log_binlog_reader::read_result::kTruncated == res);
+
+  // Not a binlog file
+  CASE_EXPECT_TRUE(atapp::log_binlog_reader::read_result::kBadFormat == reader.reset("not a binlog file"));
+
+  std::remove(file_path);
+}
+
+CASE_TEST(atapp_log_sink_binlog, rotate) {
+  const char *file_paths[] = {"atapp_log_sink_binlog_test.rotate.0.binlog",
+                              "atapp_log_sink_binlog_test.rotate.1.binlog"};
+  for (auto &file_path : file_paths) {
+    std::remove(file_path);
+  }
+
+  atapp::protocol::atapp_log log_cfg;
+  atapp::protocol::atapp_log_category cat_cfg;
+  atapp::protocol::atapp_log_sink sink_cfg;
+  sink_cfg.set_type(static_cast<std::string>(atapp::log_sink_maker::get_binlog_sink_name()));
+  sink_cfg.mutable_log_backend_binlog()->set_file("atapp_log_sink_binlog_test.rotate.%N.binlog");
+  sink_cfg.mutable_log_backend_binlog()->mutable_rotate()->set_size(256);
+  sink_cfg.mutable_log_backend_binlog()->mutable_rotate()->set_number(2);
+  sink_cfg.mutable_log_backend_binlog()->set_auto_flush("debug");
+
+  {
+    atfw::util::log::log_wrapper::log_handler_t handler = atapp::log_sink_maker::get_binlog_sink_reg()(
+        *WLOG_GETCAT(atfw::util::log::log_wrapper::categorize_t::DEFAULT), 0, log_cfg, cat_cfg, sink_cfg);
+    CASE_EXPECT_TRUE(!!handler);
+    if (!handler) {
+      return;
+    }
+
+    // The first file is full after a few logs, and the second one should be decoded alone
+    std::string content(100, 'r');
+    for (int i = 0; i < 4; ++i) {
+      handler(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kWarning, "Warning", __FILE__,
+                                                          __LINE__, __FUNCTION__),
+              atfw::util::nostd::string_view{content.data(), content.size()});
+    }
+  }
+
+  std::vector<std::string> first_logs = decode_binlog(read_whole_file(file_paths[0]));
+  std::vector<std::string> second_logs = decode_binlog(read_whole_file(file_paths[1]));
+  CASE_EXPECT_GT(first_logs.size(), 0);
+  CASE_EXPECT_GT(second_logs.size(), 0);
+  CASE_EXPECT_EQ(4, first_logs.size() + second_logs.size());
+
+  for (auto &file_path : file_paths) {
+    std::remove(file_path);
+  }
+}
+
+CASE_TEST(atapp_log_sink_binlog, restart_from_latest_file) {
+  const char *file_paths[] = {"atapp_log_sink_binlog_test.restart.0.binlog",
+                              "atapp_log_sink_binlog_test.restart.1.binlog",
+                              "atapp_log_sink_binlog_test.restart.2.binlog"};
+  for (auto &file_path : file_paths) {
+    std::remove(file_path);
+  }
+
+  atapp::log_sink_binlog_backend::options_type options;
+  options.file_pattern = "atapp_log_sink_binlog_test.restart.%N.binlog";
+  options.max_file_size = 1024;
+  options.rotate_size = 3;
+  options.auto_flush = atfw::util::log::log_level::kDebug;
+
+  std::string content(400, 's');
+  // Fill the first file and write one log into the second one
+  {
+    atapp::log_sink_binlog_backend sink(options);
+    for (int i = 0; i < 8 && read_whole_file(file_paths[1]).empty(); ++i) {
+      sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, "Info", __FILE__, __LINE__,
+                                                       __FUNCTION__),
+           atfw::util::nostd::string_view{content.data(), content.size()});
+    }
+  }
+
+  std::vector<std::string> first_logs = decode_binlog(read_whole_file(file_paths[0]));
+  std::vector<std::string> second_logs = decode_binlog(read_whole_file(file_paths[1]));
+  CASE_EXPECT_GT(first_logs.size(), 0);
+  CASE_EXPECT_EQ(1, second_logs.size());
+
+  // Restarted sink appends to the second file instead of overwriting the first one
+  {
+    atapp::log_sink_binlog_backend sink(options);
+    sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, "Info", __FILE__, __LINE__,
+                                                     __FUNCTION__),
+         atfw::util::nostd::string_view{content.data(), content.size()});
+  }
+
+  CASE_EXPECT_EQ(first_logs.size(), decode_binlog(read_whole_file(file_paths[0])).size());
+  CASE_EXPECT_EQ(2, decode_binlog(read_whole_file(file_paths[1])).size());
+  CASE_EXPECT_TRUE(read_whole_file(file_paths[2]).empty());
+
+  for (auto &file_path : file_paths) {
+    std::remove(file_path);
+  }
+}
+
+CASE_TEST(atapp_log_sink_binlog, restart_after_incomplete_record) {
+  const char *file_path = "atapp_log_sink_binlog_test.incomplete.0.binlog";
+  std::remove(file_path);
+
+  atapp::log_sink_binlog_backend::options_type options;
+  options.file_pattern = "atapp_log_sink_binlog_test.incomplete.%N.binlog";
+  options.rotate_size = 1;
+  options.auto_flush = atfw::util::log::log_level::kDebug;
+
+  std::string content = "binlog before crash";
+  {
+    atapp::log_sink_binlog_backend sink(options);
+    sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, "Info", __FILE__, __LINE__,
+                                                     __FUNCTION__),
+         atfw::util::nostd::string_view{content.data(), content.size()});
+  }
+
+  // Simulate a crash when writing a log record: type, call site id and only a part of the content
+  {
+    std::ofstream output(file_path, std::ios::out | std::ios::app | std::ios::binary);
+    const char incomplete_record[] = {static_cast<char>(atapp::log_sink_binlog_backend::kRecordLog), 1, 0, 64, 'x'};
+    output.write(incomplete_record, sizeof(incomplete_record));
+  }
+
+  {
+    atapp::log_sink_binlog_backend sink(options);
+    std::string next_content = "binlog after restart";
+    sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, "Info", __FILE__, __LINE__,
+                                                     __FUNCTION__),
+         atfw::util::nostd::string_view{next_content.data(), next_content.size()});
+  }
+
+  std::vector<std::string> logs = decode_binlog(read_whole_file(file_path));
+  CASE_EXPECT_EQ(2, logs.size());
+  if (2 == logs.size()) {
+    CASE_EXPECT_EQ(content, logs[0]);
+    CASE_EXPECT_EQ("binlog after restart", logs[1]);
+  }
+
+  std::remove(file_path);
+}
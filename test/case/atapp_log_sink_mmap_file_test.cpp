@@ -0,0 +1,161 @@
+// Copyright 2026 atframework
+// Memory-mapped log file sink unit tests
+
+#include <atframe/atapp_conf.h>
+#include <atframe/atapp_log_sink_maker.h>
+#include <atframe/atapp_log_sink_mmap_file.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+namespace {
+static std::string read_whole_file(const std::string &file_path) {
+  std::ifstream input(file_path.c_str(), std::ios::in | std::ios::binary);
+  if (!input.is_open()) {
+    return std::string();
+  }
+  return std::string{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+}
+
+static std::string make_mmap_test_path(const char *name, int index) {
+  return std::string("atapp_log_sink_mmap_file_test.") + name + "." + std::to_string(index) + ".log";
+}
+}  // namespace
+
+CASE_TEST(atapp_log_sink_mmap_file, rotate_with_prepared_segment) {
+  for (int i = 0; i < 4; ++i) {
+    std::remove(make_mmap_test_path("rotate", i).c_str());
+  }
+
+  {
+    atapp::log_sink_mmap_file_backend::options_type options;
+    options.file_pattern = "atapp_log_sink_mmap_file_test.rotate.%N.log";
+    // About 3 files are used, no file is overwritten
+    options.max_file_size = 128 * 1024;
+    options.rotate_size = 4;
+    options.flush_interval = std::chrono::milliseconds{5};
+    atapp::log_sink_mmap_file_backend sink(options);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&sink, i]() {
+        std::string content;
+        for (int j = 0; j < 2000; ++j) {
+          content = "mmap log from thread " + std::to_string(i) + " line " + std::to_string(j);
+          sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, "Info", __FILE__,
+                                                           __LINE__, __FUNCTION__),
+               atfw::util::nostd::string_view{content.data(), content.size()});
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    sink.flush();
+
+    atapp::log_sink_mmap_file_backend::stats_type stats = sink.get_stats();
+    CASE_EXPECT_EQ(8000, stats.written_records);
+    CASE_EXPECT_GT(stats.rotate_times, 0);
+    CASE_MSG_INFO() << "mmap file sink: rotate " << stats.rotate_times << " times, " << stats.prepared_rotate_times
+                    << " of them used the prepared segment" << std::endl;
+  }
+
+  // All files are truncated to the written size when the sink is destroyed
+  size_t lines = 0;
+  for (int i = 0; i < 4; ++i) {
+    std::string data = read_whole_file(make_mmap_test_path("rotate", i));
+    CASE_EXPECT_EQ(std::string::npos, data.find('\0'));
+    for (char c : data) {
+      if ('\n' == c) {
+        ++lines;
+      }
+    }
+    std::remove(make_mmap_test_path("rotate", i).c_str());
+  }
+  CASE_EXPECT_EQ(8000, lines);
+}
+
+CASE_TEST(atapp_log_sink_mmap_file, append_existing_file) {
+  std::string file_path = make_mmap_test_path("append", 0);
+  std::remove(file_path.c_str());
+
+  atapp::protocol::atapp_log log_cfg;
+  atapp::protocol::atapp_log_category cat_cfg;
+  atapp::protocol::atapp_log_sink sink_cfg;
+  sink_cfg.set_type(static_cast<std::string>(atapp::log_sink_maker::get_mmap_file_sink_name()));
+  sink_cfg.mutable_log_backend_mmap_file()->set_file("atapp_log_sink_mmap_file_test.append.%N.log");
+  sink_cfg.mutable_log_backend_mmap_file()->mutable_rotate()->set_size(4096);
+  sink_cfg.mutable_log_backend_mmap_file()->mutable_rotate()->set_number(1);
+
+  // Open the same file twice, logs of the second time should be appended
+  for (int i = 0; i < 2; ++i) {
+    atfw::util::log::log_wrapper::log_handler_t handler = atapp::log_sink_maker::get_mmap_file_sink_reg()(
+        *WLOG_GETCAT(atfw::util::log::log_wrapper::categorize_t::DEFAULT), 0, log_cfg, cat_cfg, sink_cfg);
+    CASE_EXPECT_TRUE(!!handler);
+    if (!handler) {
+      return;
+    }
+
+    std::string content = "mmap append " + std::to_string(i);
+    handler(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kError, "Error", __FILE__,
+                                                        __LINE__, __FUNCTION__),
+            atfw::util::nostd::string_view{content.data(), content.size()});
+  }
+
+  CASE_EXPECT_EQ("mmap append 0\nmmap append 1\n", read_whole_file(file_path));
+  std::remove(file_path.c_str());
+}
+
+CASE_TEST(atapp_log_sink_mmap_file, restart_from_latest_file) {
+  for (int i = 0; i < 3; ++i) {
+    std::remove(make_mmap_test_path("restart", i).c_str());
+  }
+
+  atapp::log_sink_mmap_file_backend::options_type options;
+  options.file_pattern = "atapp_log_sink_mmap_file_test.restart.%N.log";
+  options.max_file_size = 4096;
+  options.rotate_size = 3;
+
+  std::string content(400, 's');
+  // Fill the first file and write some logs into the second one
+  {
+    atapp::log_sink_mmap_file_backend sink(options);
+    for (int i = 0; i < 16 && sink.get_stats().rotate_times < 1; ++i) {
+      sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, "Info", __FILE__, __LINE__,
+                                                       __FUNCTION__),
+           atfw::util::nostd::string_view{content.data(), content.size()});
+    }
+    CASE_EXPECT_EQ(1, sink.get_stats().rotate_times);
+
+    // The second file is closed later than the first one, so its modification time is newer
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  }
+
+  std::string first_file = read_whole_file(make_mmap_test_path("restart", 0));
+  std::string second_file = read_whole_file(make_mmap_test_path("restart", 1));
+  CASE_EXPECT_FALSE(first_file.empty());
+  CASE_EXPECT_EQ(content.size() + 1, second_file.size());
+
+  // Restarted sink appends to the second file instead of overwriting the first one
+  {
+    atapp::log_sink_mmap_file_backend sink(options);
+    sink(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, "Info", __FILE__, __LINE__,
+                                                     __FUNCTION__),
+         atfw::util::nostd::string_view{content.data(), content.size()});
+  }
+
+  CASE_EXPECT_EQ(first_file, read_whole_file(make_mmap_test_path("restart", 0)));
+  CASE_EXPECT_EQ((content.size() + 1) * 2, read_whole_file(make_mmap_test_path("restart", 1)).size());
+  CASE_EXPECT_TRUE(read_whole_file(make_mmap_test_path("restart", 2)).empty());
+
+  for (int i = 0; i < 3; ++i) {
+    std::remove(make_mmap_test_path("restart", i).c_str());
+  }
+}
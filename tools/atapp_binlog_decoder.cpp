@@ -0,0 +1,102 @@
+// Copyright 2026 atframework
+//
+// Decode binlog files written by the binlog log sink into text logs
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <atframe/atapp_log_sink_binlog.h>
+
+static void print_usage(const char *program) {
+  std::cerr << "Usage: " << program << " [-o OUTPUT_FILE] <BINLOG_FILE> [BINLOG_FILE...]" << std::endl;
+  std::cerr << "  -o, --output OUTPUT_FILE    write decoded logs into OUTPUT_FILE instead of stdout" << std::endl;
+  std::cerr << "  -h, --help                  show this help message" << std::endl;
+}
+
+static int decode_file(const std::string &file_path, std::ostream &output) {
+  std::ifstream input(file_path.c_str(), std::ios::in | std::ios::binary);
+  if (!input.is_open()) {
+    std::cerr << "Open " << file_path << " failed." << std::endl;
+    return 1;
+  }
+
+  std::string data{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+  atapp::log_binlog_reader reader;
+  if (atapp::log_binlog_reader::read_result::kOk != reader.reset(data)) {
+    std::cerr << file_path << " is not a valid binlog file." << std::endl;
+    return 1;
+  }
+
+  atapp::log_binlog_reader::record_type record;
+  while (true) {
+    atapp::log_binlog_reader::read_result res = reader.next(record);
+    if (atapp::log_binlog_reader::read_result::kOk == res) {
+      output << atapp::log_binlog_reader::format(record) << '\n';
+      continue;
+    }
+
+    if (atapp::log_binlog_reader::read_result::kEof == res) {
+      break;
+    }
+
+    // The last record may be partially written when the process is still running or crashed
+    if (atapp::log_binlog_reader::read_result::kTruncated == res) {
+      std::cerr << file_path << ": truncated record at offset " << reader.get_offset() << ", ignored." << std::endl;
+      break;
+    }
+
+    std::cerr << file_path << ": bad record at offset " << reader.get_offset() << "." << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  std::string output_file;
+  std::vector<std::string> input_files;
+  for (int i = 1; i < argc; ++i) {
+    if (0 == strcmp("-o", argv[i]) || 0 == strcmp("--output", argv[i])) {
+      if (i + 1 >= argc) {
+        print_usage(argv[0]);
+        return 1;
+      }
+      output_file = argv[++i];
+    } else if (0 == strcmp("-h", argv[i]) || 0 == strcmp("--help", argv[i])) {
+      print_usage(argv[0]);
+      return 0;
+    } else {
+      input_files.push_back(argv[i]);
+    }
+  }
+
+  if (input_files.empty()) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::ofstream output_stream;
+  if (!output_file.empty()) {
+    output_stream.open(output_file.c_str(), std::ios::out | std::ios::trunc);
+    if (!output_stream.is_open()) {
+      std::cerr << "Open " << output_file << " failed." << std::endl;
+      return 1;
+    }
+  }
+  std::ostream &output = output_file.empty() ? std::cout : output_stream;
+
+  int ret = 0;
+  for (auto &file_path : input_files) {
+    if (0 != decode_file(file_path, output)) {
+      ret = 1;
+    }
+  }
+  output.flush();
+
+  return ret;
+}
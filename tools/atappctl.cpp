@@ -1,11 +1,18 @@
 
 // Copyright 2026 atframework
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include <uv.h>
@@ -45,6 +52,589 @@ class atappctl_module : public atapp::module_impl {
   int tick() override { return 0; }
 };
 
+// ============ bench: load generator of message paths ============
+enum class atappctl_bench_target_mode : int32_t {
+  kId = 0,
+  kName,
+  kConsistentHash,
+  kRandom,
+  kRoundRobin,
+};
+
+struct atappctl_bench_options {
+  bool enabled = false;
+  bool has_error = false;
+
+  atappctl_bench_target_mode target_mode = atappctl_bench_target_mode::kRoundRobin;
+  uint64_t target_id = 0;
+  std::string target_key;         // node name or hash key
+  bool hash_by_sequence = false;  // use sequence as hash key to spread messages
+
+  int32_t type = 0;
+  size_t size = 64;
+  uint64_t rate = 0;       // messages per second, 0 for closed-loop
+  size_t concurrency = 1;  // messages in flight of closed-loop
+  uint64_t total = 0;      // total messages, 0 for using duration
+  std::chrono::milliseconds duration{10000};
+  std::chrono::milliseconds delay{1000};    // wait for connections before sending
+  std::chrono::milliseconds timeout{5000};  // wait for echoes
+  bool wait_echo = true;
+
+  bool has_metadata = false;
+  atapp::protocol::atapp_metadata metadata;
+
+  std::string output;  // write summary as JSON
+};
+
+// Header at the beginning of every payload, the target should echo the payload back, just like sample_echo_svr
+struct atappctl_bench_header {
+  uint32_t magic;
+  uint32_t session;
+  uint64_t sequence;
+  int64_t send_time_ns;
+};
+
+static constexpr const uint32_t kAtappctlBenchMagic = 0x4e454241;  // "ABEN"
+
+static int64_t atappctl_bench_now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief Log-linear latency histogram, values less than 16 are exact and every power of 2 is split into 16 buckets
+ */
+class atappctl_bench_histogram {
+ public:
+  atappctl_bench_histogram() : buckets_(kBucketCount, 0), count_(0), sum_(0), max_(0) {}
+
+  void record(uint64_t value) {
+    ++buckets_[get_bucket_index(value)];
+    ++count_;
+    sum_ += value;
+    max_ = (std::max)(max_, value);
+  }
+
+  uint64_t get_count() const noexcept { return count_; }
+
+  uint64_t get_max() const noexcept { return max_; }
+
+  uint64_t get_average() const noexcept { return count_ > 0 ? sum_ / count_ : 0; }
+
+  uint64_t get_percentile(double percentile) const {
+    if (0 == count_) {
+      return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(static_cast<double>(count_) * percentile);
+    if (rank >= count_) {
+      rank = count_ - 1;
+    }
+
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+      accumulated += buckets_[i];
+      if (accumulated > rank) {
+        return (std::min)(get_bucket_upper_bound(i), max_);
+      }
+    }
+    return max_;
+  }
+
+  // Print counts by power of 2
+  void print(std::ostream &out, const char *unit) const {
+    if (0 == count_) {
+      return;
+    }
+
+    uint64_t lower = 0;
+    uint64_t upper = 1;
+    size_t bucket_index = 0;
+    while (bucket_index < buckets_.size()) {
+      uint64_t count = 0;
+      while (bucket_index < buckets_.size() && get_bucket_upper_bound(bucket_index) < upper) {
+        count += buckets_[bucket_index];
+        ++bucket_index;
+      }
+
+      if (count > 0) {
+        size_t bar = static_cast<size_t>(count * 50 / count_);
+        out << "  [" << std::setw(10) << lower << ", " << std::setw(10) << upper << ") " << unit << ": "
+            << std::setw(10) << count << " " << std::fixed << std::setprecision(2) << std::setw(6)
+            << static_cast<double>(count) * 100.0 / static_cast<double>(count_) << "% " << std::string(bar, '#')
+            << std::endl;
+      }
+
+      if (upper > ((std::numeric_limits<uint64_t>::max)() >> 1)) {
+        break;
+      }
+      lower = upper;
+      upper <<= 1;
+    }
+  }
+
+ private:
+  static constexpr const size_t kSubBucketBits = 4;
+  static constexpr const size_t kSubBucketCount = static_cast<size_t>(1) << kSubBucketBits;
+  static constexpr const size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBucketCount;
+
+  static size_t get_most_significant_bit(uint64_t value) {
+    size_t ret = 0;
+    while (value > 1) {
+      value >>= 1;
+      ++ret;
+    }
+    return ret;
+  }
+
+  static size_t get_bucket_index(uint64_t value) {
+    if (value < kSubBucketCount) {
+      return static_cast<size_t>(value);
+    }
+
+    size_t msb = get_most_significant_bit(value);
+    size_t shift = msb - kSubBucketBits;
+    size_t sub_bucket = static_cast<size_t>(value >> shift) & (kSubBucketCount - 1);
+    return (msb - kSubBucketBits + 1) * kSubBucketCount + sub_bucket;
+  }
+
+  static uint64_t get_bucket_upper_bound(size_t index) {
+    if (index < kSubBucketCount) {
+      return static_cast<uint64_t>(index);
+    }
+
+    size_t shift = index / kSubBucketCount - 1;
+    uint64_t lower = static_cast<uint64_t>(kSubBucketCount + index % kSubBucketCount) << shift;
+    return lower + ((static_cast<uint64_t>(1) << shift) - 1);
+  }
+
+  std::vector<uint64_t> buckets_;
+  uint64_t count_;
+  uint64_t sum_;
+  uint64_t max_;
+};
+
+static bool atappctl_bench_parse_duration(const std::string &value, std::chrono::milliseconds &output) {
+  char *end = nullptr;
+  double number = strtod(value.c_str(), &end);
+  if (end == value.c_str() || number < 0) {
+    return false;
+  }
+
+  std::string unit = end;
+  if (unit.empty() || unit == "s") {
+    output = std::chrono::milliseconds{static_cast<int64_t>(number * 1000)};
+  } else if (unit == "ms") {
+    output = std::chrono::milliseconds{static_cast<int64_t>(number)};
+  } else if (unit == "m") {
+    output = std::chrono::milliseconds{static_cast<int64_t>(number * 60000)};
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static bool atappctl_bench_parse_option(atappctl_bench_options &options, const std::string &param) {
+  std::string::size_type split = param.find('=');
+  if (std::string::npos == split) {
+    return false;
+  }
+
+  std::string key = param.substr(0, split);
+  std::string value = param.substr(split + 1);
+  if (key == "target") {
+    if (value == "random") {
+      options.target_mode = atappctl_bench_target_mode::kRandom;
+    } else if (value == "round_robin") {
+      options.target_mode = atappctl_bench_target_mode::kRoundRobin;
+    } else if (0 == value.compare(0, 3, "id:")) {
+      options.target_mode = atappctl_bench_target_mode::kId;
+      options.target_id = strtoull(value.c_str() + 3, nullptr, 0);
+      return 0 != options.target_id;
+    } else if (0 == value.compare(0, 5, "name:")) {
+      options.target_mode = atappctl_bench_target_mode::kName;
+      options.target_key = value.substr(5);
+      return !options.target_key.empty();
+    } else if (0 == value.compare(0, 5, "hash:")) {
+      options.target_mode = atappctl_bench_target_mode::kConsistentHash;
+      options.target_key = value.substr(5);
+      options.hash_by_sequence = options.target_key.empty() || options.target_key == "*";
+    } else {
+      return false;
+    }
+  } else if (key == "type") {
+    options.type = static_cast<int32_t>(strtol(value.c_str(), nullptr, 0));
+  } else if (key == "size") {
+    options.size = static_cast<size_t>(strtoull(value.c_str(), nullptr, 0));
+  } else if (key == "rate") {
+    options.rate = strtoull(value.c_str(), nullptr, 0);
+  } else if (key == "concurrency") {
+    options.concurrency = (std::max)(static_cast<size_t>(1), static_cast<size_t>(strtoull(value.c_str(), nullptr, 0)));
+  } else if (key == "total") {
+    options.total = strtoull(value.c_str(), nullptr, 0);
+  } else if (key == "duration") {
+    return atappctl_bench_parse_duration(value, options.duration);
+  } else if (key == "delay") {
+    return atappctl_bench_parse_duration(value, options.delay);
+  } else if (key == "timeout") {
+    return atappctl_bench_parse_duration(value, options.timeout);
+  } else if (key == "echo") {
+    options.wait_echo = value != "0" && value != "false" && value != "no";
+  } else if (key == "label") {
+    std::string::size_type label_split = value.find(':');
+    if (std::string::npos == label_split || 0 == label_split) {
+      return false;
+    }
+    options.has_metadata = true;
+    (*options.metadata.mutable_labels())[value.substr(0, label_split)] = value.substr(label_split + 1);
+  } else if (key == "namespace") {
+    options.has_metadata = true;
+    options.metadata.set_namespace_name(value);
+  } else if (key == "output") {
+    options.output = value;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+struct atappctl_bench_option_handler {
+  std::shared_ptr<atappctl_bench_options> options;
+
+  int operator()(atfw::util::cli::callback_param params) {
+    options->enabled = true;
+    for (size_t i = 0; i < params.get_params_number(); ++i) {
+      const std::string &param = params[i]->to_cpp_string();
+      if (!atappctl_bench_parse_option(*options, param)) {
+        std::cerr << "Invalid bench option: " << param << std::endl;
+        options->has_error = true;
+      }
+    }
+    return 0;
+  }
+};
+
+class atappctl_bench_module : public atapp::module_impl {
+ public:
+  explicit atappctl_bench_module(std::shared_ptr<atappctl_bench_options> options)
+      : options_(std::move(options)),
+        session_(0),
+        ready_(false),
+        started_(false),
+        sending_(false),
+        finished_(false),
+        sequence_(0),
+        sent_(0),
+        send_failed_(0),
+        received_(0),
+        response_failed_(0),
+        inflight_(0),
+        last_report_received_(0) {}
+
+  int init() override {
+    if (!options_->enabled) {
+      return 0;
+    }
+
+    if (options_->has_error) {
+      return -1;
+    }
+
+    session_ = static_cast<uint32_t>(atappctl_bench_now_ns()) ^ static_cast<uint32_t>(get_app_id());
+    payload_.resize((std::max)(options_->size, sizeof(atappctl_bench_header)), 0);
+    for (size_t i = sizeof(atappctl_bench_header); i < payload_.size(); ++i) {
+      payload_[i] = static_cast<unsigned char>('a' + i % 26);
+    }
+    return 0;
+  }
+
+  void ready() override {
+    if (!options_->enabled) {
+      return;
+    }
+
+    ready_ = true;
+    start_time_ = std::chrono::steady_clock::now() + options_->delay;
+  }
+
+  int stop() override {
+    if (options_->enabled && started_ && !finished_) {
+      finish(std::chrono::steady_clock::now());
+    }
+    return 0;
+  }
+
+  const char *name() const override { return "atappctl_bench_module"; }
+
+  int tick() override {
+    if (!ready_ || finished_) {
+      return 0;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (!started_) {
+      if (now < start_time_) {
+        return 0;
+      }
+
+      started_ = true;
+      sending_ = true;
+      begin_time_ = now;
+      last_report_time_ = now;
+      last_progress_time_ = now;
+      std::cout << "bench started, session: " << session_ << ", payload size: " << payload_.size()
+                << (options_->rate > 0 ? ", rate: " : ", concurrency: ")
+                << (options_->rate > 0 ? options_->rate : static_cast<uint64_t>(options_->concurrency)) << std::endl;
+    }
+
+    if (sending_ && is_send_finished(now)) {
+      sending_ = false;
+      send_end_time_ = now;
+    }
+
+    if (sending_) {
+      if (options_->rate > 0) {
+        uint64_t elapsed_us =
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - begin_time_).count());
+        uint64_t expected = options_->rate * elapsed_us / 1000000;
+        // Do not burst too much after a long tick
+        uint64_t max_burst = (std::max)(options_->rate / 10, static_cast<uint64_t>(1));
+        for (uint64_t i = 0; i < max_burst && sent_ + send_failed_ < expected && !is_send_finished(now); ++i) {
+          send_one();
+        }
+      } else {
+        fill_concurrency(now);
+      }
+
+      // All messages in flight are lost in closed-loop
+      if (options_->wait_echo && 0 == options_->rate && inflight_ > 0 &&
+          now - last_progress_time_ >= options_->timeout) {
+        sending_ = false;
+        send_end_time_ = now;
+      }
+    }
+
+    if (!sending_) {
+      if (!options_->wait_echo || 0 == inflight_ || now - last_progress_time_ >= options_->timeout) {
+        finish(now);
+        return 0;
+      }
+    }
+
+    if (now - last_report_time_ >= std::chrono::seconds{1}) {
+      double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(now - last_report_time_).count();
+      uint64_t completed = options_->wait_echo ? received_ : sent_;
+      std::cout << "bench " << std::chrono::duration_cast<std::chrono::seconds>(now - begin_time_).count()
+                << "s: sent " << sent_ << ", received " << received_ << ", failed " << send_failed_ + response_failed_
+                << ", inflight " << inflight_ << ", " << std::fixed << std::setprecision(1)
+                << static_cast<double>(completed - last_report_received_) / seconds << " msg/s" << std::endl;
+      last_report_received_ = completed;
+      last_report_time_ = now;
+    }
+
+    return 0;
+  }
+
+  // @return true if it's a message of this bench session
+  bool on_echo(const atapp::app::message_t &msg) {
+    atappctl_bench_header header;
+    if (!unpack_header(msg, header)) {
+      return false;
+    }
+
+    if (header.send_time_ns > 0) {
+      int64_t latency_ns = atappctl_bench_now_ns() - header.send_time_ns;
+      latency_us_.record(latency_ns > 0 ? static_cast<uint64_t>(latency_ns / 1000) : 0);
+    }
+
+    ++received_;
+    if (inflight_ > 0) {
+      --inflight_;
+    }
+    last_progress_time_ = std::chrono::steady_clock::now();
+
+    if (sending_ && 0 == options_->rate) {
+      fill_concurrency(last_progress_time_);
+    }
+    return true;
+  }
+
+  // @return true if it's a message of this bench session
+  bool on_forward_response(const atapp::app::message_t &msg, int32_t error_code) {
+    atappctl_bench_header header;
+    if (!unpack_header(msg, header)) {
+      return false;
+    }
+
+    if (error_code < 0) {
+      ++response_failed_;
+      if (options_->wait_echo && inflight_ > 0) {
+        --inflight_;
+      }
+      last_progress_time_ = std::chrono::steady_clock::now();
+    }
+    return true;
+  }
+
+  bool has_failure() const noexcept { return send_failed_ > 0 || response_failed_ > 0 || (finished_ && inflight_ > 0); }
+
+ private:
+  bool is_send_finished(std::chrono::steady_clock::time_point now) const {
+    if (options_->total > 0) {
+      return sent_ + send_failed_ >= options_->total;
+    }
+
+    return now - begin_time_ >= options_->duration;
+  }
+
+  bool unpack_header(const atapp::app::message_t &msg, atappctl_bench_header &header) const {
+    if (msg.data.size() < sizeof(atappctl_bench_header)) {
+      return false;
+    }
+
+    memcpy(&header, msg.data.data(), sizeof(header));
+    return header.magic == kAtappctlBenchMagic && header.session == session_;
+  }
+
+  void fill_concurrency(std::chrono::steady_clock::time_point now) {
+    // Without echo, send concurrency messages in every tick
+    size_t limit = options_->concurrency;
+    for (size_t i = 0; sending_ && i < limit && !is_send_finished(now); ++i) {
+      if (options_->wait_echo && inflight_ >= options_->concurrency) {
+        break;
+      }
+
+      if (send_one() < 0) {
+        break;
+      }
+    }
+  }
+
+  int32_t send_one() {
+    atappctl_bench_header header;
+    header.magic = kAtappctlBenchMagic;
+    header.session = session_;
+    header.sequence = ++sequence_;
+    header.send_time_ns = atappctl_bench_now_ns();
+    memcpy(payload_.data(), &header, sizeof(header));
+
+    gsl::span<const unsigned char> data{payload_.data(), payload_.size()};
+    const atapp::protocol::atapp_metadata *metadata = options_->has_metadata ? &options_->metadata : nullptr;
+    atapp::app &owner = *get_app();
+    int32_t res;
+    switch (options_->target_mode) {
+      case atappctl_bench_target_mode::kId:
+        res = owner.send_message(options_->target_id, options_->type, data, nullptr, metadata);
+        break;
+      case atappctl_bench_target_mode::kName:
+        res = owner.send_message(options_->target_key, options_->type, data, nullptr, metadata);
+        break;
+      case atappctl_bench_target_mode::kConsistentHash:
+        if (options_->hash_by_sequence) {
+          res = owner.send_message_by_consistent_hash(header.sequence, options_->type, data, nullptr, metadata);
+        } else {
+          res = owner.send_message_by_consistent_hash(options_->target_key, options_->type, data, nullptr, metadata);
+        }
+        break;
+      case atappctl_bench_target_mode::kRandom:
+        res = owner.send_message_by_random(options_->type, data, nullptr, metadata);
+        break;
+      default:
+        res = owner.send_message_by_round_robin(options_->type, data, nullptr, metadata);
+        break;
+    }
+
+    if (res < 0) {
+      ++send_failed_;
+      if (1 == send_failed_) {
+        FWLOGERROR("bench send message failed, res: {}", res);
+      }
+      return res;
+    }
+
+    ++sent_;
+    if (options_->wait_echo) {
+      ++inflight_;
+    }
+    return res;
+  }
+
+  void finish(std::chrono::steady_clock::time_point now) {
+    finished_ = true;
+    sending_ = false;
+    if (send_end_time_ < begin_time_) {
+      send_end_time_ = now;
+    }
+
+    std::chrono::steady_clock::time_point end_time = options_->wait_echo ? now : send_end_time_;
+    double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end_time - begin_time_).count();
+    if (seconds <= 0) {
+      seconds = 1e-9;
+    }
+    uint64_t completed = options_->wait_echo ? received_ : sent_;
+    double throughput = static_cast<double>(completed) / seconds;
+    double throughput_mb = throughput * static_cast<double>(payload_.size()) / (1024.0 * 1024.0);
+    uint64_t lost = options_->wait_echo ? inflight_ : 0;
+
+    std::cout << "bench finished in " << std::fixed << std::setprecision(3) << seconds << "s" << std::endl;
+    std::cout << "  sent: " << sent_ << ", received: " << received_ << ", send failed: " << send_failed_
+              << ", response failed: " << response_failed_ << ", lost: " << lost << std::endl;
+    std::cout << "  throughput: " << std::setprecision(1) << throughput << " msg/s, " << std::setprecision(2)
+              << throughput_mb << " MB/s" << std::endl;
+    if (latency_us_.get_count() > 0) {
+      std::cout << "  latency(us): avg " << latency_us_.get_average() << ", p50 " << latency_us_.get_percentile(0.5)
+                << ", p90 " << latency_us_.get_percentile(0.9) << ", p99 " << latency_us_.get_percentile(0.99)
+                << ", p999 " << latency_us_.get_percentile(0.999) << ", max " << latency_us_.get_max() << std::endl;
+      latency_us_.print(std::cout, "us");
+    }
+
+    if (!options_->output.empty()) {
+      std::ofstream output(options_->output.c_str(), std::ios::out | std::ios::trunc);
+      if (!output.is_open()) {
+        FWLOGERROR("bench open {} failed", options_->output);
+      } else {
+        output << "{\"payload_size\":" << payload_.size() << ",\"rate\":" << options_->rate
+               << ",\"concurrency\":" << options_->concurrency << ",\"seconds\":" << std::setprecision(6) << seconds
+               << ",\"sent\":" << sent_ << ",\"received\":" << received_ << ",\"send_failed\":" << send_failed_
+               << ",\"response_failed\":" << response_failed_ << ",\"lost\":" << lost
+               << ",\"throughput\":" << std::setprecision(3) << throughput << ",\"throughput_mb\":" << throughput_mb
+               << ",\"latency_us\":{\"avg\":" << latency_us_.get_average()
+               << ",\"p50\":" << latency_us_.get_percentile(0.5) << ",\"p90\":" << latency_us_.get_percentile(0.9)
+               << ",\"p99\":" << latency_us_.get_percentile(0.99) << ",\"p999\":" << latency_us_.get_percentile(0.999)
+               << ",\"max\":" << latency_us_.get_max() << "}}" << std::endl;
+      }
+    }
+
+    exit_code = has_failure() ? 1 : 0;
+    get_app()->stop();
+  }
+
+ private:
+  std::shared_ptr<atappctl_bench_options> options_;
+  std::vector<unsigned char> payload_;
+  uint32_t session_;
+
+  bool ready_;
+  bool started_;
+  bool sending_;
+  bool finished_;
+  std::chrono::steady_clock::time_point start_time_;
+  std::chrono::steady_clock::time_point begin_time_;
+  std::chrono::steady_clock::time_point send_end_time_;
+  std::chrono::steady_clock::time_point last_report_time_;
+  std::chrono::steady_clock::time_point last_progress_time_;
+
+  uint64_t sequence_;
+  uint64_t sent_;
+  uint64_t send_failed_;
+  uint64_t received_;
+  uint64_t response_failed_;
+  uint64_t inflight_;
+  uint64_t last_report_received_;
+  atappctl_bench_histogram latency_us_;
+};
+
 static int app_handle_on_message(atframework::atapp::app &, const atframework::atapp::app::message_sender_t &source,
                                  const atframework::atapp::app::message_t &msg) {
   std::string data;
@@ -87,16 +677,58 @@ int main(int argc, char *argv[]) {
   }
 
   // setup module
+  std::shared_ptr<atappctl_bench_options> bench_options = std::make_shared<atappctl_bench_options>();
+  std::shared_ptr<atappctl_bench_module> bench_module = std::make_shared<atappctl_bench_module>(bench_options);
   app.add_module(std::make_shared<atappctl_module>());
+  app.add_module(bench_module);
+
+  // setup options
+  app.get_option_manager()
+      ->bind_cmd("bench", atappctl_bench_option_handler{bench_options})
+      ->set_help_msg(
+          "bench [key=value...]                   run as load generator, the target should echo messages back.\n"
+          "  target=id:<id>|name:<name>|hash:<key or *>|random|round_robin  (default: round_robin)\n"
+          "  type=<type> size=<bytes> label=<key>:<value> namespace=<name>  message settings\n"
+          "  rate=<msg/s>                           open-loop rate, closed-loop with concurrency when it's 0\n"
+          "  concurrency=<n> total=<n> duration=<10s> delay=<1s> timeout=<5s> echo=<1|0> output=<json file>");
 
   // setup handle
-  app.set_evt_on_forward_request(app_handle_on_message);
-  app.set_evt_on_forward_response(app_handle_on_response);
+  app.set_evt_on_forward_request(
+      [bench_module](atframework::atapp::app &owner, const atframework::atapp::app::message_sender_t &source,
+                     const atframework::atapp::app::message_t &msg) {
+        if (bench_module->on_echo(msg)) {
+          return 0;
+        }
+        return app_handle_on_message(owner, source, msg);
+      });
+  app.set_evt_on_forward_response(
+      [bench_module](atframework::atapp::app &owner, const atframework::atapp::app::message_sender_t &source,
+                     const atframework::atapp::app::message_t &msg, int32_t error_code) {
+        if (bench_module->on_forward_response(msg, error_code)) {
+          return 0;
+        }
+        return app_handle_on_response(owner, source, msg, error_code);
+      });
   app.set_evt_on_app_connected(app_handle_on_connected);
   app.set_evt_on_app_disconnected(app_handle_on_disconnected);
 
+  // bench run as a node, start mode is used when there is no other mode
+  std::vector<const char *> args(argv, argv + argc);
+  {
+    bool has_bench = false;
+    bool has_mode = false;
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      has_bench = has_bench || arg == "bench";
+      has_mode = has_mode || arg == "start" || arg == "stop" || arg == "reload" || arg == "run";
+    }
+    if (has_bench && !has_mode) {
+      args.push_back("start");
+    }
+  }
+
   // run
-  int ret = app.run(uv_default_loop(), argc, (const char **)argv, nullptr);
+  int ret = app.run(uv_default_loop(), static_cast<int>(args.size()), args.data(), nullptr);
   if (0 == ret) {
     return exit_code;
   }